@@ -670,4 +670,21 @@ void chart_series_set_name_range_lv(lxw_chart_series series, const char *sheetna
 void chart_axis_set_name_range_lv(lxw_chart_axis axis, const char *sheetname, lxw_row_t row, lxw_col_t col);
 void chart_title_set_name_range_lv(lxw_chart chart, const char *sheetname, lxw_row_t row, lxw_col_t col);
 
+/* Bulk array write functions
+ *
+ * Numeric arrays are passed as "Array Data Pointer" with their size.
+ * String arrays are passed as "Adapt to Type" with "Handles by Value".
+ * Timestamps are LabVIEW timestamps converted to DBL (seconds since
+ * 1904-01-01 UTC) and are written as Excel dates.
+ */
+typedef unsigned long lxw_lv_string_array_handle;
+typedef unsigned long lxw_lv_string_array_2d_handle;
+
+lxw_error worksheet_write_number_array_lv(lxw_worksheet worksheet, lxw_row_t first_row, lxw_col_t first_col, const double *data, int32_t num_values, uint8_t write_as_column, lxw_format format);
+lxw_error worksheet_write_number_array_2d_lv(lxw_worksheet worksheet, lxw_row_t first_row, lxw_col_t first_col, const double *data, int32_t num_rows, int32_t num_cols, lxw_format format);
+lxw_error worksheet_write_string_array_lv(lxw_worksheet worksheet, lxw_row_t first_row, lxw_col_t first_col, lxw_lv_string_array_handle strings, uint8_t write_as_column, lxw_format format);
+lxw_error worksheet_write_string_array_2d_lv(lxw_worksheet worksheet, lxw_row_t first_row, lxw_col_t first_col, lxw_lv_string_array_2d_handle strings, lxw_format format);
+lxw_error worksheet_write_timestamps_lv(lxw_worksheet worksheet, lxw_row_t first_row, lxw_col_t col, const double *timestamps, int32_t num_values, lxw_format format);
+lxw_error worksheet_write_waveform_lv(lxw_worksheet worksheet, lxw_row_t first_row, lxw_col_t first_col, double t0, double dt, const double *values, int32_t num_values, lxw_format time_format, lxw_format value_format);
+
 #endif /* __LIBXLSXWRITER_LV_H__ */
@@ -14,7 +14,6 @@ pub fn build(b: *std.Build) void {
     const shared = b.option(bool, "SHARED_LIBRARY", "Build the Shared Library [default: false]") orelse false;
     const examples = b.option(bool, "BUILD_EXAMPLES", "Build libxlsxwriter examples [default: false]") orelse false;
     const tests = b.option(bool, "BUILD_TESTS", "Build libxlsxwriter tests [default: false]") orelse false;
-    const dtoa = b.option(bool, "USE_DTOA_LIBRARY", "Use the locale independent third party Milo Yip DTOA library [default: off]") orelse false;
     const minizip = b.option(bool, "USE_SYSTEM_MINIZIP", "Use system minizip installation [default: off]") orelse false;
     const md5 = b.option(bool, "USE_OPENSSL_MD5", "Build libxlsxwriter with the OpenSSL MD5 lib [default: off]") orelse false;
     const stdtmpfile = b.option(bool, "USE_STANDARD_TMPFILE", "Use the C standard library's tmpfile() [default: off]") orelse false;
@@ -94,13 +93,6 @@ pub fn build(b: *std.Build) void {
     else
         lib.linkSystemLibrary("crypto");
 
-    // dtoa
-    if (dtoa)
-        lib.addCSourceFile(.{
-            .file = b.path("third_party/dtoa/emyg_dtoa.c"),
-            .flags = cflags,
-        });
-
     // tmpfileplus
     if (stdtmpfile)
         lib.addCSourceFile(.{
@@ -110,6 +102,10 @@ pub fn build(b: *std.Build) void {
     else
         lib.root_module.addCMacro("USE_STANDARD_TMPFILE", "");
 
+    // threads for parallel compression
+    if (lib.rootModuleTarget().os.tag != .windows)
+        lib.linkSystemLibrary("pthread");
+
     lib.addIncludePath(b.path("include"));
     lib.addIncludePath(b.path("third_party"));
     lib.linkLibC();
@@ -23,7 +23,6 @@
 #import "styles.h"
 #import "table.h"
 #import "theme.h"
-#import "third_party/emyg_dtoa.h"
 #import "third_party/ioapi.h"
 #import "third_party/md5.h"
 #import "third_party/queue.h"
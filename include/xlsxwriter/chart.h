@@ -79,11 +79,14 @@
 #include "format.h"
 
 STAILQ_HEAD(lxw_chart_series_list, lxw_chart_series);
-STAILQ_HEAD(lxw_series_data_points, lxw_series_data_point);
 
 #define LXW_CHART_NUM_FORMAT_LEN 128
 #define LXW_CHART_DEFAULT_GAP 501
 
+/* The maximum number of points in a series set from an array. The data is
+ * stored in a single worksheet column. */
+#define LXW_CHART_ARRAY_MAX 1048576
+
 /**
  * @brief Available chart types.
  */
@@ -617,20 +620,32 @@ typedef struct lxw_series_range {
     uint8_t ignore_cache;
 
     uint8_t has_string_cache;
-    uint16_t num_data_points;
-    struct lxw_series_data_points *data_cache;
 
-} lxw_series_range;
+    /* The range was set from an array and is stored in a hidden worksheet. */
+    uint8_t has_array_data;
 
-typedef struct lxw_series_data_point {
-    uint8_t is_string;
-    double number;
-    char *string;
-    uint8_t no_data;
+    /* The cache is captured by a worksheet as rows are written in
+     * constant_memory mode. */
+    uint8_t has_row_tap;
 
-    STAILQ_ENTRY (lxw_series_data_point) list_pointers;
+    /* The cached data for each point in the range. The string and no_data
+     * arrays are only allocated if the range contains strings or empty
+     * cells. The no_data array is a bitmap. */
+    uint32_t num_data_points;
+    double *data_cache;
+    char **string_cache;
+    uint8_t *no_data_cache;
+
+} lxw_series_range;
 
-} lxw_series_data_point;
+/* The chart series ranges of a constant_memory workbook. The worksheets
+ * check the list when a row is written and capture the data of the ranges
+ * that refer to them into the range caches. Ranges are only appended. */
+typedef struct lxw_chart_range_taps {
+    lxw_series_range **ranges;
+    uint32_t count;
+    uint32_t size;
+} lxw_chart_range_taps;
 
 /**
  * @brief Struct to represent a chart line.
@@ -834,7 +849,6 @@ typedef struct lxw_chart_title {
      * will only have 1 point in order to re-use similar functions.*/
     lxw_series_range *range;
 
-    struct lxw_series_data_point data_point;
     lxw_chart_layout *layout;
 
 } lxw_chart_title;
@@ -902,8 +916,6 @@ typedef struct lxw_chart_custom_label {
      * will only have 1 point in order to re-use similar functions.*/
     lxw_series_range *range;
 
-    struct lxw_series_data_point data_point;
-
 } lxw_chart_custom_label;
 
 /**
@@ -1087,6 +1099,8 @@ typedef struct lxw_chart_series {
     lxw_chart_line *trendline_line;
     double trendline_intercept;
 
+    lxw_chart_range_taps *range_taps;
+
     STAILQ_ENTRY (lxw_chart_series) list_pointers;
 
 } lxw_chart_series;
@@ -1246,6 +1260,7 @@ typedef struct lxw_chart {
     lxw_chart_line *high_low_lines_line;
 
     struct lxw_chart_series_list *series_list;
+    lxw_chart_range_taps *range_taps;
 
     uint8_t has_table;
     uint8_t has_table_vertical;
@@ -1457,6 +1472,57 @@ void chart_series_set_values(lxw_chart_series *series, const char *sheetname,
                              lxw_row_t first_row, lxw_col_t first_col,
                              lxw_row_t last_row, lxw_col_t last_col);
 
+/**
+ * @brief Set a series "categories" range from an array of numbers.
+ *
+ * @param series         A series object created via `chart_add_series()`.
+ * @param categories     An array of category values.
+ * @param num_categories The number of elements in the array.
+ *
+ * @return A #lxw_error code.
+ *
+ * The `%chart_series_set_categories_array()` function is an alternative to
+ * `chart_series_set_categories()` for data that is only held in memory. The
+ * values are copied and, when the workbook is closed, they are written to a
+ * hidden worksheet which the series range refers to:
+ *
+ * @code
+ *     double x[] = {1, 2, 3, 4, 5};
+ *     double y[] = {2, 4, 6, 8, 10};
+ *
+ *     lxw_chart_series *series = chart_add_series(chart, NULL, NULL);
+ *
+ *     chart_series_set_categories_array(series, x, 5);
+ *     chart_series_set_values_array(    series, y, 5);
+ * @endcode
+ *
+ * The chart data cache is taken directly from the array so this also works
+ * for workbooks created with the `constant_memory` option, where the data
+ * cache can't be read back from a worksheet.
+ *
+ * The number of elements must be in the range 1 to 1,048,576.
+ */
+lxw_error chart_series_set_categories_array(lxw_chart_series *series,
+                                            const double *categories,
+                                            uint32_t num_categories);
+
+/**
+ * @brief Set a series "values" range from an array of numbers.
+ *
+ * @param series     A series object created via `chart_add_series()`.
+ * @param values     An array of data values.
+ * @param num_values The number of elements in the array.
+ *
+ * @return A #lxw_error code.
+ *
+ * The `%chart_series_set_values_array()` function is an alternative to
+ * `chart_series_set_values()` for data that is only held in memory. See the
+ * documentation for `chart_series_set_categories_array()` above.
+ */
+lxw_error chart_series_set_values_array(lxw_chart_series *series,
+                                        const double *values,
+                                        uint32_t num_values);
+
 /**
  * @brief Set the name of a chart series range.
  *
@@ -3994,11 +4060,34 @@ void chart_set_hole_size(lxw_chart *chart, uint8_t size);
 lxw_error lxw_chart_add_data_cache(lxw_series_range *range, uint8_t *data,
                                    uint16_t rows, uint8_t cols, uint8_t col);
 
+lxw_error lxw_chart_init_data_cache(lxw_series_range *range,
+                                    uint32_t num_data_points);
+lxw_error lxw_chart_set_cache_string(lxw_series_range *range, uint32_t index,
+                                     const char *string);
+lxw_error lxw_chart_set_cache_no_data(lxw_series_range *range,
+                                      uint32_t index);
+lxw_error lxw_chart_init_empty_data_cache(lxw_series_range *range,
+                                          uint32_t num_data_points);
+void lxw_chart_set_cache_number(lxw_series_range *range, uint32_t index,
+                                double number);
+lxw_error lxw_chart_copy_data_cache(lxw_series_range *range,
+                                    lxw_series_range *source);
+lxw_error lxw_chart_parse_range_formula(lxw_series_range *range);
+void lxw_chart_range_taps_free(lxw_chart_range_taps *range_taps);
+void lxw_chart_set_range(lxw_series_range *range, const char *sheetname,
+                         lxw_row_t first_row, lxw_col_t first_col,
+                         lxw_row_t last_row, lxw_col_t last_col);
+void lxw_chart_free_data_cache(lxw_series_range *range);
+
 /* Declarations required for unit testing. */
 #ifdef TESTING
 
 STATIC void _chart_xml_declaration(lxw_chart *chart);
 STATIC void _chart_write_legend(lxw_chart *chart);
+STATIC void _chart_write_num_cache(lxw_chart *chart,
+                                   lxw_series_range *range);
+STATIC void _chart_write_str_cache(lxw_chart *chart,
+                                   lxw_series_range *range);
 
 #endif /* TESTING */
 
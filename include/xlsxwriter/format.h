@@ -368,6 +368,7 @@ typedef struct lxw_format {
     int32_t xf_index;
     int32_t dxf_index;
     int32_t xf_id;
+    uint32_t format_id;
 
     char num_format[LXW_FORMAT_FIELD_LEN];
     char font_name[LXW_FORMAT_FIELD_LEN];
@@ -508,6 +509,7 @@ int32_t lxw_format_get_dxf_index(lxw_format *format);
 lxw_font *lxw_format_get_font_key(lxw_format *format);
 lxw_border *lxw_format_get_border_key(lxw_format *format);
 lxw_fill *lxw_format_get_fill_key(lxw_format *format);
+void lxw_format_set_intern_key(lxw_format *key, lxw_format *format);
 
 /**
  * @brief Set the font used in the cell.
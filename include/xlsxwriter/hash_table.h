@@ -19,33 +19,35 @@
 
 /* List declarations. */
 STAILQ_HEAD(lxw_hash_order_list, lxw_hash_element);
-SLIST_HEAD(lxw_hash_bucket_list, lxw_hash_element);
 
-/* LXW_HASH hash table struct. */
+/*
+ * LXW_HASH hash table struct. The elements are stored in an open addressing
+ * table of slots with linear probing. The number of slots is a power of 2
+ * and the table is resized when it is more than 3/4 full.
+ */
 typedef struct lxw_hash_table {
-    uint32_t num_buckets;
-    uint32_t used_buckets;
+    uint32_t num_slots;
     uint32_t unique_count;
     uint8_t free_key;
     uint8_t free_value;
 
     struct lxw_hash_order_list *order_list;
-    struct lxw_hash_bucket_list **buckets;
+    struct lxw_hash_element **slots;
 } lxw_hash_table;
 
 /*
  * LXW_HASH table element struct.
  *
- * The hash elements contain pointers to allow them to be stored in
- * lists in the the hash table buckets and also pointers to track the
- * insertion order in a separate list.
+ * The hash elements store the hash of their key so that the table can be
+ * resized without rehashing the keys, and pointers to track the insertion
+ * order in a separate list.
  */
 typedef struct lxw_hash_element {
     void *key;
     void *value;
+    uint64_t hash;
 
     STAILQ_ENTRY (lxw_hash_element) lxw_hash_order_pointers;
-    SLIST_ENTRY (lxw_hash_element) lxw_hash_list_pointers;
 } lxw_hash_element;
 
 
@@ -59,13 +61,15 @@ lxw_hash_element *lxw_hash_key_exists(lxw_hash_table *lxw_hash, void *key,
                                       size_t key_len);
 lxw_hash_element *lxw_insert_hash_element(lxw_hash_table *lxw_hash, void *key,
                                           void *value, size_t key_len);
-lxw_hash_table *lxw_hash_new(uint32_t num_buckets, uint8_t free_key,
+lxw_hash_table *lxw_hash_new(uint32_t num_slots, uint8_t free_key,
                              uint8_t free_value);
 void lxw_hash_free(lxw_hash_table *lxw_hash);
 
 /* Declarations required for unit testing. */
 #ifdef TESTING
 
+STATIC uint64_t _hash_key(const void *key, size_t key_len);
+
 #endif
 
 /* *INDENT-OFF* */
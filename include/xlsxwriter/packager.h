@@ -77,6 +77,10 @@ typedef struct lxw_packager {
     char *output_buffer;
     const char *tmpdir;
     uint8_t use_zip64;
+    uint16_t num_threads;
+    struct lxw_deflate_pool *deflate_pool;
+    struct lxw_deflated_part *deflated_parts;
+    struct lxw_sink_stream *sink_stream;
 
 } lxw_packager;
 
@@ -88,7 +92,8 @@ extern "C" {
 /* *INDENT-ON* */
 
 lxw_packager *lxw_packager_new(const char *filename, const char *tmpdir,
-                               uint8_t use_zip64);
+                               uint8_t use_zip64,
+                               lxw_output_sink *output_sink);
 void lxw_packager_free(lxw_packager *packager);
 lxw_error lxw_create_package(lxw_packager *self);
 
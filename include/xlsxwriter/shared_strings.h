@@ -16,32 +16,55 @@
 
 #include "common.h"
 
-/* Define a tree.h RB structure for storing shared strings. */
-RB_HEAD(sst_rb_tree, sst_element);
-
 /* Define a queue.h structure for storing shared strings in insertion order. */
 STAILQ_HEAD(sst_order_list, sst_element);
 
-/* Wrapper around RB_GENERATE_STATIC from tree.h to avoid unused function
- * warnings and to avoid portability issues with the _unused attribute. */
-#define LXW_RB_GENERATE_ELEMENT(name, type, field, cmp) \
-    RB_GENERATE_INSERT_COLOR(name, type, field, static) \
-    RB_GENERATE_INSERT(name, type, field, cmp, static)  \
-    /* Add unused struct to allow adding a semicolon */ \
-    struct lxw_rb_generate_element{int unused;}
-
 /*
- * Elements of the SST table. They contain pointers to allow them to
- * be stored in a RB tree and also pointers to track the insertion order
- * in a separate list.
+ * Elements of the SST table. They are stored in an open addressing hash
+ * table to find duplicate strings and in a separate list to track the
+ * insertion order. The elements and strings are allocated from blocks
+ * owned by the table so that their addresses are stable.
  */
 struct sst_element {
     uint32_t index;
     char *string;
+    size_t length;
     uint8_t is_rich_string;
 
+    /* The string is known not to contain control characters. */
+    uint8_t is_validated;
+
     STAILQ_ENTRY (sst_element) sst_order_pointers;
-    RB_ENTRY (sst_element) sst_tree_pointers;
+};
+
+/* A slot in the hash table with the cached hash of its string. */
+struct sst_slot {
+    struct sst_element *element;
+    uint32_t hash;
+};
+
+/*
+ * A slot in the hash table used with temp files. The string is stored in
+ * the key file at the given offset.
+ */
+struct sst_file_slot {
+    long offset;
+    uint32_t hash;
+    uint32_t index;
+    uint32_t length;
+    uint8_t used;
+};
+
+/* An entry in the cache of recently used strings used with temp files. */
+struct sst_lru_entry {
+    char *string;
+    uint32_t hash;
+    uint32_t index;
+    uint32_t length;
+
+    struct sst_lru_entry *prev;
+    struct sst_lru_entry *next;
+    struct sst_lru_entry *chain;
 };
 
 /*
@@ -54,7 +77,35 @@ typedef struct lxw_sst {
     uint32_t unique_count;
 
     struct sst_order_list *order_list;
-    struct sst_rb_tree *rb_tree;
+
+    /* Open addressing hash table. The number of slots is a power of 2. */
+    struct sst_slot *slots;
+    uint32_t num_slots;
+
+    /* Blocks used to allocate the elements and to intern the strings. */
+    union lxw_sst_block *blocks;
+    struct sst_element *element_data;
+    uint32_t elements_free;
+    char *string_data;
+    size_t string_bytes_free;
+    size_t string_bytes;
+
+    /* With temp files the <si> elements are written to the si file and the
+     * strings to the key file. Only a hash table of their key file offsets
+     * and a cache of the most recently used strings are kept in memory. */
+    uint8_t use_tmpfiles;
+    FILE *si_file;
+    FILE *key_file;
+    long key_file_size;
+    uint8_t key_file_read;
+    char *read_buffer;
+    size_t read_buffer_size;
+    struct sst_file_slot *file_slots;
+    struct sst_lru_entry *lru_entries;
+    struct sst_lru_entry **lru_buckets;
+    struct sst_lru_entry *lru_head;
+    struct sst_lru_entry *lru_tail;
+    uint32_t lru_used;
 
 } lxw_sst;
 
@@ -66,8 +117,16 @@ extern "C" {
 
 lxw_sst *lxw_sst_new(void);
 void lxw_sst_free(lxw_sst *sst);
+lxw_error lxw_sst_use_tmpfiles(lxw_sst *sst, const char *tmpdir);
 struct sst_element *lxw_get_sst_index(lxw_sst *sst, const char *string,
                                       uint8_t is_rich_string);
+lxw_error lxw_get_sst_id(lxw_sst *sst, const char *string,
+                         uint8_t is_rich_string, uint32_t *index);
+struct sst_element *lxw_get_sst_index_len(lxw_sst *sst, const char *string,
+                                          size_t length, uint8_t is_static,
+                                          uint8_t is_validated);
+lxw_error lxw_get_sst_id_len(lxw_sst *sst, const char *string, size_t length,
+                             uint8_t is_validated, uint32_t *index);
 void lxw_sst_assemble_xml_file(lxw_sst *self);
 
 /* Declarations required for unit testing. */
@@ -287,16 +287,9 @@ FILE *lxw_tmpfile(const char *tmpdir);
 FILE *lxw_get_filehandle(char **buf, size_t *size, const char *tmpdir);
 FILE *lxw_fopen(const char *filename, const char *mode);
 
-/* Use the third party dtoa function to avoid locale issues with sprintf
- * double formatting. Otherwise we use a simple macro that falls back to the
- * default c-lib sprintf.
- */
-#ifdef USE_DTOA_LIBRARY
+/* Format a double with the shortest round trip digits, independent of the
+ * locale. The buffer should be at least LXW_ATTR_32 bytes. */
 int lxw_sprintf_dbl(char *data, double number);
-#else
-#define lxw_sprintf_dbl(data, number) \
-        lxw_snprintf(data, LXW_ATTR_32, "%.16G", number)
-#endif
 
 uint16_t lxw_hash_password(const char *password);
 
@@ -66,6 +66,7 @@ STAILQ_HEAD(lxw_worksheets, lxw_worksheet);
 STAILQ_HEAD(lxw_chartsheets, lxw_chartsheet);
 STAILQ_HEAD(lxw_charts, lxw_chart);
 TAILQ_HEAD(lxw_defined_names, lxw_defined_name);
+STAILQ_HEAD(lxw_compression_overrides, lxw_compression_override);
 
 /* Struct to hold the 2 sheet types. */
 typedef struct lxw_sheet {
@@ -103,6 +104,82 @@ typedef struct lxw_image_md5 {
     RB_ENTRY (lxw_image_md5) tree_pointers;
 } lxw_image_md5;
 
+/**
+ * @brief Compression strategies for the xlsx file parts.
+ *
+ * The zlib strategies that can be used with the `compression_strategy`
+ * workbook option and with `workbook_set_part_compression()`.
+ */
+enum lxw_compression_strategies {
+
+    /** The default zlib strategy. This is the best choice for XML data. */
+    LXW_COMPRESSION_STRATEGY_DEFAULT = 0,
+
+    /** Optimized for data made up of small values with a random
+     *  distribution. */
+    LXW_COMPRESSION_STRATEGY_FILTERED,
+
+    /** Huffman encoding only, without string matching. This is fast but
+     *  compresses XML poorly. */
+    LXW_COMPRESSION_STRATEGY_HUFFMAN_ONLY,
+
+    /** Limit string matching to run-length encoding. */
+    LXW_COMPRESSION_STRATEGY_RLE,
+
+    /** Use fixed Huffman codes. */
+    LXW_COMPRESSION_STRATEGY_FIXED
+};
+
+/**
+ * @brief Compression settings for xlsx file parts.
+ *
+ * Compression settings used with `workbook_set_part_compression()` to
+ * override the workbook compression options for some of the parts in the
+ * xlsx file.
+ */
+typedef struct lxw_part_compression {
+
+    /** The zlib compression level from 1 (fastest) to 9 (smallest). The
+     *  default, 0, is the zlib default level of 6. */
+    uint8_t level;
+
+    /** The zlib compression strategy. See #lxw_compression_strategies. */
+    uint8_t strategy;
+
+    /** Store the part in the xlsx file without compressing it. */
+    uint8_t store_only;
+
+} lxw_part_compression;
+
+/**
+ * @brief Shared string table statistics.
+ *
+ * Statistics about the strings in the shared string table returned by
+ * `workbook_get_string_stats()`.
+ */
+typedef struct lxw_string_stats {
+
+    /** The number of strings written to the shared string table, including
+     *  repeated strings. */
+    uint32_t total_strings;
+
+    /** The number of unique strings in the shared string table. */
+    uint32_t unique_strings;
+
+    /** The number of bytes used to store the unique strings, including the
+     *  terminating nulls. */
+    size_t string_bytes;
+
+} lxw_string_stats;
+
+/* Struct to represent a per-part compression override. */
+typedef struct lxw_compression_override {
+    char *part_name;
+    lxw_part_compression compression;
+
+    STAILQ_ENTRY (lxw_compression_override) list_pointers;
+} lxw_compression_override;
+
 /* Wrapper around RB_GENERATE_STATIC from tree.h to avoid unused function
  * warnings and to avoid portability issues with the _unused attribute. */
 #define LXW_RB_GENERATE_WORKSHEET_NAMES(name, type, field, cmp)  \
@@ -164,6 +241,15 @@ typedef struct lxw_image_md5 {
 #define LXW_FOREACH_WORKSHEET(worksheet, workbook) \
     STAILQ_FOREACH((worksheet), (workbook)->worksheets, list_pointers)
 
+/* Key to look up chart ranges that refer to the same worksheet data. */
+typedef struct lxw_chart_range_key {
+    lxw_worksheet *worksheet;
+    lxw_row_t first_row;
+    lxw_row_t last_row;
+    lxw_col_t first_col;
+    lxw_col_t last_col;
+} lxw_chart_range_key;
+
 /* Struct to represent a defined name. */
 typedef struct lxw_defined_name {
     int16_t index;
@@ -220,6 +306,33 @@ typedef struct lxw_doc_properties {
 
 } lxw_doc_properties;
 
+/**
+ * @brief Output sink for streaming the xlsx file.
+ *
+ * Callback functions used with the `output_sink` workbook option to stream
+ * the xlsx file to an application defined destination, such as a socket or
+ * a pipe, as it is created. See `workbook_new_opt()` for more details.
+ */
+typedef struct lxw_output_sink {
+
+    /** Write `size` bytes of the xlsx file. The data is written sequentially
+     *  and is never rewritten. The function should return the number of bytes
+     *  written. Any value less than `size` is treated as an error. */
+    size_t (*write)(void *user_data, const void *data, size_t size);
+
+    /** Optional function called after the last of the data has been
+     *  written. It should return 0 on success. */
+    int (*flush)(void *user_data);
+
+    /** Optional function called once when the xlsx file is closed, including
+     *  after an error. It should return 0 on success. */
+    int (*close)(void *user_data);
+
+    /** Application data passed to the callback functions. */
+    void *user_data;
+
+} lxw_output_sink;
+
 /**
  * @brief Workbook options.
  *
@@ -252,6 +365,53 @@ typedef struct lxw_doc_properties {
  * - `output_buffer_size`: Used with output_buffer to get the size of the
  *   created buffer. This option can only be used if filename is NULL.
  *
+ * - `output_sink`: Stream the xlsx file through the write, flush and close
+ *   callback functions of a #lxw_output_sink instead of writing it to a
+ *   file. Each part of the file is passed to the `write` callback once it is
+ *   complete, so the file can be sent, for example as an HTTP chunked
+ *   response, while it is being created. Only the compressed data of the
+ *   current part is held in memory. This option can only be used if filename
+ *   is `NULL`.
+ *
+ * - `compact_cells`: Store number, shared string, boolean, blank and error
+ *   cells in a compact form of 16 bytes per cell in a sorted array for each
+ *   row, instead of as a tree of cell objects. This significantly reduces
+ *   the memory used by large worksheets. Other cell types, such as formulas,
+ *   are stored as usual. This option is ignored in `constant_memory` mode.
+ *   See @ref ww_mem_compact for more details.
+ *
+ * - `constant_memory_sst`: In `constant_memory` mode write the worksheet
+ *   strings to a shared string table instead of writing them "in-line". The
+ *   unique strings are stored in temporary files and only a hash table of
+ *   their positions and a cache of the recently used strings are kept in
+ *   memory. This gives much smaller files when strings are repeated, at the
+ *   cost of some temporary file space. This option is ignored if
+ *   `constant_memory` is off. See @ref ww_mem_constant_sst for more details.
+ *
+ * - `num_threads`: The number of worker threads used to compress the xlsx
+ *   file parts in workbook_close(). Large parts are split into chunks that
+ *   are compressed in parallel. The default, 0, or 1 compresses the parts
+ *   serially in the calling thread. The output is the same for any number of
+ *   threads greater than 1 but it isn't byte for byte the same as the serial
+ *   output. Around 64MB of part data is held in memory for the
+ *   compression queue.
+ *
+ * - `compression_level`: The zlib compression level used for the xlsx file
+ *   parts, from 1 (fastest) to 9 (smallest). The default, 0, is the zlib
+ *   default level of 6. Level 1 is significantly faster than the default
+ *   for large worksheets and gives a file that is around 30% larger.
+ *
+ * - `compression_strategy`: The zlib compression strategy used for the xlsx
+ *   file parts. See #lxw_compression_strategies. The default strategy is the
+ *   best choice for most data.
+ *
+ * - `store_only`: Store the xlsx file parts without compressing them. This
+ *   is the fastest option but it gives a much larger file. This option is off
+ *   by default.
+ *
+ * The compression options can be overridden for individual parts, or groups
+ * of parts, in the xlsx file using `workbook_set_part_compression()`.
+ *
  * @note In `constant_memory` mode each row of in-memory data is written to
  * disk and then freed when a new row is started via one of the
  * `worksheet_write_*()` functions. Therefore, once this option is active data
@@ -281,6 +441,27 @@ typedef struct lxw_workbook_options {
 
     /** Used with output_buffer to get the size of the created buffer */
     size_t *output_buffer_size;
+
+    /** Number of threads used to compress the xlsx file. */
+    uint16_t num_threads;
+
+    /** The zlib compression level for the xlsx file parts: 1-9. */
+    uint8_t compression_level;
+
+    /** The zlib compression strategy for the xlsx file parts. */
+    uint8_t compression_strategy;
+
+    /** Store the xlsx file parts without compression. */
+    uint8_t store_only;
+
+    /** Output sink to stream the xlsx file to instead of a file. */
+    lxw_output_sink *output_sink;
+
+    /** Store simple worksheet cells in a compact form to reduce memory. */
+    uint8_t compact_cells;
+
+    /** Use a shared string table in constant_memory mode. */
+    uint8_t constant_memory_sst;
 } lxw_workbook_options;
 
 /**
@@ -304,11 +485,13 @@ typedef struct lxw_workbook {
     struct lxw_image_md5s *background_md5s;
     struct lxw_charts *charts;
     struct lxw_charts *ordered_charts;
+    lxw_chart_range_taps chart_range_taps;
     struct lxw_formats *formats;
     struct lxw_defined_names *defined_names;
     lxw_sst *sst;
     lxw_doc_properties *properties;
     struct lxw_custom_properties *custom_properties;
+    struct lxw_compression_overrides *compression_overrides;
 
     char *filename;
     lxw_workbook_options options;
@@ -321,6 +504,7 @@ typedef struct lxw_workbook {
     uint16_t num_xf_formats;
     uint16_t num_dxf_formats;
     uint16_t num_format_count;
+    uint32_t num_format_ids;
     uint16_t drawing_count;
     uint16_t comment_count;
     uint32_t num_embedded_images;
@@ -347,6 +531,7 @@ typedef struct lxw_workbook {
 
     lxw_hash_table *used_xf_formats;
     lxw_hash_table *used_dxf_formats;
+    lxw_hash_table *interned_formats;
 
     char *vba_project;
     char *vba_project_signature;
@@ -432,6 +617,50 @@ lxw_workbook *workbook_new(const char *filename);
  * - `output_buffer_size`: Used with output_buffer to get the size of the
  *   created buffer. This option can only be used if filename is `NULL`.
  *
+ * - `output_sink`: Stream the xlsx file through the write, flush and close
+ *   callback functions of a #lxw_output_sink instead of writing it to a
+ *   file. Each part of the file is passed to the `write` callback once it is
+ *   complete, so the file can be sent, for example as an HTTP chunked
+ *   response, while it is being created. Only the compressed data of the
+ *   current part is held in memory. This option can only be used if filename
+ *   is `NULL`.
+ *
+ * - `compact_cells`: Store number, shared string, boolean, blank and error
+ *   cells in a compact form of 16 bytes per cell in a sorted array for each
+ *   row, instead of as a tree of cell objects. This significantly reduces
+ *   the memory used by large worksheets. Other cell types, such as formulas,
+ *   are stored as usual. This option is ignored in `constant_memory` mode.
+ *   See @ref ww_mem_compact for more details.
+ *
+ * - `constant_memory_sst`: In `constant_memory` mode write the worksheet
+ *   strings to a shared string table instead of writing them "in-line". The
+ *   unique strings are stored in temporary files and only a hash table of
+ *   their positions and a cache of the recently used strings are kept in
+ *   memory. This gives much smaller files when strings are repeated, at the
+ *   cost of some temporary file space. This option is ignored if
+ *   `constant_memory` is off. See @ref ww_mem_constant_sst for more details.
+ *
+ * - `num_threads`: The number of worker threads used to compress the xlsx
+ *   file parts in workbook_close(). Large parts are split into chunks that
+ *   are compressed in parallel. The default, 0, or 1 compresses the parts
+ *   serially in the calling thread. The output is the same for any number of
+ *   threads greater than 1 but it isn't byte for byte the same as the serial
+ *   output.
+ *
+ * - `compression_level`: The zlib compression level used for the xlsx file
+ *   parts, from 1 (fastest) to 9 (smallest). The default, 0, is the zlib
+ *   default level of 6.
+ *
+ * - `compression_strategy`: The zlib compression strategy used for the xlsx
+ *   file parts. See #lxw_compression_strategies.
+ *
+ * - `store_only`: Store the xlsx file parts without compressing them. This
+ *   is the fastest option but it gives a much larger file. This option is off
+ *   by default.
+ *
+ * The compression options can be overridden for individual parts, or groups
+ * of parts, in the xlsx file using `workbook_set_part_compression()`.
+ *
  * @note In `constant_memory` mode each row of in-memory data is written to
  * disk and then freed when a new row is started via one of the
  * `worksheet_write_*()` functions. Therefore, once this option is active data
@@ -572,6 +801,48 @@ lxw_chartsheet *workbook_add_chartsheet(lxw_workbook *workbook,
  */
 lxw_format *workbook_add_format(lxw_workbook *workbook);
 
+/**
+ * @brief Get the workbook format with the same properties as a format.
+ *
+ * @param workbook Pointer to a lxw_workbook instance.
+ * @param format   A format to use as a template.
+ *
+ * @return A lxw_format instance or NULL on a memory error.
+ *
+ * The `workbook_intern_format()` function returns a single, shared format
+ * for each unique set of format properties. The first time a set of
+ * properties is seen a copy of `format` is added to the workbook. After that
+ * the same copy is returned for any format with the same properties.
+ *
+ * The `format` itself isn't changed or kept, so it can be used as a template
+ * that is modified for each cell. This avoids creating a format for every
+ * cell when the formatting is computed from the data:
+ *
+ * @code
+ *    lxw_format *template = workbook_add_format(workbook);
+ *    lxw_format *format;
+ *
+ *    for (row = 0; row < num_rows; row++) {
+ *        // Set the properties for this cell.
+ *        format_set_bg_color(template, value_to_color(values[row]));
+ *
+ *        // Get the shared format with the same properties.
+ *        format = workbook_intern_format(workbook, template);
+ *
+ *        worksheet_write_number(worksheet, row, 0, values[row], format);
+ *    }
+ * @endcode
+ *
+ * The memory used by the formats, and the time taken to prepare them in
+ * `workbook_close()`, then depends on the number of unique formats rather
+ * than the number of cells.
+ *
+ * The returned format shouldn't be modified since it may be shared by other
+ * cells.
+ */
+lxw_format *workbook_intern_format(lxw_workbook *workbook,
+                                   lxw_format *format);
+
 /**
  * @brief Create a new chart to be added to a worksheet:
  *
@@ -1114,6 +1385,76 @@ void workbook_use_1904_epoch(lxw_workbook *workbook);
 void workbook_set_size(lxw_workbook *workbook,
                        uint16_t width, uint16_t height);
 
+/**
+ * @brief Set the compression for some of the parts in the xlsx file.
+ *
+ * @param workbook    Pointer to a lxw_workbook instance.
+ * @param part_name   The name, or name pattern, of the parts in the file.
+ * @param compression Pointer to a lxw_part_compression struct.
+ *
+ * @return A #lxw_error.
+ *
+ * The `%workbook_set_part_compression()` function can be used to override
+ * the `compression_level`, `compression_strategy` and `store_only` workbook
+ * options, see `workbook_new_opt()`, for some of the parts in the xlsx file.
+ * For example to use fast compression for the worksheet data and maximum
+ * compression for the shared strings table:
+ *
+ * @code
+ *     lxw_part_compression fast = {.level = 1};
+ *     lxw_part_compression best = {.level = 9};
+ *
+ *     workbook_set_part_compression(workbook, "xl/worksheets/sheet*.xml", &fast);
+ *     workbook_set_part_compression(workbook, "xl/sharedStrings.xml", &best);
+ * @endcode
+ *
+ * The `part_name` is the path of the part in the xlsx file such as
+ * `xl/worksheets/sheet1.xml` or `xl/media/image1.png`. It can contain `*`
+ * wildcards, which match any characters other than `/`. A `part_name` that
+ * ends in `/` matches all of the parts in that directory and in the
+ * directories below it.
+ *
+ * The settings in `compression` replace all of the workbook compression
+ * options for the matching parts. If more than one `part_name` matches a part
+ * then the last one that was added is used.
+ *
+ * PNG, JPEG and GIF images are already compressed so they are stored in the
+ * xlsx file without compression by default, regardless of the workbook
+ * options. An override that matches the image part, such as `xl/media/`,
+ * takes precedence over this.
+ */
+lxw_error workbook_set_part_compression(lxw_workbook *workbook,
+                                        const char *part_name,
+                                        lxw_part_compression *compression);
+
+/**
+ * @brief Get statistics about the shared strings in the workbook.
+ *
+ * @param workbook Pointer to a lxw_workbook instance.
+ * @param stats    Pointer to a lxw_string_stats struct to fill in.
+ *
+ * The `%workbook_get_string_stats()` function gets the number of strings
+ * written to the workbook's shared string table and how many of them are
+ * unique. Each unique string is only stored once, so this can be used to
+ * check how much an application benefits from repeated strings:
+ *
+ * @code
+ *     lxw_string_stats stats;
+ *
+ *     workbook_get_string_stats(workbook, &stats);
+ *
+ *     printf("%u strings, %u unique.\n", stats.total_strings,
+ *            stats.unique_strings);
+ * @endcode
+ *
+ * Strings written in `constant_memory` mode are stored in the worksheet
+ * rather than the shared string table, so they aren't counted, unless the
+ * `constant_memory_sst` option is set. In that case they are written to the
+ * shared string table and are counted.
+ */
+void workbook_get_string_stats(lxw_workbook *workbook,
+                               lxw_string_stats *stats);
+
 void lxw_workbook_free(lxw_workbook *workbook);
 void lxw_workbook_assemble_xml_file(lxw_workbook *workbook);
 void lxw_workbook_set_default_xf_indices(lxw_workbook *workbook);
@@ -1142,6 +1483,8 @@ STATIC lxw_error _store_defined_name(lxw_workbook *self, const char *name,
                                      const char *formula, int16_t index,
                                      uint8_t hidden);
 
+STATIC lxw_error _prepare_chart_array_data(lxw_workbook *self);
+
 #endif /* TESTING */
 
 /* *INDENT-OFF* */
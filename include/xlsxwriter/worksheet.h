@@ -711,6 +711,33 @@ enum lxw_ignore_errors {
     LXW_IGNORE_LAST_OPTION
 };
 
+/** Data types for the arrays written by worksheet_write_array(). */
+enum lxw_array_types {
+
+    /** An array of `double` numbers. */
+    LXW_ARRAY_NUMBER,
+
+    /** An array of `const char *` UTF-8 strings. */
+    LXW_ARRAY_STRING
+};
+
+/** Flags that describe the strings written by worksheet_write_string_len().
+ *  They can be combined with `|`. */
+enum lxw_string_flags {
+
+    /** The string is checked and copied, as in worksheet_write_string(). */
+    LXW_STRING_DEFAULT = 0,
+
+    /** The string is valid UTF-8 and doesn't contain control characters, so
+     *  it doesn't need to be checked for characters that need escaping. */
+    LXW_STRING_VALIDATED = 1,
+
+    /** The string is null terminated and the caller keeps it unchanged
+     *  until the cell has been written to the file, so it doesn't need to
+     *  be copied. */
+    LXW_STRING_STATIC = 2
+};
+
 enum cell_types {
     NUMBER_CELL = 1,
     STRING_CELL,
@@ -725,7 +752,8 @@ enum cell_types {
     COMMENT,
     HYPERLINK_URL,
     HYPERLINK_INTERNAL,
-    HYPERLINK_EXTERNAL
+    HYPERLINK_EXTERNAL,
+    INLINE_STATIC_STRING_CELL
 };
 
 enum pane_types {
@@ -761,10 +789,9 @@ struct lxw_table_rows {
  * warnings and to avoid portability issues with the _unused attribute. */
 #define LXW_RB_GENERATE_ROW(name, type, field, cmp)       \
     RB_GENERATE_INSERT_COLOR(name, type, field, static)   \
-    RB_GENERATE_REMOVE_COLOR(name, type, field, static)   \
     RB_GENERATE_INSERT(name, type, field, cmp, static)    \
-    RB_GENERATE_REMOVE(name, type, field, static)         \
     RB_GENERATE_FIND(name, type, field, cmp, static)      \
+    RB_GENERATE_NFIND(name, type, field, cmp, static)     \
     RB_GENERATE_NEXT(name, type, field, static)           \
     RB_GENERATE_MINMAX(name, type, field, static)         \
     /* Add unused struct to allow adding a semicolon */   \
@@ -776,6 +803,7 @@ struct lxw_table_rows {
     RB_GENERATE_INSERT(name, type, field, cmp, static)    \
     RB_GENERATE_REMOVE(name, type, field, static)         \
     RB_GENERATE_FIND(name, type, field, cmp, static)      \
+    RB_GENERATE_NFIND(name, type, field, cmp, static)     \
     RB_GENERATE_NEXT(name, type, field, static)           \
     RB_GENERATE_MINMAX(name, type, field, static)         \
     /* Add unused struct to allow adding a semicolon */   \
@@ -860,6 +888,13 @@ typedef struct lxw_col_options {
     uint8_t collapsed;
 } lxw_col_options;
 
+/* Struct to store the first and last column of the cells in a block of 16
+ * rows, used for the row "spans" attribute. */
+typedef struct lxw_block_span {
+    lxw_col_t col_min;
+    lxw_col_t col_max;
+} lxw_block_span;
+
 typedef struct lxw_merged_range {
     lxw_row_t first_row;
     lxw_row_t last_row;
@@ -2105,6 +2140,31 @@ typedef struct lxw_rich_string_tuple {
     const char *string;
 } lxw_rich_string_tuple;
 
+/* Pool of fixed size objects, such as cells and rows, allocated in slabs. */
+typedef struct lxw_object_pool {
+    size_t object_size;
+    size_t slab_objects;
+    size_t slab_used;
+    char *slab_data;
+    union lxw_pool_slab *slabs;
+    void *free_list;
+} lxw_object_pool;
+
+/* Row data deflated as it is written in constant_memory mode. */
+typedef struct lxw_deflated_rows {
+    FILE *file;
+    char *buffer;
+    size_t buffer_size;
+    void *stream;
+    uint64_t uncompressed_size;
+    unsigned long crc;
+    long offset;
+    uint8_t level;
+    uint8_t strategy;
+    uint8_t complete;
+    uint8_t error;
+} lxw_deflated_rows;
+
 /**
  * @brief Struct to represent an Excel worksheet.
  *
@@ -2118,6 +2178,20 @@ typedef struct lxw_worksheet {
     FILE *optimize_tmpfile;
     char *optimize_buffer;
     size_t optimize_buffer_size;
+    char *sheet_data_buffer;
+    size_t sheet_data_length;
+    lxw_row_t sheet_data_row_num;
+    lxw_col_t sheet_data_col_num;
+    uint8_t sheet_data_row_name_length;
+    uint8_t sheet_data_col_name_length;
+    char sheet_data_row_name[10];
+    char sheet_data_col_name[4];
+    lxw_object_pool cell_pool;
+    lxw_object_pool row_pool;
+    uint8_t compact_cells;
+    lxw_format **compact_formats;
+    uint32_t compact_formats_size;
+    lxw_deflated_rows *deflated_rows;
     struct lxw_table_rows *table;
     struct lxw_table_rows *hyperlinks;
     struct lxw_table_rows *comments;
@@ -2166,6 +2240,27 @@ typedef struct lxw_worksheet {
 
     uint8_t col_size_changed;
     uint8_t row_size_changed;
+    uint8_t col_offsets_valid;
+    uint8_t row_offsets_valid;
+
+    uint32_t *col_offsets;
+    lxw_col_t col_offsets_max;
+
+    lxw_row_t *row_offset_rows;
+    uint32_t *row_offset_sums;
+    lxw_row_t row_offsets_count;
+
+    lxw_block_span *block_spans;
+    uint32_t block_spans_max;
+    uint8_t block_spans_invalid;
+
+    /* Chart ranges captured as rows are written in constant_memory mode. */
+    lxw_chart_range_taps *chart_range_taps;
+    uint32_t chart_range_taps_seen;
+    lxw_series_range **row_taps;
+    uint32_t row_taps_count;
+    uint32_t row_taps_size;
+
     uint8_t optimize;
     struct lxw_row *optimize_row;
 
@@ -2312,6 +2407,7 @@ typedef struct lxw_worksheet_init_data {
     uint16_t index;
     uint8_t hidden;
     uint8_t optimize;
+    uint8_t compact_cells;
     uint16_t *active_sheet;
     uint16_t *first_sheet;
     lxw_sst *sst;
@@ -2321,6 +2417,10 @@ typedef struct lxw_worksheet_init_data {
     lxw_format *default_url_format;
     uint16_t max_url_length;
     uint8_t use_1904_epoch;
+    uint8_t deflate_rows;
+    uint8_t compression_level;
+    uint8_t compression_strategy;
+    lxw_chart_range_taps *chart_range_taps;
 
 } lxw_worksheet_init_data;
 
@@ -2337,6 +2437,9 @@ typedef struct lxw_row {
     uint8_t height_changed;
 
     struct lxw_table_cells *cells;
+    struct lxw_compact_cell *compact_cells;
+    lxw_col_t num_compact_cells;
+    lxw_col_t compact_cells_size;
 
     /* tree management pointers for tree.h. */
     RB_ENTRY (lxw_row) tree_pointers;
@@ -2359,12 +2462,40 @@ typedef struct lxw_cell {
     double formula_result;
     char *user_data1;
     char *user_data2;
-    char *sst_string;
+    struct sst_element *sst_element;
 
     /* List pointers for tree.h. */
     RB_ENTRY (lxw_cell) tree_pointers;
 } lxw_cell;
 
+/* Struct to represent a number, shared string, boolean, blank or error cell
+ * when the compact_cells workbook option is on. The format is stored as an
+ * index into the worksheet compact_formats table, with 0 for no format. */
+typedef struct lxw_compact_cell {
+    union {
+        double number;
+        struct sst_element *sst_element;
+    } u;
+
+    uint32_t format_id;
+    lxw_col_t col_num;
+    uint8_t type;
+} lxw_compact_cell;
+
+/* Struct to iterate over the stored cells of a worksheet range, in row and
+ * then column order, without searching the trees for each cell. */
+typedef struct lxw_range_iterator {
+    lxw_worksheet *worksheet;
+    lxw_row_t last_row;
+    lxw_col_t first_col;
+    lxw_col_t last_col;
+
+    lxw_row *row;
+    lxw_cell *cell;
+    lxw_col_t compact_index;
+    lxw_cell compact_cell;
+} lxw_range_iterator;
+
 /* Struct to represent a drawing Target/ID pair. */
 typedef struct lxw_drawing_rel_id {
     uint32_t id;
@@ -2476,6 +2607,167 @@ lxw_error worksheet_write_string(lxw_worksheet *worksheet,
                                  lxw_row_t row,
                                  lxw_col_t col, const char *string,
                                  lxw_format *format);
+
+/**
+ * @brief Write a string of known length to a worksheet cell.
+ *
+ * @param worksheet Pointer to a lxw_worksheet instance to be updated.
+ * @param row       The zero indexed row number.
+ * @param col       The zero indexed column number.
+ * @param string    String to write to cell.
+ * @param length    The length of the string in bytes.
+ * @param format    A pointer to a Format instance or NULL.
+ * @param flags     A combination of #lxw_string_flags.
+ *
+ * @return A #lxw_error code.
+ *
+ * The `%worksheet_write_string_len()` function is a version of
+ * `worksheet_write_string()` for strings whose length is already known. The
+ * string doesn't have to be null terminated, unless the `LXW_STRING_STATIC`
+ * flag is used, and it shouldn't contain null bytes:
+ *
+ * @code
+ *     const char *record = "Alice,Bob";
+ *
+ *     worksheet_write_string_len(worksheet, 0, 0, record,     5, NULL,
+ *                                LXW_STRING_DEFAULT);
+ *     worksheet_write_string_len(worksheet, 0, 1, record + 6, 3, NULL,
+ *                                LXW_STRING_DEFAULT);
+ * @endcode
+ *
+ * The `flags` parameter can be used to avoid work that the library would
+ * otherwise do for each string:
+ *
+ * - `LXW_STRING_VALIDATED`: the string is valid UTF-8 without control
+ *   characters and isn't scanned for characters that need to be escaped.
+ *
+ * - `LXW_STRING_STATIC`: the string is null terminated at `length` and
+ *   isn't copied. The caller must keep it unchanged until it is written to
+ *   the file, which is in `workbook_close()` or, in `constant_memory` mode,
+ *   when a later row is written.
+ *
+ * Passing a string with control characters as `LXW_STRING_VALIDATED`, or
+ * freeing a `LXW_STRING_STATIC` string too early, will produce an invalid
+ * file or undefined behavior.
+ */
+lxw_error worksheet_write_string_len(lxw_worksheet *worksheet,
+                                     lxw_row_t row,
+                                     lxw_col_t col, const char *string,
+                                     size_t length, lxw_format *format,
+                                     uint8_t flags);
+
+/**
+ * @brief Write an array of numbers to a worksheet row.
+ *
+ * @param worksheet  Pointer to a lxw_worksheet instance to be updated.
+ * @param row        The zero indexed row number.
+ * @param first_col  The zero indexed column number of the first cell.
+ * @param numbers    The array of numbers to write.
+ * @param num_values The number of values in the array.
+ * @param format     A pointer to a Format instance or NULL.
+ *
+ * @return A #lxw_error code.
+ *
+ * The `%worksheet_write_row_numbers()` function writes an array of numbers
+ * to consecutive cells in a row, starting at `first_col`. It is equivalent to
+ * calling `worksheet_write_number()` for each value but the range is
+ * validated and the row is looked up once, which is faster for long rows:
+ *
+ * @code
+ *     double data[] = {1.5, 2.5, 3.5, 4.5};
+ *
+ *     worksheet_write_row_numbers(worksheet, 0, 0, data, 4, NULL);
+ * @endcode
+ *
+ * The `format` is applied to all of the cells. If the cells don't fit in the
+ * worksheet then nothing is written and
+ * #LXW_ERROR_WORKSHEET_INDEX_OUT_OF_RANGE is returned.
+ */
+lxw_error worksheet_write_row_numbers(lxw_worksheet *worksheet,
+                                      lxw_row_t row,
+                                      lxw_col_t first_col,
+                                      const double *numbers,
+                                      lxw_col_t num_values,
+                                      lxw_format *format);
+
+/**
+ * @brief Write an array of numbers to a worksheet column.
+ *
+ * @param worksheet  Pointer to a lxw_worksheet instance to be updated.
+ * @param first_row  The zero indexed row number of the first cell.
+ * @param col        The zero indexed column number.
+ * @param numbers    The array of numbers to write.
+ * @param num_values The number of values in the array.
+ * @param format     A pointer to a Format instance or NULL.
+ *
+ * @return A #lxw_error code.
+ *
+ * The `%worksheet_write_column_numbers()` function writes an array of
+ * numbers to consecutive cells in a column, starting at `first_row`:
+ *
+ * @code
+ *     double data[] = {1.5, 2.5, 3.5, 4.5};
+ *
+ *     worksheet_write_column_numbers(worksheet, 0, 0, data, 4, NULL);
+ * @endcode
+ *
+ * See `worksheet_write_row_numbers()` for more details.
+ */
+lxw_error worksheet_write_column_numbers(lxw_worksheet *worksheet,
+                                         lxw_row_t first_row,
+                                         lxw_col_t col,
+                                         const double *numbers,
+                                         lxw_row_t num_values,
+                                         lxw_format *format);
+
+/**
+ * @brief Write a 2D array of numbers or strings to a worksheet range.
+ *
+ * @param worksheet Pointer to a lxw_worksheet instance to be updated.
+ * @param first_row The zero indexed row number of the first cell.
+ * @param first_col The zero indexed column number of the first cell.
+ * @param num_rows  The number of rows in the array.
+ * @param num_cols  The number of columns in the array.
+ * @param type      The data type of the array, see #lxw_array_types.
+ * @param data      The array data, in row order.
+ * @param formats   An array of `num_cols` column formats or NULL.
+ *
+ * @return A #lxw_error code.
+ *
+ * The `%worksheet_write_array()` function writes a 2D array of data to a
+ * range of cells. The data is a contiguous array of `num_rows * num_cols`
+ * values in row order. For #LXW_ARRAY_NUMBER it is an array of `double` and
+ * for #LXW_ARRAY_STRING an array of `const char *`:
+ *
+ * @code
+ *     double numbers[2][3] = {{1, 2, 3}, {4, 5, 6}};
+ *     const char *strings[2][2] = {{"Apple", "Pear"}, {"Plum", NULL}};
+ *     lxw_format *formats[2] = {bold, NULL};
+ *
+ *     worksheet_write_array(worksheet, 0, 0, 2, 3, LXW_ARRAY_NUMBER,
+ *                           numbers, NULL);
+ *
+ *     worksheet_write_array(worksheet, 3, 0, 2, 2, LXW_ARRAY_STRING,
+ *                           strings, formats);
+ * @endcode
+ *
+ * The optional `formats` array holds a format, or NULL, for each column of
+ * the data. As with `worksheet_write_string()`, NULL or empty strings are
+ * ignored unless they have a format, in which case a blank cell is written.
+ *
+ * If the range doesn't fit in the worksheet then nothing is written and
+ * #LXW_ERROR_WORKSHEET_INDEX_OUT_OF_RANGE is returned. If a string can't be
+ * written, for example because it is too long, the cells before it are
+ * written and the error is returned.
+ */
+lxw_error worksheet_write_array(lxw_worksheet *worksheet,
+                                lxw_row_t first_row,
+                                lxw_col_t first_col,
+                                lxw_row_t num_rows,
+                                lxw_col_t num_cols,
+                                uint8_t type, const void *data,
+                                lxw_format **formats);
+
 /**
  * @brief Write a formula to a worksheet cell.
  *
@@ -5940,7 +6232,18 @@ void lxw_worksheet_prepare_tables(lxw_worksheet *worksheet,
                                   uint32_t table_id);
 
 lxw_row *lxw_worksheet_find_row(lxw_worksheet *worksheet, lxw_row_t row_num);
-lxw_cell *lxw_worksheet_find_cell_in_row(lxw_row *row, lxw_col_t col_num);
+lxw_cell *lxw_worksheet_find_cell_in_row(lxw_worksheet *worksheet,
+                                         lxw_row *row, lxw_col_t col_num,
+                                         lxw_cell *compact_cell);
+void lxw_worksheet_range_iterator_init(lxw_range_iterator *iterator,
+                                       lxw_worksheet *worksheet,
+                                       lxw_row_t first_row,
+                                       lxw_col_t first_col,
+                                       lxw_row_t last_row,
+                                       lxw_col_t last_col);
+lxw_cell *lxw_worksheet_range_iterator_next(lxw_range_iterator *iterator);
+lxw_error lxw_worksheet_cache_chart_cell(lxw_series_range *range,
+                                         uint32_t index, lxw_cell *cell);
 /*
  * External functions to call intern XML functions shared with chartsheet.
  */
@@ -5971,8 +6274,17 @@ STATIC void _worksheet_write_page_margins(lxw_worksheet *worksheet);
 STATIC void _worksheet_write_page_setup(lxw_worksheet *worksheet);
 STATIC void _worksheet_write_col_info(lxw_worksheet *worksheet,
                                       lxw_col_options *options);
+STATIC int32_t _worksheet_size_col(lxw_worksheet *self, lxw_col_t col_num,
+                                   uint8_t anchor);
+STATIC int32_t _worksheet_size_row(lxw_worksheet *self, lxw_row_t row_num,
+                                   uint8_t anchor);
+STATIC uint32_t _worksheet_col_offset(lxw_worksheet *self,
+                                      lxw_col_t col_num);
+STATIC uint32_t _worksheet_row_offset(lxw_worksheet *self,
+                                      lxw_row_t row_num);
 STATIC void _write_row(lxw_worksheet *worksheet, lxw_row *row, char *spans);
-STATIC lxw_row *_get_row_list(struct lxw_table_rows *table,
+STATIC lxw_row *_get_row_list(lxw_worksheet *worksheet,
+                              struct lxw_table_rows *table,
                               lxw_row_t row_num);
 
 STATIC void _worksheet_write_merge_cell(lxw_worksheet *worksheet,
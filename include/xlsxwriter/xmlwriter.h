@@ -34,6 +34,10 @@
         dst[LXW_MAX_ATTRIBUTE_LENGTH - 1] = '\0';       \
     } while (0)
 
+/* Size of the attribute storage in an xml_attribute_list, and of the heap
+ * blocks added if an element's attributes don't fit in it. */
+#define LXW_ATTRIBUTE_BUFFER_SIZE 1024
+
 
  /* *INDENT-OFF* */
 #ifdef __cplusplus
@@ -41,58 +45,87 @@ extern "C" {
 #endif
 /* *INDENT-ON* */
 
-/* Attribute used in XML elements. */
+/* Attribute used in XML elements. The key and value strings are stored
+ * after the struct in the attribute list's storage. */
 struct xml_attribute {
-    char key[LXW_MAX_ATTRIBUTE_LENGTH];
-    char value[LXW_MAX_ATTRIBUTE_LENGTH];
+    char *key;
+    char *value;
 
     /* Make the struct a queue.h list element. */
     STAILQ_ENTRY (xml_attribute) list_entries;
 };
 
-/* Use queue.h macros to define the xml_attribute_list type. */
-STAILQ_HEAD(xml_attribute_list, xml_attribute);
+/* Heap block used for attributes that don't fit in the list's buffer. */
+struct xml_attribute_block {
+    struct xml_attribute_block *next;
+    size_t size;
+};
+
+/* A list of attributes, usually a local variable, that also holds the
+ * storage for the attributes so that they don't need to be allocated
+ * individually. The first two members match STAILQ_HEAD() so that the
+ * queue.h macros can be used with the list. */
+struct xml_attribute_list {
+    struct xml_attribute *stqh_first;
+    struct xml_attribute **stqh_last;
+
+    char *buffer;
+    size_t used;
+    size_t size;
+    struct xml_attribute_block *blocks;
+
+    union {
+        char data[LXW_ATTRIBUTE_BUFFER_SIZE];
+        void *align;
+    } storage;
+};
+
+/* Initialize or free the storage of a xml_attribute_list. */
+void lxw_init_attributes(struct xml_attribute_list *attributes);
+void lxw_free_attributes(struct xml_attribute_list *attributes);
 
-/* Create a new attribute struct to add to a xml_attribute_list. */
-struct xml_attribute *lxw_new_attribute_str(const char *key,
+/* Create a new attribute struct in the storage of a xml_attribute_list. */
+struct xml_attribute *lxw_new_attribute_str(struct xml_attribute_list
+                                            *attributes, const char *key,
                                             const char *value);
-struct xml_attribute *lxw_new_attribute_int(const char *key, int32_t value);
-struct xml_attribute *lxw_new_attribute_dbl(const char *key, double value);
+struct xml_attribute *lxw_new_attribute_int(struct xml_attribute_list
+                                            *attributes, const char *key,
+                                            int32_t value);
+struct xml_attribute *lxw_new_attribute_dbl(struct xml_attribute_list
+                                            *attributes, const char *key,
+                                            double value);
 
 /* Macro to initialize the xml_attribute_list pointers. */
 #define LXW_INIT_ATTRIBUTES()                                 \
-    STAILQ_INIT(&attributes)
+    lxw_init_attributes(&attributes)
 
 /* Macro to add attribute string elements to xml_attribute_list. */
-#define LXW_PUSH_ATTRIBUTES_STR(key, value)                   \
-    do {                                                      \
-    attribute = lxw_new_attribute_str((key), (value));        \
-    STAILQ_INSERT_TAIL(&attributes, attribute, list_entries); \
+#define LXW_PUSH_ATTRIBUTES_STR(key, value)                                \
+    do {                                                                   \
+    attribute = lxw_new_attribute_str(&attributes, (key), (value));        \
+    if (attribute)                                                         \
+        STAILQ_INSERT_TAIL(&attributes, attribute, list_entries);          \
     } while (0)
 
 /* Macro to add attribute int values to xml_attribute_list. */
-#define LXW_PUSH_ATTRIBUTES_INT(key, value)                   \
-    do {                                                      \
-    attribute = lxw_new_attribute_int((key), (value));        \
-    STAILQ_INSERT_TAIL(&attributes, attribute, list_entries); \
+#define LXW_PUSH_ATTRIBUTES_INT(key, value)                                \
+    do {                                                                   \
+    attribute = lxw_new_attribute_int(&attributes, (key), (value));        \
+    if (attribute)                                                         \
+        STAILQ_INSERT_TAIL(&attributes, attribute, list_entries);          \
     } while (0)
 
 /* Macro to add attribute double values to xml_attribute_list. */
-#define LXW_PUSH_ATTRIBUTES_DBL(key, value)                   \
-    do {                                                      \
-    attribute = lxw_new_attribute_dbl((key), (value));        \
-    STAILQ_INSERT_TAIL(&attributes, attribute, list_entries); \
+#define LXW_PUSH_ATTRIBUTES_DBL(key, value)                                \
+    do {                                                                   \
+    attribute = lxw_new_attribute_dbl(&attributes, (key), (value));        \
+    if (attribute)                                                         \
+        STAILQ_INSERT_TAIL(&attributes, attribute, list_entries);          \
     } while (0)
 
-/* Macro to free xml_attribute_list and attribute. */
+/* Macro to free the xml_attribute_list storage. The list can be reused. */
 #define LXW_FREE_ATTRIBUTES()                                 \
-    do {                                                      \
-        while (!STAILQ_EMPTY(&attributes)) {                  \
-            attribute = STAILQ_FIRST(&attributes);            \
-            STAILQ_REMOVE_HEAD(&attributes, list_entries);    \
-            free(attribute);                                  \
-        }                                                     \
-    } while (0)
+    lxw_free_attributes(&attributes)
 
 /**
  * Create the XML declaration in an XML file.
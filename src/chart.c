@@ -33,21 +33,10 @@ STATIC uint8_t _chart_has_secondary_y_axis(lxw_chart *self);
 STATIC void
 _chart_free_range(lxw_series_range *range)
 {
-    struct lxw_series_data_point *data_point;
-
     if (!range)
         return;
 
-    if (range->data_cache) {
-        while (!STAILQ_EMPTY(range->data_cache)) {
-            data_point = STAILQ_FIRST(range->data_cache);
-            free(data_point->string);
-            STAILQ_REMOVE_HEAD(range->data_cache, list_pointers);
-
-            free(data_point);
-        }
-        free(range->data_cache);
-    }
+    lxw_chart_free_data_cache(range);
 
     free(range->formula);
     free(range->sheetname);
@@ -177,17 +166,15 @@ _chart_series_free(lxw_chart_series *series)
 }
 
 /*
- * Initialize the data cache in a range object.
+ * Check if a point in a range data cache has data.
  */
-STATIC lxw_error
-_chart_init_data_cache(lxw_series_range *range)
+STATIC uint8_t
+_chart_cache_has_data(lxw_series_range *range, uint32_t index)
 {
-    /* Initialize the series range data cache. */
-    range->data_cache = calloc(1, sizeof(struct lxw_series_data_points));
-    RETURN_ON_MEM_ERROR(range->data_cache, LXW_ERROR_MEMORY_MALLOC_FAILED);
-    STAILQ_INIT(range->data_cache);
+    if (!range->no_data_cache)
+        return LXW_TRUE;
 
-    return LXW_NO_ERROR;
+    return !(range->no_data_cache[index >> 3] & (1 << (index & 7)));
 }
 
 /*
@@ -287,19 +274,6 @@ lxw_chart_new(uint8_t type)
     chart->y2_axis->title.range = calloc(1, sizeof(lxw_series_range));
     GOTO_LABEL_ON_MEM_ERROR(chart->y2_axis->title.range, mem_error);
 
-    /* Initialize the ranges in the chart titles. */
-    if (_chart_init_data_cache(chart->title.range) != LXW_NO_ERROR)
-        goto mem_error;
-
-    if (_chart_init_data_cache(chart->x_axis->title.range) != LXW_NO_ERROR)
-        goto mem_error;
-
-    if (_chart_init_data_cache(chart->y_axis->title.range) != LXW_NO_ERROR)
-        goto mem_error;
-
-    if (_chart_init_data_cache(chart->y2_axis->title.range) != LXW_NO_ERROR)
-        goto mem_error;
-
     chart->type = type;
     chart->style_id = 2;
     chart->hole_size = 50;
@@ -598,6 +572,7 @@ _chart_set_range(lxw_series_range *range, const char *sheetname,
     char formula[LXW_MAX_FORMULA_RANGE_LENGTH] = { 0 };
 
     /* Set the range properties. */
+    free(range->sheetname);
     range->sheetname = lxw_strdup(sheetname);
     range->first_row = first_row;
     range->first_col = first_col;
@@ -614,6 +589,82 @@ _chart_set_range(lxw_series_range *range, const char *sheetname,
     range->formula = lxw_strdup(formula);
 }
 
+/*
+ * Add a series range to the ranges captured by the worksheets as rows are
+ * written in constant_memory mode. The list only exists in that mode.
+ */
+STATIC void
+_chart_add_range_tap(lxw_chart_range_taps *range_taps,
+                     lxw_series_range *range)
+{
+    lxw_series_range **ranges;
+    uint32_t new_size;
+
+    if (!range_taps)
+        return;
+
+    /* Drop any data captured for a previous range. */
+    lxw_chart_free_data_cache(range);
+    range->has_row_tap = LXW_FALSE;
+
+    if (!range->sheetname && lxw_chart_parse_range_formula(range))
+        return;
+
+    if (range_taps->count == range_taps->size) {
+        new_size = range_taps->size ? range_taps->size * 2 : 16;
+        ranges = realloc(range_taps->ranges,
+                         new_size * sizeof(lxw_series_range *));
+        if (!ranges)
+            return;
+
+        range_taps->ranges = ranges;
+        range_taps->size = new_size;
+    }
+
+    range_taps->ranges[range_taps->count++] = range;
+}
+
+/*
+ * Utility function to set a chart range from an array of numbers. The data is
+ * stored in the range cache and the range is pointed at a hidden data
+ * worksheet when the workbook is closed.
+ */
+STATIC lxw_error
+_chart_set_range_array(lxw_series_range *range, const double *data,
+                       uint32_t num_data_points, const char *function_name)
+{
+    lxw_error err;
+
+    if (!data) {
+        LXW_WARN_FORMAT1("%s(): data array must be specified",
+                         function_name);
+        return LXW_ERROR_NULL_PARAMETER_IGNORED;
+    }
+
+    if (num_data_points == 0 || num_data_points > LXW_CHART_ARRAY_MAX) {
+        LXW_WARN_FORMAT2("%s(): number of data points must be in the "
+                         "range 1 to %d", function_name, LXW_CHART_ARRAY_MAX);
+        return LXW_ERROR_PARAMETER_VALIDATION;
+    }
+
+    err = lxw_chart_init_data_cache(range, num_data_points);
+    if (err)
+        return err;
+
+    memcpy(range->data_cache, data, num_data_points * sizeof(double));
+
+    free(range->formula);
+    free(range->sheetname);
+    range->formula = NULL;
+    range->sheetname = NULL;
+    range->has_string_cache = LXW_FALSE;
+    range->ignore_cache = LXW_FALSE;
+    range->has_array_data = LXW_TRUE;
+    range->has_row_tap = LXW_FALSE;
+
+    return LXW_NO_ERROR;
+}
+
 /*****************************************************************************
  *
  * XML functions.
@@ -1362,7 +1413,7 @@ _chart_write_a_body_pr(lxw_chart *self, int32_t rotation,
  * Write the <c:ptCount> element.
  */
 STATIC void
-_chart_write_pt_count(lxw_chart *self, uint16_t num_data_points)
+_chart_write_pt_count(lxw_chart *self, uint32_t num_data_points)
 {
     struct xml_attribute_list attributes;
     struct xml_attribute *attribute;
@@ -1410,14 +1461,13 @@ _chart_write_f(lxw_chart *self, char *formula)
  * Write the <c:pt> element.
  */
 STATIC void
-_chart_write_pt(lxw_chart *self, uint16_t index,
-                lxw_series_data_point *data_point)
+_chart_write_pt(lxw_chart *self, uint32_t index, lxw_series_range *range)
 {
     struct xml_attribute_list attributes;
     struct xml_attribute *attribute;
 
     /* Ignore chart points that have no data. */
-    if (data_point->no_data)
+    if (!_chart_cache_has_data(range, index))
         return;
 
     LXW_INIT_ATTRIBUTES();
@@ -1425,10 +1475,10 @@ _chart_write_pt(lxw_chart *self, uint16_t index,
 
     lxw_xml_start_tag(self->file, "c:pt", &attributes);
 
-    if (data_point->is_string && data_point->string)
-        _chart_write_v_str(self, data_point->string);
+    if (range->string_cache && range->string_cache[index])
+        _chart_write_v_str(self, range->string_cache[index]);
     else
-        _chart_write_v_num(self, data_point->number);
+        _chart_write_v_num(self, range->data_cache[index]);
 
     lxw_xml_end_tag(self->file, "c:pt");
 
@@ -1439,14 +1489,13 @@ _chart_write_pt(lxw_chart *self, uint16_t index,
  * Write the <c:pt> element.
  */
 STATIC void
-_chart_write_num_pt(lxw_chart *self, uint16_t index,
-                    lxw_series_data_point *data_point)
+_chart_write_num_pt(lxw_chart *self, uint32_t index, lxw_series_range *range)
 {
     struct xml_attribute_list attributes;
     struct xml_attribute *attribute;
 
     /* Ignore chart points that have no data. */
-    if (data_point->no_data)
+    if (!_chart_cache_has_data(range, index))
         return;
 
     LXW_INIT_ATTRIBUTES();
@@ -1454,7 +1503,7 @@ _chart_write_num_pt(lxw_chart *self, uint16_t index,
 
     lxw_xml_start_tag(self->file, "c:pt", &attributes);
 
-    _chart_write_v_num(self, data_point->number);
+    _chart_write_v_num(self, range->data_cache[index]);
 
     lxw_xml_end_tag(self->file, "c:pt");
 
@@ -1476,8 +1525,7 @@ _chart_write_format_code(lxw_chart *self)
 STATIC void
 _chart_write_num_cache(lxw_chart *self, lxw_series_range *range)
 {
-    lxw_series_data_point *data_point;
-    uint16_t index = 0;
+    uint32_t index;
 
     lxw_xml_start_tag(self->file, "c:numCache", NULL);
 
@@ -1487,10 +1535,9 @@ _chart_write_num_cache(lxw_chart *self, lxw_series_range *range)
     /* Write the c:ptCount element. */
     _chart_write_pt_count(self, range->num_data_points);
 
-    STAILQ_FOREACH(data_point, range->data_cache, list_pointers) {
+    for (index = 0; index < range->num_data_points; index++) {
         /* Write the c:pt element. */
-        _chart_write_num_pt(self, index, data_point);
-        index++;
+        _chart_write_num_pt(self, index, range);
     }
 
     lxw_xml_end_tag(self->file, "c:numCache");
@@ -1502,18 +1549,16 @@ _chart_write_num_cache(lxw_chart *self, lxw_series_range *range)
 STATIC void
 _chart_write_str_cache(lxw_chart *self, lxw_series_range *range)
 {
-    lxw_series_data_point *data_point;
-    uint16_t index = 0;
+    uint32_t index;
 
     lxw_xml_start_tag(self->file, "c:strCache", NULL);
 
     /* Write the c:ptCount element. */
     _chart_write_pt_count(self, range->num_data_points);
 
-    STAILQ_FOREACH(data_point, range->data_cache, list_pointers) {
+    for (index = 0; index < range->num_data_points; index++) {
         /* Write the c:pt element. */
-        _chart_write_pt(self, index, data_point);
-        index++;
+        _chart_write_pt(self, index, range);
     }
 
     lxw_xml_end_tag(self->file, "c:strCache");
@@ -1530,7 +1575,7 @@ _chart_write_num_ref(lxw_chart *self, lxw_series_range *range)
     /* Write the c:f element. */
     _chart_write_f(self, range->formula);
 
-    if (!STAILQ_EMPTY(range->data_cache)) {
+    if (range->num_data_points) {
         /* Write the c:numCache element. */
         _chart_write_num_cache(self, range);
     }
@@ -1549,7 +1594,7 @@ _chart_write_str_ref(lxw_chart *self, lxw_series_range *range)
     /* Write the c:f element. */
     _chart_write_f(self, range->formula);
 
-    if (!STAILQ_EMPTY(range->data_cache)) {
+    if (range->num_data_points) {
         /* Write the c:strCache element. */
         _chart_write_str_cache(self, range);
     }
@@ -5862,6 +5907,263 @@ lxw_chart_assemble_xml_file(lxw_chart *self)
  *
  ****************************************************************************/
 
+/*
+ * Allocate the data cache of a range object for a number of points. The
+ * numbers are initialized to zero.
+ */
+lxw_error
+lxw_chart_init_data_cache(lxw_series_range *range, uint32_t num_data_points)
+{
+    lxw_chart_free_data_cache(range);
+
+    if (!num_data_points)
+        return LXW_NO_ERROR;
+
+    range->data_cache = calloc(num_data_points, sizeof(double));
+    RETURN_ON_MEM_ERROR(range->data_cache, LXW_ERROR_MEMORY_MALLOC_FAILED);
+
+    range->num_data_points = num_data_points;
+
+    return LXW_NO_ERROR;
+}
+
+/*
+ * Allocate the data cache of a range object with all of the points marked as
+ * having no data. This is used when the data is captured as rows are written.
+ */
+lxw_error
+lxw_chart_init_empty_data_cache(lxw_series_range *range,
+                                uint32_t num_data_points)
+{
+    lxw_error err = lxw_chart_init_data_cache(range, num_data_points);
+
+    if (err || !num_data_points)
+        return err;
+
+    range->no_data_cache = malloc((num_data_points + 7) / 8);
+    RETURN_ON_MEM_ERROR(range->no_data_cache, LXW_ERROR_MEMORY_MALLOC_FAILED);
+
+    memset(range->no_data_cache, 0xFF, (num_data_points + 7) / 8);
+
+    return LXW_NO_ERROR;
+}
+
+/*
+ * Store a copy of a string for a point in a range data cache. The string
+ * array is allocated for the first string in the range.
+ */
+lxw_error
+lxw_chart_set_cache_string(lxw_series_range *range, uint32_t index,
+                           const char *string)
+{
+    if (!range->string_cache) {
+        range->string_cache = calloc(range->num_data_points, sizeof(char *));
+        RETURN_ON_MEM_ERROR(range->string_cache,
+                            LXW_ERROR_MEMORY_MALLOC_FAILED);
+    }
+
+    free(range->string_cache[index]);
+    range->string_cache[index] = lxw_strdup(string);
+    RETURN_ON_MEM_ERROR(range->string_cache[index],
+                        LXW_ERROR_MEMORY_MALLOC_FAILED);
+
+    range->has_string_cache = LXW_TRUE;
+
+    if (range->no_data_cache)
+        range->no_data_cache[index >> 3] &= ~(1 << (index & 7));
+
+    return LXW_NO_ERROR;
+}
+
+/*
+ * Store a number for a point in a range data cache.
+ */
+void
+lxw_chart_set_cache_number(lxw_series_range *range, uint32_t index,
+                           double number)
+{
+    range->data_cache[index] = number;
+
+    if (range->no_data_cache)
+        range->no_data_cache[index >> 3] &= ~(1 << (index & 7));
+}
+
+/*
+ * Mark a point in a range data cache as having no data. The bitmap is
+ * allocated for the first empty point in the range.
+ */
+lxw_error
+lxw_chart_set_cache_no_data(lxw_series_range *range, uint32_t index)
+{
+    if (!range->no_data_cache) {
+        range->no_data_cache = calloc((range->num_data_points + 7) / 8, 1);
+        RETURN_ON_MEM_ERROR(range->no_data_cache,
+                            LXW_ERROR_MEMORY_MALLOC_FAILED);
+    }
+
+    range->no_data_cache[index >> 3] |= 1 << (index & 7);
+
+    return LXW_NO_ERROR;
+}
+
+/*
+ * Set the worksheet range of a range object. This is used by the workbook to
+ * point ranges set from arrays at the hidden data worksheet.
+ */
+void
+lxw_chart_set_range(lxw_series_range *range, const char *sheetname,
+                    lxw_row_t first_row, lxw_col_t first_col,
+                    lxw_row_t last_row, lxw_col_t last_col)
+{
+    _chart_set_range(range, sheetname, first_row, first_col, last_row,
+                     last_col);
+}
+
+/*
+ * Copy the data cache of a range object to another range with the same data.
+ */
+lxw_error
+lxw_chart_copy_data_cache(lxw_series_range *range, lxw_series_range *source)
+{
+    uint32_t num_data_points = source->num_data_points;
+    uint32_t i;
+    lxw_error err;
+
+    err = lxw_chart_init_data_cache(range, num_data_points);
+    if (err)
+        return err;
+
+    if (!num_data_points)
+        return LXW_NO_ERROR;
+
+    memcpy(range->data_cache, source->data_cache,
+           num_data_points * sizeof(double));
+
+    if (source->no_data_cache) {
+        range->no_data_cache = malloc((num_data_points + 7) / 8);
+        GOTO_LABEL_ON_MEM_ERROR(range->no_data_cache, mem_error);
+
+        memcpy(range->no_data_cache, source->no_data_cache,
+               (num_data_points + 7) / 8);
+    }
+
+    if (source->string_cache) {
+        for (i = 0; i < num_data_points; i++) {
+            if (!source->string_cache[i])
+                continue;
+
+            err = lxw_chart_set_cache_string(range, i,
+                                             source->string_cache[i]);
+            if (err)
+                goto mem_error;
+        }
+    }
+
+    range->has_string_cache = source->has_string_cache;
+
+    return LXW_NO_ERROR;
+
+mem_error:
+    lxw_chart_free_data_cache(range);
+    return LXW_ERROR_MEMORY_MALLOC_FAILED;
+}
+
+/*
+ * Set the sheetname and row/col dimensions of a range from a formula like
+ * Sheet1!$A$1:$A$5. Non-contiguous ranges aren't supported.
+ */
+lxw_error
+lxw_chart_parse_range_formula(lxw_series_range *range)
+{
+    char formula[LXW_MAX_FORMULA_RANGE_LENGTH] = { 0 };
+    char *tmp_str;
+    char *sheetname;
+
+    /* Ignore non-contiguous range like (Sheet1!$A$1:$A$2,Sheet1!$A$4:$A$5) */
+    if (!range->formula || range->formula[0] == '(')
+        return LXW_ERROR_PARAMETER_VALIDATION;
+
+    /* Create a copy of the formula to modify and parse into parts. */
+    lxw_snprintf(formula, LXW_MAX_FORMULA_RANGE_LENGTH, "%s", range->formula);
+
+    /* Check for valid formula. Note, This needs stronger validation. */
+    tmp_str = strchr(formula, '!');
+    if (tmp_str == NULL)
+        return LXW_ERROR_PARAMETER_VALIDATION;
+
+    /* Split the formulas into sheetname and row-col data. */
+    *tmp_str = '\0';
+    tmp_str++;
+    sheetname = formula;
+
+    if (lxw_str_is_empty(tmp_str) || lxw_str_is_empty(sheetname))
+        return LXW_ERROR_PARAMETER_VALIDATION;
+
+    /* Remove any worksheet quoting. */
+    if (sheetname[0] == '\'')
+        sheetname++;
+    if (strlen(sheetname) > 0 && sheetname[strlen(sheetname) - 1] == '\'') {
+        sheetname[strlen(sheetname) - 1] = '\0';
+    }
+
+    free(range->sheetname);
+    range->sheetname = lxw_strdup(sheetname);
+    RETURN_ON_MEM_ERROR(range->sheetname, LXW_ERROR_MEMORY_MALLOC_FAILED);
+
+    range->first_row = lxw_name_to_row(tmp_str);
+    range->first_col = lxw_name_to_col(tmp_str);
+
+    if (strchr(tmp_str, ':')) {
+        /* 2D range. */
+        range->last_row = lxw_name_to_row_2(tmp_str);
+        range->last_col = lxw_name_to_col_2(tmp_str);
+    }
+    else {
+        /* 1D range. */
+        range->last_row = range->first_row;
+        range->last_col = range->first_col;
+    }
+
+    return LXW_NO_ERROR;
+}
+
+/*
+ * Free the list of ranges captured in constant_memory mode. The ranges are
+ * owned by the chart series.
+ */
+void
+lxw_chart_range_taps_free(lxw_chart_range_taps *range_taps)
+{
+    free(range_taps->ranges);
+    range_taps->ranges = NULL;
+    range_taps->count = 0;
+    range_taps->size = 0;
+}
+
+/*
+ * Free the data cache of a range object.
+ */
+void
+lxw_chart_free_data_cache(lxw_series_range *range)
+{
+    uint32_t i;
+
+    if (range->string_cache) {
+        for (i = 0; i < range->num_data_points; i++)
+            free(range->string_cache[i]);
+
+        free(range->string_cache);
+    }
+
+    free(range->data_cache);
+    free(range->no_data_cache);
+
+    range->data_cache = NULL;
+    range->string_cache = NULL;
+    range->no_data_cache = NULL;
+    range->num_data_points = 0;
+}
+
 /*
  * Add data to a data cache in a range object, for testing only.
  */
@@ -5869,19 +6171,17 @@ lxw_error
 lxw_chart_add_data_cache(lxw_series_range *range, uint8_t *data,
                          uint16_t rows, uint8_t cols, uint8_t col)
 {
-    struct lxw_series_data_point *data_point;
     uint16_t i;
+    lxw_error err;
 
     range->ignore_cache = LXW_TRUE;
-    range->num_data_points = rows;
 
-    /* Initialize the series range data cache. */
-    for (i = 0; i < rows; i++) {
-        data_point = calloc(1, sizeof(struct lxw_series_data_point));
-        RETURN_ON_MEM_ERROR(data_point, LXW_ERROR_MEMORY_MALLOC_FAILED);
-        STAILQ_INSERT_TAIL(range->data_cache, data_point, list_pointers);
-        data_point->number = data[i * cols + col];
-    }
+    err = lxw_chart_init_data_cache(range, rows);
+    if (err)
+        return err;
+
+    for (i = 0; i < rows; i++)
+        range->data_cache[i] = data[i * cols + col];
 
     return LXW_NO_ERROR;
 }
@@ -5935,14 +6235,13 @@ chart_add_series(lxw_chart *self, const char *categories, const char *values)
             series->values->formula = lxw_strdup(values);
     }
 
-    if (_chart_init_data_cache(series->categories) != LXW_NO_ERROR)
-        goto mem_error;
+    series->range_taps = self->range_taps;
 
-    if (_chart_init_data_cache(series->values) != LXW_NO_ERROR)
-        goto mem_error;
+    if (series->categories->formula)
+        _chart_add_range_tap(series->range_taps, series->categories);
 
-    if (_chart_init_data_cache(series->title.range) != LXW_NO_ERROR)
-        goto mem_error;
+    if (series->values->formula)
+        _chart_add_range_tap(series->range_taps, series->values);
 
     if (self->type == LXW_CHART_SCATTER_SMOOTH)
         series->smooth = LXW_TRUE;
@@ -6062,8 +6361,12 @@ chart_series_set_categories(lxw_chart_series *series, const char *sheetname,
         return;
     }
 
+    series->categories->has_array_data = LXW_FALSE;
+
     _chart_set_range(series->categories, sheetname,
                      first_row, first_col, last_row, last_col);
+
+    _chart_add_range_tap(series->range_taps, series->categories);
 }
 
 /*
@@ -6079,8 +6382,36 @@ chart_series_set_values(lxw_chart_series *series, const char *sheetname,
         return;
     }
 
+    series->values->has_array_data = LXW_FALSE;
+
     _chart_set_range(series->values, sheetname,
                      first_row, first_col, last_row, last_col);
+
+    _chart_add_range_tap(series->range_taps, series->values);
+}
+
+/*
+ * Set the categories of a series from an array of numbers.
+ */
+lxw_error
+chart_series_set_categories_array(lxw_chart_series *series,
+                                  const double *categories,
+                                  uint32_t num_categories)
+{
+    return _chart_set_range_array(series->categories, categories,
+                                  num_categories,
+                                  "chart_series_set_categories_array");
+}
+
+/*
+ * Set the values of a series from an array of numbers.
+ */
+lxw_error
+chart_series_set_values_array(lxw_chart_series *series,
+                              const double *values, uint32_t num_values)
+{
+    return _chart_set_range_array(series->values, values, num_values,
+                                  "chart_series_set_values_array");
 }
 
 /*
@@ -6366,12 +6697,9 @@ chart_series_set_labels_custom(lxw_chart_series *series,
                 data_label->range = calloc(1, sizeof(lxw_series_range));
                 GOTO_LABEL_ON_MEM_ERROR(data_label->range, mem_error);
 
+                /* The range data cache allows the value to be looked up and
+                 * filled in when the file is closed. */
                 data_label->range->formula = lxw_strdup(src_value + 1);
-
-                /* Add the formula to the data cache to allow value to be looked
-                 * up and filled in when the file is closed. */
-                if (_chart_init_data_cache(data_label->range) != LXW_NO_ERROR)
-                    goto mem_error;
             }
             else {
                 /* The value is a simple string. */
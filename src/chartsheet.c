@@ -253,7 +253,8 @@ chartsheet_set_chart_opt(lxw_chartsheet *self,
 
     /* Check that the chart has a 'values' series. */
     STAILQ_FOREACH(series, chart->series_list, list_pointers) {
-        if (!series->values->formula && !series->values->sheetname) {
+        if (!series->values->formula && !series->values->sheetname
+            && !series->values->has_array_data) {
             LXW_WARN("chartsheet_set_chart()/_opt(): chart must have a "
                      "'values' series.");
 
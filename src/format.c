@@ -165,15 +165,12 @@ _check_valign(uint8_t align)
  ****************************************************************************/
 
 /*
- * Returns a format struct suitable for hashing as a lookup key. This is
+ * Fill in a format struct suitable for hashing as a lookup key. This is
  * mainly a memcpy with any pointer members set to NULL.
  */
-STATIC lxw_format *
-_get_format_key(lxw_format *self)
+STATIC void
+_set_format_key(lxw_format *key, lxw_format *self)
 {
-    lxw_format *key = calloc(1, sizeof(lxw_format));
-    GOTO_LABEL_ON_MEM_ERROR(key, mem_error);
-
     memcpy(key, self, sizeof(lxw_format));
 
     /* Set pointer members to NULL since they aren't part of the comparison. */
@@ -183,12 +180,64 @@ _get_format_key(lxw_format *self)
     key->num_dxf_formats = NULL;
     key->list_pointers.stqe_next = NULL;
 
-    return key;
+    /* The workbook format id isn't part of the comparison either. */
+    key->format_id = 0;
+}
 
-mem_error:
+/*
+ * Look up a format in a hash table of used formats. If there isn't an
+ * equivalent format it is added with a copy of the key, so that a key is
+ * only allocated once for each unique format. Returns the existing format or
+ * NULL if the format was added or on a memory error.
+ */
+STATIC lxw_format *
+_find_or_add_format(lxw_hash_table *formats_hash_table, lxw_format *self,
+                    uint8_t *added)
+{
+    lxw_format format_key;
+    lxw_format *key_copy;
+    lxw_hash_element *hash_element;
+
+    *added = LXW_FALSE;
+
+    _set_format_key(&format_key, self);
+
+    /* Look up the format in the hash table. */
+    hash_element = lxw_hash_key_exists(formats_hash_table, &format_key,
+                                       sizeof(lxw_format));
+    if (hash_element)
+        return hash_element->value;
+
+    /* New format requiring a key owned by the hash table. */
+    key_copy = malloc(sizeof(lxw_format));
+    RETURN_ON_MEM_ERROR(key_copy, NULL);
+
+    memcpy(key_copy, &format_key, sizeof(lxw_format));
+
+    if (!lxw_insert_hash_element(formats_hash_table, key_copy, self,
+                                 sizeof(lxw_format))) {
+        free(key_copy);
+        return NULL;
+    }
+
+    *added = LXW_TRUE;
     return NULL;
 }
 
+/*
+ * Fill in a format struct with only the user properties of a format, for
+ * use as the key of the workbook interned formats.
+ */
+void
+lxw_format_set_intern_key(lxw_format *key, lxw_format *self)
+{
+    _set_format_key(key, self);
+
+    /* The indices are set when the format is used in a cell. */
+    key->xf_index = LXW_PROPERTY_UNSET;
+    key->dxf_index = LXW_PROPERTY_UNSET;
+}
+
 /*
  * Returns a font struct suitable for hashing as a lookup key.
  */
@@ -272,11 +321,10 @@ mem_error:
 int32_t
 lxw_format_get_xf_index(lxw_format *self)
 {
-    lxw_format *format_key;
     lxw_format *existing_format;
-    lxw_hash_element *hash_element;
     lxw_hash_table *formats_hash_table = self->xf_format_indices;
     int32_t index;
+    uint8_t added;
 
     /* Note: The formats_hash_table/xf_format_indices contains the unique and
      * more importantly the *used* formats in the workbook.
@@ -288,33 +336,24 @@ lxw_format_get_xf_index(lxw_format *self)
     }
 
     /* Otherwise, the format doesn't have an index number so we assign one.
-     * First generate a unique key to identify the format in the hash table.
+     * First look for an equivalent format in the hash table.
      */
-    format_key = _get_format_key(self);
+    index = formats_hash_table->unique_count;
+    existing_format = _find_or_add_format(formats_hash_table, self, &added);
 
-    /* Return the default format index if the key generation failed. */
-    if (!format_key)
-        return 0;
-
-    /* Look up the format in the hash table. */
-    hash_element =
-        lxw_hash_key_exists(formats_hash_table, format_key,
-                            sizeof(lxw_format));
-
-    if (hash_element) {
+    if (existing_format) {
         /* Format matches existing format with an index. */
-        free(format_key);
-        existing_format = hash_element->value;
         return existing_format->xf_index;
     }
-    else {
+    else if (added) {
         /* New format requiring an index. */
-        index = formats_hash_table->unique_count;
         self->xf_index = index;
-        lxw_insert_hash_element(formats_hash_table, format_key, self,
-                                sizeof(lxw_format));
         return index;
     }
+    else {
+        /* Return the default format index if the key generation failed. */
+        return 0;
+    }
 }
 
 /*
@@ -323,11 +362,10 @@ lxw_format_get_xf_index(lxw_format *self)
 int32_t
 lxw_format_get_dxf_index(lxw_format *self)
 {
-    lxw_format *format_key;
     lxw_format *existing_format;
-    lxw_hash_element *hash_element;
     lxw_hash_table *formats_hash_table = self->dxf_format_indices;
     int32_t index;
+    uint8_t added;
 
     /* Note: The formats_hash_table/dxf_format_indices contains the unique and
      * more importantly the *used* formats in the workbook.
@@ -339,33 +377,24 @@ lxw_format_get_dxf_index(lxw_format *self)
     }
 
     /* Otherwise, the format doesn't have an index number so we assign one.
-     * First generate a unique key to identify the format in the hash table.
+     * First look for an equivalent format in the hash table.
      */
-    format_key = _get_format_key(self);
+    index = formats_hash_table->unique_count;
+    existing_format = _find_or_add_format(formats_hash_table, self, &added);
 
-    /* Return the default format index if the key generation failed. */
-    if (!format_key)
-        return 0;
-
-    /* Look up the format in the hash table. */
-    hash_element =
-        lxw_hash_key_exists(formats_hash_table, format_key,
-                            sizeof(lxw_format));
-
-    if (hash_element) {
+    if (existing_format) {
         /* Format matches existing format with an index. */
-        free(format_key);
-        existing_format = hash_element->value;
         return existing_format->dxf_index;
     }
-    else {
+    else if (added) {
         /* New format requiring an index. */
-        index = formats_hash_table->unique_count;
         self->dxf_index = index;
-        lxw_insert_hash_element(formats_hash_table, format_key, self,
-                                sizeof(lxw_format));
         return index;
     }
+    else {
+        /* Return the default format index if the key generation failed. */
+        return 0;
+    }
 }
 
 /*
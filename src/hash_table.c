@@ -14,151 +14,170 @@
 #include <stdint.h>
 #include "xlsxwriter/hash_table.h"
 
+/* The minimum number of hash table slots. Must be a power of 2. */
+#define LXW_HASH_MIN_SLOTS 8
+
+/* The 64-bit golden ratio multiplier, built from 32-bit halves since C89
+ * doesn't have 64-bit integer constants. */
+#define LXW_HASH_MULTIPLIER \
+    (((uint64_t) 0x9E3779B9UL << 32) | (uint64_t) 0x7F4A7C15UL)
+
 /*
- * Calculate the hash key using the FNV function. See:
- * http://en.wikipedia.org/wiki/Fowler-Noll-Vo_hash_function
+ * Calculate the hash of a key 8 bytes at a time with a multiply and shift
+ * mix for each word and a final avalanche step.
  */
-STATIC size_t
-_generate_hash_key(void *data, size_t data_len, size_t num_buckets)
+STATIC uint64_t
+_hash_key(const void *key, size_t key_len)
 {
-    unsigned char *p = data;
-    size_t hash = 2166136261U;
-    size_t i;
+    const unsigned char *p = key;
+    uint64_t hash = (uint64_t) key_len * LXW_HASH_MULTIPLIER;
+    uint64_t word;
+
+    while (key_len >= sizeof(uint64_t)) {
+        memcpy(&word, p, sizeof(uint64_t));
+        hash = (hash ^ word) * LXW_HASH_MULTIPLIER;
+        hash ^= hash >> 32;
+
+        p += sizeof(uint64_t);
+        key_len -= sizeof(uint64_t);
+    }
+
+    if (key_len) {
+        word = 0;
+        memcpy(&word, p, key_len);
+        hash = (hash ^ word) * LXW_HASH_MULTIPLIER;
+        hash ^= hash >> 32;
+    }
 
-    for (i = 0; i < data_len; i++)
-        hash = (hash * 16777619) ^ p[i];
+    hash ^= hash >> 29;
+    hash *= LXW_HASH_MULTIPLIER;
+    hash ^= hash >> 32;
 
-    return hash % num_buckets;
+    return hash;
 }
 
 /*
- * Check if an element exists in the hash table and return a pointer
- * to it if it does.
+ * Find the slot for a key. This is either the slot of the element with the
+ * key or the empty slot where it should be inserted.
  */
-lxw_hash_element *
-lxw_hash_key_exists(lxw_hash_table *lxw_hash, void *key, size_t key_len)
+STATIC lxw_hash_element **
+_find_hash_slot(lxw_hash_table *lxw_hash, void *key, size_t key_len,
+                uint64_t hash)
 {
-    size_t hash_key = _generate_hash_key(key, key_len, lxw_hash->num_buckets);
-    struct lxw_hash_bucket_list *list;
+    uint32_t mask = lxw_hash->num_slots - 1;
+    uint32_t i = (uint32_t) hash & mask;
     lxw_hash_element *element;
 
-    if (!lxw_hash->buckets[hash_key]) {
-        /* The key isn't in the LXW_HASH hash table. */
-        return NULL;
-    }
-    else {
-        /* The key is already in the table or there is a hash collision. */
-        list = lxw_hash->buckets[hash_key];
-
-        /* Iterate over the keys in the bucket's linked list. */
-        SLIST_FOREACH(element, list, lxw_hash_list_pointers) {
-            if (memcmp(element->key, key, key_len) == 0) {
-                /* The key already exists in the table. */
-                return element;
-            }
-        }
+    while ((element = lxw_hash->slots[i]) != NULL) {
+        if (element->hash == hash && memcmp(element->key, key, key_len) == 0)
+            break;
 
-        /* Key doesn't exist in the list so this is a hash collision. */
-        return NULL;
+        i = (i + 1) & mask;
     }
+
+    return &lxw_hash->slots[i];
 }
 
 /*
- * Insert or update a value in the LXW_HASH table based on a key
- * and return a pointer to the new or updated element.
+ * Double the number of slots and reinsert the elements using their stored
+ * hashes.
  */
-lxw_hash_element *
-lxw_insert_hash_element(lxw_hash_table *lxw_hash, void *key, void *value,
-                        size_t key_len)
+STATIC lxw_error
+_grow_hash_slots(lxw_hash_table *lxw_hash)
 {
-    size_t hash_key = _generate_hash_key(key, key_len, lxw_hash->num_buckets);
-    struct lxw_hash_bucket_list *list = NULL;
-    lxw_hash_element *element = NULL;
+    uint32_t num_slots = lxw_hash->num_slots * 2;
+    uint32_t mask = num_slots - 1;
+    lxw_hash_element **slots;
+    lxw_hash_element *element;
+    uint32_t i;
 
-    if (!lxw_hash->buckets[hash_key]) {
-        /* The key isn't in the LXW_HASH hash table. */
+    slots = calloc(num_slots, sizeof(lxw_hash_element *));
+    RETURN_ON_MEM_ERROR(slots, LXW_ERROR_MEMORY_MALLOC_FAILED);
 
-        /* Create a linked list in the bucket to hold the lxw_hash keys. */
-        list = calloc(1, sizeof(struct lxw_hash_bucket_list));
-        GOTO_LABEL_ON_MEM_ERROR(list, mem_error1);
+    STAILQ_FOREACH(element, lxw_hash->order_list, lxw_hash_order_pointers) {
+        i = (uint32_t) element->hash & mask;
+        while (slots[i])
+            i = (i + 1) & mask;
 
-        /* Initialize the bucket linked list. */
-        SLIST_INIT(list);
+        slots[i] = element;
+    }
 
-        /* Create an lxw_hash element to add to the linked list. */
-        element = calloc(1, sizeof(lxw_hash_element));
-        GOTO_LABEL_ON_MEM_ERROR(element, mem_error1);
+    free(lxw_hash->slots);
+    lxw_hash->slots = slots;
+    lxw_hash->num_slots = num_slots;
 
-        /* Store the key and value. */
-        element->key = key;
-        element->value = value;
+    return LXW_NO_ERROR;
+}
 
-        /* Add the lxw_hash element to the bucket's linked list. */
-        SLIST_INSERT_HEAD(list, element, lxw_hash_list_pointers);
+/*
+ * Check if an element exists in the hash table and return a pointer
+ * to it if it does.
+ */
+lxw_hash_element *
+lxw_hash_key_exists(lxw_hash_table *lxw_hash, void *key, size_t key_len)
+{
+    uint64_t hash = _hash_key(key, key_len);
 
-        /* Also add it to the insertion order linked list. */
-        STAILQ_INSERT_TAIL(lxw_hash->order_list, element,
-                           lxw_hash_order_pointers);
+    return *_find_hash_slot(lxw_hash, key, key_len, hash);
+}
 
-        /* Store the bucket list at the hash index. */
-        lxw_hash->buckets[hash_key] = list;
+/*
+ * Insert or update a value in the LXW_HASH table based on a key
+ * and return a pointer to the new or updated element.
+ */
+lxw_hash_element *
+lxw_insert_hash_element(lxw_hash_table *lxw_hash, void *key, void *value,
+                        size_t key_len)
+{
+    uint64_t hash = _hash_key(key, key_len);
+    lxw_hash_element **slot = _find_hash_slot(lxw_hash, key, key_len, hash);
+    lxw_hash_element *element = *slot;
 
-        lxw_hash->used_buckets++;
-        lxw_hash->unique_count++;
+    if (element) {
+        /* The key already exists in the table. Update the value. */
+        if (lxw_hash->free_value)
+            free(element->value);
 
+        element->value = value;
         return element;
     }
-    else {
-        /* The key is already in the table or there is a hash collision. */
-        list = lxw_hash->buckets[hash_key];
-
-        /* Iterate over the keys in the bucket's linked list. */
-        SLIST_FOREACH(element, list, lxw_hash_list_pointers) {
-            if (memcmp(element->key, key, key_len) == 0) {
-                /* The key already exists in the table. Update the value. */
-                if (lxw_hash->free_value)
-                    free(element->value);
-
-                element->value = value;
-                return element;
-            }
-        }
 
-        /* Key doesn't exist in the list so this is a hash collision.
-         * Create an lxw_hash element to add to the linked list. */
-        element = calloc(1, sizeof(lxw_hash_element));
-        GOTO_LABEL_ON_MEM_ERROR(element, mem_error2);
+    /* Keep the load factor of the table under 3/4. */
+    if (lxw_hash->unique_count + 1 > lxw_hash->num_slots / 4 * 3) {
+        if (_grow_hash_slots(lxw_hash) != LXW_NO_ERROR)
+            return NULL;
 
-        /* Store the key and value. */
-        element->key = key;
-        element->value = value;
+        slot = _find_hash_slot(lxw_hash, key, key_len, hash);
+    }
 
-        /* Add the lxw_hash element to the bucket linked list. */
-        SLIST_INSERT_HEAD(list, element, lxw_hash_list_pointers);
+    /* Create an lxw_hash element to add to the table. */
+    element = calloc(1, sizeof(lxw_hash_element));
+    RETURN_ON_MEM_ERROR(element, NULL);
 
-        /* Also add it to the insertion order linked list. */
-        STAILQ_INSERT_TAIL(lxw_hash->order_list, element,
-                           lxw_hash_order_pointers);
+    /* Store the key, value and hash. */
+    element->key = key;
+    element->value = value;
+    element->hash = hash;
 
-        lxw_hash->unique_count++;
+    *slot = element;
 
-        return element;
-    }
+    /* Also add it to the insertion order linked list. */
+    STAILQ_INSERT_TAIL(lxw_hash->order_list, element,
+                       lxw_hash_order_pointers);
 
-mem_error1:
-    free(list);
+    lxw_hash->unique_count++;
 
-mem_error2:
-    free(element);
-    return NULL;
+    return element;
 }
 
 /*
  * Create a new LXW_HASH hash table object.
  */
 lxw_hash_table *
-lxw_hash_new(uint32_t num_buckets, uint8_t free_key, uint8_t free_value)
+lxw_hash_new(uint32_t num_slots, uint8_t free_key, uint8_t free_value)
 {
+    uint32_t initial_slots = LXW_HASH_MIN_SLOTS;
+
     /* Create the new hash table. */
     lxw_hash_table *lxw_hash = calloc(1, sizeof(lxw_hash_table));
     RETURN_ON_MEM_ERROR(lxw_hash, NULL);
@@ -166,10 +185,13 @@ lxw_hash_new(uint32_t num_buckets, uint8_t free_key, uint8_t free_value)
     lxw_hash->free_key = free_key;
     lxw_hash->free_value = free_value;
 
-    /* Add the lxw_hash element buckets. */
-    lxw_hash->buckets =
-        calloc(num_buckets, sizeof(struct lxw_hash_bucket_list *));
-    GOTO_LABEL_ON_MEM_ERROR(lxw_hash->buckets, mem_error);
+    /* Round the number of slots up to a power of 2. */
+    while (initial_slots < num_slots && initial_slots < 0x80000000U)
+        initial_slots *= 2;
+
+    /* Add the lxw_hash element slots. */
+    lxw_hash->slots = calloc(initial_slots, sizeof(lxw_hash_element *));
+    GOTO_LABEL_ON_MEM_ERROR(lxw_hash->slots, mem_error);
 
     /* Add a list for tracking the insertion order. */
     lxw_hash->order_list = calloc(1, sizeof(struct lxw_hash_order_list));
@@ -178,8 +200,7 @@ lxw_hash_new(uint32_t num_buckets, uint8_t free_key, uint8_t free_value)
     /* Initialize the order list. */
     STAILQ_INIT(lxw_hash->order_list);
 
-    /* Store the number of buckets to calculate the load factor. */
-    lxw_hash->num_buckets = num_buckets;
+    lxw_hash->num_slots = initial_slots;
 
     return lxw_hash;
 
@@ -194,7 +215,6 @@ mem_error:
 void
 lxw_hash_free(lxw_hash_table *lxw_hash)
 {
-    size_t i;
     lxw_hash_element *element;
     lxw_hash_element *element_temp;
 
@@ -213,12 +233,7 @@ lxw_hash_free(lxw_hash_table *lxw_hash)
         }
     }
 
-    /* Free the buckets from the hash table. */
-    for (i = 0; i < lxw_hash->num_buckets; i++) {
-        free(lxw_hash->buckets[i]);
-    }
-
     free(lxw_hash->order_list);
-    free(lxw_hash->buckets);
+    free(lxw_hash->slots);
     free(lxw_hash);
 }
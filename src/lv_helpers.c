@@ -466,3 +466,447 @@ chart_title_set_name_range_lv(lxw_chart *chart, const char *sheetname,
     chart_title_set_name_range(chart, utf8_str, row, col);
     free(utf8_str);
 }
+
+/* ============================================================================
+ * Bulk Array Write Functions
+ *
+ * These write a whole LabVIEW array in one Call Library Node call. Numeric
+ * arrays are passed as "Array Data Pointer" parameters with their sizes.
+ * String arrays are passed as LabVIEW array handles ("Handles by Value") and
+ * are converted to UTF-8 through a scratch buffer that is reused for all of
+ * the strings in the call. Timestamps are LabVIEW timestamps converted to
+ * DBL, i.e. seconds since 1904-01-01 00:00:00 UTC.
+ * ============================================================================ */
+
+/* LabVIEW string handle. The string data isn't null terminated. */
+typedef struct lxw_lv_string {
+    int32_t cnt;
+    unsigned char str[1];
+} lxw_lv_string, *lxw_lv_string_ptr, **lxw_lv_string_handle;
+
+/* LabVIEW 1D and 2D string array handles. */
+typedef struct lxw_lv_string_array {
+    int32_t dim_size;
+    lxw_lv_string_handle elt[1];
+} lxw_lv_string_array, **lxw_lv_string_array_handle;
+
+typedef struct lxw_lv_string_array_2d {
+    int32_t dim_sizes[2];
+    lxw_lv_string_handle elt[1];
+} lxw_lv_string_array_2d, **lxw_lv_string_array_2d_handle;
+
+/* The Excel date of the LabVIEW epoch, 1904-01-01, in the 1900 epoch. */
+#define LV_EPOCH_1900_DAYS 1462.0
+#define LV_SECONDS_PER_DAY 86400.0
+#define LV_WAVEFORM_CHUNK  1024
+#define LV_NO_STRING       ((size_t) -1)
+
+/* Scratch buffers used to convert the strings of an array to UTF-8. */
+typedef struct lv_scratch {
+    char *utf8;
+    size_t utf8_size;
+    size_t utf8_used;
+#ifdef _WIN32
+    wchar_t *wide;
+    size_t wide_size;
+#endif
+} lv_scratch;
+
+/*
+ * Make sure that a scratch buffer can hold "needed" elements.
+ */
+static int
+lv_scratch_reserve(void **buffer, size_t *size, size_t needed,
+                   size_t element_size)
+{
+    size_t new_size = *size ? *size : 256;
+    void *new_buffer;
+
+    if (needed <= *size)
+        return 1;
+
+    while (new_size < needed)
+        new_size *= 2;
+
+    new_buffer = realloc(*buffer, new_size * element_size);
+    if (!new_buffer)
+        return 0;
+
+    *buffer = new_buffer;
+    *size = new_size;
+    return 1;
+}
+
+static void
+lv_scratch_free(lv_scratch *scratch)
+{
+    free(scratch->utf8);
+#ifdef _WIN32
+    free(scratch->wide);
+#endif
+}
+
+/*
+ * Convert a LabVIEW ANSI string to UTF-8 and append it, null terminated, to
+ * the scratch buffer. Returns the offset of the string in the buffer, or
+ * LV_NO_STRING if the conversion fails.
+ */
+static size_t
+lv_scratch_append(lv_scratch *scratch, const unsigned char *string,
+                  int32_t length)
+{
+    size_t offset = scratch->utf8_used;
+
+#ifdef _WIN32
+    int wide_len;
+    int utf8_len;
+
+    wide_len = MultiByteToWideChar(CP_ACP, 0, (const char *) string, length,
+                                   NULL, 0);
+    if (wide_len == 0)
+        return LV_NO_STRING;
+
+    if (!lv_scratch_reserve((void **) &scratch->wide, &scratch->wide_size,
+                            (size_t) wide_len, sizeof(wchar_t)))
+        return LV_NO_STRING;
+
+    MultiByteToWideChar(CP_ACP, 0, (const char *) string, length,
+                        scratch->wide, wide_len);
+
+    utf8_len = WideCharToMultiByte(CP_UTF8, 0, scratch->wide, wide_len,
+                                   NULL, 0, NULL, NULL);
+    if (utf8_len == 0)
+        return LV_NO_STRING;
+
+    if (!lv_scratch_reserve((void **) &scratch->utf8, &scratch->utf8_size,
+                            offset + utf8_len + 1, 1))
+        return LV_NO_STRING;
+
+    WideCharToMultiByte(CP_UTF8, 0, scratch->wide, wide_len,
+                        scratch->utf8 + offset, utf8_len, NULL, NULL);
+    scratch->utf8_used += utf8_len;
+#else
+    /* On non-Windows, assume input is already UTF-8 or compatible */
+    if (!lv_scratch_reserve((void **) &scratch->utf8, &scratch->utf8_size,
+                            offset + length + 1, 1))
+        return LV_NO_STRING;
+
+    memcpy(scratch->utf8 + offset, string, length);
+    scratch->utf8_used += length;
+#endif
+
+    scratch->utf8[scratch->utf8_used++] = '\0';
+    return offset;
+}
+
+/*
+ * Check that an array of num_rows x num_cols cells fits in the worksheet.
+ */
+static lxw_error
+lv_check_range(lxw_row_t first_row, lxw_col_t first_col, int32_t num_rows,
+               int32_t num_cols)
+{
+    if (num_rows < 0 || num_cols < 0)
+        return LXW_ERROR_PARAMETER_VALIDATION;
+
+    if (first_row >= LXW_ROW_MAX
+        || (uint32_t) num_rows > LXW_ROW_MAX - first_row)
+        return LXW_ERROR_WORKSHEET_INDEX_OUT_OF_RANGE;
+
+    if (first_col >= LXW_COL_MAX
+        || (uint32_t) num_cols > (uint32_t) (LXW_COL_MAX - first_col))
+        return LXW_ERROR_WORKSHEET_INDEX_OUT_OF_RANGE;
+
+    return LXW_NO_ERROR;
+}
+
+/*
+ * Convert a LabVIEW timestamp, as seconds since the LabVIEW epoch, to an
+ * Excel date in the epoch used by the worksheet.
+ */
+static double
+lv_timestamp_to_excel(lxw_worksheet *worksheet, double seconds)
+{
+    double days = seconds / LV_SECONDS_PER_DAY;
+
+    if (worksheet->use_1904_epoch)
+        return days;
+    else
+        return days + LV_EPOCH_1900_DAYS;
+}
+
+/*
+ * Write a row ordered array of LabVIEW strings, one worksheet row at a time.
+ * The strings of each row are converted into the scratch buffer and written
+ * with worksheet_write_array().
+ */
+static lxw_error
+lv_write_strings(lxw_worksheet *worksheet, lxw_row_t first_row,
+                 lxw_col_t first_col, int32_t num_rows, int32_t num_cols,
+                 lxw_lv_string_handle *strings, lxw_format *format)
+{
+    lv_scratch scratch;
+    const char **row_strings = NULL;
+    size_t *offsets = NULL;
+    lxw_format **formats = NULL;
+    lxw_lv_string_handle string;
+    lxw_error err;
+    int32_t row;
+    int32_t col;
+
+    err = lv_check_range(first_row, first_col, num_rows, num_cols);
+    if (err || !num_rows || !num_cols)
+        return err;
+
+    memset(&scratch, 0, sizeof(scratch));
+
+    row_strings = calloc(num_cols, sizeof(char *));
+    offsets = calloc(num_cols, sizeof(size_t));
+    formats = calloc(num_cols, sizeof(lxw_format *));
+
+    if (!row_strings || !offsets || !formats) {
+        err = LXW_ERROR_MEMORY_MALLOC_FAILED;
+        goto cleanup;
+    }
+
+    for (col = 0; col < num_cols; col++)
+        formats[col] = format;
+
+    for (row = 0; row < num_rows; row++) {
+        scratch.utf8_used = 0;
+
+        for (col = 0; col < num_cols; col++) {
+            string = strings[(size_t) row * num_cols + col];
+            offsets[col] = LV_NO_STRING;
+
+            if (!string || !*string || (*string)->cnt <= 0)
+                continue;
+
+            offsets[col] = lv_scratch_append(&scratch, (*string)->str,
+                                             (*string)->cnt);
+            if (offsets[col] == LV_NO_STRING) {
+                err = LXW_ERROR_MEMORY_MALLOC_FAILED;
+                goto cleanup;
+            }
+        }
+
+        /* Set the pointers once the scratch buffer has stopped moving. */
+        for (col = 0; col < num_cols; col++) {
+            if (offsets[col] == LV_NO_STRING)
+                row_strings[col] = NULL;
+            else
+                row_strings[col] = scratch.utf8 + offsets[col];
+        }
+
+        err = worksheet_write_array(worksheet, first_row + row, first_col, 1,
+                                    (lxw_col_t) num_cols, LXW_ARRAY_STRING,
+                                    row_strings, formats);
+        if (err)
+            goto cleanup;
+    }
+
+cleanup:
+    lv_scratch_free(&scratch);
+    free(row_strings);
+    free(offsets);
+    free(formats);
+    return err;
+}
+
+/*
+ * Write a 1D array of numbers to a row or, if write_as_column is set, to a
+ * column of the worksheet.
+ */
+lxw_error
+worksheet_write_number_array_lv(lxw_worksheet *worksheet,
+                                lxw_row_t first_row, lxw_col_t first_col,
+                                const double *data, int32_t num_values,
+                                uint8_t write_as_column, lxw_format *format)
+{
+    lxw_error err;
+
+    if (write_as_column)
+        err = lv_check_range(first_row, first_col, num_values, 1);
+    else
+        err = lv_check_range(first_row, first_col, 1, num_values);
+
+    if (err)
+        return err;
+
+    if (write_as_column)
+        return worksheet_write_column_numbers(worksheet, first_row,
+                                              first_col, data,
+                                              (lxw_row_t) num_values, format);
+    else
+        return worksheet_write_row_numbers(worksheet, first_row, first_col,
+                                           data, (lxw_col_t) num_values,
+                                           format);
+}
+
+/*
+ * Write a 2D array of numbers, in LabVIEW row order, to the worksheet.
+ */
+lxw_error
+worksheet_write_number_array_2d_lv(lxw_worksheet *worksheet,
+                                   lxw_row_t first_row, lxw_col_t first_col,
+                                   const double *data, int32_t num_rows,
+                                   int32_t num_cols, lxw_format *format)
+{
+    lxw_error err;
+    int32_t row;
+
+    err = lv_check_range(first_row, first_col, num_rows, num_cols);
+    if (err || !num_rows || !num_cols)
+        return err;
+
+    if (!data)
+        return LXW_ERROR_NULL_PARAMETER_IGNORED;
+
+    if (num_cols == 1)
+        return worksheet_write_column_numbers(worksheet, first_row,
+                                              first_col, data,
+                                              (lxw_row_t) num_rows, format);
+
+    for (row = 0; row < num_rows; row++) {
+        err = worksheet_write_row_numbers(worksheet, first_row + row,
+                                          first_col,
+                                          data + (size_t) row * num_cols,
+                                          (lxw_col_t) num_cols, format);
+        if (err)
+            return err;
+    }
+
+    return LXW_NO_ERROR;
+}
+
+/*
+ * Write a LabVIEW 1D string array to a row or, if write_as_column is set, to
+ * a column of the worksheet.
+ */
+lxw_error
+worksheet_write_string_array_lv(lxw_worksheet *worksheet,
+                                lxw_row_t first_row, lxw_col_t first_col,
+                                lxw_lv_string_array_handle strings,
+                                uint8_t write_as_column, lxw_format *format)
+{
+    int32_t num_values;
+
+    if (!strings || !*strings)
+        return LXW_ERROR_NULL_PARAMETER_IGNORED;
+
+    num_values = (*strings)->dim_size;
+
+    if (write_as_column)
+        return lv_write_strings(worksheet, first_row, first_col, num_values,
+                                1, (*strings)->elt, format);
+    else
+        return lv_write_strings(worksheet, first_row, first_col, 1,
+                                num_values, (*strings)->elt, format);
+}
+
+/*
+ * Write a LabVIEW 2D string array to the worksheet.
+ */
+lxw_error
+worksheet_write_string_array_2d_lv(lxw_worksheet *worksheet,
+                                   lxw_row_t first_row, lxw_col_t first_col,
+                                   lxw_lv_string_array_2d_handle strings,
+                                   lxw_format *format)
+{
+    if (!strings || !*strings)
+        return LXW_ERROR_NULL_PARAMETER_IGNORED;
+
+    return lv_write_strings(worksheet, first_row, first_col,
+                            (*strings)->dim_sizes[0],
+                            (*strings)->dim_sizes[1], (*strings)->elt,
+                            format);
+}
+
+/*
+ * Write a 1D array of LabVIEW timestamps to a column of the worksheet as
+ * Excel dates. The format should have a date/time number format.
+ */
+lxw_error
+worksheet_write_timestamps_lv(lxw_worksheet *worksheet, lxw_row_t first_row,
+                              lxw_col_t col, const double *timestamps,
+                              int32_t num_values, lxw_format *format)
+{
+    double dates[LV_WAVEFORM_CHUNK];
+    lxw_error err;
+    int32_t done;
+    int32_t count;
+    int32_t i;
+
+    err = lv_check_range(first_row, col, num_values, 1);
+    if (err || !num_values)
+        return err;
+
+    if (!timestamps)
+        return LXW_ERROR_NULL_PARAMETER_IGNORED;
+
+    for (done = 0; done < num_values; done += count) {
+        count = num_values - done;
+        if (count > LV_WAVEFORM_CHUNK)
+            count = LV_WAVEFORM_CHUNK;
+
+        for (i = 0; i < count; i++)
+            dates[i] = lv_timestamp_to_excel(worksheet, timestamps[done + i]);
+
+        err = worksheet_write_column_numbers(worksheet, first_row + done, col,
+                                             dates, (lxw_row_t) count,
+                                             format);
+        if (err)
+            return err;
+    }
+
+    return LXW_NO_ERROR;
+}
+
+/*
+ * Write a LabVIEW waveform, given by its t0, dt and Y array, to two columns
+ * of the worksheet: the time of each point as an Excel date in first_col and
+ * the value in the column after it.
+ */
+lxw_error
+worksheet_write_waveform_lv(lxw_worksheet *worksheet, lxw_row_t first_row,
+                            lxw_col_t first_col, double t0, double dt,
+                            const double *values, int32_t num_values,
+                            lxw_format *time_format, lxw_format *value_format)
+{
+    double data[LV_WAVEFORM_CHUNK][2];
+    lxw_format *formats[2];
+    lxw_error err;
+    int32_t done;
+    int32_t count;
+    int32_t i;
+
+    err = lv_check_range(first_row, first_col, num_values, 2);
+    if (err || !num_values)
+        return err;
+
+    if (!values)
+        return LXW_ERROR_NULL_PARAMETER_IGNORED;
+
+    formats[0] = time_format;
+    formats[1] = value_format;
+
+    for (done = 0; done < num_values; done += count) {
+        count = num_values - done;
+        if (count > LV_WAVEFORM_CHUNK)
+            count = LV_WAVEFORM_CHUNK;
+
+        for (i = 0; i < count; i++) {
+            data[i][0] = lv_timestamp_to_excel(worksheet,
+                                               t0 + (done + i) * dt);
+            data[i][1] = values[done + i];
+        }
+
+        err = worksheet_write_array(worksheet, first_row + done, first_col,
+                                    (lxw_row_t) count, 2, LXW_ARRAY_NUMBER,
+                                    data, formats);
+        if (err)
+            return err;
+    }
+
+    return LXW_NO_ERROR;
+}
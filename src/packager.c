@@ -44,6 +44,7 @@
  *
  */
 
+#include <limits.h>
 #include <zlib.h>
 #include "xlsxwriter/xmlwriter.h"
 #include "xlsxwriter/packager.h"
@@ -51,15 +52,53 @@
 #include "xlsxwriter/utility.h"
 
 STATIC lxw_error _add_file_to_zip(lxw_packager *self, FILE *file,
-                                  const char *filename);
+                                  const char *filename,
+                                  lxw_part_compression *compression);
 
 STATIC lxw_error _add_buffer_to_zip(lxw_packager *self, const char *buffer,
-                                    size_t buffer_size, const char *filename);
+                                    size_t buffer_size, const char *filename,
+                                    lxw_part_compression *compression);
+
+STATIC lxw_part_compression _get_part_compression(lxw_packager *self,
+                                                  const char *filename,
+                                                  uint8_t store_by_default);
 
 STATIC lxw_error _add_to_zip(lxw_packager *self, FILE *file,
                              char **buffer, size_t *buffer_size,
                              const char *filename);
 
+STATIC lxw_error _add_static_part_to_zip(lxw_packager *self,
+                                         uint8_t part_id,
+                                         const char *filename);
+
+STATIC lxw_error _read_file_to_buffer(FILE *file, char **buffer,
+                                      size_t *buffer_size);
+
+STATIC lxw_error _add_worksheet_to_zip(lxw_packager *self,
+                                       lxw_worksheet *worksheet,
+                                       char **buffer, size_t *buffer_size,
+                                       const char *filename);
+
+/* The package parts that are the same in every workbook. */
+enum lxw_static_parts {
+    LXW_STATIC_PART_CHART_STYLE,
+    LXW_STATIC_PART_CHART_COLORS,
+    LXW_STATIC_PART_THEME
+};
+
+/* A part that is already deflated and is written to the zip file raw. */
+typedef struct lxw_deflated_part {
+    uint8_t part_id;
+    int level;
+    int strategy;
+    unsigned char *data;
+    size_t size;
+    size_t uncompressed_size;
+    uLong crc;
+
+    struct lxw_deflated_part *next;
+} lxw_deflated_part;
+
 STATIC lxw_error _write_vml_drawing_rels_file(lxw_packager *self,
                                               lxw_worksheet *worksheet,
                                               uint32_t index);
@@ -118,6 +157,10 @@ _open_zipfile_win32(const char *filename)
 
 #endif
 
+#if !defined(USE_NO_THREADS) && !defined(_WIN32)
+#include <pthread.h>
+#endif
+
 STATIC voidpf ZCALLBACK
 _fopen_memstream(voidpf opaque, const char *filename, int mode)
 {
@@ -167,13 +210,159 @@ mem_error:
     return EOF;
 }
 
+/*
+ * The zip file is written to an output sink through the following minizip
+ * file functions. Minizip seeks back to update the local header of each
+ * member file after its data is written, so the stream buffers the current
+ * member and only passes it to the sink when the next member is started.
+ * Everything passed to the sink is final so it is written sequentially.
+ */
+typedef struct lxw_sink_stream {
+    lxw_output_sink *sink;
+    char *data;
+    size_t size;
+    size_t allocated;
+    ZPOS64_T offset;
+    ZPOS64_T position;
+    int error;
+} lxw_sink_stream;
+
+/*
+ * Pass the buffered data to the output sink.
+ */
+STATIC int
+_flush_sink_stream(lxw_sink_stream *stream)
+{
+    if (stream->error)
+        return -1;
+
+    if (stream->size
+        && stream->sink->write(stream->sink->user_data, stream->data,
+                               stream->size) != stream->size) {
+        stream->error = LXW_TRUE;
+        return -1;
+    }
+
+    stream->offset += stream->size;
+    stream->size = 0;
+
+    return 0;
+}
+
+STATIC voidpf ZCALLBACK
+_fopen_sink(voidpf opaque, const void *filename, int mode)
+{
+    lxw_packager *packager = (lxw_packager *) opaque;
+    (void) filename;
+    (void) mode;
+    return packager->sink_stream;
+}
+
+STATIC uLong ZCALLBACK
+_fread_sink(voidpf opaque, voidpf stream, void *buf, uLong size)
+{
+    (void) opaque;
+    (void) stream;
+    (void) buf;
+    (void) size;
+    return 0;
+}
+
+STATIC uLong ZCALLBACK
+_fwrite_sink(voidpf opaque, voidpf stream, const void *buf, uLong size)
+{
+    lxw_sink_stream *sink_stream = (lxw_sink_stream *) stream;
+    size_t start = (size_t) (sink_stream->position - sink_stream->offset);
+    size_t end = start + size;
+    size_t allocated;
+    char *data;
+    (void) opaque;
+
+    if (end > sink_stream->allocated) {
+        allocated = sink_stream->allocated ? sink_stream->allocated : 4096;
+
+        while (allocated < end)
+            allocated *= 2;
+
+        data = realloc(sink_stream->data, allocated);
+        if (!data) {
+            sink_stream->error = LXW_TRUE;
+            return 0;
+        }
+
+        sink_stream->data = data;
+        sink_stream->allocated = allocated;
+    }
+
+    memcpy(sink_stream->data + start, buf, size);
+    sink_stream->position += size;
+
+    if (end > sink_stream->size)
+        sink_stream->size = end;
+
+    return size;
+}
+
+STATIC ZPOS64_T ZCALLBACK
+_ftell_sink(voidpf opaque, voidpf stream)
+{
+    (void) opaque;
+    return ((lxw_sink_stream *) stream)->position;
+}
+
+STATIC long ZCALLBACK
+_fseek_sink(voidpf opaque, voidpf stream, ZPOS64_T offset, int origin)
+{
+    lxw_sink_stream *sink_stream = (lxw_sink_stream *) stream;
+    ZPOS64_T end = sink_stream->offset + sink_stream->size;
+    (void) opaque;
+
+    if (origin == ZLIB_FILEFUNC_SEEK_CUR)
+        offset += sink_stream->position;
+    else if (origin == ZLIB_FILEFUNC_SEEK_END)
+        offset += end;
+
+    /* Data that has been passed to the sink can't be rewritten. */
+    if (offset < sink_stream->offset || offset > end)
+        return -1;
+
+    sink_stream->position = offset;
+    return 0;
+}
+
+STATIC int ZCALLBACK
+_fclose_sink(voidpf opaque, voidpf stream)
+{
+    lxw_sink_stream *sink_stream = (lxw_sink_stream *) stream;
+    lxw_output_sink *sink = sink_stream->sink;
+    int error = _flush_sink_stream(sink_stream);
+    (void) opaque;
+
+    if (!error && sink->flush && sink->flush(sink->user_data))
+        error = -1;
+
+    if (sink->close && sink->close(sink->user_data))
+        error = -1;
+
+    return error ? EOF : 0;
+}
+
+STATIC int ZCALLBACK
+_ferror_sink(voidpf opaque, voidpf stream)
+{
+    (void) opaque;
+    return ((lxw_sink_stream *) stream)->error;
+}
+
 /*
  * Create a new packager object.
  */
 lxw_packager *
-lxw_packager_new(const char *filename, const char *tmpdir, uint8_t use_zip64)
+lxw_packager_new(const char *filename, const char *tmpdir, uint8_t use_zip64,
+                 lxw_output_sink *output_sink)
 {
     zlib_filefunc_def filefunc;
+    zlib_filefunc64_def filefunc64;
     lxw_packager *packager = calloc(1, sizeof(lxw_packager));
     GOTO_LABEL_ON_MEM_ERROR(packager, mem_error);
 
@@ -213,6 +402,21 @@ lxw_packager_new(const char *filename, const char *tmpdir, uint8_t use_zip64)
         packager->zipfile = zipOpen(packager->filename, 0);
 #endif
     }
+    else if (output_sink) {
+        packager->sink_stream = calloc(1, sizeof(lxw_sink_stream));
+        GOTO_LABEL_ON_MEM_ERROR(packager->sink_stream, mem_error);
+        packager->sink_stream->sink = output_sink;
+
+        filefunc64.zopen64_file = _fopen_sink;
+        filefunc64.zread_file = _fread_sink;
+        filefunc64.zwrite_file = _fwrite_sink;
+        filefunc64.ztell64_file = _ftell_sink;
+        filefunc64.zseek64_file = _fseek_sink;
+        filefunc64.zclose_file = _fclose_sink;
+        filefunc64.zerror_file = _ferror_sink;
+        filefunc64.opaque = packager;
+        packager->zipfile = zipOpen2_64(NULL, 0, NULL, &filefunc64);
+    }
     else {
         fill_fopen_filefunc(&filefunc);
         filefunc.opaque = packager;
@@ -237,9 +441,22 @@ mem_error:
 void
 lxw_packager_free(lxw_packager *packager)
 {
+    lxw_deflated_part *deflated;
+
     if (!packager)
         return;
 
+    while (packager->deflated_parts) {
+        deflated = packager->deflated_parts;
+        packager->deflated_parts = deflated->next;
+        free(deflated->data);
+        free(deflated);
+    }
+
+    if (packager->sink_stream)
+        free(packager->sink_stream->data);
+
+    free(packager->sink_stream);
     free((void *) packager->buffer);
     free((void *) packager->filename);
     free(packager);
@@ -310,8 +527,8 @@ _write_worksheet_files(lxw_packager *self)
 
         lxw_worksheet_assemble_xml_file(worksheet);
 
-        err = _add_to_zip(self, worksheet->file, &buffer, &buffer_size,
-                          sheetname);
+        err = _add_worksheet_to_zip(self, worksheet, &buffer, &buffer_size,
+                                    sheetname);
         fclose(worksheet->file);
         free(buffer);
         RETURN_ON_ERROR(err);
@@ -361,6 +578,45 @@ _write_chartsheet_files(lxw_packager *self)
     return LXW_NO_ERROR;
 }
 
+/*
+ * Add an image to the zip file. PNG, JPEG and GIF images are already
+ * compressed so they are stored rather than deflated again, unless there is a
+ * workbook_set_part_compression() override for the image part.
+ */
+STATIC lxw_error
+_add_image_to_zip(lxw_packager *self, lxw_object_properties *object_props,
+                  const char *filename)
+{
+    lxw_part_compression compression;
+    uint8_t is_compressed = object_props->image_type == LXW_IMAGE_PNG
+        || object_props->image_type == LXW_IMAGE_JPEG
+        || object_props->image_type == LXW_IMAGE_GIF;
+    FILE *image_stream;
+    lxw_error err;
+
+    compression = _get_part_compression(self, filename, is_compressed);
+
+    if (object_props->is_image_buffer)
+        return _add_buffer_to_zip(self,
+                                  object_props->image_buffer,
+                                  object_props->image_buffer_size,
+                                  filename, &compression);
+
+    /* Check that the image file exists and can be opened. */
+    image_stream = lxw_fopen(object_props->filename, "rb");
+    if (!image_stream) {
+        LXW_WARN_FORMAT1("Error adding image to xlsx file: file "
+                         "doesn't exist or can't be opened: %s.",
+                         object_props->filename);
+        return LXW_ERROR_CREATING_TMPFILE;
+    }
+
+    err = _add_file_to_zip(self, image_stream, filename, &compression);
+    fclose(image_stream);
+
+    return err;
+}
+
 /*
  * Write the /xl/media/image?.xml files.
  */
@@ -372,7 +628,6 @@ _write_image_files(lxw_packager *self)
     lxw_worksheet *worksheet;
     lxw_object_properties *object_props;
     lxw_error err;
-    FILE *image_stream;
 
     char filename[LXW_FILENAME_LENGTH] = { 0 };
     uint32_t index = 1;
@@ -397,26 +652,7 @@ _write_image_files(lxw_packager *self)
                          "xl/media/image%d.%s", index++,
                          object_props->extension);
 
-            if (!object_props->is_image_buffer) {
-                /* Check that the image file exists and can be opened. */
-                image_stream = lxw_fopen(object_props->filename, "rb");
-                if (!image_stream) {
-                    LXW_WARN_FORMAT1("Error adding image to xlsx file: file "
-                                     "doesn't exist or can't be opened: %s.",
-                                     object_props->filename);
-                    return LXW_ERROR_CREATING_TMPFILE;
-                }
-
-                err = _add_file_to_zip(self, image_stream, filename);
-                fclose(image_stream);
-            }
-            else {
-                err = _add_buffer_to_zip(self,
-                                         object_props->image_buffer,
-                                         object_props->image_buffer_size,
-                                         filename);
-            }
-
+            err = _add_image_to_zip(self, object_props, filename);
             RETURN_ON_ERROR(err);
         }
 
@@ -429,26 +665,7 @@ _write_image_files(lxw_packager *self)
                          "xl/media/image%d.%s", index++,
                          object_props->extension);
 
-            if (!object_props->is_image_buffer) {
-                /* Check that the image file exists and can be opened. */
-                image_stream = lxw_fopen(object_props->filename, "rb");
-                if (!image_stream) {
-                    LXW_WARN_FORMAT1("Error adding image to xlsx file: file "
-                                     "doesn't exist or can't be opened: %s.",
-                                     object_props->filename);
-                    return LXW_ERROR_CREATING_TMPFILE;
-                }
-
-                err = _add_file_to_zip(self, image_stream, filename);
-                fclose(image_stream);
-            }
-            else {
-                err = _add_buffer_to_zip(self,
-                                         object_props->image_buffer,
-                                         object_props->image_buffer_size,
-                                         filename);
-            }
-
+            err = _add_image_to_zip(self, object_props, filename);
             RETURN_ON_ERROR(err);
         }
     }
@@ -478,7 +695,7 @@ _add_vba_project(lxw_packager *self)
         return LXW_ERROR_CREATING_TMPFILE;
     }
 
-    err = _add_file_to_zip(self, image_stream, "xl/vbaProject.bin");
+    err = _add_file_to_zip(self, image_stream, "xl/vbaProject.bin", NULL);
     fclose(image_stream);
     RETURN_ON_ERROR(err);
 
@@ -507,7 +724,8 @@ _add_vba_project_signature(lxw_packager *self)
         return LXW_ERROR_CREATING_TMPFILE;
     }
 
-    err = _add_file_to_zip(self, image_stream, "xl/vbaProjectSignature.bin");
+    err = _add_file_to_zip(self, image_stream,
+                           "xl/vbaProjectSignature.bin", NULL);
     fclose(image_stream);
     RETURN_ON_ERROR(err);
 
@@ -952,54 +1170,71 @@ static lxw_style_xml_func chart_style_xml_funcs[] = {
 };
 
 /*
- * Write the chart style files for charts.
+ * Concatenate the chart style or color XML part functions into a buffer.
  */
-STATIC lxw_error
-_write_chart_style_files(lxw_packager *self)
+STATIC char *
+_concat_xml_funcs(lxw_style_xml_func *xml_funcs, size_t *size)
 {
-    lxw_workbook *workbook = self->workbook;
-    lxw_chart *chart;
-    char filename[LXW_FILENAME_LENGTH] = { 0 };
-    uint32_t index = 1;
-    lxw_error err;
     size_t total_len = 0;
     size_t i;
-    char *style_xml;
+    char *xml;
     char *pos;
 
-    /* Calculate total length of style XML. */
-    for (i = 0; chart_style_xml_funcs[i] != NULL; i++) {
-        total_len += strlen(chart_style_xml_funcs[i] ());
+    /* Calculate total length of the XML. */
+    for (i = 0; xml_funcs[i] != NULL; i++) {
+        total_len += strlen(xml_funcs[i] ());
     }
 
-    /* Allocate buffer for complete style XML. */
-    style_xml = malloc(total_len + 1);
-    if (!style_xml) {
-        return LXW_ERROR_MEMORY_MALLOC_FAILED;
-    }
+    /* Allocate buffer for the complete XML. */
+    xml = malloc(total_len + 1);
+    if (!xml)
+        return NULL;
 
     /* Concatenate all parts. */
-    pos = style_xml;
-    for (i = 0; chart_style_xml_funcs[i] != NULL; i++) {
-        const char *part = chart_style_xml_funcs[i] ();
+    pos = xml;
+    for (i = 0; xml_funcs[i] != NULL; i++) {
+        const char *part = xml_funcs[i] ();
         size_t len = strlen(part);
         memcpy(pos, part, len);
         pos += len;
     }
     *pos = '\0';
 
+    *size = total_len;
+    return xml;
+}
+
+/*
+ * Get the chart style XML.
+ */
+STATIC char *
+_get_chart_style_xml(lxw_packager *self, size_t *size)
+{
+    (void) self;
+    return _concat_xml_funcs(chart_style_xml_funcs, size);
+}
+
+/*
+ * Write the chart style files for charts.
+ */
+STATIC lxw_error
+_write_chart_style_files(lxw_packager *self)
+{
+    lxw_workbook *workbook = self->workbook;
+    lxw_chart *chart;
+    char filename[LXW_FILENAME_LENGTH] = { 0 };
+    uint32_t index = 1;
+    lxw_error err;
+
     STAILQ_FOREACH(chart, workbook->ordered_charts, ordered_list_pointers) {
         lxw_snprintf(filename, LXW_FILENAME_LENGTH,
                      "xl/charts/style%d.xml", index++);
 
-        err = _add_buffer_to_zip(self, style_xml, total_len, filename);
-        if (err) {
-            free(style_xml);
-            return err;
-        }
+        err = _add_static_part_to_zip(self, LXW_STATIC_PART_CHART_STYLE,
+                                      filename);
+        RETURN_ON_ERROR(err);
     }
 
-    free(style_xml);
     return LXW_NO_ERROR;
 }
 
@@ -1042,6 +1277,16 @@ static lxw_style_xml_func chart_color_xml_funcs[] = {
     NULL
 };
 
+/*
+ * Get the chart color XML.
+ */
+STATIC char *
+_get_chart_color_xml(lxw_packager *self, size_t *size)
+{
+    (void) self;
+    return _concat_xml_funcs(chart_color_xml_funcs, size);
+}
+
 /*
  * Write the chart color files for charts.
  */
@@ -1053,44 +1298,16 @@ _write_chart_color_files(lxw_packager *self)
     char filename[LXW_FILENAME_LENGTH] = { 0 };
     uint32_t index = 1;
     lxw_error err;
-    size_t total_len = 0;
-    size_t i;
-    char *colors_xml;
-    char *pos;
-
-    /* Calculate total length of color XML. */
-    for (i = 0; chart_color_xml_funcs[i] != NULL; i++) {
-        total_len += strlen(chart_color_xml_funcs[i] ());
-    }
-
-    /* Allocate buffer for complete color XML. */
-    colors_xml = malloc(total_len + 1);
-    if (!colors_xml) {
-        return LXW_ERROR_MEMORY_MALLOC_FAILED;
-    }
-
-    /* Concatenate all parts. */
-    pos = colors_xml;
-    for (i = 0; chart_color_xml_funcs[i] != NULL; i++) {
-        const char *part = chart_color_xml_funcs[i] ();
-        size_t len = strlen(part);
-        memcpy(pos, part, len);
-        pos += len;
-    }
-    *pos = '\0';
 
     STAILQ_FOREACH(chart, workbook->ordered_charts, ordered_list_pointers) {
         lxw_snprintf(filename, LXW_FILENAME_LENGTH,
                      "xl/charts/colors%d.xml", index++);
 
-        err = _add_buffer_to_zip(self, colors_xml, total_len, filename);
-        if (err) {
-            free(colors_xml);
-            return err;
-        }
+        err = _add_static_part_to_zip(self, LXW_STATIC_PART_CHART_COLORS,
+                                      filename);
+        RETURN_ON_ERROR(err);
     }
 
-    free(colors_xml);
     return LXW_NO_ERROR;
 }
 
@@ -1863,39 +2080,46 @@ mem_error:
 }
 
 /*
- * Write the theme.xml file.
+ * Get the theme XML.
  */
-STATIC lxw_error
-_write_theme_file(lxw_packager *self)
+STATIC char *
+_get_theme_xml(lxw_packager *self, size_t *size)
 {
-    lxw_error err = LXW_NO_ERROR;
     lxw_theme *theme = lxw_theme_new();
     char *buffer = NULL;
     size_t buffer_size = 0;
 
-    if (!theme) {
-        err = LXW_ERROR_MEMORY_MALLOC_FAILED;
-        goto mem_error;
-    }
+    if (!theme)
+        return NULL;
 
     theme->file = lxw_get_filehandle(&buffer, &buffer_size, self->tmpdir);
     if (!theme->file) {
-        err = LXW_ERROR_CREATING_TMPFILE;
-        goto mem_error;
+        lxw_theme_free(theme);
+        return NULL;
     }
 
     lxw_theme_assemble_xml_file(theme);
 
-    err = _add_to_zip(self, theme->file, &buffer, &buffer_size,
-                      "xl/theme/theme1.xml");
+    /* Flush to ensure buffer is updated when using a memory-backed file. */
+    fflush(theme->file);
+    if (!buffer && _read_file_to_buffer(theme->file, &buffer, &buffer_size))
+        buffer = NULL;
 
     fclose(theme->file);
-    free(buffer);
-
-mem_error:
     lxw_theme_free(theme);
 
-    return err;
+    *size = buffer_size;
+    return buffer;
+}
+
+/*
+ * Write the theme.xml file.
+ */
+STATIC lxw_error
+_write_theme_file(lxw_packager *self)
+{
+    return _add_static_part_to_zip(self, LXW_STATIC_PART_THEME,
+                                   "xl/theme/theme1.xml");
 }
 
 /*
@@ -2650,222 +2874,1708 @@ mem_error:
 
 /*****************************************************************************
  *
- * Public functions.
+ * Compression functions.
  *
  ****************************************************************************/
 
-STATIC lxw_error
-_add_file_to_zip(lxw_packager *self, FILE *file, const char *filename)
+/*
+ * Match a package part name against a workbook_set_part_compression()
+ * pattern. A "*" matches any characters other than "/" and a trailing "/"
+ * matches all of the parts below a directory.
+ */
+STATIC uint8_t
+_part_name_matches(const char *pattern, const char *part_name)
 {
-    int16_t error = ZIP_OK;
-    size_t size_read;
+    while (*pattern) {
+        if (*pattern == '*') {
+            pattern++;
 
-    error = zipOpenNewFileInZip4_64(self->zipfile,
-                                    filename,
-                                    &self->zipfile_info,
-                                    NULL, 0, NULL, 0, NULL,
-                                    Z_DEFLATED, Z_DEFAULT_COMPRESSION, 0,
-                                    -MAX_WBITS, DEF_MEM_LEVEL,
-                                    Z_DEFAULT_STRATEGY, NULL, 0, 0, 0,
-                                    self->use_zip64);
+            /* Try each possible length for the wildcard match. */
+            while (1) {
+                if (_part_name_matches(pattern, part_name))
+                    return LXW_TRUE;
 
-    if (error != ZIP_OK) {
-        LXW_ERROR("Error adding member to zipfile");
-        RETURN_ON_ZIP_ERROR(error, LXW_ERROR_ZIP_FILE_ADD);
-    }
+                if (*part_name == '\0' || *part_name == '/')
+                    return LXW_FALSE;
 
-    fflush(file);
-    rewind(file);
+                part_name++;
+            }
+        }
 
-    size_read = fread((void *) self->buffer, 1, self->buffer_size, file);
+        if (*pattern != *part_name)
+            return LXW_FALSE;
 
-    while (size_read) {
+        if (*pattern == '/' && pattern[1] == '\0')
+            return LXW_TRUE;
 
-        if (size_read < self->buffer_size) {
-            if (ferror(file)) {
-                LXW_ERROR("Error reading member file data");
-                RETURN_ON_ZIP_ERROR(error, LXW_ERROR_ZIP_FILE_ADD);
-            }
-        }
+        pattern++;
+        part_name++;
+    }
 
-        error = zipWriteInFileInZip(self->zipfile,
-                                    self->buffer, (unsigned int) size_read);
+    return *part_name == '\0';
+}
 
-        if (error < 0) {
-            LXW_ERROR("Error in writing member in the zipfile");
-            RETURN_ON_ZIP_ERROR(error, LXW_ERROR_ZIP_FILE_ADD);
-        }
+/*
+ * Get the compression settings for a package part from the workbook options
+ * and any matching part overrides. The last matching override is used. If
+ * "store_by_default" is set the part is stored unless there is an override.
+ */
+STATIC lxw_part_compression
+_get_part_compression(lxw_packager *self, const char *filename,
+                      uint8_t store_by_default)
+{
+    lxw_part_compression compression = { 0, 0, 0 };
+    lxw_compression_override *compression_override;
 
-        size_read =
-            fread((void *) (void *) self->buffer, 1, self->buffer_size, file);
+    if (!self->workbook)
+        return compression;
+
+    compression.level = self->workbook->options.compression_level;
+    compression.strategy = self->workbook->options.compression_strategy;
+    compression.store_only = self->workbook->options.store_only;
+
+    if (store_by_default) {
+        compression.level = 0;
+        compression.strategy = LXW_COMPRESSION_STRATEGY_DEFAULT;
+        compression.store_only = LXW_TRUE;
     }
 
-    error = zipCloseFileInZip(self->zipfile);
-    if (error != ZIP_OK) {
-        LXW_ERROR("Error in closing member in the zipfile");
-        RETURN_ON_ZIP_ERROR(error, LXW_ERROR_ZIP_FILE_ADD);
+    STAILQ_FOREACH(compression_override, self->workbook->compression_overrides,
+                   list_pointers) {
+        if (_part_name_matches(compression_override->part_name, filename))
+            compression = compression_override->compression;
     }
 
-    return LXW_NO_ERROR;
+    return compression;
+}
+
+/*
+ * Convert the part compression level to a zlib level.
+ */
+STATIC int
+_zlib_level(lxw_part_compression *compression)
+{
+    if (compression->store_only)
+        return 0;
+    else if (compression->level)
+        return compression->level;
+    else
+        return Z_DEFAULT_COMPRESSION;
+}
+
+/*
+ * Convert the part compression strategy to a zlib strategy.
+ */
+STATIC int
+_zlib_strategy(lxw_part_compression *compression)
+{
+    switch (compression->strategy) {
+        case LXW_COMPRESSION_STRATEGY_FILTERED:
+            return Z_FILTERED;
+        case LXW_COMPRESSION_STRATEGY_HUFFMAN_ONLY:
+            return Z_HUFFMAN_ONLY;
+        case LXW_COMPRESSION_STRATEGY_RLE:
+            return Z_RLE;
+        case LXW_COMPRESSION_STRATEGY_FIXED:
+            return Z_FIXED;
+        default:
+            return Z_DEFAULT_STRATEGY;
+    }
 }
 
+/*
+ * Open a new member file in the zip file with the part compression settings.
+ * If "raw" is set the data written to the member must already be deflated.
+ */
 STATIC lxw_error
-_add_buffer_to_zip(lxw_packager *self, const char *buffer, size_t buffer_size,
-                   const char *filename)
+_open_file_in_zip(lxw_packager *self, const char *filename,
+                  lxw_part_compression *compression, int raw)
 {
-    int16_t error = ZIP_OK;
+    int16_t error;
+    int method = compression->store_only ? 0 : Z_DEFLATED;
+
+    /* The previous member file is complete so it can go to the sink. */
+    if (self->sink_stream && _flush_sink_stream(self->sink_stream)) {
+        LXW_ERROR("Error writing member to output sink");
+        return LXW_ERROR_ZIP_FILE_ADD;
+    }
 
     error = zipOpenNewFileInZip4_64(self->zipfile,
                                     filename,
                                     &self->zipfile_info,
                                     NULL, 0, NULL, 0, NULL,
-                                    Z_DEFLATED, Z_DEFAULT_COMPRESSION, 0,
+                                    method, _zlib_level(compression), raw,
                                     -MAX_WBITS, DEF_MEM_LEVEL,
-                                    Z_DEFAULT_STRATEGY, NULL, 0, 0, 0,
-                                    self->use_zip64);
+                                    _zlib_strategy(compression),
+                                    NULL, 0, 0, 0, self->use_zip64);
 
     if (error != ZIP_OK) {
         LXW_ERROR("Error adding member to zipfile");
         RETURN_ON_ZIP_ERROR(error, LXW_ERROR_ZIP_FILE_ADD);
     }
 
-    error = zipWriteInFileInZip(self->zipfile,
-                                buffer, (unsigned int) buffer_size);
-
-    if (error < 0) {
-        LXW_ERROR("Error in writing member in the zipfile");
-        RETURN_ON_ZIP_ERROR(error, LXW_ERROR_ZIP_FILE_ADD);
-    }
-
-    error = zipCloseFileInZip(self->zipfile);
-    if (error != ZIP_OK) {
-        LXW_ERROR("Error in closing member in the zipfile");
-        RETURN_ON_ZIP_ERROR(error, LXW_ERROR_ZIP_FILE_ADD);
-    }
-
     return LXW_NO_ERROR;
 }
 
+/*
+ * Write data to the current member file in the zip file. The minizip write
+ * length is an unsigned int so large data is written in slices.
+ */
 STATIC lxw_error
-_add_to_zip(lxw_packager *self, FILE *file, char **buffer,
-            size_t *buffer_size, const char *filename)
+_write_data_to_zip(lxw_packager *self, const char *data, size_t size)
+{
+    int16_t error;
+    size_t slice_size;
+
+    while (size) {
+        slice_size = size > UINT_MAX ? UINT_MAX : size;
+
+        error = zipWriteInFileInZip(self->zipfile, data,
+                                    (unsigned int) slice_size);
+
+        if (error < 0) {
+            LXW_ERROR("Error in writing member in the zipfile");
+            RETURN_ON_ZIP_ERROR(error, LXW_ERROR_ZIP_FILE_ADD);
+        }
+
+        data += slice_size;
+        size -= slice_size;
+    }
+
+    return LXW_NO_ERROR;
+}
+
+/*
+ * Write a buffer to a new member file in the zip file.
+ */
+STATIC lxw_error
+_write_buffer_to_zip(lxw_packager *self, const char *buffer,
+                     size_t buffer_size, const char *filename,
+                     lxw_part_compression *compression)
+{
+    int16_t error = ZIP_OK;
+    lxw_error err;
+
+    err = _open_file_in_zip(self, filename, compression, 0);
+    RETURN_ON_ERROR(err);
+
+    err = _write_data_to_zip(self, buffer, buffer_size);
+    RETURN_ON_ERROR(err);
+
+    error = zipCloseFileInZip(self->zipfile);
+    if (error != ZIP_OK) {
+        LXW_ERROR("Error in closing member in the zipfile");
+        RETURN_ON_ZIP_ERROR(error, LXW_ERROR_ZIP_FILE_ADD);
+    }
+
+    return LXW_NO_ERROR;
+}
+
+/*
+ * Read the whole of a part file into an allocated buffer.
+ */
+STATIC lxw_error
+_read_file_to_buffer(FILE *file, char **buffer, size_t *buffer_size)
+{
+    char *data;
+    char *new_data;
+    size_t data_size = 0;
+    size_t allocated = 128 * 1024;
+    size_t size_read;
+
+    fflush(file);
+    rewind(file);
+
+    data = malloc(allocated);
+    RETURN_ON_MEM_ERROR(data, LXW_ERROR_MEMORY_MALLOC_FAILED);
+
+    while (1) {
+        size_read = fread(data + data_size, 1, allocated - data_size, file);
+        data_size += size_read;
+
+        if (data_size < allocated) {
+            if (ferror(file)) {
+                LXW_ERROR("Error reading member file data");
+                free(data);
+                return LXW_ERROR_ZIP_FILE_ADD;
+            }
+
+            break;
+        }
+
+        allocated *= 2;
+        new_data = realloc(data, allocated);
+        if (!new_data) {
+            free(data);
+            return LXW_ERROR_MEMORY_MALLOC_FAILED;
+        }
+
+        data = new_data;
+    }
+
+    *buffer = data;
+    *buffer_size = data_size;
+
+    return LXW_NO_ERROR;
+}
+
+/*
+ * Write an already deflated part to a new member file in the zip file.
+ */
+STATIC lxw_error
+_write_deflated_part(lxw_packager *self, const char *filename,
+                     const lxw_deflated_part *deflated,
+                     lxw_part_compression *compression)
+{
+    int16_t error = ZIP_OK;
+    lxw_error err;
+
+    err = _open_file_in_zip(self, filename, compression, 1);
+    RETURN_ON_ERROR(err);
+
+    err = _write_data_to_zip(self, (const char *) deflated->data,
+                             deflated->size);
+    RETURN_ON_ERROR(err);
+
+    error = zipCloseFileInZipRaw64(self->zipfile,
+                                   (ZPOS64_T) deflated->uncompressed_size,
+                                   deflated->crc);
+    if (error != ZIP_OK) {
+        LXW_ERROR("Error in closing member in the zipfile");
+        RETURN_ON_ZIP_ERROR(error, LXW_ERROR_ZIP_FILE_ADD);
+    }
+
+    return LXW_NO_ERROR;
+}
+
+/*****************************************************************************
+ *
+ * Parallel compression functions.
+ *
+ * If the workbook "num_threads" option is greater than 1 the package parts
+ * are queued and deflated by a pool of worker threads while the main thread
+ * assembles the following parts. Each part is split into fixed size chunks
+ * that are compressed independently, in the same way as pigz, using the
+ * previous 32KB of the part as a preset dictionary. The compressed chunks are
+ * joined and written to the zip file as raw data in the original part order.
+ * The chunk size doesn't depend on the number of threads so the output is the
+ * same for any num_threads > 1.
+ *
+ * Parts are queued in segments of a whole number of chunks, with the
+ * preceding 32KB of the part for the dictionary, so that only a bounded
+ * amount of a large part is held in memory at a time.
+ *
+ ****************************************************************************/
+#ifndef USE_NO_THREADS
+
+#define LXW_DEFLATE_CHUNK_SIZE   (128 * 1024)
+#define LXW_DEFLATE_DICT_SIZE    (32 * 1024)
+#define LXW_DEFLATE_SEGMENT_SIZE (64 * LXW_DEFLATE_CHUNK_SIZE)
+#define LXW_DEFLATE_MAX_PENDING  (64 * 1024 * 1024)
+
+#ifdef _WIN32
+typedef HANDLE lxw_thread;
+typedef CRITICAL_SECTION lxw_mutex;
+typedef CONDITION_VARIABLE lxw_cond;
+
+#define LXW_MUTEX_INIT(mutex)        InitializeCriticalSection(mutex)
+#define LXW_MUTEX_DESTROY(mutex)     DeleteCriticalSection(mutex)
+#define LXW_MUTEX_LOCK(mutex)        EnterCriticalSection(mutex)
+#define LXW_MUTEX_UNLOCK(mutex)      LeaveCriticalSection(mutex)
+#define LXW_COND_INIT(cond)          InitializeConditionVariable(cond)
+#define LXW_COND_DESTROY(cond)       ((void) (cond))
+#define LXW_COND_WAIT(cond, mutex)   \
+    SleepConditionVariableCS(cond, mutex, INFINITE)
+#define LXW_COND_BROADCAST(cond)     WakeAllConditionVariable(cond)
+#else
+typedef pthread_t lxw_thread;
+typedef pthread_mutex_t lxw_mutex;
+typedef pthread_cond_t lxw_cond;
+
+#define LXW_MUTEX_INIT(mutex)        pthread_mutex_init(mutex, NULL)
+#define LXW_MUTEX_DESTROY(mutex)     pthread_mutex_destroy(mutex)
+#define LXW_MUTEX_LOCK(mutex)        pthread_mutex_lock(mutex)
+#define LXW_MUTEX_UNLOCK(mutex)      pthread_mutex_unlock(mutex)
+#define LXW_COND_INIT(cond)          pthread_cond_init(cond, NULL)
+#define LXW_COND_DESTROY(cond)       pthread_cond_destroy(cond)
+#define LXW_COND_WAIT(cond, mutex)   pthread_cond_wait(cond, mutex)
+#define LXW_COND_BROADCAST(cond)     pthread_cond_broadcast(cond)
+#endif
+
+/* A chunk of a part to be compressed by a worker thread. */
+typedef struct lxw_deflate_chunk {
+    const unsigned char *input;
+    size_t input_size;
+    size_t dictionary_size;
+    unsigned char *output;
+    size_t output_size;
+    uLong crc;
+    int level;
+    int strategy;
+    uint8_t is_last;
+    uint8_t error;
+} lxw_deflate_chunk;
+
+/* A queued package part, or a segment of one, and its chunks. The buffer
+ * holds the dictionary data from the preceding segment, if any, followed by
+ * the segment data. */
+typedef struct lxw_deflate_part {
+    char *filename;
+    char *buffer;
+    size_t buffer_size;
+    size_t dictionary_size;
+    uint8_t is_first;
+    uint8_t is_last;
+    lxw_part_compression compression;
+    const lxw_deflated_part *deflated;
+    lxw_deflate_chunk *chunks;
+    size_t num_chunks;
+    size_t chunks_started;
+    size_t chunks_done;
+
+    STAILQ_ENTRY (lxw_deflate_part) list_pointers;
+} lxw_deflate_part;
+
+STAILQ_HEAD(lxw_deflate_parts, lxw_deflate_part);
+
+/* The worker thread pool. The part queue is in zip file order. */
+struct lxw_deflate_pool {
+    lxw_thread *threads;
+    uint16_t num_threads;
+    lxw_mutex mutex;
+    lxw_cond work_ready;
+    lxw_cond work_done;
+    struct lxw_deflate_parts parts;
+    lxw_deflate_part *next_part;
+    size_t pending_size;
+    uint8_t shutdown;
+
+    /* The member file being written, which may span several segments. */
+    uLong member_crc;
+    uint64_t member_size;
+};
+
+/*
+ * Compress one chunk as a raw deflate stream. All but the last chunk end on
+ * a byte boundary with a sync flush so that the chunks can be concatenated.
+ */
+STATIC void
+_deflate_chunk(lxw_deflate_chunk *chunk)
+{
+    z_stream stream;
+    size_t output_size;
+    int flush = chunk->is_last ? Z_FINISH : Z_SYNC_FLUSH;
+    int ret;
+
+    chunk->crc = crc32(crc32(0L, Z_NULL, 0), chunk->input,
+                       (uInt) chunk->input_size);
+
+    memset(&stream, 0, sizeof(stream));
+
+    if (deflateInit2(&stream, chunk->level, Z_DEFLATED,
+                     -MAX_WBITS, DEF_MEM_LEVEL, chunk->strategy) != Z_OK) {
+        chunk->error = LXW_TRUE;
+        return;
+    }
+
+    if (chunk->dictionary_size)
+        deflateSetDictionary(&stream,
+                             chunk->input - chunk->dictionary_size,
+                             (uInt) chunk->dictionary_size);
+
+    /* Add some space for the sync flush marker to the worst case size. */
+    output_size = deflateBound(&stream, (uLong) chunk->input_size) + 16;
+
+    chunk->output = malloc(output_size);
+    if (!chunk->output) {
+        chunk->error = LXW_TRUE;
+        deflateEnd(&stream);
+        return;
+    }
+
+    stream.next_in = (Bytef *) chunk->input;
+    stream.avail_in = (uInt) chunk->input_size;
+    stream.next_out = chunk->output;
+    stream.avail_out = (uInt) output_size;
+
+    ret = deflate(&stream, flush);
+
+    if (chunk->is_last ? ret != Z_STREAM_END
+        : ret != Z_OK || stream.avail_out == 0)
+        chunk->error = LXW_TRUE;
+
+    chunk->output_size = output_size - stream.avail_out;
+    deflateEnd(&stream);
+}
+
+/*
+ * Worker thread loop: take the next chunk from the queue and compress it.
+ */
+STATIC void
+_deflate_worker(struct lxw_deflate_pool *pool)
+{
+    lxw_deflate_part *part;
+    lxw_deflate_chunk *chunk;
+
+    LXW_MUTEX_LOCK(&pool->mutex);
+
+    while (1) {
+        while (!pool->next_part && !pool->shutdown)
+            LXW_COND_WAIT(&pool->work_ready, &pool->mutex);
+
+        if (!pool->next_part)
+            break;
+
+        part = pool->next_part;
+        chunk = &part->chunks[part->chunks_started++];
+
+        if (part->chunks_started == part->num_chunks) {
+            pool->next_part = STAILQ_NEXT(part, list_pointers);
+
+            /* Skip stored parts, which have no chunks to compress. */
+            while (pool->next_part && !pool->next_part->num_chunks)
+                pool->next_part = STAILQ_NEXT(pool->next_part, list_pointers);
+        }
+
+        LXW_MUTEX_UNLOCK(&pool->mutex);
+        _deflate_chunk(chunk);
+        LXW_MUTEX_LOCK(&pool->mutex);
+
+        if (++part->chunks_done == part->num_chunks)
+            LXW_COND_BROADCAST(&pool->work_done);
+    }
+
+    LXW_MUTEX_UNLOCK(&pool->mutex);
+}
+
+#ifdef _WIN32
+STATIC DWORD WINAPI
+_deflate_thread(LPVOID pool)
+{
+    _deflate_worker((struct lxw_deflate_pool *) pool);
+    return 0;
+}
+#else
+STATIC void *
+_deflate_thread(void *pool)
+{
+    _deflate_worker((struct lxw_deflate_pool *) pool);
+    return NULL;
+}
+#endif
+
+/*
+ * Free a queued part and its compressed chunks.
+ */
+STATIC void
+_free_deflate_part(lxw_deflate_part *part)
+{
+    size_t i;
+
+    if (!part)
+        return;
+
+    if (part->chunks) {
+        for (i = 0; i < part->num_chunks; i++)
+            free(part->chunks[i].output);
+    }
+
+    free(part->chunks);
+    free(part->buffer);
+    free(part->filename);
+    free(part);
+}
+
+/*
+ * Stop the worker threads and free any parts that weren't written.
+ */
+STATIC void
+_deflate_pool_stop(lxw_packager *self)
+{
+    struct lxw_deflate_pool *pool = self->deflate_pool;
+    lxw_deflate_part *part;
+    uint16_t i;
+
+    if (!pool)
+        return;
+
+    LXW_MUTEX_LOCK(&pool->mutex);
+    pool->shutdown = LXW_TRUE;
+    pool->next_part = NULL;
+    LXW_COND_BROADCAST(&pool->work_ready);
+    LXW_MUTEX_UNLOCK(&pool->mutex);
+
+    for (i = 0; i < pool->num_threads; i++) {
+#ifdef _WIN32
+        WaitForSingleObject(pool->threads[i], INFINITE);
+        CloseHandle(pool->threads[i]);
+#else
+        pthread_join(pool->threads[i], NULL);
+#endif
+    }
+
+    while (!STAILQ_EMPTY(&pool->parts)) {
+        part = STAILQ_FIRST(&pool->parts);
+        STAILQ_REMOVE_HEAD(&pool->parts, list_pointers);
+        _free_deflate_part(part);
+    }
+
+    LXW_COND_DESTROY(&pool->work_ready);
+    LXW_COND_DESTROY(&pool->work_done);
+    LXW_MUTEX_DESTROY(&pool->mutex);
+    free(pool->threads);
+    free(pool);
+
+    self->deflate_pool = NULL;
+}
+
+/*
+ * Start the worker threads. If no threads can be created the parts are
+ * compressed serially instead.
+ */
+STATIC lxw_error
+_deflate_pool_start(lxw_packager *self)
+{
+    struct lxw_deflate_pool *pool;
+    uint16_t i;
+
+    pool = calloc(1, sizeof(struct lxw_deflate_pool));
+    RETURN_ON_MEM_ERROR(pool, LXW_ERROR_MEMORY_MALLOC_FAILED);
+
+    pool->threads = calloc(self->num_threads, sizeof(lxw_thread));
+    if (!pool->threads) {
+        free(pool);
+        return LXW_ERROR_MEMORY_MALLOC_FAILED;
+    }
+
+    STAILQ_INIT(&pool->parts);
+    LXW_MUTEX_INIT(&pool->mutex);
+    LXW_COND_INIT(&pool->work_ready);
+    LXW_COND_INIT(&pool->work_done);
+
+    for (i = 0; i < self->num_threads; i++) {
+#ifdef _WIN32
+        pool->threads[i] = CreateThread(NULL, 0, _deflate_thread, pool, 0,
+                                        NULL);
+        if (!pool->threads[i])
+            break;
+#else
+        if (pthread_create(&pool->threads[i], NULL, _deflate_thread, pool))
+            break;
+#endif
+    }
+
+    pool->num_threads = i;
+    self->deflate_pool = pool;
+
+    if (!pool->num_threads) {
+        LXW_WARN("workbook_close(): couldn't create compression threads. "
+                 "Compressing serially.");
+        _deflate_pool_stop(self);
+    }
+
+    return LXW_NO_ERROR;
+}
+
+/*
+ * Write a compressed part, or a segment of one, to the zip file as raw
+ * deflate data. The member file is opened by the first segment of the part
+ * and closed by the last one.
+ */
+STATIC lxw_error
+_write_deflate_part(lxw_packager *self, lxw_deflate_part *part)
+{
+    struct lxw_deflate_pool *pool = self->deflate_pool;
+    int16_t error = ZIP_OK;
+    lxw_error err;
+    size_t i;
+
+    if (part->deflated)
+        return _write_deflated_part(self, part->filename, part->deflated,
+                                    &part->compression);
+
+    for (i = 0; i < part->num_chunks; i++) {
+        if (part->chunks[i].error) {
+            LXW_ERROR("Error compressing member file data");
+            return LXW_ERROR_ZIP_FILE_ADD;
+        }
+    }
+
+    if (part->is_first) {
+        err = _open_file_in_zip(self, part->filename, &part->compression,
+                                !part->compression.store_only);
+        RETURN_ON_ERROR(err);
+
+        pool->member_crc = crc32(0L, Z_NULL, 0);
+        pool->member_size = 0;
+    }
+
+    /* Stored parts have no chunks and are written as they are. */
+    if (part->compression.store_only) {
+        err = _write_data_to_zip(self, part->buffer + part->dictionary_size,
+                                 part->buffer_size);
+        RETURN_ON_ERROR(err);
+    }
+
+    for (i = 0; i < part->num_chunks; i++) {
+        lxw_deflate_chunk *chunk = &part->chunks[i];
+
+        err = _write_data_to_zip(self, (const char *) chunk->output,
+                                 chunk->output_size);
+        RETURN_ON_ERROR(err);
+
+        pool->member_crc = crc32_combine(pool->member_crc, chunk->crc,
+                                         (z_off_t) chunk->input_size);
+    }
+
+    pool->member_size += part->buffer_size;
+
+    if (!part->is_last)
+        return LXW_NO_ERROR;
+
+    if (part->compression.store_only)
+        error = zipCloseFileInZip(self->zipfile);
+    else
+        error = zipCloseFileInZipRaw64(self->zipfile,
+                                       (ZPOS64_T) pool->member_size,
+                                       pool->member_crc);
+
+    if (error != ZIP_OK) {
+        LXW_ERROR("Error in closing member in the zipfile");
+        RETURN_ON_ZIP_ERROR(error, LXW_ERROR_ZIP_FILE_ADD);
+    }
+
+    return LXW_NO_ERROR;
+}
+
+/*
+ * Write the compressed parts at the head of the queue to the zip file. If
+ * "flush" is set, or if too much data is queued, wait for the workers to
+ * finish the pending parts. Otherwise only the completed parts are written.
+ */
+STATIC lxw_error
+_write_deflate_parts(lxw_packager *self, uint8_t flush)
+{
+    struct lxw_deflate_pool *pool = self->deflate_pool;
+    lxw_deflate_part *part;
+    lxw_error err;
+
+    while (1) {
+        LXW_MUTEX_LOCK(&pool->mutex);
+
+        part = STAILQ_FIRST(&pool->parts);
+
+        if (part && part->chunks_done < part->num_chunks) {
+            if (!flush && pool->pending_size <= LXW_DEFLATE_MAX_PENDING)
+                part = NULL;
+            else
+                LXW_COND_WAIT(&pool->work_done, &pool->mutex);
+
+            LXW_MUTEX_UNLOCK(&pool->mutex);
+
+            if (!part)
+                return LXW_NO_ERROR;
+
+            continue;
+        }
+
+        if (part) {
+            STAILQ_REMOVE_HEAD(&pool->parts, list_pointers);
+            pool->pending_size -= part->buffer_size;
+        }
+
+        LXW_MUTEX_UNLOCK(&pool->mutex);
+
+        if (!part)
+            return LXW_NO_ERROR;
+
+        err = _write_deflate_part(self, part);
+        _free_deflate_part(part);
+        RETURN_ON_ERROR(err);
+    }
+}
+
+/*
+ * Add a part to the end of the queue and write out any parts that are
+ * already compressed.
+ */
+STATIC lxw_error
+_insert_deflate_part(lxw_packager *self, lxw_deflate_part *part)
+{
+    struct lxw_deflate_pool *pool = self->deflate_pool;
+
+    LXW_MUTEX_LOCK(&pool->mutex);
+
+    STAILQ_INSERT_TAIL(&pool->parts, part, list_pointers);
+    pool->pending_size += part->buffer_size;
+
+    if (!pool->next_part && part->num_chunks)
+        pool->next_part = part;
+
+    LXW_COND_BROADCAST(&pool->work_ready);
+    LXW_MUTEX_UNLOCK(&pool->mutex);
+
+    return _write_deflate_parts(self, LXW_FALSE);
+}
+
+/*
+ * Queue a segment of a part for compression by the worker threads. The
+ * buffer holds "dictionary_size" bytes of the preceding part data followed
+ * by the segment data. The queue takes ownership of the buffer.
+ */
+STATIC lxw_error
+_queue_deflate_part(lxw_packager *self, char *buffer, size_t dictionary_size,
+                    size_t buffer_size, const char *filename,
+                    lxw_part_compression *compression, uint8_t is_first,
+                    uint8_t is_last)
+{
+    lxw_deflate_part *part;
+    lxw_deflate_chunk *chunk;
+    size_t offset = 0;
+    size_t i;
+
+    part = calloc(1, sizeof(lxw_deflate_part));
+    if (!part) {
+        free(buffer);
+        return LXW_ERROR_MEMORY_MALLOC_FAILED;
+    }
+
+    part->buffer = buffer;
+    part->buffer_size = buffer_size;
+    part->dictionary_size = dictionary_size;
+    part->is_first = is_first;
+    part->is_last = is_last;
+    part->compression = *compression;
+    part->filename = lxw_strdup(filename);
+
+    if (!part->filename) {
+        _free_deflate_part(part);
+        return LXW_ERROR_MEMORY_MALLOC_FAILED;
+    }
+
+    /* Stored parts are queued without chunks to keep the part order. */
+    if (!part->compression.store_only) {
+        part->num_chunks = buffer_size / LXW_DEFLATE_CHUNK_SIZE + 1;
+
+        if (buffer_size && buffer_size % LXW_DEFLATE_CHUNK_SIZE == 0)
+            part->num_chunks--;
+
+        part->chunks = calloc(part->num_chunks, sizeof(lxw_deflate_chunk));
+
+        if (!part->chunks) {
+            _free_deflate_part(part);
+            return LXW_ERROR_MEMORY_MALLOC_FAILED;
+        }
+    }
+
+    for (i = 0; i < part->num_chunks; i++) {
+        chunk = &part->chunks[i];
+        chunk->input = (unsigned char *) buffer + dictionary_size + offset;
+        chunk->input_size = LXW_DEFLATE_CHUNK_SIZE;
+        chunk->dictionary_size = LXW_DEFLATE_DICT_SIZE;
+        chunk->level = _zlib_level(&part->compression);
+        chunk->strategy = _zlib_strategy(&part->compression);
+
+        if (dictionary_size + offset < LXW_DEFLATE_DICT_SIZE)
+            chunk->dictionary_size = dictionary_size + offset;
+
+        if (i == part->num_chunks - 1) {
+            chunk->input_size = buffer_size - offset;
+            chunk->is_last = is_last;
+        }
+
+        offset += chunk->input_size;
+    }
+
+    return _insert_deflate_part(self, part);
+}
+
+/*
+ * Queue a part that is already deflated so that it is written in order with
+ * the other queued parts.
+ */
+STATIC lxw_error
+_queue_deflated_part(lxw_packager *self, const char *filename,
+                     const lxw_deflated_part *deflated,
+                     lxw_part_compression *compression)
+{
+    lxw_deflate_part *part;
+
+    part = calloc(1, sizeof(lxw_deflate_part));
+    RETURN_ON_MEM_ERROR(part, LXW_ERROR_MEMORY_MALLOC_FAILED);
+
+    part->deflated = deflated;
+    part->compression = *compression;
+    part->filename = lxw_strdup(filename);
+
+    if (!part->filename) {
+        _free_deflate_part(part);
+        return LXW_ERROR_MEMORY_MALLOC_FAILED;
+    }
+
+    return _insert_deflate_part(self, part);
+}
+
+/*
+ * Read a part file in segments and queue them for compression. Each segment
+ * buffer starts with the end of the previous segment for the dictionary.
+ */
+STATIC lxw_error
+_queue_deflate_file(lxw_packager *self, FILE *file, const char *filename,
+                    lxw_part_compression *compression)
+{
+    char *buffer;
+    char *next_buffer = NULL;
+    size_t dictionary_size = 0;
+    size_t size_read;
+    uint8_t is_first = LXW_TRUE;
+    uint8_t is_last = LXW_FALSE;
+    lxw_error err;
+    int next_char;
+
+    fflush(file);
+    rewind(file);
+
+    buffer = malloc(LXW_DEFLATE_DICT_SIZE + LXW_DEFLATE_SEGMENT_SIZE);
+    RETURN_ON_MEM_ERROR(buffer, LXW_ERROR_MEMORY_MALLOC_FAILED);
+
+    while (!is_last) {
+        size_read = fread(buffer + dictionary_size, 1,
+                          LXW_DEFLATE_SEGMENT_SIZE, file);
+
+        /* Check for the end of the file after a full segment. */
+        if (size_read == LXW_DEFLATE_SEGMENT_SIZE) {
+            next_char = fgetc(file);
+
+            if (next_char == EOF)
+                is_last = LXW_TRUE;
+            else
+                ungetc(next_char, file);
+        }
+        else {
+            is_last = LXW_TRUE;
+        }
+
+        if (ferror(file)) {
+            LXW_ERROR("Error reading member file data");
+            free(buffer);
+            return LXW_ERROR_ZIP_FILE_ADD;
+        }
+
+        if (!is_last) {
+            next_buffer = malloc(LXW_DEFLATE_DICT_SIZE +
+                                 LXW_DEFLATE_SEGMENT_SIZE);
+            if (!next_buffer) {
+                free(buffer);
+                return LXW_ERROR_MEMORY_MALLOC_FAILED;
+            }
+
+            memcpy(next_buffer,
+                   buffer + dictionary_size + size_read -
+                   LXW_DEFLATE_DICT_SIZE, LXW_DEFLATE_DICT_SIZE);
+        }
+
+        err = _queue_deflate_part(self, buffer, dictionary_size, size_read,
+                                  filename, compression, is_first, is_last);
+        if (err) {
+            free(next_buffer);
+            return err;
+        }
+
+        buffer = next_buffer;
+        next_buffer = NULL;
+        dictionary_size = LXW_DEFLATE_DICT_SIZE;
+        is_first = LXW_FALSE;
+    }
+
+    return LXW_NO_ERROR;
+}
+
+/*
+ * Copy a part buffer in segments and queue them for compression.
+ */
+STATIC lxw_error
+_queue_deflate_buffer(lxw_packager *self, const char *buffer,
+                      size_t buffer_size, const char *filename,
+                      lxw_part_compression *compression)
+{
+    char *segment;
+    size_t segment_size;
+    size_t dictionary_size;
+    size_t offset = 0;
+    lxw_error err;
+
+    do {
+        segment_size = buffer_size - offset;
+        if (segment_size > LXW_DEFLATE_SEGMENT_SIZE)
+            segment_size = LXW_DEFLATE_SEGMENT_SIZE;
+
+        dictionary_size = offset;
+        if (dictionary_size > LXW_DEFLATE_DICT_SIZE)
+            dictionary_size = LXW_DEFLATE_DICT_SIZE;
+
+        segment = malloc(dictionary_size + segment_size + 1);
+        RETURN_ON_MEM_ERROR(segment, LXW_ERROR_MEMORY_MALLOC_FAILED);
+
+        memcpy(segment, buffer + offset - dictionary_size,
+               dictionary_size + segment_size);
+
+        err = _queue_deflate_part(self, segment, dictionary_size,
+                                  segment_size, filename, compression,
+                                  offset == 0,
+                                  offset + segment_size == buffer_size);
+        RETURN_ON_ERROR(err);
+
+        offset += segment_size;
+    } while (offset < buffer_size);
+
+    return LXW_NO_ERROR;
+}
+
+#endif /* USE_NO_THREADS */
+
+/*****************************************************************************
+ *
+ * Static part functions.
+ *
+ * The chart style, chart color and theme parts are the same in every
+ * workbook. They are deflated once for each compression level and strategy
+ * and the deflated data is then written raw for every copy of the part. When
+ * threads are available the deflated parts are shared by all the workbooks
+ * in the process. Otherwise they are kept for the lifetime of the packager.
+ *
+ ****************************************************************************/
+
+/* Function to get the XML for a static part. */
+typedef char *(*lxw_static_part_func)(lxw_packager *self, size_t *size);
+
+/* The XML functions, in lxw_static_parts order. */
+static lxw_static_part_func static_part_funcs[] = {
+    _get_chart_style_xml,
+    _get_chart_color_xml,
+    _get_theme_xml
+};
+
+#ifndef USE_NO_THREADS
+static lxw_deflated_part *lxw_shared_deflated_parts = NULL;
+
+#ifdef _WIN32
+static SRWLOCK lxw_deflated_parts_lock = SRWLOCK_INIT;
+
+#define LXW_DEFLATED_PARTS_LOCK()   \
+    AcquireSRWLockExclusive(&lxw_deflated_parts_lock)
+#define LXW_DEFLATED_PARTS_UNLOCK() \
+    ReleaseSRWLockExclusive(&lxw_deflated_parts_lock)
+#else
+static pthread_mutex_t lxw_deflated_parts_lock = PTHREAD_MUTEX_INITIALIZER;
+
+#define LXW_DEFLATED_PARTS_LOCK()   \
+    pthread_mutex_lock(&lxw_deflated_parts_lock)
+#define LXW_DEFLATED_PARTS_UNLOCK() \
+    pthread_mutex_unlock(&lxw_deflated_parts_lock)
+#endif
+
+#else
+#define LXW_DEFLATED_PARTS_LOCK()
+#define LXW_DEFLATED_PARTS_UNLOCK()
+#endif
+
+/*
+ * Deflate the XML for a static part as a single raw deflate stream.
+ */
+STATIC lxw_error
+_deflate_static_part(lxw_deflated_part *deflated, const char *xml,
+                     size_t xml_size)
+{
+    z_stream stream;
+    size_t output_size;
+    int ret;
+
+    memset(&stream, 0, sizeof(stream));
+
+    if (deflateInit2(&stream, deflated->level, Z_DEFLATED, -MAX_WBITS,
+                     DEF_MEM_LEVEL, deflated->strategy) != Z_OK)
+        return LXW_ERROR_MEMORY_MALLOC_FAILED;
+
+    output_size = deflateBound(&stream, (uLong) xml_size);
+
+    deflated->data = malloc(output_size);
+    if (!deflated->data) {
+        deflateEnd(&stream);
+        return LXW_ERROR_MEMORY_MALLOC_FAILED;
+    }
+
+    stream.next_in = (Bytef *) xml;
+    stream.avail_in = (uInt) xml_size;
+    stream.next_out = deflated->data;
+    stream.avail_out = (uInt) output_size;
+
+    ret = deflate(&stream, Z_FINISH);
+    deflateEnd(&stream);
+
+    if (ret != Z_STREAM_END) {
+        LXW_ERROR("Error compressing member file data");
+        return LXW_ERROR_ZIP_FILE_ADD;
+    }
+
+    deflated->size = output_size - stream.avail_out;
+    deflated->uncompressed_size = xml_size;
+    deflated->crc = crc32(crc32(0L, Z_NULL, 0), (const Bytef *) xml,
+                          (uInt) xml_size);
+
+    return LXW_NO_ERROR;
+}
+
+/*
+ * Get the deflated data for a static part, deflating it on first use.
+ */
+STATIC lxw_error
+_get_deflated_part(lxw_packager *self, uint8_t part_id,
+                   lxw_part_compression *compression,
+                   const lxw_deflated_part **deflated_part)
+{
+    lxw_deflated_part **deflated_parts = &self->deflated_parts;
+    lxw_deflated_part *deflated;
+    lxw_error err = LXW_NO_ERROR;
+    int level = _zlib_level(compression);
+    int strategy = _zlib_strategy(compression);
+    size_t xml_size = 0;
+    char *xml;
+
+#ifndef USE_NO_THREADS
+    deflated_parts = &lxw_shared_deflated_parts;
+#endif
+
+    LXW_DEFLATED_PARTS_LOCK();
+
+    for (deflated = *deflated_parts; deflated; deflated = deflated->next) {
+        if (deflated->part_id == part_id && deflated->level == level
+            && deflated->strategy == strategy)
+            break;
+    }
+
+    if (!deflated) {
+        deflated = calloc(1, sizeof(lxw_deflated_part));
+        xml = static_part_funcs[part_id] (self, &xml_size);
+
+        if (deflated && xml) {
+            deflated->part_id = part_id;
+            deflated->level = level;
+            deflated->strategy = strategy;
+
+            err = _deflate_static_part(deflated, xml, xml_size);
+        }
+        else {
+            err = LXW_ERROR_MEMORY_MALLOC_FAILED;
+        }
+
+        free(xml);
+
+        if (err) {
+            if (deflated)
+                free(deflated->data);
+            free(deflated);
+            deflated = NULL;
+        }
+        else {
+            deflated->next = *deflated_parts;
+            *deflated_parts = deflated;
+        }
+    }
+
+    LXW_DEFLATED_PARTS_UNLOCK();
+
+    *deflated_part = deflated;
+    return err;
+}
+
+/*
+ * Add a static part to the zip file, deflating it only once.
+ */
+STATIC lxw_error
+_add_static_part_to_zip(lxw_packager *self, uint8_t part_id,
+                        const char *filename)
+{
+    lxw_part_compression compression;
+    const lxw_deflated_part *deflated;
+    size_t xml_size = 0;
+    char *xml;
+    lxw_error err;
+
+    compression = _get_part_compression(self, filename, LXW_FALSE);
+
+    /* Stored parts don't need any compression so they aren't cached. */
+    if (compression.store_only) {
+        xml = static_part_funcs[part_id] (self, &xml_size);
+        RETURN_ON_MEM_ERROR(xml, LXW_ERROR_MEMORY_MALLOC_FAILED);
+
+        err = _add_buffer_to_zip(self, xml, xml_size, filename, &compression);
+        free(xml);
+        return err;
+    }
+
+    err = _get_deflated_part(self, part_id, &compression, &deflated);
+    RETURN_ON_ERROR(err);
+
+#ifndef USE_NO_THREADS
+    if (self->deflate_pool)
+        return _queue_deflated_part(self, filename, deflated, &compression);
+#endif
+
+    return _write_deflated_part(self, filename, deflated, &compression);
+}
+
+/*****************************************************************************
+ *
+ * Public functions.
+ *
+ ****************************************************************************/
+
+/*
+ * Add a file to the zip file. If "compression" is NULL the settings for the
+ * part are taken from the workbook options.
+ */
+STATIC lxw_error
+_add_file_to_zip(lxw_packager *self, FILE *file, const char *filename,
+                 lxw_part_compression *compression)
+{
+    int16_t error = ZIP_OK;
+    size_t size_read;
+    lxw_part_compression part_compression;
+    lxw_error err;
+
+    if (!compression) {
+        part_compression = _get_part_compression(self, filename, LXW_FALSE);
+        compression = &part_compression;
+    }
+
+#ifndef USE_NO_THREADS
+    if (self->deflate_pool)
+        return _queue_deflate_file(self, file, filename, compression);
+#endif
+
+    err = _open_file_in_zip(self, filename, compression, 0);
+    RETURN_ON_ERROR(err);
+
+    fflush(file);
+    rewind(file);
+
+    size_read = fread((void *) self->buffer, 1, self->buffer_size, file);
+
+    while (size_read) {
+
+        if (size_read < self->buffer_size) {
+            if (ferror(file)) {
+                LXW_ERROR("Error reading member file data");
+                RETURN_ON_ZIP_ERROR(error, LXW_ERROR_ZIP_FILE_ADD);
+            }
+        }
+
+        error = zipWriteInFileInZip(self->zipfile,
+                                    self->buffer, (unsigned int) size_read);
+
+        if (error < 0) {
+            LXW_ERROR("Error in writing member in the zipfile");
+            RETURN_ON_ZIP_ERROR(error, LXW_ERROR_ZIP_FILE_ADD);
+        }
+
+        size_read =
+            fread((void *) (void *) self->buffer, 1, self->buffer_size, file);
+    }
+
+    error = zipCloseFileInZip(self->zipfile);
+    if (error != ZIP_OK) {
+        LXW_ERROR("Error in closing member in the zipfile");
+        RETURN_ON_ZIP_ERROR(error, LXW_ERROR_ZIP_FILE_ADD);
+    }
+
+    return LXW_NO_ERROR;
+}
+
+/*
+ * Add a buffer to the zip file. If "compression" is NULL the settings for the
+ * part are taken from the workbook options.
+ */
+STATIC lxw_error
+_add_buffer_to_zip(lxw_packager *self, const char *buffer, size_t buffer_size,
+                   const char *filename, lxw_part_compression *compression)
+{
+    lxw_part_compression part_compression;
+
+    if (!compression) {
+        part_compression = _get_part_compression(self, filename, LXW_FALSE);
+        compression = &part_compression;
+    }
+
+#ifndef USE_NO_THREADS
+    if (self->deflate_pool)
+        return _queue_deflate_buffer(self, buffer, buffer_size, filename,
+                                     compression);
+#endif
+
+    return _write_buffer_to_zip(self, buffer, buffer_size, filename,
+                                compression);
+}
+
+STATIC lxw_error
+_add_to_zip(lxw_packager *self, FILE *file, char **buffer,
+            size_t *buffer_size, const char *filename)
 {
     /* Flush to ensure buffer is updated when using a memory-backed file. */
     fflush(file);
     return *buffer ?
-        _add_buffer_to_zip(self, *buffer, *buffer_size, filename) :
-        _add_file_to_zip(self, file, filename);
+        _add_buffer_to_zip(self, *buffer, *buffer_size, filename, NULL) :
+        _add_file_to_zip(self, file, filename, NULL);
+}
+
+/*
+ * Deflate part of the worksheet XML and write it to the current zip member,
+ * which has been opened for raw data.
+ */
+STATIC lxw_error
+_write_deflated_xml(lxw_packager *self, const char *data, size_t size,
+                    lxw_part_compression *compression, int flush)
+{
+    z_stream stream;
+    int16_t error = ZIP_OK;
+    int ret;
+
+    memset(&stream, 0, sizeof(stream));
+
+    if (deflateInit2(&stream, _zlib_level(compression), Z_DEFLATED,
+                     -MAX_WBITS, DEF_MEM_LEVEL,
+                     _zlib_strategy(compression)) != Z_OK)
+        return LXW_ERROR_MEMORY_MALLOC_FAILED;
+
+    stream.next_in = (Bytef *) data;
+    stream.avail_in = (uInt) size;
+
+    do {
+        stream.next_out = (Bytef *) self->buffer;
+        stream.avail_out = (uInt) self->buffer_size;
+
+        ret = deflate(&stream, flush);
+        if (ret == Z_STREAM_ERROR)
+            break;
+
+        error = zipWriteInFileInZip(self->zipfile, self->buffer,
+                                    (unsigned int) (self->buffer_size -
+                                                    stream.avail_out));
+        if (error < 0)
+            break;
+    } while (stream.avail_out == 0);
+
+    deflateEnd(&stream);
+
+    if (ret == Z_STREAM_ERROR || error < 0) {
+        LXW_ERROR("Error in writing member in the zipfile");
+        RETURN_ON_ZIP_ERROR(error, LXW_ERROR_ZIP_FILE_ADD);
+    }
+
+    return LXW_NO_ERROR;
+}
+
+/*
+ * Get the next block of the deflated worksheet rows, either from the memory
+ * buffer or by reading the tmpfile into the packager buffer.
+ */
+STATIC size_t
+_read_deflated_rows(lxw_packager *self, lxw_deflated_rows *rows,
+                    size_t *position, const char **data)
+{
+    size_t size;
+
+    if (rows->buffer) {
+        size = rows->buffer_size - *position;
+        if (size > self->buffer_size)
+            size = self->buffer_size;
+
+        *data = rows->buffer + *position;
+        *position += size;
+    }
+    else {
+        size = fread((void *) self->buffer, 1, self->buffer_size, rows->file);
+        *data = self->buffer;
+    }
+
+    return size;
+}
+
+/*
+ * Write the deflated worksheet rows unchanged to the current zip member.
+ */
+STATIC lxw_error
+_copy_deflated_rows(lxw_packager *self, lxw_deflated_rows *rows)
+{
+    int16_t error;
+    const char *data;
+    size_t position = 0;
+    size_t size;
+
+    while ((size = _read_deflated_rows(self, rows, &position, &data))) {
+        error = zipWriteInFileInZip(self->zipfile, data, (unsigned int) size);
+
+        if (error < 0) {
+            LXW_ERROR("Error in writing member in the zipfile");
+            RETURN_ON_ZIP_ERROR(error, LXW_ERROR_ZIP_FILE_ADD);
+        }
+    }
+
+    if (!rows->buffer && ferror(rows->file)) {
+        LXW_ERROR("Error reading member file data");
+        return LXW_ERROR_ZIP_FILE_ADD;
+    }
+
+    return LXW_NO_ERROR;
+}
+
+/*
+ * Inflate the deflated worksheet rows and write them to the current zip
+ * member. This is used when the worksheet part compression doesn't match
+ * the settings that the rows were compressed with.
+ */
+STATIC lxw_error
+_inflate_rows_to_zip(lxw_packager *self, lxw_deflated_rows *rows)
+{
+    z_stream stream;
+    unsigned char *output;
+    const char *data;
+    size_t position = 0;
+    size_t size;
+    int16_t error = ZIP_OK;
+    int ret = Z_OK;
+
+    output = malloc(LXW_ZIP_BUFFER_SIZE);
+    RETURN_ON_MEM_ERROR(output, LXW_ERROR_MEMORY_MALLOC_FAILED);
+
+    memset(&stream, 0, sizeof(stream));
+
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+        free(output);
+        return LXW_ERROR_MEMORY_MALLOC_FAILED;
+    }
+
+    while ((size = _read_deflated_rows(self, rows, &position, &data))) {
+        stream.next_in = (Bytef *) data;
+        stream.avail_in = (uInt) size;
+
+        do {
+            stream.next_out = output;
+            stream.avail_out = LXW_ZIP_BUFFER_SIZE;
+
+            ret = inflate(&stream, Z_NO_FLUSH);
+            if (ret != Z_OK && ret != Z_BUF_ERROR)
+                break;
+
+            error = zipWriteInFileInZip(self->zipfile, output,
+                                        LXW_ZIP_BUFFER_SIZE -
+                                        stream.avail_out);
+            if (error < 0)
+                break;
+        } while (stream.avail_out == 0);
+
+        if ((ret != Z_OK && ret != Z_BUF_ERROR) || error < 0)
+            break;
+    }
+
+    inflateEnd(&stream);
+    free(output);
+
+    if ((ret != Z_OK && ret != Z_BUF_ERROR) || error < 0
+        || (!rows->buffer && ferror(rows->file))) {
+        LXW_ERROR("Error in writing member in the zipfile");
+        RETURN_ON_ZIP_ERROR(error, LXW_ERROR_ZIP_FILE_ADD);
+    }
+
+    return LXW_NO_ERROR;
+}
+
+/*
+ * Combine the CRC of a block of data with the CRC of the data before it. The
+ * length is applied in steps since it may not fit in a z_off_t.
+ */
+STATIC uLong
+_crc32_combine_large(uLong crc1, uLong crc2, uint64_t length2)
+{
+    uint64_t step = 1UL << 30;
+
+    while (length2 > step) {
+        crc1 = crc32_combine(crc1, 0, (z_off_t) step);
+        length2 -= step;
+    }
+
+    return crc32_combine(crc1, crc2, (z_off_t) length2);
+}
+
+/*
+ * Write a constant_memory worksheet whose rows were deflated as they were
+ * written. The worksheet XML before and after the rows is deflated around
+ * them and the member is written raw, with a CRC combined from the three
+ * parts. If the part compression differs from the one used for the rows
+ * they are inflated and written through the normal zip member functions.
+ */
+STATIC lxw_error
+_write_worksheet_with_rows(lxw_packager *self, lxw_worksheet *worksheet,
+                           const char *xml, size_t xml_size,
+                           const char *filename)
+{
+    lxw_deflated_rows *rows = worksheet->deflated_rows;
+    lxw_part_compression compression;
+    size_t offset = (size_t) rows->offset;
+    size_t footer_size = xml_size - offset;
+    int16_t error = ZIP_OK;
+    lxw_error err;
+    uLong crc;
+    int raw;
+
+    compression = _get_part_compression(self, filename, LXW_FALSE);
+
+    raw = !compression.store_only
+        && compression.level == rows->level
+        && compression.strategy == rows->strategy;
+
+    fflush(rows->file);
+    if (!rows->buffer)
+        rewind(rows->file);
+
+    err = _open_file_in_zip(self, filename, &compression, raw);
+    RETURN_ON_ERROR(err);
+
+    if (raw) {
+        err = _write_deflated_xml(self, xml, offset, &compression,
+                                  Z_SYNC_FLUSH);
+        RETURN_ON_ERROR(err);
+
+        err = _copy_deflated_rows(self, rows);
+        RETURN_ON_ERROR(err);
+
+        err = _write_deflated_xml(self, xml + offset, footer_size,
+                                  &compression, Z_FINISH);
+        RETURN_ON_ERROR(err);
+
+        crc = crc32(crc32(0L, Z_NULL, 0), (const Bytef *) xml,
+                    (uInt) offset);
+        crc = _crc32_combine_large(crc, rows->crc, rows->uncompressed_size);
+        crc = crc32_combine(crc,
+                            crc32(crc32(0L, Z_NULL, 0),
+                                  (const Bytef *) xml + offset,
+                                  (uInt) footer_size),
+                            (z_off_t) footer_size);
+
+        error = zipCloseFileInZipRaw64(self->zipfile,
+                                       (ZPOS64_T) xml_size +
+                                       rows->uncompressed_size, crc);
+    }
+    else {
+        err = _write_data_to_zip(self, xml, offset);
+        RETURN_ON_ERROR(err);
+
+        err = _inflate_rows_to_zip(self, rows);
+        RETURN_ON_ERROR(err);
+
+        err = _write_data_to_zip(self, xml + offset, footer_size);
+        RETURN_ON_ERROR(err);
+
+        error = zipCloseFileInZip(self->zipfile);
+    }
+
+    if (error != ZIP_OK) {
+        LXW_ERROR("Error in closing member in the zipfile");
+        RETURN_ON_ZIP_ERROR(error, LXW_ERROR_ZIP_FILE_ADD);
+    }
+
+    return LXW_NO_ERROR;
+}
+
+/*
+ * Add a worksheet file to the zip file. Worksheets with rows that were
+ * deflated in constant_memory mode are written directly to the zip file
+ * instead of through the parallel compression queue.
+ */
+STATIC lxw_error
+_add_worksheet_to_zip(lxw_packager *self, lxw_worksheet *worksheet,
+                      char **buffer, size_t *buffer_size,
+                      const char *filename)
+{
+    lxw_deflated_rows *rows = worksheet->deflated_rows;
+    char *file_data = NULL;
+    size_t file_size = 0;
+    lxw_error err;
+
+    if (!rows || !rows->complete)
+        return _add_to_zip(self, worksheet->file, buffer, buffer_size,
+                           filename);
+
+    if (rows->error) {
+        LXW_ERROR("Error compressing worksheet row data");
+        return LXW_ERROR_ZIP_FILE_ADD;
+    }
+
+#ifndef USE_NO_THREADS
+    /* Write the queued parts first to keep the zip file order. */
+    if (self->deflate_pool) {
+        err = _write_deflate_parts(self, LXW_TRUE);
+        RETURN_ON_ERROR(err);
+    }
+#endif
+
+    /* Flush to ensure buffer is updated when using a memory-backed file. */
+    fflush(worksheet->file);
+
+    if (*buffer)
+        return _write_worksheet_with_rows(self, worksheet, *buffer,
+                                          *buffer_size, filename);
+
+    err = _read_file_to_buffer(worksheet->file, &file_data, &file_size);
+    RETURN_ON_ERROR(err);
+
+    err = _write_worksheet_with_rows(self, worksheet, file_data, file_size,
+                                     filename);
+    free(file_data);
+
+    return err;
 }
 
 /*
  * Write the xml files that make up the XLSX OPC package.
  */
-lxw_error
-lxw_create_package(lxw_packager *self)
+STATIC lxw_error
+_write_package_files(lxw_packager *self)
 {
     lxw_error error;
-    int8_t zip_error;
 
     error = _write_content_types_file(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     error = _write_root_rels_file(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     error = _write_workbook_rels_file(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     error = _write_worksheet_files(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     error = _write_chartsheet_files(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     error = _write_workbook_file(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     error = _write_chart_files(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     /* Generate external style files (testing individually) */
     error = _write_chart_style_files(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     /* Generate external color files (testing individually) */
     error = _write_chart_color_files(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     error = _write_drawing_files(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     error = _write_vml_files(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     error = _write_comment_files(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     error = _write_table_files(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     error = _write_shared_strings_file(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     error = _write_custom_file(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     error = _write_theme_file(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     error = _write_styles_file(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     error = _write_worksheet_rels_file(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     error = _write_chartsheet_rels_file(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     error = _write_drawing_rels_file(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     /* Generate chart relationship files (links to style/color files) */
     error = _write_chart_rels_files(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     error = _write_image_files(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     error = _add_vba_project(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     error = _add_vba_project_signature(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     error = _write_vba_project_rels_file(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     error = _write_core_file(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     error = _write_metadata_file(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     error = _write_rich_value_file(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     error = _write_rich_value_rel_file(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     error = _write_rich_value_types_file(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     error = _write_rich_value_structure_file(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     error = _write_rich_value_rels_file(self);
-    RETURN_AND_ZIPCLOSE_ON_ERROR(error);
+    RETURN_ON_ERROR(error);
 
     error = _write_app_file(self);
+    RETURN_ON_ERROR(error);
+
+    return LXW_NO_ERROR;
+}
+
+/*
+ * Create the XLSX OPC package, compressing the parts in parallel if
+ * required, and close the zip file.
+ */
+lxw_error
+lxw_create_package(lxw_packager *self)
+{
+    lxw_error error = LXW_NO_ERROR;
+    int8_t zip_error;
+
+#ifndef USE_NO_THREADS
+    if (self->num_threads > 1)
+        error = _deflate_pool_start(self);
+#endif
+
+    if (!error)
+        error = _write_package_files(self);
+
+#ifndef USE_NO_THREADS
+    if (self->deflate_pool) {
+        if (!error)
+            error = _write_deflate_parts(self, LXW_TRUE);
+
+        _deflate_pool_stop(self);
+    }
+#endif
+
     RETURN_AND_ZIPCLOSE_ON_ERROR(error);
 
     zip_error = zipClose(self->zipfile, NULL);
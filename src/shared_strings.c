@@ -12,18 +12,32 @@
 #include "xlsxwriter/shared_strings.h"
 #include "xlsxwriter/utility.h"
 #include <ctype.h>
+#include <limits.h>
 
-/*
- * Forward declarations.
- */
+/* The initial number of hash table slots. Must be a power of 2. */
+#define LXW_SST_MIN_SLOTS      256
+
+/* The number of elements and string bytes allocated in each block. */
+#define LXW_SST_BLOCK_ELEMENTS 1024
+#define LXW_SST_BLOCK_BYTES    65536
+
+/* The size of the recently used string cache used with temp files. Longer
+ * strings aren't cached. The number of buckets must be a power of 2. */
+#define LXW_SST_LRU_ENTRIES    2048
+#define LXW_SST_LRU_BUCKETS    4096
+#define LXW_SST_LRU_MAX_LENGTH 255
 
-STATIC int _element_cmp(struct sst_element *element1,
-                        struct sst_element *element2);
+#define LXW_SST_BUFFER_SIZE    4096
 
-#ifndef __clang_analyzer__
-LXW_RB_GENERATE_ELEMENT(sst_rb_tree, sst_element, sst_tree_pointers,
-                        _element_cmp);
-#endif
+/*
+ * Header for the blocks used to allocate the elements and strings. The union
+ * keeps the data that follows the header aligned.
+ */
+union lxw_sst_block {
+    union lxw_sst_block *next;
+    double align_double;
+    void *align_pointer;
+};
 
 /*****************************************************************************
  *
@@ -41,9 +55,10 @@ lxw_sst_new(void)
     lxw_sst *sst = calloc(1, sizeof(lxw_sst));
     RETURN_ON_MEM_ERROR(sst, NULL);
 
-    /* Add the sst RB tree. */
-    sst->rb_tree = calloc(1, sizeof(struct sst_rb_tree));
-    GOTO_LABEL_ON_MEM_ERROR(sst->rb_tree, mem_error);
+    /* Add the hash table slots. */
+    sst->slots = calloc(LXW_SST_MIN_SLOTS, sizeof(struct sst_slot));
+    GOTO_LABEL_ON_MEM_ERROR(sst->slots, mem_error);
+    sst->num_slots = LXW_SST_MIN_SLOTS;
 
     /* Add a list for tracking the insertion order. */
     sst->order_list = calloc(1, sizeof(struct sst_order_list));
@@ -52,9 +67,6 @@ lxw_sst_new(void)
     /* Initialize the order list. */
     STAILQ_INIT(sst->order_list);
 
-    /* Initialize the RB tree. */
-    RB_INIT(sst->rb_tree);
-
     return sst;
 
 mem_error:
@@ -68,36 +80,413 @@ mem_error:
 void
 lxw_sst_free(lxw_sst *sst)
 {
-    struct sst_element *sst_element;
-    struct sst_element *sst_element_temp;
+    union lxw_sst_block *block;
+    union lxw_sst_block *next_block;
 
     if (!sst)
         return;
 
-    /* Free the sst_elements and their data using the ordered linked list. */
-    if (sst->order_list) {
-        STAILQ_FOREACH_SAFE(sst_element, sst->order_list, sst_order_pointers,
-                            sst_element_temp) {
-
-            if (sst_element && sst_element->string)
-                free(sst_element->string);
-            if (sst_element)
-                free(sst_element);
-        }
+    /* The elements and their strings are freed with the blocks. */
+    for (block = sst->blocks; block; block = next_block) {
+        next_block = block->next;
+        free(block);
     }
 
+    if (sst->si_file)
+        fclose(sst->si_file);
+    if (sst->key_file)
+        fclose(sst->key_file);
+
+    if (sst->lru_entries)
+        free(sst->lru_entries[0].string);
+
+    free(sst->lru_entries);
+    free(sst->lru_buckets);
+    free(sst->file_slots);
+    free(sst->read_buffer);
     free(sst->order_list);
-    free(sst->rb_tree);
+    free(sst->slots);
     free(sst);
 }
 
 /*
- * Comparator for the element structure
+ * Store the shared strings in temp files instead of in memory. This is used
+ * in constant_memory mode so that the memory used doesn't depend on the
+ * length of the unique strings.
+ */
+lxw_error
+lxw_sst_use_tmpfiles(lxw_sst *sst, const char *tmpdir)
+{
+    char *strings;
+    uint32_t i;
+
+    sst->si_file = lxw_tmpfile(tmpdir);
+    if (!sst->si_file)
+        return LXW_ERROR_CREATING_TMPFILE;
+
+    sst->key_file = lxw_tmpfile(tmpdir);
+    if (!sst->key_file)
+        return LXW_ERROR_CREATING_TMPFILE;
+
+    sst->file_slots = calloc(sst->num_slots, sizeof(struct sst_file_slot));
+    RETURN_ON_MEM_ERROR(sst->file_slots, LXW_ERROR_MEMORY_MALLOC_FAILED);
+
+    sst->lru_entries = calloc(LXW_SST_LRU_ENTRIES,
+                              sizeof(struct sst_lru_entry));
+    RETURN_ON_MEM_ERROR(sst->lru_entries, LXW_ERROR_MEMORY_MALLOC_FAILED);
+
+    sst->lru_buckets = calloc(LXW_SST_LRU_BUCKETS,
+                              sizeof(struct sst_lru_entry *));
+    RETURN_ON_MEM_ERROR(sst->lru_buckets, LXW_ERROR_MEMORY_MALLOC_FAILED);
+
+    /* The cached strings are stored in a single allocation. */
+    strings = malloc(LXW_SST_LRU_ENTRIES * (LXW_SST_LRU_MAX_LENGTH + 1));
+    RETURN_ON_MEM_ERROR(strings, LXW_ERROR_MEMORY_MALLOC_FAILED);
+
+    for (i = 0; i < LXW_SST_LRU_ENTRIES; i++) {
+        sst->lru_entries[i].string = strings;
+        strings += LXW_SST_LRU_MAX_LENGTH + 1;
+    }
+
+    /* The in-memory hash table isn't used. */
+    free(sst->slots);
+    sst->slots = NULL;
+
+    sst->use_tmpfiles = LXW_TRUE;
+
+    return LXW_NO_ERROR;
+}
+
+/*
+ * Calculate the FNV-1a hash of a string and get its length in one pass.
+ */
+STATIC uint32_t
+_hash_string(const char *string, size_t *length)
+{
+    const unsigned char *p = (const unsigned char *) string;
+    uint32_t hash = 2166136261U;
+
+    while (*p) {
+        hash ^= *p++;
+        hash *= 16777619U;
+    }
+
+    *length = (size_t) (p - (const unsigned char *) string);
+
+    return hash;
+}
+
+/*
+ * Calculate the FNV-1a hash of a string of known length.
+ */
+STATIC uint32_t
+_hash_bytes(const char *string, size_t length)
+{
+    const unsigned char *p = (const unsigned char *) string;
+    const unsigned char *end = p + length;
+    uint32_t hash = 2166136261U;
+
+    while (p < end) {
+        hash ^= *p++;
+        hash *= 16777619U;
+    }
+
+    return hash;
+}
+
+/*
+ * Allocate a block of data owned by the table.
+ */
+STATIC void *
+_new_block(lxw_sst *sst, size_t size)
+{
+    union lxw_sst_block *block = malloc(sizeof(union lxw_sst_block) + size);
+    RETURN_ON_MEM_ERROR(block, NULL);
+
+    block->next = sst->blocks;
+    sst->blocks = block;
+
+    return block + 1;
+}
+
+/*
+ * Allocate a new element from the current element block.
  */
-STATIC int
-_element_cmp(struct sst_element *element1, struct sst_element *element2)
+STATIC struct sst_element *
+_new_element(lxw_sst *sst)
 {
-    return strcmp(element1->string, element2->string);
+    if (!sst->elements_free) {
+        sst->element_data = _new_block(sst, LXW_SST_BLOCK_ELEMENTS
+                                       * sizeof(struct sst_element));
+        if (!sst->element_data)
+            return NULL;
+
+        sst->elements_free = LXW_SST_BLOCK_ELEMENTS;
+    }
+
+    sst->elements_free--;
+
+    return sst->element_data++;
+}
+
+/*
+ * Copy a string into the string blocks. Long strings get a block of their
+ * own so that they don't waste the end of the current block.
+ */
+STATIC char *
+_intern_string(lxw_sst *sst, const char *string, size_t length)
+{
+    size_t size = length + 1;
+    char *interned;
+
+    if (size > LXW_SST_BLOCK_BYTES / 4) {
+        interned = _new_block(sst, size);
+    }
+    else {
+        if (size > sst->string_bytes_free) {
+            sst->string_data = _new_block(sst, LXW_SST_BLOCK_BYTES);
+            if (!sst->string_data) {
+                sst->string_bytes_free = 0;
+                return NULL;
+            }
+
+            sst->string_bytes_free = LXW_SST_BLOCK_BYTES;
+        }
+
+        interned = sst->string_data;
+        sst->string_data += size;
+        sst->string_bytes_free -= size;
+    }
+
+    if (!interned)
+        return NULL;
+
+    memcpy(interned, string, length);
+    interned[length] = '\0';
+    sst->string_bytes += size;
+
+    return interned;
+}
+
+/*
+ * Double the number of hash table slots and reinsert the elements using
+ * their cached hashes.
+ */
+STATIC lxw_error
+_grow_slots(lxw_sst *sst)
+{
+    uint32_t num_slots = sst->num_slots * 2;
+    uint32_t mask = num_slots - 1;
+    struct sst_slot *slots;
+    uint32_t i;
+    uint32_t j;
+
+    slots = calloc(num_slots, sizeof(struct sst_slot));
+    RETURN_ON_MEM_ERROR(slots, LXW_ERROR_MEMORY_MALLOC_FAILED);
+
+    for (i = 0; i < sst->num_slots; i++) {
+        if (!sst->slots[i].element)
+            continue;
+
+        j = sst->slots[i].hash & mask;
+        while (slots[j].element)
+            j = (j + 1) & mask;
+
+        slots[j] = sst->slots[i];
+    }
+
+    free(sst->slots);
+    sst->slots = slots;
+    sst->num_slots = num_slots;
+
+    return LXW_NO_ERROR;
+}
+
+/*
+ * Remove an entry from the recently used list.
+ */
+STATIC void
+_lru_unlink(lxw_sst *sst, struct sst_lru_entry *entry)
+{
+    if (entry->prev)
+        entry->prev->next = entry->next;
+    else
+        sst->lru_head = entry->next;
+
+    if (entry->next)
+        entry->next->prev = entry->prev;
+    else
+        sst->lru_tail = entry->prev;
+}
+
+/*
+ * Add an entry to the front of the recently used list.
+ */
+STATIC void
+_lru_push_front(lxw_sst *sst, struct sst_lru_entry *entry)
+{
+    entry->prev = NULL;
+    entry->next = sst->lru_head;
+
+    if (sst->lru_head)
+        sst->lru_head->prev = entry;
+    else
+        sst->lru_tail = entry;
+
+    sst->lru_head = entry;
+}
+
+/*
+ * Find a string in the recently used string cache.
+ */
+STATIC struct sst_lru_entry *
+_lru_find(lxw_sst *sst, const char *string, size_t length, uint32_t hash)
+{
+    struct sst_lru_entry *entry;
+
+    entry = sst->lru_buckets[hash & (LXW_SST_LRU_BUCKETS - 1)];
+
+    while (entry) {
+        if (entry->hash == hash && entry->length == length
+            && memcmp(entry->string, string, length) == 0) {
+
+            if (entry != sst->lru_head) {
+                _lru_unlink(sst, entry);
+                _lru_push_front(sst, entry);
+            }
+
+            return entry;
+        }
+
+        entry = entry->chain;
+    }
+
+    return NULL;
+}
+
+/*
+ * Add a string to the recently used string cache, replacing the least
+ * recently used string if the cache is full.
+ */
+STATIC void
+_lru_add(lxw_sst *sst, const char *string, size_t length, uint32_t hash,
+         uint32_t index)
+{
+    struct sst_lru_entry *entry;
+    struct sst_lru_entry **link;
+
+    if (length > LXW_SST_LRU_MAX_LENGTH)
+        return;
+
+    if (sst->lru_used < LXW_SST_LRU_ENTRIES) {
+        entry = &sst->lru_entries[sst->lru_used++];
+    }
+    else {
+        entry = sst->lru_tail;
+        _lru_unlink(sst, entry);
+
+        /* Remove the old string from its bucket. */
+        link = &sst->lru_buckets[entry->hash & (LXW_SST_LRU_BUCKETS - 1)];
+        while (*link != entry)
+            link = &(*link)->chain;
+
+        *link = entry->chain;
+    }
+
+    memcpy(entry->string, string, length);
+    entry->hash = hash;
+    entry->index = index;
+    entry->length = (uint32_t) length;
+
+    link = &sst->lru_buckets[hash & (LXW_SST_LRU_BUCKETS - 1)];
+    entry->chain = *link;
+    *link = entry;
+
+    _lru_push_front(sst, entry);
+}
+
+/*
+ * Read a string back from the key file.
+ */
+STATIC char *
+_read_key(lxw_sst *sst, struct sst_file_slot *slot)
+{
+    char *buffer;
+
+    if (slot->length > sst->read_buffer_size) {
+        buffer = realloc(sst->read_buffer, slot->length);
+        RETURN_ON_MEM_ERROR(buffer, NULL);
+
+        sst->read_buffer = buffer;
+        sst->read_buffer_size = slot->length;
+    }
+
+    sst->key_file_read = LXW_TRUE;
+
+    if (fseek(sst->key_file, slot->offset, SEEK_SET) != 0)
+        return NULL;
+
+    if (fread(sst->read_buffer, 1, slot->length, sst->key_file)
+        != slot->length)
+        return NULL;
+
+    return sst->read_buffer;
+}
+
+/*
+ * Double the number of temp file hash table slots and reinsert the slots
+ * using their cached hashes. The key file isn't read.
+ */
+STATIC lxw_error
+_grow_file_slots(lxw_sst *sst)
+{
+    uint32_t num_slots = sst->num_slots * 2;
+    uint32_t mask = num_slots - 1;
+    struct sst_file_slot *slots;
+    uint32_t i;
+    uint32_t j;
+
+    slots = calloc(num_slots, sizeof(struct sst_file_slot));
+    RETURN_ON_MEM_ERROR(slots, LXW_ERROR_MEMORY_MALLOC_FAILED);
+
+    for (i = 0; i < sst->num_slots; i++) {
+        if (!sst->file_slots[i].used)
+            continue;
+
+        j = sst->file_slots[i].hash & mask;
+        while (slots[j].used)
+            j = (j + 1) & mask;
+
+        slots[j] = sst->file_slots[i];
+    }
+
+    free(sst->file_slots);
+    sst->file_slots = slots;
+    sst->num_slots = num_slots;
+
+    return LXW_NO_ERROR;
+}
+
+/*
+ * Copy a string of known length to the read buffer and null terminate it.
+ */
+STATIC char *
+_read_buffer_string(lxw_sst *sst, const char *string, size_t length)
+{
+    char *buffer;
+
+    if (length + 1 > sst->read_buffer_size) {
+        buffer = realloc(sst->read_buffer, length + 1);
+        RETURN_ON_MEM_ERROR(buffer, NULL);
+
+        sst->read_buffer = buffer;
+        sst->read_buffer_size = length + 1;
+    }
+
+    memcpy(sst->read_buffer, string, length);
+    sst->read_buffer[length] = '\0';
+
+    return sst->read_buffer;
 }
 
 /*****************************************************************************
@@ -139,14 +528,14 @@ _write_t(lxw_sst *self, char *string)
  * Write the <si> element.
  */
 STATIC void
-_write_si(lxw_sst *self, char *string)
+_write_si(lxw_sst *self, char *string, uint8_t is_validated)
 {
     uint8_t escaped_string = LXW_FALSE;
 
     lxw_xml_start_tag(self->file, "si", NULL);
 
     /* Look for and escape control chars in the string. */
-    if (lxw_has_control_characters(string)) {
+    if (!is_validated && lxw_has_control_characters(string)) {
         string = lxw_escape_control_characters(string);
         escaped_string = LXW_TRUE;
     }
@@ -209,8 +598,28 @@ _write_sst_strings(lxw_sst *self)
         if (sst_element->is_rich_string)
             _write_rich_si(self, sst_element->string);
         else
-            _write_si(self, sst_element->string);
+            _write_si(self, sst_element->string,
+                      sst_element->is_validated);
+
+    }
+}
+
+/*
+ * Copy the sst strings that were written to the si temp file.
+ */
+STATIC void
+_write_sst_tmpfile_strings(lxw_sst *self)
+{
+    char buffer[LXW_SST_BUFFER_SIZE];
+    size_t read_size = 1;
+
+    fflush(self->si_file);
+    rewind(self->si_file);
 
+    while (read_size) {
+        read_size = fread(buffer, 1, LXW_SST_BUFFER_SIZE, self->si_file);
+        /* Ignore return value. There is no easy way to raise error. */
+        (void) fwrite(buffer, 1, read_size, self->file);
     }
 }
 
@@ -227,53 +636,257 @@ lxw_sst_assemble_xml_file(lxw_sst *self)
     _write_sst(self);
 
     /* Write the sst strings. */
-    _write_sst_strings(self);
+    if (self->use_tmpfiles)
+        _write_sst_tmpfile_strings(self);
+    else
+        _write_sst_strings(self);
 
     /* Close the sst tag. */
     lxw_xml_end_tag(self->file, "sst");
 }
 
-/*****************************************************************************
- *
- * Public functions.
- *
- ****************************************************************************/
 /*
- * Add to or find a string in the SST SharedString table and return it's index.
+ * Add to or find a string in the in-memory hash table and return its
+ * element. Static strings are owned by the caller and must be null
+ * terminated.
  */
-struct sst_element *
-lxw_get_sst_index(lxw_sst *sst, const char *string, uint8_t is_rich_string)
+STATIC struct sst_element *
+_get_sst_element(lxw_sst *sst, const char *string, size_t length,
+                 uint32_t hash, uint8_t is_rich_string, uint8_t is_static,
+                 uint8_t is_validated)
 {
     struct sst_element *element;
-    struct sst_element *existing_element;
+    struct sst_slot *slot;
+    uint32_t mask = sst->num_slots - 1;
+    uint32_t i = hash & mask;
+
+    /* Look for the string, comparing the cached hashes first. */
+    while (sst->slots[i].element) {
+        slot = &sst->slots[i];
+
+        if (slot->hash == hash && slot->element->length == length
+            && memcmp(slot->element->string, string, length) == 0) {
+            sst->string_count++;
+            return slot->element;
+        }
+
+        i = (i + 1) & mask;
+    }
+
+    /* Keep the load factor of the hash table under 3/4. */
+    if (sst->unique_count + 1 > sst->num_slots / 4 * 3) {
+        if (_grow_slots(sst) != LXW_NO_ERROR)
+            return NULL;
 
-    /* Create an sst element to potentially add to the table. */
-    element = calloc(1, sizeof(struct sst_element));
+        mask = sst->num_slots - 1;
+        i = hash & mask;
+        while (sst->slots[i].element)
+            i = (i + 1) & mask;
+    }
+
+    /* Create a new element with the string and its index. */
+    element = _new_element(sst);
     if (!element)
         return NULL;
 
-    /* Create potential new element with the string and its index. */
+    /* Static strings are owned by the caller and aren't copied. */
+    if (is_static)
+        element->string = (char *) string;
+    else
+        element->string = _intern_string(sst, string, length);
+
+    if (!element->string) {
+        sst->element_data--;
+        sst->elements_free++;
+        return NULL;
+    }
+
     element->index = sst->unique_count;
-    element->string = lxw_strdup(string);
+    element->length = length;
     element->is_rich_string = is_rich_string;
+    element->is_validated = is_validated;
+
+    sst->slots[i].element = element;
+    sst->slots[i].hash = hash;
 
-    /* Try to insert it and see whether we already have that string. */
-    existing_element = RB_INSERT(sst_rb_tree, sst->rb_tree, element);
+    /* Also add it to the insertion order linked list. */
+    STAILQ_INSERT_TAIL(sst->order_list, element, sst_order_pointers);
+
+    /* Update SST string counts. */
+    sst->string_count++;
+    sst->unique_count++;
+    return element;
+}
 
-    /* If existing_element is not NULL, then it already existed. */
-    /* Free new created element. */
-    if (existing_element) {
-        free(element->string);
-        free(element);
+/*
+ * Add to or find a string in a SST SharedString table that uses temp files
+ * and get its index. Recently used strings are found in memory. Other
+ * strings are found via their hash and then compared with the string in the
+ * key file.
+ */
+STATIC lxw_error
+_get_sst_file_id(lxw_sst *sst, const char *string, size_t length,
+                 uint32_t hash, uint8_t is_rich_string, uint8_t is_validated,
+                 uint32_t *index)
+{
+    struct sst_lru_entry *entry;
+    struct sst_file_slot *slot;
+    const char *key;
+    char *si_string;
+    FILE *file;
+    uint32_t mask = sst->num_slots - 1;
+    uint32_t i = hash & mask;
+    lxw_error err;
+
+    /* Look for the string in the recently used strings. */
+    entry = _lru_find(sst, string, length, hash);
+    if (entry) {
         sst->string_count++;
-        return existing_element;
+        *index = entry->index;
+        return LXW_NO_ERROR;
     }
 
-    /* If it didn't exist, also add it to the insertion order linked list. */
-    STAILQ_INSERT_TAIL(sst->order_list, element, sst_order_pointers);
+    /* Look for the string in the hash table and the key file. */
+    while (sst->file_slots[i].used) {
+        slot = &sst->file_slots[i];
+
+        if (slot->hash == hash && slot->length == length) {
+            key = length ? _read_key(sst, slot) : "";
+            if (!key)
+                return LXW_ERROR_READING_TMPFILE;
+
+            if (memcmp(key, string, length) == 0) {
+                _lru_add(sst, string, length, hash, slot->index);
+                sst->string_count++;
+                *index = slot->index;
+                return LXW_NO_ERROR;
+            }
+        }
+
+        i = (i + 1) & mask;
+    }
+
+    /* The key file offsets are limited to the range of a long. */
+    if ((long) length > LONG_MAX - sst->key_file_size)
+        return LXW_ERROR_SHARED_STRING_INDEX_NOT_FOUND;
+
+    /* Keep the load factor of the hash table under 3/4. */
+    if (sst->unique_count + 1 > sst->num_slots / 4 * 3) {
+        err = _grow_file_slots(sst);
+        RETURN_ON_ERROR(err);
+
+        mask = sst->num_slots - 1;
+        i = hash & mask;
+        while (sst->file_slots[i].used)
+            i = (i + 1) & mask;
+    }
+
+    /* The string may not be null terminated so the si element is written
+     * from a copy of it in the read buffer. */
+    si_string = _read_buffer_string(sst, string, length);
+    if (!si_string)
+        return LXW_ERROR_MEMORY_MALLOC_FAILED;
+
+    /* Append the string to the key file. */
+    if (sst->key_file_read) {
+        if (fseek(sst->key_file, 0, SEEK_END) != 0)
+            return LXW_ERROR_READING_TMPFILE;
+
+        sst->key_file_read = LXW_FALSE;
+    }
+
+    if (fwrite(string, 1, length, sst->key_file) != length)
+        return LXW_ERROR_CREATING_TMPFILE;
+
+    slot = &sst->file_slots[i];
+    slot->offset = sst->key_file_size;
+    slot->hash = hash;
+    slot->index = sst->unique_count;
+    slot->length = (uint32_t) length;
+    slot->used = LXW_TRUE;
+
+    sst->key_file_size += (long) length;
+    sst->string_bytes += length + 1;
+
+    /* Write the si element to its temp file. */
+    file = sst->file;
+    sst->file = sst->si_file;
+
+    if (is_rich_string)
+        _write_rich_si(sst, si_string);
+    else
+        _write_si(sst, si_string, is_validated);
+
+    sst->file = file;
+
+    _lru_add(sst, string, length, hash, slot->index);
 
     /* Update SST string counts. */
+    *index = sst->unique_count;
     sst->string_count++;
     sst->unique_count++;
-    return element;
+    return LXW_NO_ERROR;
+}
+
+/*****************************************************************************
+ *
+ * Public functions.
+ *
+ ****************************************************************************/
+/*
+ * Add to or find a string in the SST SharedString table and return it's index.
+ * Finding a string that is already in the table doesn't allocate any memory.
+ */
+struct sst_element *
+lxw_get_sst_index(lxw_sst *sst, const char *string, uint8_t is_rich_string)
+{
+    size_t length;
+    uint32_t hash = _hash_string(string, &length);
+
+    return _get_sst_element(sst, string, length, hash, is_rich_string,
+                            LXW_FALSE, LXW_FALSE);
+}
+
+/*
+ * Add to or find a string of known length in the SST SharedString table. The
+ * string doesn't have to be null terminated unless it is static, in which
+ * case it isn't copied and must outlive the table.
+ */
+struct sst_element *
+lxw_get_sst_index_len(lxw_sst *sst, const char *string, size_t length,
+                      uint8_t is_static, uint8_t is_validated)
+{
+    uint32_t hash = _hash_bytes(string, length);
+
+    return _get_sst_element(sst, string, length, hash, LXW_FALSE, is_static,
+                            is_validated);
+}
+
+/*
+ * Add to or find a string in a SST SharedString table that uses temp files
+ * and get its index.
+ */
+lxw_error
+lxw_get_sst_id(lxw_sst *sst, const char *string, uint8_t is_rich_string,
+               uint32_t *index)
+{
+    size_t length;
+    uint32_t hash = _hash_string(string, &length);
+
+    return _get_sst_file_id(sst, string, length, hash, is_rich_string,
+                            LXW_FALSE, index);
+}
+
+/*
+ * Add to or find a string of known length, which doesn't have to be null
+ * terminated, in a SST SharedString table that uses temp files.
+ */
+lxw_error
+lxw_get_sst_id_len(lxw_sst *sst, const char *string, size_t length,
+                   uint8_t is_validated, uint32_t *index)
+{
+    uint32_t hash = _hash_bytes(string, length);
+
+    return _get_sst_file_id(sst, string, length, hash, LXW_FALSE,
+                            is_validated, index);
 }
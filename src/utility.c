@@ -21,10 +21,6 @@
 #include "xlsxwriter/common.h"
 #include "xlsxwriter/third_party/tmpfileplus.h"
 
-#ifdef USE_DTOA_LIBRARY
-#include "xlsxwriter/third_party/emyg_dtoa.h"
-#endif
-
 char *error_strings[LXW_MAX_ERRNO + 1] = {
     "No error.",
     "Memory error, failed to malloc() required memory.",
@@ -696,18 +692,999 @@ lxw_get_filehandle(char **buf, size_t *size, const char *tmpdir)
 #endif
 }
 
+/*****************************************************************************
+ *
+ * Double to string conversion.
+ *
+ * Doubles are converted to the shortest decimal string that converts back to
+ * the same value, using the Ryu algorithm from Ulf Adams, "Ryu: fast
+ * float-to-string conversion", PLDI 2018. The string is formatted like
+ * sprintf() "%.16G" but is independent of the C library locale.
+ *
+ ****************************************************************************/
+
+#define LXW_UINT64(high, low)  (((uint64_t) (high) << 32) | (uint64_t) (low))
+#define LXW_DBL_MANTISSA_BITS  52
+#define LXW_DBL_BIAS           1023
+#define LXW_POW5_INV_BITCOUNT  125
+#define LXW_POW5_BITCOUNT      125
+
+/* 2^(pow5bits(q) + 124) / 5^q + 1, as {low, high} 64 bit words. */
+static const uint64_t lxw_pow5_inv_split[292][2] = {
+    {LXW_UINT64(0x00000000, 0x00000001), LXW_UINT64(0x20000000, 0x00000000)},
+    {LXW_UINT64(0x99999999, 0x9999999A), LXW_UINT64(0x19999999, 0x99999999)},
+    {LXW_UINT64(0x47AE147A, 0xE147AE15), LXW_UINT64(0x147AE147, 0xAE147AE1)},
+    {LXW_UINT64(0x6C8B4395, 0x810624DE), LXW_UINT64(0x10624DD2, 0xF1A9FBE7)},
+    {LXW_UINT64(0x7A786C22, 0x6809D496), LXW_UINT64(0x1A36E2EB, 0x1C432CA5)},
+    {LXW_UINT64(0x61F9F01B, 0x866E43AB), LXW_UINT64(0x14F8B588, 0xE368F084)},
+    {LXW_UINT64(0xB4C7F349, 0x38583622), LXW_UINT64(0x10C6F7A0, 0xB5ED8D36)},
+    {LXW_UINT64(0x87A6520E, 0xC08D236A), LXW_UINT64(0x1AD7F29A, 0xBCAF4857)},
+    {LXW_UINT64(0x9FB841A5, 0x66D74F88), LXW_UINT64(0x15798EE2, 0x308C39DF)},
+    {LXW_UINT64(0xE62D0151, 0x1F12A607), LXW_UINT64(0x112E0BE8, 0x26D694B2)},
+    {LXW_UINT64(0xD6AE6881, 0xCB5109A4), LXW_UINT64(0x1B7CDFD9, 0xD7BDBAB7)},
+    {LXW_UINT64(0xDEF1ED34, 0xA2A73AEA), LXW_UINT64(0x15FD7FE1, 0x7964955F)},
+    {LXW_UINT64(0x7F27F0F6, 0xE885C8BB), LXW_UINT64(0x11979981, 0x2DEA1119)},
+    {LXW_UINT64(0x650CB4BE, 0x40D60DF8), LXW_UINT64(0x1C25C268, 0x497681C2)},
+    {LXW_UINT64(0xEA709098, 0x33DE7193), LXW_UINT64(0x16849B86, 0xA12B9B01)},
+    {LXW_UINT64(0x21F3A6E0, 0x297EC143), LXW_UINT64(0x1203AF9E, 0xE756159B)},
+    {LXW_UINT64(0x6985D7CD, 0x0F313537), LXW_UINT64(0x1CD2B297, 0xD889BC2B)},
+    {LXW_UINT64(0x2137DFD7, 0x3F5A90F9), LXW_UINT64(0x170EF546, 0x46D49689)},
+    {LXW_UINT64(0xE75FE645, 0xCC4873FA), LXW_UINT64(0x12725DD1, 0xD243ABA0)},
+    {LXW_UINT64(0xA5663D3C, 0x7A0D865D), LXW_UINT64(0x1D83C94F, 0xB6D2AC34)},
+    {LXW_UINT64(0x511E9763, 0x94D79EB1), LXW_UINT64(0x179CA10C, 0x9242235D)},
+    {LXW_UINT64(0xDA7EDF82, 0xDD794BC1), LXW_UINT64(0x12E3B40A, 0x0E9B4F7D)},
+    {LXW_UINT64(0x2A6498D1, 0x625BAC68), LXW_UINT64(0x1E392010, 0x175EE596)},
+    {LXW_UINT64(0xEEB6E0A7, 0x81E2F053), LXW_UINT64(0x182DB340, 0x12B25144)},
+    {LXW_UINT64(0x58924D52, 0xCE4F26A9), LXW_UINT64(0x1357C299, 0xA88EA76A)},
+    {LXW_UINT64(0x27507BB7, 0xB07EA441), LXW_UINT64(0x1EF2D0F5, 0xDA7DD8AA)},
+    {LXW_UINT64(0x52A6C95F, 0xC0655034), LXW_UINT64(0x18C240C4, 0xAECB13BB)},
+    {LXW_UINT64(0x0EEBD44C, 0x99EAA690), LXW_UINT64(0x13CE9A36, 0xF23C0FC9)},
+    {LXW_UINT64(0xB17953AD, 0xC3110A80), LXW_UINT64(0x1FB0F6BE, 0x50601941)},
+    {LXW_UINT64(0xC12DDC8B, 0x02740867), LXW_UINT64(0x195A5EFE, 0xA6B34767)},
+    {LXW_UINT64(0x3424B06F, 0x3529A052), LXW_UINT64(0x14484BFE, 0xEBC29F86)},
+    {LXW_UINT64(0x901D59F2, 0x90EE19DB), LXW_UINT64(0x1039D665, 0x89687F9E)},
+    {LXW_UINT64(0x4CFBC31D, 0xB4B0295F), LXW_UINT64(0x19F623D5, 0xA8A73297)},
+    {LXW_UINT64(0x3D9635B1, 0x5D59BAB2), LXW_UINT64(0x14C4E977, 0xBA1F5BAC)},
+    {LXW_UINT64(0x97AB5E27, 0x7DE16228), LXW_UINT64(0x109D8792, 0xFB4C4956)},
+    {LXW_UINT64(0xF2ABC9D8, 0xC9689D0D), LXW_UINT64(0x1A95A5B7, 0xF87A0EF0)},
+    {LXW_UINT64(0x5BBCA17A, 0x3ABA173E), LXW_UINT64(0x15448493, 0x2D2E725A)},
+    {LXW_UINT64(0xAFCA1AC8, 0x2EFB45CB), LXW_UINT64(0x11039D42, 0x8A8B8EAE)},
+    {LXW_UINT64(0xB2DCF7A6, 0xB1920945), LXW_UINT64(0x1B38FB9D, 0xAA78E44A)},
+    {LXW_UINT64(0xF57D92EB, 0xC141A104), LXW_UINT64(0x15C72FB1, 0x552D836E)},
+    {LXW_UINT64(0xC4647589, 0x6767B403), LXW_UINT64(0x116C2627, 0x77579C58)},
+    {LXW_UINT64(0x6D6D88DB, 0xD8A5ECD2), LXW_UINT64(0x1BE03D0B, 0xF225C6F4)},
+    {LXW_UINT64(0x8ABE0716, 0x46EB23DB), LXW_UINT64(0x164CFDA3, 0x281E38C3)},
+    {LXW_UINT64(0x6EFE6C11, 0xD255B649), LXW_UINT64(0x11D7314F, 0x534B609C)},
+    {LXW_UINT64(0xB197134F, 0xB6EF8A0E), LXW_UINT64(0x1C8B8218, 0x85456760)},
+    {LXW_UINT64(0x27AC0F72, 0xF8BFA1A5), LXW_UINT64(0x16D601AD, 0x376AB91A)},
+    {LXW_UINT64(0xB95672C2, 0x60994E1E), LXW_UINT64(0x1244CE24, 0x2C5560E1)},
+    {LXW_UINT64(0xF5571E03, 0xCDC21695), LXW_UINT64(0x1D3AE36D, 0x13BBCE35)},
+    {LXW_UINT64(0x2AAC1803, 0x0B01ABAB), LXW_UINT64(0x17624F8A, 0x762FD82B)},
+    {LXW_UINT64(0xBBBCE002, 0x6F348956), LXW_UINT64(0x12B50C6E, 0xC4F31355)},
+    {LXW_UINT64(0x92C7CCD0, 0xB1EDA889), LXW_UINT64(0x1DEE7A4A, 0xD4B81EEF)},
+    {LXW_UINT64(0xDBD30A40, 0x8E57BA07), LXW_UINT64(0x17F1FB6F, 0x10934BF2)},
+    {LXW_UINT64(0x7CA8D500, 0x71DFC806), LXW_UINT64(0x1327FC58, 0xDA0F6FF5)},
+    {LXW_UINT64(0xFAA7BB33, 0xE9660CD6), LXW_UINT64(0x1EA6608E, 0x29B24CBB)},
+    {LXW_UINT64(0x9552FC29, 0x8784D711), LXW_UINT64(0x18851A0B, 0x548EA3C9)},
+    {LXW_UINT64(0xAAA8C9BA, 0xD2D0AC0E), LXW_UINT64(0x139DAE6F, 0x76D88307)},
+    {LXW_UINT64(0xDDDADC5E, 0x1E1AACE3), LXW_UINT64(0x1F62B0B2, 0x57C0D1A5)},
+    {LXW_UINT64(0x7E48B04B, 0x4B488A4F), LXW_UINT64(0x191BC08E, 0xAC9A4151)},
+    {LXW_UINT64(0xCB6D59D5, 0xD5D3A1D9), LXW_UINT64(0x141633A5, 0x56E1CDDA)},
+    {LXW_UINT64(0x3C577B11, 0x77DC817B), LXW_UINT64(0x1011C2EA, 0xABE7D7E2)},
+    {LXW_UINT64(0xC6F25E82, 0x5960CF2A), LXW_UINT64(0x19B604AA, 0xACA62636)},
+    {LXW_UINT64(0x6BF51868, 0x4780A5BB), LXW_UINT64(0x14919D55, 0x56EB51C5)},
+    {LXW_UINT64(0x232A79ED, 0x06008496), LXW_UINT64(0x10747DDD, 0xDF22A7D1)},
+    {LXW_UINT64(0xD1DD8FE1, 0xA3340756), LXW_UINT64(0x1A53FC96, 0x31D10C81)},
+    {LXW_UINT64(0xA7E4731A, 0xE8F66C45), LXW_UINT64(0x150FFD44, 0xF4A73D34)},
+    {LXW_UINT64(0x531D28E2, 0x53F8569E), LXW_UINT64(0x10D9976A, 0x5D52975D)},
+    {LXW_UINT64(0xEB61DB03, 0xB98D5762), LXW_UINT64(0x1AF5BF10, 0x9550F22E)},
+    {LXW_UINT64(0xBC4E48CF, 0xC7A445E8), LXW_UINT64(0x159165A6, 0xDDDA5B58)},
+    {LXW_UINT64(0x6371D3D9, 0x6C836B20), LXW_UINT64(0x11411E1F, 0x17E1E2AD)},
+    {LXW_UINT64(0x9F1C8628, 0xAD9F11CD), LXW_UINT64(0x1B9B6364, 0xF3030448)},
+    {LXW_UINT64(0xE5B06B53, 0xBE18DB0B), LXW_UINT64(0x1615E91D, 0x8F359D06)},
+    {LXW_UINT64(0xEAF3890F, 0xCB4715A2), LXW_UINT64(0x11AB20E4, 0x72914A6B)},
+    {LXW_UINT64(0x44B8DB4C, 0x7871BC37), LXW_UINT64(0x1C45016D, 0x841BAA46)},
+    {LXW_UINT64(0x03C715D6, 0xC6C1635F), LXW_UINT64(0x169D9ABE, 0x03495505)},
+    {LXW_UINT64(0x3638DE45, 0x6BCDE919), LXW_UINT64(0x1217AEFE, 0x69077737)},
+    {LXW_UINT64(0x56C163A2, 0x461641C1), LXW_UINT64(0x1CF2B197, 0x0E725858)},
+    {LXW_UINT64(0xDF011C81, 0xD1AB67CE), LXW_UINT64(0x17288E12, 0x71F51379)},
+    {LXW_UINT64(0x7F3416CE, 0x4155ECA5), LXW_UINT64(0x1286D80E, 0xC190DC61)},
+    {LXW_UINT64(0x6520247D, 0x3556476E), LXW_UINT64(0x1DA48CE4, 0x68E7C702)},
+    {LXW_UINT64(0xEA801D30, 0xF7783925), LXW_UINT64(0x17B6D71D, 0x20B96C01)},
+    {LXW_UINT64(0xBB99B0F3, 0xF92CFA84), LXW_UINT64(0x12F8AC17, 0x4D612334)},
+    {LXW_UINT64(0x5F5C4E53, 0x2847F739), LXW_UINT64(0x1E5AACF2, 0x15683854)},
+    {LXW_UINT64(0x7F7D0B75, 0xB9D32C2E), LXW_UINT64(0x18488A5B, 0x44536043)},
+    {LXW_UINT64(0x9930D5F7, 0xC7DC2358), LXW_UINT64(0x136D3B7C, 0x36A919CF)},
+    {LXW_UINT64(0x8EB4898C, 0x72F9D226), LXW_UINT64(0x1F152BF9, 0xF10E8FB2)},
+    {LXW_UINT64(0x722A07A3, 0x8F2E41B8), LXW_UINT64(0x18DDBCC7, 0xF40BA628)},
+    {LXW_UINT64(0xC1BB394F, 0xA5BE9AFA), LXW_UINT64(0x13E49706, 0x5CD61E86)},
+    {LXW_UINT64(0x9C5EC219, 0x0930F7F6), LXW_UINT64(0x1FD424D6, 0xFAF030D7)},
+    {LXW_UINT64(0x49E56814, 0x075A5FF8), LXW_UINT64(0x197683DF, 0x2F268D79)},
+    {LXW_UINT64(0x6E512010, 0x05E1E660), LXW_UINT64(0x145ECFE5, 0xBF520AC7)},
+    {LXW_UINT64(0xF1DA800C, 0xD181851A), LXW_UINT64(0x104BD984, 0x990E6F05)},
+    {LXW_UINT64(0x4FC40014, 0x8268D4F5), LXW_UINT64(0x1A12F5A0, 0xF4E3E4D6)},
+    {LXW_UINT64(0xD96999AA, 0x01ED772B), LXW_UINT64(0x14DBF7B3, 0xF71CB711)},
+    {LXW_UINT64(0xADEE1488, 0x018AC5BC), LXW_UINT64(0x10AFF95C, 0xC5B09274)},
+    {LXW_UINT64(0x497CEDA6, 0x68DE092C), LXW_UINT64(0x1AB32894, 0x6F80EA54)},
+    {LXW_UINT64(0x3ACA57B8, 0x53E4D424), LXW_UINT64(0x155C2076, 0xBF9A5510)},
+    {LXW_UINT64(0x623B7960, 0x431D7683), LXW_UINT64(0x1116805E, 0xFFAEAA73)},
+    {LXW_UINT64(0x9D2BF566, 0xD1C8BD9E), LXW_UINT64(0x1B5733CB, 0x32B110B8)},
+    {LXW_UINT64(0x7DBCC452, 0x416D647F), LXW_UINT64(0x15DF5CA2, 0x8EF40D60)},
+    {LXW_UINT64(0xCAFD69DB, 0x678AB6CC), LXW_UINT64(0x117F7D4E, 0xD8C33DE6)},
+    {LXW_UINT64(0xAB2F0FC5, 0x72778ADF), LXW_UINT64(0x1BFF2EE4, 0x8E052FD7)},
+    {LXW_UINT64(0x88F27304, 0x5B92D580), LXW_UINT64(0x1665BF1D, 0x3E6A8CAC)},
+    {LXW_UINT64(0xD3F528D0, 0x49424466), LXW_UINT64(0x11EAFF4A, 0x98553D56)},
+    {LXW_UINT64(0xB988414D, 0x4203A0A3), LXW_UINT64(0x1CAB3210, 0xF3BB9557)},
+    {LXW_UINT64(0x6139CDD7, 0x6802E6E9), LXW_UINT64(0x16EF5B40, 0xC2FC7779)},
+    {LXW_UINT64(0xE7617179, 0x20025254), LXW_UINT64(0x125915CD, 0x68C9F92D)},
+    {LXW_UINT64(0xA568B58E, 0x999D5086), LXW_UINT64(0x1D5B5615, 0x74765B7C)},
+    {LXW_UINT64(0x5120913E, 0xE14AA6D2), LXW_UINT64(0x177C44DD, 0xF6C515FD)},
+    {LXW_UINT64(0xA74D40FF, 0x1AA21F0E), LXW_UINT64(0x12C9D0B1, 0x923744CA)},
+    {LXW_UINT64(0x0BAECE64, 0xF769CB4A), LXW_UINT64(0x1E0FB44F, 0x50586E11)},
+    {LXW_UINT64(0x3C8BD850, 0xC5EE3C3B), LXW_UINT64(0x180C903F, 0x7379F1A7)},
+    {LXW_UINT64(0xCA0979DA, 0x37F1C9C9), LXW_UINT64(0x133D4032, 0xC2C7F485)},
+    {LXW_UINT64(0xA9A8C2F6, 0xBFE942DB), LXW_UINT64(0x1EC866B7, 0x9E0CBA6F)},
+    {LXW_UINT64(0x2153CF2B, 0xCCBA9BE3), LXW_UINT64(0x18A0522C, 0x7E709526)},
+    {LXW_UINT64(0x1AA97289, 0x70954982), LXW_UINT64(0x13B374F0, 0x6526DDB8)},
+    {LXW_UINT64(0xF775840F, 0x1A88759D), LXW_UINT64(0x1F8587E7, 0x083E2F8C)},
+    {LXW_UINT64(0x5F913672, 0x7BA05E17), LXW_UINT64(0x19379FEC, 0x0698260A)},
+    {LXW_UINT64(0x1940F85B, 0x9619E4DF), LXW_UINT64(0x142C7FF0, 0x054684D5)},
+    {LXW_UINT64(0xE100C6AF, 0xAB47EA4C), LXW_UINT64(0x1023998C, 0xD1053710)},
+    {LXW_UINT64(0xCE67A44C, 0x453FDD47), LXW_UINT64(0x19D28F47, 0xB4D524E7)},
+    {LXW_UINT64(0xD852E9D6, 0x9DCCB106), LXW_UINT64(0x14A8729F, 0xC3DDB71F)},
+    {LXW_UINT64(0x79DBEE45, 0x4B0A2738), LXW_UINT64(0x1086C219, 0x697E2C19)},
+    {LXW_UINT64(0x295FE3A2, 0x11A9D859), LXW_UINT64(0x1A71368F, 0x0F30468F)},
+    {LXW_UINT64(0xBAB31C81, 0xA7BB137A), LXW_UINT64(0x15275ED8, 0xD8F36BA5)},
+    {LXW_UINT64(0x6228E39A, 0xEC95A92F), LXW_UINT64(0x10EC4BE0, 0xAD8F8951)},
+    {LXW_UINT64(0x9D0E38F7, 0xE0EF7517), LXW_UINT64(0x1B13AC9A, 0xAF4C0EE8)},
+    {LXW_UINT64(0xB0D82D93, 0x1A592A79), LXW_UINT64(0x15A956E2, 0x25D67253)},
+    {LXW_UINT64(0x8D79BE0F, 0x4847552E), LXW_UINT64(0x11544581, 0xB7DEC1DC)},
+    {LXW_UINT64(0x158F967E, 0xDA0BBB7C), LXW_UINT64(0x1BBA08CF, 0x8C979C94)},
+    {LXW_UINT64(0x77A611FF, 0x14D62F97), LXW_UINT64(0x162E6D72, 0xD6DFB076)},
+    {LXW_UINT64(0xF951A7FF, 0x43DE8C79), LXW_UINT64(0x11BEBDF5, 0x78B2F391)},
+    {LXW_UINT64(0xC21C3FFE, 0xD2FDAD8E), LXW_UINT64(0x1C646322, 0x5AB7EC1C)},
+    {LXW_UINT64(0x01B03332, 0x42648AD8), LXW_UINT64(0x16B6B5B5, 0x155FF017)},
+    {LXW_UINT64(0x0159C28E, 0x9B83A246), LXW_UINT64(0x122BC490, 0xDDE659AC)},
+    {LXW_UINT64(0xCEF60417, 0x5F3903A3), LXW_UINT64(0x1D12D41A, 0xFCA3C2AC)},
+    {LXW_UINT64(0x725E69AC, 0x4C2D9C83), LXW_UINT64(0x17424348, 0xCA1C9BBD)},
+    {LXW_UINT64(0xF5185489, 0xD68AE39C), LXW_UINT64(0x129B6907, 0x0816E2FD)},
+    {LXW_UINT64(0xEE8D540F, 0xBDAB05C6), LXW_UINT64(0x1DC574D8, 0x0CF16B2F)},
+    {LXW_UINT64(0xBED77672, 0xFE226B05), LXW_UINT64(0x17D12A46, 0x70C1228C)},
+    {LXW_UINT64(0xFF12C528, 0xCB4EBC04), LXW_UINT64(0x130DBB6B, 0x8D674ED6)},
+    {LXW_UINT64(0xCB513B74, 0x787DF9A0), LXW_UINT64(0x1E7C5F12, 0x7BD87E24)},
+    {LXW_UINT64(0x090DC929, 0xF9FE614D), LXW_UINT64(0x18637F41, 0xFCAD31B7)},
+    {LXW_UINT64(0xA0D7D421, 0x94CB810A), LXW_UINT64(0x1382CC34, 0xCA2427C5)},
+    {LXW_UINT64(0x67BFB9CF, 0x5478CE77), LXW_UINT64(0x1F37AD21, 0x436D0C6F)},
+    {LXW_UINT64(0x1FCC94A5, 0xDD2D71F9), LXW_UINT64(0x18F9574D, 0xCF8A7059)},
+    {LXW_UINT64(0x7FD6DD51, 0x7DBDF4C7), LXW_UINT64(0x13FAAC3E, 0x3FA1F37A)},
+    {LXW_UINT64(0xFFBE2EE8, 0xC92FEE0B), LXW_UINT64(0x1FF779FD, 0x329CB8C3)},
+    {LXW_UINT64(0x6631BF20, 0xA0F324D6), LXW_UINT64(0x1992C7FD, 0xC216FA36)},
+    {LXW_UINT64(0xB827CC1A, 0x1A5C1D78), LXW_UINT64(0x14756CCB, 0x01ABFB5E)},
+    {LXW_UINT64(0x935309AE, 0x7B7CE460), LXW_UINT64(0x105DF0A2, 0x67BCC918)},
+    {LXW_UINT64(0x1EEB42B0, 0xC594A099), LXW_UINT64(0x1A2FE76A, 0x3F9474F4)},
+    {LXW_UINT64(0xE5890227, 0x0476E6E1), LXW_UINT64(0x14F31F88, 0x32DD2A5C)},
+    {LXW_UINT64(0xB7A0CE85, 0x9D2BEBE7), LXW_UINT64(0x10C27FA0, 0x28B0EEB0)},
+    {LXW_UINT64(0x59014A6F, 0x61DFDFD8), LXW_UINT64(0x1AD0CC33, 0x744E4AB4)},
+    {LXW_UINT64(0xE0CDD525, 0xE7E64CAD), LXW_UINT64(0x1573D68F, 0x903EA229)},
+    {LXW_UINT64(0x4D717751, 0x8651D6F1), LXW_UINT64(0x11297872, 0xD9CBB4EE)},
+    {LXW_UINT64(0x7BE8BEE8, 0xD6E957E8), LXW_UINT64(0x1B758D84, 0x8FAC54B0)},
+    {LXW_UINT64(0xFCBA3253, 0xDF211320), LXW_UINT64(0x15F7A46A, 0x0C89DD59)},
+    {LXW_UINT64(0x63C82843, 0x18E74280), LXW_UINT64(0x1192E9EE, 0x706E4AAE)},
+    {LXW_UINT64(0x060D0D38, 0x27D86A66), LXW_UINT64(0x1C1E4317, 0x1A4A1117)},
+    {LXW_UINT64(0x6B3DA42C, 0xECAD21EB), LXW_UINT64(0x167E9C12, 0x7B6E7412)},
+    {LXW_UINT64(0x88FE1CF0, 0xBD574E56), LXW_UINT64(0x11FEE341, 0xFC585CDB)},
+    {LXW_UINT64(0x419694B4, 0x62254A23), LXW_UINT64(0x1CCB0536, 0x608D615F)},
+    {LXW_UINT64(0x67ABAA29, 0xE81DD4E9), LXW_UINT64(0x1708D0F8, 0x4D3DE77F)},
+    {LXW_UINT64(0xB95621BB, 0x2017DD87), LXW_UINT64(0x126D73F9, 0xD764B932)},
+    {LXW_UINT64(0xC223692B, 0x668C95A5), LXW_UINT64(0x1D7BECC2, 0xF23AC1EA)},
+    {LXW_UINT64(0xCE82BA89, 0x1ED6DE1D), LXW_UINT64(0x17965702, 0x5B6234BB)},
+    {LXW_UINT64(0xA5356207, 0x4BDF1818), LXW_UINT64(0x12DEAC01, 0xE2B4F6FC)},
+    {LXW_UINT64(0x3B889CD8, 0x7964F359), LXW_UINT64(0x1E311336, 0x3787F194)},
+    {LXW_UINT64(0xFC6D4A46, 0xC783F5E1), LXW_UINT64(0x18274291, 0xC6065ADC)},
+    {LXW_UINT64(0x30576E9F, 0x06032B1A), LXW_UINT64(0x13529BA7, 0xD19EAF17)},
+    {LXW_UINT64(0x1A257DCB, 0x3CD1DE90), LXW_UINT64(0x1EEA92A6, 0x1C311825)},
+    {LXW_UINT64(0x481DFE3C, 0x30A7E540), LXW_UINT64(0x18BBA884, 0xE35A79B7)},
+    {LXW_UINT64(0xD34B31C9, 0xC0865100), LXW_UINT64(0x13C9539D, 0x82AEC7C5)},
+    {LXW_UINT64(0x5211E942, 0xCDA3B4CD), LXW_UINT64(0x1FA885C8, 0xD117A609)},
+    {LXW_UINT64(0x74DB2102, 0x3E1C90A4), LXW_UINT64(0x19539E3A, 0x40DFB807)},
+    {LXW_UINT64(0xF715B401, 0xCB4A0D50), LXW_UINT64(0x1442E4FB, 0x67196005)},
+    {LXW_UINT64(0xF8DE299B, 0x09080AA7), LXW_UINT64(0x103583FC, 0x527AB337)},
+    {LXW_UINT64(0x8E304291, 0xA80CDDD7), LXW_UINT64(0x19EF3993, 0xB72AB859)},
+    {LXW_UINT64(0x3E8D020E, 0x200A4B13), LXW_UINT64(0x14BF6142, 0xF8EEF9E1)},
+    {LXW_UINT64(0x653D9B3E, 0x80083C0F), LXW_UINT64(0x10991A9B, 0xFA58C7E7)},
+    {LXW_UINT64(0x6EC8F864, 0x000D2CE4), LXW_UINT64(0x1A8E90F9, 0x908E0CA5)},
+    {LXW_UINT64(0x8BD3F9E9, 0x99A423EA), LXW_UINT64(0x153EDA61, 0x4071A3B7)},
+    {LXW_UINT64(0x3CA994BA, 0xE1501CBB), LXW_UINT64(0x10FF151A, 0x99F482F9)},
+    {LXW_UINT64(0xC775BAC4, 0x9BB3612B), LXW_UINT64(0x1B31BB5D, 0xC320D18E)},
+    {LXW_UINT64(0xD2C4956A, 0x16291A89), LXW_UINT64(0x15C162B1, 0x68E70E0B)},
+    {LXW_UINT64(0xDBD07788, 0x11BA7BA1), LXW_UINT64(0x11678227, 0x871F3E6F)},
+    {LXW_UINT64(0x2C80BF40, 0x1C5D929B), LXW_UINT64(0x1BD8D03F, 0x3E9863E6)},
+    {LXW_UINT64(0xBD33CC33, 0x49E47549), LXW_UINT64(0x16470CFF, 0x6546B651)},
+    {LXW_UINT64(0xCA8FD68F, 0x6E505DD4), LXW_UINT64(0x11D270CC, 0x51055EA7)},
+    {LXW_UINT64(0x4419574B, 0xE3B3C953), LXW_UINT64(0x1C83E7AD, 0x4E6EFDD9)},
+    {LXW_UINT64(0x03477909, 0x82F63AA9), LXW_UINT64(0x16CFEC8A, 0xA52597E1)},
+    {LXW_UINT64(0xCF6C60D4, 0x68C4FBBA), LXW_UINT64(0x123FF06E, 0xEA847980)},
+    {LXW_UINT64(0xE57A3487, 0x0E07F92A), LXW_UINT64(0x1D331A4B, 0x10D3F59A)},
+    {LXW_UINT64(0x512E906C, 0x0B399422), LXW_UINT64(0x175C1508, 0xDA432AE2)},
+    {LXW_UINT64(0xDA8BA6BC, 0xD5C7A9B5), LXW_UINT64(0x12B010D3, 0xE1CF5581)},
+    {LXW_UINT64(0x90DF712E, 0x22D90F87), LXW_UINT64(0x1DE68153, 0x02E5559C)},
+    {LXW_UINT64(0xDA4C5A8B, 0x4F140C6C), LXW_UINT64(0x17EB9AA8, 0xCF1DDE16)},
+    {LXW_UINT64(0xAEA37BA2, 0xA5A9A38A), LXW_UINT64(0x1322E220, 0xA5B17E78)},
+    {LXW_UINT64(0x7DD25F6A, 0xA2A905A9), LXW_UINT64(0x1E9E369A, 0xA2B59727)},
+    {LXW_UINT64(0x97DB7F88, 0x8220D154), LXW_UINT64(0x187E9215, 0x4EF7AC1F)},
+    {LXW_UINT64(0x797C6606, 0xCE80A777), LXW_UINT64(0x139874DD, 0xD8C6234C)},
+    {LXW_UINT64(0x8F2D700A, 0xE4010BF1), LXW_UINT64(0x1F5A5496, 0x27A36BAD)},
+    {LXW_UINT64(0x0C2459A2, 0x5000D65A), LXW_UINT64(0x19151078, 0x1FB5EFBE)},
+    {LXW_UINT64(0x701D1481, 0xD99A4515), LXW_UINT64(0x1410D9F9, 0xB2F7F2FE)},
+    {LXW_UINT64(0xC017439B, 0x147B6A77), LXW_UINT64(0x100D7B2E, 0x28C65BFE)},
+    {LXW_UINT64(0xCCF205C4, 0xED9243F2), LXW_UINT64(0x19AF2B7D, 0x0E0A2CCA)},
+    {LXW_UINT64(0x0A5B37D0, 0xBE0E9CC2), LXW_UINT64(0x148C22CA, 0x71A1BD6F)},
+    {LXW_UINT64(0x0848F973, 0xCB3EE3CE), LXW_UINT64(0x10701BD5, 0x27B4978C)},
+    {LXW_UINT64(0xDA0E5BEC, 0x78649FB0), LXW_UINT64(0x1A4CF955, 0x0C5425AC)},
+    {LXW_UINT64(0x7B3EAFF0, 0x60507FC0), LXW_UINT64(0x150A6110, 0xD6A9B7BD)},
+    {LXW_UINT64(0x95CBBFF3, 0x80406633), LXW_UINT64(0x10D51A73, 0xDEEE2C97)},
+    {LXW_UINT64(0xEFAC6652, 0x66CD7052), LXW_UINT64(0x1AEE90B9, 0x64B04758)},
+    {LXW_UINT64(0x2623850E, 0xB8A459DB), LXW_UINT64(0x158BA6FA, 0xB6F36C47)},
+    {LXW_UINT64(0x1E82D0D8, 0x93B6AE49), LXW_UINT64(0x113C8595, 0x5F29236C)},
+    {LXW_UINT64(0xFD9E1AF4, 0x1F8AB075), LXW_UINT64(0x1B9408EE, 0xFEA838AC)},
+    {LXW_UINT64(0x97B1AF29, 0xB2D559F7), LXW_UINT64(0x16100725, 0x988693BD)},
+    {LXW_UINT64(0xAC8E25BA, 0xF5777B2C), LXW_UINT64(0x11A66C1E, 0x139EDC97)},
+    {LXW_UINT64(0x7A7D092B, 0x2258C513), LXW_UINT64(0x1C3D79C9, 0xB8FE2DBF)},
+    {LXW_UINT64(0x61FDA0EF, 0x4EAD6A76), LXW_UINT64(0x169794A1, 0x60CB57CC)},
+    {LXW_UINT64(0xE7FE1A59, 0x0BBDEEC5), LXW_UINT64(0x1212DD4D, 0xE7091309)},
+    {LXW_UINT64(0xA6635D5B, 0x45FCB13A), LXW_UINT64(0x1CEAFBAF, 0xD80E84DC)},
+    {LXW_UINT64(0x851C4AAF, 0x6B308DC8), LXW_UINT64(0x172262F3, 0x133ED0B0)},
+    {LXW_UINT64(0xD0E36EF2, 0xBC26D7D4), LXW_UINT64(0x1281E8C2, 0x75CBDA26)},
+    {LXW_UINT64(0xB49F17EA, 0xC6A48C86), LXW_UINT64(0x1D9CA79D, 0x894629D7)},
+    {LXW_UINT64(0x2A18DFEF, 0x0550706B), LXW_UINT64(0x17B08617, 0xA104EE46)},
+    {LXW_UINT64(0x54E0B325, 0x9DD9F389), LXW_UINT64(0x12F39E79, 0x4D9D8B6B)},
+    {LXW_UINT64(0x87CDEB6F, 0x62F65274), LXW_UINT64(0x1E529728, 0x7C2F4578)},
+    {LXW_UINT64(0xD30B22BF, 0x825EA85D), LXW_UINT64(0x18421286, 0xC9BF6AC6)},
+    {LXW_UINT64(0x0F3C1BCC, 0x684BB9E4), LXW_UINT64(0x13680ED2, 0x3AFF889F)},
+    {LXW_UINT64(0x18602C7A, 0x4079296D), LXW_UINT64(0x1F0CE483, 0x9198DA98)},
+    {LXW_UINT64(0x46B356C8, 0x33942124), LXW_UINT64(0x18D71D36, 0x0E13E213)},
+    {LXW_UINT64(0x388F78A0, 0x29434DB6), LXW_UINT64(0x13DF4A91, 0xA4DCB4DC)},
+    {LXW_UINT64(0x5A7F2766, 0xA86BAF8A), LXW_UINT64(0x1FCBAA82, 0xA1612160)},
+    {LXW_UINT64(0x153285EB, 0xB9EFBFA2), LXW_UINT64(0x196FBB9B, 0xB44DB44D)},
+    {LXW_UINT64(0xAA8ED189, 0x618C994E), LXW_UINT64(0x145962E2, 0xF6A4903D)},
+    {LXW_UINT64(0xEED8A7A1, 0x1AD6E10C), LXW_UINT64(0x1047824F, 0x2BB6D9CA)},
+    {LXW_UINT64(0x7E27729B, 0x5E249B45), LXW_UINT64(0x1A0C03B1, 0xDF8AF611)},
+    {LXW_UINT64(0xFE85F549, 0x181D4904), LXW_UINT64(0x14D6695B, 0x193BF80D)},
+    {LXW_UINT64(0xCB9E5DD4, 0x134AA0D0), LXW_UINT64(0x10AB877C, 0x142FF9A4)},
+    {LXW_UINT64(0xDF63C953, 0x5211014D), LXW_UINT64(0x1AAC0BF9, 0xB9E65C3A)},
+    {LXW_UINT64(0x191CA10F, 0x74DA6771), LXW_UINT64(0x15566FFA, 0xFB1EB02F)},
+    {LXW_UINT64(0xADB080D9, 0x2A4852C1), LXW_UINT64(0x1111F32F, 0x2F4BC025)},
+    {LXW_UINT64(0x15E7348E, 0xAA0D5134), LXW_UINT64(0x1B4FEB7E, 0xB212CD09)},
+    {LXW_UINT64(0xAB1F5D3E, 0xEE710DC4), LXW_UINT64(0x15D98932, 0x280F0A6D)},
+    {LXW_UINT64(0xBC191765, 0x8B8DA49D), LXW_UINT64(0x117AD428, 0x200C0857)},
+    {LXW_UINT64(0x2CF4F23C, 0x127C3A94), LXW_UINT64(0x1BF7B9D9, 0xCCE00D59)},
+    {LXW_UINT64(0xF0C3F4FC, 0xDB969543), LXW_UINT64(0x165FC7E1, 0x70B33DE0)},
+    {LXW_UINT64(0x5A365D97, 0x16121103), LXW_UINT64(0x11E63981, 0x26F5CB1A)},
+    {LXW_UINT64(0x9056FC24, 0xF01CE804), LXW_UINT64(0x1CA38F35, 0x0B22DE90)},
+    {LXW_UINT64(0xD9DF301D, 0x8CE3ECD0), LXW_UINT64(0x16E93F5D, 0xA2824BA6)},
+    {LXW_UINT64(0xE17F59B1, 0x3D8323DA), LXW_UINT64(0x125432B1, 0x4ECEA2EB)},
+    {LXW_UINT64(0x68CBC2B5, 0x2F38395C), LXW_UINT64(0x1D53844E, 0xE47DD179)},
+    {LXW_UINT64(0x53D6355D, 0xBF602DE3), LXW_UINT64(0x17760372, 0x5064A794)},
+    {LXW_UINT64(0xA9782AB1, 0x65E68B1C), LXW_UINT64(0x12C4CF8E, 0xA6B6EC76)},
+    {LXW_UINT64(0x0F26AAB5, 0x6FD744FA), LXW_UINT64(0x1E07B27D, 0xD78B13F1)},
+    {LXW_UINT64(0x3F52222A, 0xBFDF6A62), LXW_UINT64(0x18062864, 0xAC6F4327)},
+    {LXW_UINT64(0x65DB4E88, 0x997F884E), LXW_UINT64(0x13382050, 0x89F29C1F)},
+    {LXW_UINT64(0x6FC54A74, 0x28CC0D4A), LXW_UINT64(0x1EC033B4, 0x0FEA9365)},
+    {LXW_UINT64(0x596AA1F6, 0x8709A43B), LXW_UINT64(0x1899C2F6, 0x73220F84)},
+    {LXW_UINT64(0xADEEE7F8, 0x6C07B696), LXW_UINT64(0x13AE3591, 0xF5B4D936)},
+    {LXW_UINT64(0x497E3FF3, 0xE00C5756), LXW_UINT64(0x1F7D2283, 0x22BAF524)},
+    {LXW_UINT64(0xD464FFF6, 0x4CD6AC45), LXW_UINT64(0x1930E868, 0xE89590E9)},
+    {LXW_UINT64(0x4383FFF8, 0x3D7889D1), LXW_UINT64(0x14272053, 0xED4473EE)},
+    {LXW_UINT64(0xCF9CCCC6, 0x9793A174), LXW_UINT64(0x101F4D0F, 0xF1038FF1)},
+    {LXW_UINT64(0x7F6147A4, 0x25B90252), LXW_UINT64(0x19CBAE7F, 0xE805B31C)},
+    {LXW_UINT64(0xCC4DD2E9, 0xB7C7350F), LXW_UINT64(0x14A2F1FF, 0xECD15C16)},
+    {LXW_UINT64(0x3D0B0F21, 0x5FD290D9), LXW_UINT64(0x10825B33, 0x23DAB012)},
+    {LXW_UINT64(0x61AB4B68, 0x9950E7C1), LXW_UINT64(0x1A6A2B85, 0x062AB350)},
+    {LXW_UINT64(0x4E22A2BA, 0x1440B967), LXW_UINT64(0x1521BC6A, 0x6B555C40)},
+    {LXW_UINT64(0x0B4EE894, 0xDD009453), LXW_UINT64(0x10E7C9EE, 0xBC4449CD)},
+    {LXW_UINT64(0x1217DA87, 0xC800ED51), LXW_UINT64(0x1B0C764A, 0xC6D3A948)},
+    {LXW_UINT64(0xDB46486C, 0xA000BDDA), LXW_UINT64(0x15A391D5, 0x6BDC876C)},
+    {LXW_UINT64(0x490506BD, 0x4CCD64AF), LXW_UINT64(0x114FA7DD, 0xEFE39F8A)},
+    {LXW_UINT64(0xA8080AC8, 0x7AE23AB1), LXW_UINT64(0x1BB2A62F, 0xE638FF43)},
+    {LXW_UINT64(0x5339A239, 0xFBE82EF4), LXW_UINT64(0x162884F3, 0x1E93FF69)},
+    {LXW_UINT64(0x75C7B4FB, 0x2FECF25D), LXW_UINT64(0x11BA03F5, 0xB20FFF87)},
+    {LXW_UINT64(0x22D92191, 0xE647EA2E), LXW_UINT64(0x1C5CD322, 0xB67FFF3F)},
+    {LXW_UINT64(0xB57A8141, 0x850654F2), LXW_UINT64(0x16B0A8E8, 0x91FFFF65)},
+    {LXW_UINT64(0xC4620101, 0x373843F5), LXW_UINT64(0x1226ED86, 0xDB3332B7)},
+    {LXW_UINT64(0x3A366801, 0xF1F39FEE), LXW_UINT64(0x1D0B15A4, 0x91EB8459)},
+    {LXW_UINT64(0xFB5EB99B, 0x27F6198B), LXW_UINT64(0x173C1150, 0x74BC69E0)},
+    {LXW_UINT64(0x2F7EFAE2, 0x865E7AD6), LXW_UINT64(0x12967440, 0x5D6387E7)},
+    {LXW_UINT64(0xE597F7D0, 0xD6FD9156), LXW_UINT64(0x1DBD86CD, 0x6238D971)},
+    {LXW_UINT64(0x8479930D, 0x78CADAAB), LXW_UINT64(0x17CAD23D, 0xE82D7AC1)},
+    {LXW_UINT64(0xD0614271, 0x2D6F1556), LXW_UINT64(0x1308A831, 0x868AC89A)},
+    {LXW_UINT64(0x4D686A4E, 0xAF182222), LXW_UINT64(0x1E74404F, 0x3DAADA91)},
+    {LXW_UINT64(0xA453883E, 0xF279B4E8), LXW_UINT64(0x185D003F, 0x6488AEDA)},
+    {LXW_UINT64(0xE9DC6CFF, 0x28615D87), LXW_UINT64(0x137D99CC, 0x506D58AE)},
+    {LXW_UINT64(0xA960AE65, 0x0D6895A4), LXW_UINT64(0x1F2F5C7A, 0x1A488DE4)},
+    {LXW_UINT64(0xBAB3BEB7, 0x3DED4483), LXW_UINT64(0x18F2B061, 0xAEA07183)},
+    {LXW_UINT64(0x2EF6322C, 0x318A9D36), LXW_UINT64(0x13F559E7, 0xBEE6C136)}
+};
+
+/* 5^i normalized to 125 bits, as {low, high} 64 bit words. */
+static const uint64_t lxw_pow5_split[326][2] = {
+    {LXW_UINT64(0x00000000, 0x00000000), LXW_UINT64(0x10000000, 0x00000000)},
+    {LXW_UINT64(0x00000000, 0x00000000), LXW_UINT64(0x14000000, 0x00000000)},
+    {LXW_UINT64(0x00000000, 0x00000000), LXW_UINT64(0x19000000, 0x00000000)},
+    {LXW_UINT64(0x00000000, 0x00000000), LXW_UINT64(0x1F400000, 0x00000000)},
+    {LXW_UINT64(0x00000000, 0x00000000), LXW_UINT64(0x13880000, 0x00000000)},
+    {LXW_UINT64(0x00000000, 0x00000000), LXW_UINT64(0x186A0000, 0x00000000)},
+    {LXW_UINT64(0x00000000, 0x00000000), LXW_UINT64(0x1E848000, 0x00000000)},
+    {LXW_UINT64(0x00000000, 0x00000000), LXW_UINT64(0x1312D000, 0x00000000)},
+    {LXW_UINT64(0x00000000, 0x00000000), LXW_UINT64(0x17D78400, 0x00000000)},
+    {LXW_UINT64(0x00000000, 0x00000000), LXW_UINT64(0x1DCD6500, 0x00000000)},
+    {LXW_UINT64(0x00000000, 0x00000000), LXW_UINT64(0x12A05F20, 0x00000000)},
+    {LXW_UINT64(0x00000000, 0x00000000), LXW_UINT64(0x174876E8, 0x00000000)},
+    {LXW_UINT64(0x00000000, 0x00000000), LXW_UINT64(0x1D1A94A2, 0x00000000)},
+    {LXW_UINT64(0x00000000, 0x00000000), LXW_UINT64(0x12309CE5, 0x40000000)},
+    {LXW_UINT64(0x00000000, 0x00000000), LXW_UINT64(0x16BCC41E, 0x90000000)},
+    {LXW_UINT64(0x00000000, 0x00000000), LXW_UINT64(0x1C6BF526, 0x34000000)},
+    {LXW_UINT64(0x00000000, 0x00000000), LXW_UINT64(0x11C37937, 0xE0800000)},
+    {LXW_UINT64(0x00000000, 0x00000000), LXW_UINT64(0x16345785, 0xD8A00000)},
+    {LXW_UINT64(0x00000000, 0x00000000), LXW_UINT64(0x1BC16D67, 0x4EC80000)},
+    {LXW_UINT64(0x00000000, 0x00000000), LXW_UINT64(0x1158E460, 0x913D0000)},
+    {LXW_UINT64(0x00000000, 0x00000000), LXW_UINT64(0x15AF1D78, 0xB58C4000)},
+    {LXW_UINT64(0x00000000, 0x00000000), LXW_UINT64(0x1B1AE4D6, 0xE2EF5000)},
+    {LXW_UINT64(0x00000000, 0x00000000), LXW_UINT64(0x10F0CF06, 0x4DD59200)},
+    {LXW_UINT64(0x00000000, 0x00000000), LXW_UINT64(0x152D02C7, 0xE14AF680)},
+    {LXW_UINT64(0x00000000, 0x00000000), LXW_UINT64(0x1A784379, 0xD99DB420)},
+    {LXW_UINT64(0x00000000, 0x00000000), LXW_UINT64(0x108B2A2C, 0x28029094)},
+    {LXW_UINT64(0x00000000, 0x00000000), LXW_UINT64(0x14ADF4B7, 0x320334B9)},
+    {LXW_UINT64(0x40000000, 0x00000000), LXW_UINT64(0x19D971E4, 0xFE8401E7)},
+    {LXW_UINT64(0x88000000, 0x00000000), LXW_UINT64(0x1027E72F, 0x1F128130)},
+    {LXW_UINT64(0xAA000000, 0x00000000), LXW_UINT64(0x1431E0FA, 0xE6D7217C)},
+    {LXW_UINT64(0xD4800000, 0x00000000), LXW_UINT64(0x193E5939, 0xA08CE9DB)},
+    {LXW_UINT64(0xC9A00000, 0x00000000), LXW_UINT64(0x1F8DEF88, 0x08B02452)},
+    {LXW_UINT64(0xBE040000, 0x00000000), LXW_UINT64(0x13B8B5B5, 0x056E16B3)},
+    {LXW_UINT64(0xAD850000, 0x00000000), LXW_UINT64(0x18A6E322, 0x46C99C60)},
+    {LXW_UINT64(0xD8E64000, 0x00000000), LXW_UINT64(0x1ED09BEA, 0xD87C0378)},
+    {LXW_UINT64(0x878FE800, 0x00000000), LXW_UINT64(0x13426172, 0xC74D822B)},
+    {LXW_UINT64(0x6973E200, 0x00000000), LXW_UINT64(0x1812F9CF, 0x7920E2B6)},
+    {LXW_UINT64(0x03D0DA80, 0x00000000), LXW_UINT64(0x1E17B843, 0x57691B64)},
+    {LXW_UINT64(0x82628890, 0x00000000), LXW_UINT64(0x12CED32A, 0x16A1B11E)},
+    {LXW_UINT64(0x22FB2AB4, 0x00000000), LXW_UINT64(0x178287F4, 0x9C4A1D66)},
+    {LXW_UINT64(0xABB9F561, 0x00000000), LXW_UINT64(0x1D6329F1, 0xC35CA4BF)},
+    {LXW_UINT64(0xCB54395C, 0xA0000000), LXW_UINT64(0x125DFA37, 0x1A19E6F7)},
+    {LXW_UINT64(0xBE2947B3, 0xC8000000), LXW_UINT64(0x16F578C4, 0xE0A060B5)},
+    {LXW_UINT64(0x2DB399A0, 0xBA000000), LXW_UINT64(0x1CB2D6F6, 0x18C878E3)},
+    {LXW_UINT64(0xFC904004, 0x74400000), LXW_UINT64(0x11EFC659, 0xCF7D4B8D)},
+    {LXW_UINT64(0x7BB45005, 0x91500000), LXW_UINT64(0x166BB7F0, 0x435C9E71)},
+    {LXW_UINT64(0xDAA16406, 0xF5A40000), LXW_UINT64(0x1C06A5EC, 0x5433C60D)},
+    {LXW_UINT64(0xA8A4DE84, 0x59868000), LXW_UINT64(0x118427B3, 0xB4A05BC8)},
+    {LXW_UINT64(0xD2CE1625, 0x6FE82000), LXW_UINT64(0x15E531A0, 0xA1C872BA)},
+    {LXW_UINT64(0x87819BAE, 0xCBE22800), LXW_UINT64(0x1B5E7E08, 0xCA3A8F69)},
+    {LXW_UINT64(0xF4B1014D, 0x3F6D5900), LXW_UINT64(0x111B0EC5, 0x7E6499A1)},
+    {LXW_UINT64(0x71DD41A0, 0x8F48AF40), LXW_UINT64(0x1561D276, 0xDDFDC00A)},
+    {LXW_UINT64(0x0E549208, 0xB31ADB10), LXW_UINT64(0x1ABA4714, 0x957D300D)},
+    {LXW_UINT64(0x28F4DB45, 0x6FF0C8EA), LXW_UINT64(0x10B46C6C, 0xDD6E3E08)},
+    {LXW_UINT64(0x33321216, 0xCBECFB24), LXW_UINT64(0x14E18788, 0x14C9CD8A)},
+    {LXW_UINT64(0xBFFE969C, 0x7EE839ED), LXW_UINT64(0x1A19E96A, 0x19FC40EC)},
+    {LXW_UINT64(0xF7FF1E21, 0xCF512434), LXW_UINT64(0x105031E2, 0x503DA893)},
+    {LXW_UINT64(0xF5FEE5AA, 0x43256D41), LXW_UINT64(0x14643E5A, 0xE44D12B8)},
+    {LXW_UINT64(0x337E9F14, 0xD3EEC892), LXW_UINT64(0x197D4DF1, 0x9D605767)},
+    {LXW_UINT64(0x005E46DA, 0x08EA7AB6), LXW_UINT64(0x1FDCA16E, 0x04B86D41)},
+    {LXW_UINT64(0xA03AEC48, 0x45928CB2), LXW_UINT64(0x13E9E4E4, 0xC2F34448)},
+    {LXW_UINT64(0xC849A75A, 0x56F72FDE), LXW_UINT64(0x18E45E1D, 0xF3B0155A)},
+    {LXW_UINT64(0x7A5C1130, 0xECB4FBD6), LXW_UINT64(0x1F1D75A5, 0x709C1AB1)},
+    {LXW_UINT64(0xEC798ABE, 0x93F11D65), LXW_UINT64(0x13726987, 0x666190AE)},
+    {LXW_UINT64(0xA797ED6E, 0x38ED64BF), LXW_UINT64(0x184F03E9, 0x3FF9F4DA)},
+    {LXW_UINT64(0x517DE8C9, 0xC728BDEF), LXW_UINT64(0x1E62C4E3, 0x8FF87211)},
+    {LXW_UINT64(0xD2EEB17E, 0x1C7976B5), LXW_UINT64(0x12FDBB0E, 0x39FB474A)},
+    {LXW_UINT64(0x87AA5DDD, 0xA397D462), LXW_UINT64(0x17BD29D1, 0xC87A191D)},
+    {LXW_UINT64(0xE994F555, 0x0C7DC97B), LXW_UINT64(0x1DAC7446, 0x3A989F64)},
+    {LXW_UINT64(0x11FD1955, 0x27CE9DED), LXW_UINT64(0x128BC8AB, 0xE49F639F)},
+    {LXW_UINT64(0xD67C5FAA, 0x71C24568), LXW_UINT64(0x172EBAD6, 0xDDC73C86)},
+    {LXW_UINT64(0x8C1B7795, 0x0E32D6C2), LXW_UINT64(0x1CFA698C, 0x95390BA8)},
+    {LXW_UINT64(0x57912ABD, 0x28DFC639), LXW_UINT64(0x121C81F7, 0xDD43A749)},
+    {LXW_UINT64(0xAD75756C, 0x7317B7C8), LXW_UINT64(0x16A3A275, 0xD494911B)},
+    {LXW_UINT64(0x98D2D2C7, 0x8FDDA5BA), LXW_UINT64(0x1C4C8B13, 0x49B9B562)},
+    {LXW_UINT64(0x9F83C3BC, 0xB9EA8794), LXW_UINT64(0x11AFD6EC, 0x0E14115D)},
+    {LXW_UINT64(0x0764B4AB, 0xE8652979), LXW_UINT64(0x161BCCA7, 0x119915B5)},
+    {LXW_UINT64(0x493DE1D6, 0xE27E73D7), LXW_UINT64(0x1BA2BFD0, 0xD5FF5B22)},
+    {LXW_UINT64(0x6DC6AD26, 0x4D8F0866), LXW_UINT64(0x1145B7E2, 0x85BF98F5)},
+    {LXW_UINT64(0xC938586F, 0xE0F2CA80), LXW_UINT64(0x159725DB, 0x272F7F32)},
+    {LXW_UINT64(0x7B866E8B, 0xD92F7D20), LXW_UINT64(0x1AFCEF51, 0xF0FB5EFF)},
+    {LXW_UINT64(0xAD340517, 0x67BDAE34), LXW_UINT64(0x10DE1593, 0x369D1B5F)},
+    {LXW_UINT64(0x9881065D, 0x41AD19C1), LXW_UINT64(0x15159AF8, 0x04446237)},
+    {LXW_UINT64(0x7EA147F4, 0x92186032), LXW_UINT64(0x1A5B01B6, 0x05557AC5)},
+    {LXW_UINT64(0x6F24CCF8, 0xDB4F3C1F), LXW_UINT64(0x1078E111, 0xC3556CBB)},
+    {LXW_UINT64(0x4AEE0037, 0x12230B27), LXW_UINT64(0x14971956, 0x342AC7EA)},
+    {LXW_UINT64(0xDDA98044, 0xD6ABCDF0), LXW_UINT64(0x19BCDFAB, 0xC13579E4)},
+    {LXW_UINT64(0x0A89F02B, 0x062B60B6), LXW_UINT64(0x10160BCB, 0x58C16C2F)},
+    {LXW_UINT64(0xCD2C6C35, 0xC7B638E4), LXW_UINT64(0x141B8EBE, 0x2EF1C73A)},
+    {LXW_UINT64(0x80778743, 0x39A3C71D), LXW_UINT64(0x1922726D, 0xBAAE3909)},
+    {LXW_UINT64(0xE0956914, 0x080CB8E4), LXW_UINT64(0x1F6B0F09, 0x2959C74B)},
+    {LXW_UINT64(0x6C5D61AC, 0x8507F38E), LXW_UINT64(0x13A2E965, 0xB9D81C8F)},
+    {LXW_UINT64(0x4774BA17, 0xA649F072), LXW_UINT64(0x188BA3BF, 0x284E23B3)},
+    {LXW_UINT64(0x1951E89D, 0x8FDC6C8F), LXW_UINT64(0x1EAE8CAE, 0xF261ACA0)},
+    {LXW_UINT64(0x0FD33162, 0x79E9C3D9), LXW_UINT64(0x132D17ED, 0x577D0BE4)},
+    {LXW_UINT64(0x13C7FDBB, 0x186434CF), LXW_UINT64(0x17F85DE8, 0xAD5C4EDD)},
+    {LXW_UINT64(0x58B9FD29, 0xDE7D4203), LXW_UINT64(0x1DF67562, 0xD8B36294)},
+    {LXW_UINT64(0xB7743E3A, 0x2B0E4942), LXW_UINT64(0x12BA095D, 0xC7701D9C)},
+    {LXW_UINT64(0xE5514DC8, 0xB5D1DB92), LXW_UINT64(0x17688BB5, 0x394C2503)},
+    {LXW_UINT64(0xDEA5A13A, 0xE3465277), LXW_UINT64(0x1D42AEA2, 0x879F2E44)},
+    {LXW_UINT64(0x0B2784C4, 0xCE0BF38A), LXW_UINT64(0x1249AD25, 0x94C37CEB)},
+    {LXW_UINT64(0xCDF165F6, 0x018EF06D), LXW_UINT64(0x16DC186E, 0xF9F45C25)},
+    {LXW_UINT64(0x416DBF73, 0x81F2AC88), LXW_UINT64(0x1C931E8A, 0xB871732F)},
+    {LXW_UINT64(0x88E497A8, 0x3137ABD5), LXW_UINT64(0x11DBF316, 0xB346E7FD)},
+    {LXW_UINT64(0xEB1DBD92, 0x3D8596CA), LXW_UINT64(0x1652EFDC, 0x6018A1FC)},
+    {LXW_UINT64(0x25E52CF6, 0xCCE6FC7D), LXW_UINT64(0x1BE7ABD3, 0x781ECA7C)},
+    {LXW_UINT64(0x97AF3C1A, 0x40105DCE), LXW_UINT64(0x1170CB64, 0x2B133E8D)},
+    {LXW_UINT64(0xFD9B0B20, 0xD0147542), LXW_UINT64(0x15CCFE3D, 0x35D80E30)},
+    {LXW_UINT64(0x3D01CDE9, 0x04199292), LXW_UINT64(0x1B403DCC, 0x834E11BD)},
+    {LXW_UINT64(0x462120B1, 0xA28FFB9B), LXW_UINT64(0x1108269F, 0xD210CB16)},
+    {LXW_UINT64(0xD7A968DE, 0x0B33FA82), LXW_UINT64(0x154A3047, 0xC694FDDB)},
+    {LXW_UINT64(0xCD93C315, 0x8E00F923), LXW_UINT64(0x1A9CBC59, 0xB83A3D52)},
+    {LXW_UINT64(0xC07C59ED, 0x78C09BB6), LXW_UINT64(0x10A1F5B8, 0x13246653)},
+    {LXW_UINT64(0xB09B7068, 0xD6F0C2A3), LXW_UINT64(0x14CA7326, 0x17ED7FE8)},
+    {LXW_UINT64(0xDCC24C83, 0x0CACF34C), LXW_UINT64(0x19FD0FEF, 0x9DE8DFE2)},
+    {LXW_UINT64(0xC9F96FD1, 0xE7EC180F), LXW_UINT64(0x103E29F5, 0xC2B18BED)},
+    {LXW_UINT64(0x3C77CBC6, 0x61E71E13), LXW_UINT64(0x144DB473, 0x335DEEE9)},
+    {LXW_UINT64(0x8B95BEB7, 0xFA60E598), LXW_UINT64(0x19612190, 0x00356AA3)},
+    {LXW_UINT64(0x6E7B2E65, 0xF8F91EFE), LXW_UINT64(0x1FB969F4, 0x0042C54C)},
+    {LXW_UINT64(0xC50CFCFF, 0xBB9BB35F), LXW_UINT64(0x13D3E238, 0x8029BB4F)},
+    {LXW_UINT64(0xB6503C3F, 0xAA82A037), LXW_UINT64(0x18C8DAC6, 0xA0342A23)},
+    {LXW_UINT64(0xA3E44B4F, 0x95234844), LXW_UINT64(0x1EFB1178, 0x484134AC)},
+    {LXW_UINT64(0xE66EAF11, 0xBD360D2B), LXW_UINT64(0x135CEAEB, 0x2D28C0EB)},
+    {LXW_UINT64(0xE00A5AD6, 0x2C839075), LXW_UINT64(0x183425A5, 0xF872F126)},
+    {LXW_UINT64(0x980CF18B, 0xB7A47493), LXW_UINT64(0x1E412F0F, 0x768FAD70)},
+    {LXW_UINT64(0x5F0816F7, 0x52C6C8DC), LXW_UINT64(0x12E8BD69, 0xAA19CC66)},
+    {LXW_UINT64(0xF6CA1CB5, 0x27787B13), LXW_UINT64(0x17A2ECC4, 0x14A03F7F)},
+    {LXW_UINT64(0xF47CA3E2, 0x715699D7), LXW_UINT64(0x1D8BA7F5, 0x19C84F5F)},
+    {LXW_UINT64(0xF8CDE66D, 0x86D62026), LXW_UINT64(0x127748F9, 0x301D319B)},
+    {LXW_UINT64(0xF7016008, 0xE88BA830), LXW_UINT64(0x17151B37, 0x7C247E02)},
+    {LXW_UINT64(0xB4C1B80B, 0x22AE923C), LXW_UINT64(0x1CDA6205, 0x5B2D9D83)},
+    {LXW_UINT64(0x50F91306, 0xF5AD1B65), LXW_UINT64(0x12087D43, 0x58FC8272)},
+    {LXW_UINT64(0xE53757C8, 0xB318623F), LXW_UINT64(0x168A9C94, 0x2F3BA30E)},
+    {LXW_UINT64(0x9E852DBA, 0xDFDE7ACF), LXW_UINT64(0x1C2D43B9, 0x3B0A8BD2)},
+    {LXW_UINT64(0xA3133C94, 0xCBEB0CC1), LXW_UINT64(0x119C4A53, 0xC4E69763)},
+    {LXW_UINT64(0x8BD80BB9, 0xFEE5CFF1), LXW_UINT64(0x16035CE8, 0xB6203D3C)},
+    {LXW_UINT64(0xAECE0EA8, 0x7E9F43EE), LXW_UINT64(0x1B843422, 0xE3A84C8B)},
+    {LXW_UINT64(0x4D40C929, 0x4F238A75), LXW_UINT64(0x1132A095, 0xCE492FD7)},
+    {LXW_UINT64(0x2090FB73, 0xA2EC6D12), LXW_UINT64(0x157F48BB, 0x41DB7BCD)},
+    {LXW_UINT64(0x68B53A50, 0x8BA78856), LXW_UINT64(0x1ADF1AEA, 0x12525AC0)},
+    {LXW_UINT64(0x41714472, 0x5748B536), LXW_UINT64(0x10CB70D2, 0x4B7378B8)},
+    {LXW_UINT64(0x51CD958E, 0xED1AE283), LXW_UINT64(0x14FE4D06, 0xDE5056E6)},
+    {LXW_UINT64(0xE640FAF2, 0xA8619B24), LXW_UINT64(0x1A3DE048, 0x95E46C9F)},
+    {LXW_UINT64(0xEFE89CD7, 0xA93D00F7), LXW_UINT64(0x1066AC2D, 0x5DAEC3E3)},
+    {LXW_UINT64(0xEBE2C40D, 0x938C4134), LXW_UINT64(0x14805738, 0xB51A74DC)},
+    {LXW_UINT64(0x26DB7510, 0xF86F5181), LXW_UINT64(0x19A06D06, 0xE2611214)},
+    {LXW_UINT64(0x9849292A, 0x9B4592F1), LXW_UINT64(0x10044424, 0x4D7CAB4C)},
+    {LXW_UINT64(0xBE5B7375, 0x4216F7AD), LXW_UINT64(0x1405552D, 0x60DBD61F)},
+    {LXW_UINT64(0xADF25052, 0x929CB598), LXW_UINT64(0x1906AA78, 0xB912CBA7)},
+    {LXW_UINT64(0x996EE467, 0x3743E2FF), LXW_UINT64(0x1F485516, 0xE7577E91)},
+    {LXW_UINT64(0xFFE54EC0, 0x828A6DDF), LXW_UINT64(0x138D352E, 0x5096AF1A)},
+    {LXW_UINT64(0xBFDEA270, 0xA32D0957), LXW_UINT64(0x18708279, 0xE4BC5AE1)},
+    {LXW_UINT64(0x2FD64B0C, 0xCBF84BAD), LXW_UINT64(0x1E8CA318, 0x5DEB719A)},
+    {LXW_UINT64(0x5DE5EEE7, 0xFF7B2F4C), LXW_UINT64(0x1317E5EF, 0x3AB32700)},
+    {LXW_UINT64(0x755F6AA1, 0xFF59FB1F), LXW_UINT64(0x17DDDF6B, 0x095FF0C0)},
+    {LXW_UINT64(0x92B7454A, 0x7F3079E7), LXW_UINT64(0x1DD55745, 0xCBB7ECF0)},
+    {LXW_UINT64(0x5BB28B4E, 0x8F7E4C30), LXW_UINT64(0x12A5568B, 0x9F52F416)},
+    {LXW_UINT64(0xF29F2E22, 0x335DDF3C), LXW_UINT64(0x174EAC2E, 0x8727B11B)},
+    {LXW_UINT64(0xEF46F9AA, 0xC035570B), LXW_UINT64(0x1D22573A, 0x28F19D62)},
+    {LXW_UINT64(0xD58C5C0A, 0xB8215667), LXW_UINT64(0x12357684, 0x5997025D)},
+    {LXW_UINT64(0x4AEF730D, 0x6629AC01), LXW_UINT64(0x16C2D425, 0x6FFCC2F5)},
+    {LXW_UINT64(0x9DAB4FD0, 0xBFB41701), LXW_UINT64(0x1C73892E, 0xCBFBF3B2)},
+    {LXW_UINT64(0xA28B11E2, 0x77D08E60), LXW_UINT64(0x11C835BD, 0x3F7D784F)},
+    {LXW_UINT64(0x8B2DD65B, 0x15C4B1F9), LXW_UINT64(0x163A432C, 0x8F5CD663)},
+    {LXW_UINT64(0x6DF94BF1, 0xDB35DE77), LXW_UINT64(0x1BC8D3F7, 0xB3340BFC)},
+    {LXW_UINT64(0xC4BBCF77, 0x2901AB0A), LXW_UINT64(0x115D847A, 0xD000877D)},
+    {LXW_UINT64(0x35EAC354, 0xF34215CD), LXW_UINT64(0x15B4E599, 0x8400A95D)},
+    {LXW_UINT64(0x8365742A, 0x30129B40), LXW_UINT64(0x1B221EFF, 0xE500D3B4)},
+    {LXW_UINT64(0xD21F689A, 0x5E0BA108), LXW_UINT64(0x10F5535F, 0xEF208450)},
+    {LXW_UINT64(0x06A742C0, 0xF58E894A), LXW_UINT64(0x1532A837, 0xEAE8A565)},
+    {LXW_UINT64(0x48511371, 0x32F22B9D), LXW_UINT64(0x1A7F5245, 0xE5A2CEBE)},
+    {LXW_UINT64(0xED32AC26, 0xBFD75B42), LXW_UINT64(0x108F936B, 0xAF85C136)},
+    {LXW_UINT64(0xA87F5730, 0x6FCD3212), LXW_UINT64(0x14B37846, 0x9B673184)},
+    {LXW_UINT64(0xD29F2CFC, 0x8BC07E97), LXW_UINT64(0x19E05658, 0x4240FDE5)},
+    {LXW_UINT64(0xA3A37C1D, 0xD7584F1E), LXW_UINT64(0x102C35F7, 0x29689EAF)},
+    {LXW_UINT64(0x8C8C5B25, 0x4D2E62E6), LXW_UINT64(0x14374374, 0xF3C2C65B)},
+    {LXW_UINT64(0x6FAF71EE, 0xA079FB9F), LXW_UINT64(0x19451452, 0x30B377F2)},
+    {LXW_UINT64(0x0B9B4E6A, 0x48987A87), LXW_UINT64(0x1F965966, 0xBCE055EF)},
+    {LXW_UINT64(0x67411102, 0x6D5F4C94), LXW_UINT64(0x13BDF7E0, 0x360C35B5)},
+    {LXW_UINT64(0xC1115543, 0x08B71FBA), LXW_UINT64(0x18AD75D8, 0x438F4322)},
+    {LXW_UINT64(0x7155AA93, 0xCAE4E7A8), LXW_UINT64(0x1ED8D34E, 0x547313EB)},
+    {LXW_UINT64(0x26D58A9C, 0x5ECF10C9), LXW_UINT64(0x13478410, 0xF4C7EC73)},
+    {LXW_UINT64(0xF08AED43, 0x7682D4FB), LXW_UINT64(0x18196515, 0x31F9E78F)},
+    {LXW_UINT64(0xECADA894, 0x54238A3A), LXW_UINT64(0x1E1FBE5A, 0x7E786173)},
+    {LXW_UINT64(0x73EC895C, 0xB4963664), LXW_UINT64(0x12D3D6F8, 0x8F0B3CE8)},
+    {LXW_UINT64(0x90E7ABB3, 0xE1BBC3FD), LXW_UINT64(0x1788CCB6, 0xB2CE0C22)},
+    {LXW_UINT64(0x352196A0, 0xDA2AB4FD), LXW_UINT64(0x1D6AFFE4, 0x5F818F2B)},
+    {LXW_UINT64(0x0134FE24, 0x885AB11E), LXW_UINT64(0x1262DFEE, 0xBBB0F97B)},
+    {LXW_UINT64(0xC1823DAD, 0xAA715D65), LXW_UINT64(0x16FB97EA, 0x6A9D37D9)},
+    {LXW_UINT64(0x31E2CD19, 0x150DB4BF), LXW_UINT64(0x1CBA7DE5, 0x054485D0)},
+    {LXW_UINT64(0x1F2DC02F, 0xAD2890F7), LXW_UINT64(0x11F48EAF, 0x234AD3A2)},
+    {LXW_UINT64(0xA6F9303B, 0x9872B535), LXW_UINT64(0x1671B25A, 0xEC1D888A)},
+    {LXW_UINT64(0x50B77C4A, 0x7E8F6282), LXW_UINT64(0x1C0E1EF1, 0xA724EAAD)},
+    {LXW_UINT64(0x5272ADAE, 0x8F199D91), LXW_UINT64(0x1188D357, 0x087712AC)},
+    {LXW_UINT64(0x670F591A, 0x32E004F6), LXW_UINT64(0x15EB082C, 0xCA94D757)},
+    {LXW_UINT64(0x40D32F60, 0xBF980633), LXW_UINT64(0x1B65CA37, 0xFD3A0D2D)},
+    {LXW_UINT64(0x4883FD9C, 0x77BF03E0), LXW_UINT64(0x111F9E62, 0xFE44483C)},
+    {LXW_UINT64(0x5AA4FD03, 0x95AEC4D8), LXW_UINT64(0x156785FB, 0xBDD55A4B)},
+    {LXW_UINT64(0x314E3C44, 0x7B1A760E), LXW_UINT64(0x1AC1677A, 0xAD4AB0DE)},
+    {LXW_UINT64(0xDED0E5AA, 0xCCF089C9), LXW_UINT64(0x10B8E0AC, 0xAC4EAE8A)},
+    {LXW_UINT64(0x96851F15, 0x802CAC3B), LXW_UINT64(0x14E718D7, 0xD7625A2D)},
+    {LXW_UINT64(0xFC2666DA, 0xE037D74A), LXW_UINT64(0x1A20DF0D, 0xCD3AF0B8)},
+    {LXW_UINT64(0x9D980048, 0xCC22E68E), LXW_UINT64(0x10548B68, 0xA044D673)},
+    {LXW_UINT64(0x84FE005A, 0xFF2BA032), LXW_UINT64(0x1469AE42, 0xC8560C10)},
+    {LXW_UINT64(0xA63D8071, 0xBEF6883E), LXW_UINT64(0x198419D3, 0x7A6B8F14)},
+    {LXW_UINT64(0xCFCCE08E, 0x2EB42A4E), LXW_UINT64(0x1FE52048, 0x590672D9)},
+    {LXW_UINT64(0x21E00C58, 0xDD309A70), LXW_UINT64(0x13EF342D, 0x37A407C8)},
+    {LXW_UINT64(0x2A580F6F, 0x147CC10D), LXW_UINT64(0x18EB0138, 0x858D09BA)},
+    {LXW_UINT64(0xB4EE134A, 0xD99BF150), LXW_UINT64(0x1F25C186, 0xA6F04C28)},
+    {LXW_UINT64(0x7114CC0E, 0xC80176D2), LXW_UINT64(0x137798F4, 0x28562F99)},
+    {LXW_UINT64(0xCD59FF12, 0x7A01D486), LXW_UINT64(0x18557F31, 0x326BBB7F)},
+    {LXW_UINT64(0xC0B07ED7, 0x188249A8), LXW_UINT64(0x1E6ADEFD, 0x7F06AA5F)},
+    {LXW_UINT64(0xD86E4F46, 0x6F516E09), LXW_UINT64(0x1302CB5E, 0x6F642A7B)},
+    {LXW_UINT64(0xCE89E318, 0x0B25C98B), LXW_UINT64(0x17C37E36, 0x0B3D351A)},
+    {LXW_UINT64(0x822C5BDE, 0x0DEF3BEE), LXW_UINT64(0x1DB45DC3, 0x8E0C8261)},
+    {LXW_UINT64(0xF15BB96A, 0xC8B58575), LXW_UINT64(0x1290BA9A, 0x38C7D17C)},
+    {LXW_UINT64(0x2DB2A7C5, 0x7AE2E6D2), LXW_UINT64(0x1734E940, 0xC6F9C5DC)},
+    {LXW_UINT64(0x391F51B6, 0xD99BA086), LXW_UINT64(0x1D022390, 0xF8B83753)},
+    {LXW_UINT64(0x03B39312, 0x48014454), LXW_UINT64(0x1221563A, 0x9B732294)},
+    {LXW_UINT64(0x04A077D6, 0xDA019569), LXW_UINT64(0x16A9ABC9, 0x424FEB39)},
+    {LXW_UINT64(0x45C895CC, 0x9081FAC3), LXW_UINT64(0x1C5416BB, 0x92E3E607)},
+    {LXW_UINT64(0x8B9D5D9F, 0xDA513CBA), LXW_UINT64(0x11B48E35, 0x3BCE6FC4)},
+    {LXW_UINT64(0xAE84B507, 0xD0E58BE8), LXW_UINT64(0x1621B1C2, 0x8AC20BB5)},
+    {LXW_UINT64(0x1A25E249, 0xC51EEEE3), LXW_UINT64(0x1BAA1E33, 0x2D728EA3)},
+    {LXW_UINT64(0xF057AD6E, 0x1B33554D), LXW_UINT64(0x114A52DF, 0xFC679925)},
+    {LXW_UINT64(0x6C6D98C9, 0xA2002AA1), LXW_UINT64(0x159CE797, 0xFB817F6F)},
+    {LXW_UINT64(0x4788FEFC, 0x0A803549), LXW_UINT64(0x1B04217D, 0xFA61DF4B)},
+    {LXW_UINT64(0x0CB59F5D, 0x8690214E), LXW_UINT64(0x10E294EE, 0xBC7D2B8F)},
+    {LXW_UINT64(0xCFE30734, 0xE83429A1), LXW_UINT64(0x151B3A2A, 0x6B9C7672)},
+    {LXW_UINT64(0x83DBC902, 0x2241340A), LXW_UINT64(0x1A6208B5, 0x0683940F)},
+    {LXW_UINT64(0xB2695DA1, 0x5568C086), LXW_UINT64(0x107D4571, 0x24123C89)},
+    {LXW_UINT64(0x1F03B509, 0xAAC2F0A7), LXW_UINT64(0x149C96CD, 0x6D16CBAC)},
+    {LXW_UINT64(0x26C4A24C, 0x1573ACD1), LXW_UINT64(0x19C3BC80, 0xC85C7E97)},
+    {LXW_UINT64(0x783AE56F, 0x8D684C03), LXW_UINT64(0x101A55D0, 0x7D39CF1E)},
+    {LXW_UINT64(0x16499ECB, 0x70C25F03), LXW_UINT64(0x1420EB44, 0x9C8842E6)},
+    {LXW_UINT64(0x9BDC067E, 0x4CF2F6C4), LXW_UINT64(0x19292615, 0xC3AA539F)},
+    {LXW_UINT64(0x82D3081D, 0xE02FB476), LXW_UINT64(0x1F736F9B, 0x3494E887)},
+    {LXW_UINT64(0xB1C3E512, 0xAC1DD0C9), LXW_UINT64(0x13A825C1, 0x00DD1154)},
+    {LXW_UINT64(0xDE34DE57, 0x572544FC), LXW_UINT64(0x18922F31, 0x411455A9)},
+    {LXW_UINT64(0x55C215ED, 0x2CEE963B), LXW_UINT64(0x1EB6BAFD, 0x91596B14)},
+    {LXW_UINT64(0xB5994DB4, 0x3C151DE5), LXW_UINT64(0x133234DE, 0x7AD7E2EC)},
+    {LXW_UINT64(0xE2FFA121, 0x4B1A655E), LXW_UINT64(0x17FEC216, 0x198DDBA7)},
+    {LXW_UINT64(0xDBBF8969, 0x9DE0FEB6), LXW_UINT64(0x1DFE729B, 0x9FF15291)},
+    {LXW_UINT64(0x2957B5E2, 0x02AC9F31), LXW_UINT64(0x12BF07A1, 0x43F6D39B)},
+    {LXW_UINT64(0xF3ADA35A, 0x8357C6FE), LXW_UINT64(0x176EC989, 0x94F48881)},
+    {LXW_UINT64(0x70990C31, 0x242DB8BD), LXW_UINT64(0x1D4A7BEB, 0xFA31AAA2)},
+    {LXW_UINT64(0x865FA79E, 0xB69C9376), LXW_UINT64(0x124E8D73, 0x7C5F0AA5)},
+    {LXW_UINT64(0xE7F79186, 0x6443B854), LXW_UINT64(0x16E230D0, 0x5B76CD4E)},
+    {LXW_UINT64(0xA1F575E7, 0xFD54A669), LXW_UINT64(0x1C9ABD04, 0x725480A2)},
+    {LXW_UINT64(0xA53969B0, 0xFE54E801), LXW_UINT64(0x11E0B622, 0xC774D065)},
+    {LXW_UINT64(0x0E87C41D, 0x3DEA2202), LXW_UINT64(0x1658E3AB, 0x7952047F)},
+    {LXW_UINT64(0xD229B524, 0x8D64AA82), LXW_UINT64(0x1BEF1C96, 0x57A6859E)},
+    {LXW_UINT64(0x435A1136, 0xD85EEA91), LXW_UINT64(0x117571DD, 0xF6C81383)},
+    {LXW_UINT64(0x14309584, 0x8E76A536), LXW_UINT64(0x15D2CE55, 0x747A1864)},
+    {LXW_UINT64(0x193CBAE5, 0xB2144E83), LXW_UINT64(0x1B4781EA, 0xD1989E7D)},
+    {LXW_UINT64(0x2FC5F4CF, 0x8F4CB112), LXW_UINT64(0x110CB132, 0xC2FF630E)},
+    {LXW_UINT64(0xBBB77203, 0x731FDD56), LXW_UINT64(0x154FDD7F, 0x73BF3BD1)},
+    {LXW_UINT64(0x2AA54E84, 0x4FE7D4AC), LXW_UINT64(0x1AA3D4DF, 0x50AF0AC6)},
+    {LXW_UINT64(0xDAA75112, 0xB1F0E4EB), LXW_UINT64(0x10A6650B, 0x926D66BB)},
+    {LXW_UINT64(0xD1512557, 0x5E6D1E26), LXW_UINT64(0x14CFFE4E, 0x7708C06A)},
+    {LXW_UINT64(0x85A56EAD, 0x360865B0), LXW_UINT64(0x1A03FDE2, 0x14CAF085)},
+    {LXW_UINT64(0x7387652C, 0x41C53F8E), LXW_UINT64(0x10427EAD, 0x4CFED653)},
+    {LXW_UINT64(0x50693E77, 0x52368F71), LXW_UINT64(0x14531E58, 0xA03E8BE8)},
+    {LXW_UINT64(0x64838E15, 0x26C4334E), LXW_UINT64(0x1967E5EE, 0xC84E2EE2)},
+    {LXW_UINT64(0xFDA4719A, 0x70754022), LXW_UINT64(0x1FC1DF6A, 0x7A61BA9A)},
+    {LXW_UINT64(0xDE86C700, 0x86494815), LXW_UINT64(0x13D92BA2, 0x8C7D14A0)},
+    {LXW_UINT64(0x162878C0, 0xA7DB9A1A), LXW_UINT64(0x18CF768B, 0x2F9C59C9)},
+    {LXW_UINT64(0x5BB296F0, 0xD1D280A1), LXW_UINT64(0x1F03542D, 0xFB83703B)},
+    {LXW_UINT64(0x194F9E56, 0x83239064), LXW_UINT64(0x1362149C, 0xBD322625)},
+    {LXW_UINT64(0x5FA385EC, 0x23EC747E), LXW_UINT64(0x183A99C3, 0xEC7EAFAE)},
+    {LXW_UINT64(0xF78C6767, 0x2CE7919D), LXW_UINT64(0x1E494034, 0xE79E5B99)},
+    {LXW_UINT64(0x3AB7C0A0, 0x7C10BB02), LXW_UINT64(0x12EDC821, 0x10C2F940)},
+    {LXW_UINT64(0x4965B0C8, 0x9B14E9C3), LXW_UINT64(0x17A93A29, 0x54F3B790)},
+    {LXW_UINT64(0x5BBF1CFA, 0xC1DA2433), LXW_UINT64(0x1D9388B3, 0xAA30A574)},
+    {LXW_UINT64(0xB957721C, 0xB92856A0), LXW_UINT64(0x127C3570, 0x4A5E6768)},
+    {LXW_UINT64(0xE7AD4EA3, 0xE7726C48), LXW_UINT64(0x171B42CC, 0x5CF60142)},
+    {LXW_UINT64(0xA198A24C, 0xE14F075A), LXW_UINT64(0x1CE2137F, 0x74338193)},
+    {LXW_UINT64(0x44FF6570, 0x0CD16498), LXW_UINT64(0x120D4C2F, 0xA8A030FC)},
+    {LXW_UINT64(0x563F3ECC, 0x1005BDBE), LXW_UINT64(0x16909F3B, 0x92C83D3B)},
+    {LXW_UINT64(0x2BCF0E7F, 0x14072D2E), LXW_UINT64(0x1C34C70A, 0x777A4C8A)},
+    {LXW_UINT64(0x5B61690F, 0x6C847C3D), LXW_UINT64(0x11A0FC66, 0x8AAC6FD6)},
+    {LXW_UINT64(0xF239C353, 0x47A59B4C), LXW_UINT64(0x16093B80, 0x2D578BCB)},
+    {LXW_UINT64(0xEEC83428, 0x198F021F), LXW_UINT64(0x1B8B8A60, 0x38AD6EBE)},
+    {LXW_UINT64(0x553D2099, 0x0FF96153), LXW_UINT64(0x1137367C, 0x236C6537)},
+    {LXW_UINT64(0x2A8C68BF, 0x53F7B9A8), LXW_UINT64(0x1585041B, 0x2C477E85)},
+    {LXW_UINT64(0x752F82EF, 0x28F5A812), LXW_UINT64(0x1AE64521, 0xF7595E26)},
+    {LXW_UINT64(0x093DB1D5, 0x7999890B), LXW_UINT64(0x10CFEB35, 0x3A97DAD8)},
+    {LXW_UINT64(0x0B8D1E4A, 0xD7FFEB4E), LXW_UINT64(0x1503E602, 0x893DD18E)},
+    {LXW_UINT64(0x8E7065DD, 0x8DFFE622), LXW_UINT64(0x1A44DF83, 0x2B8D45F1)},
+    {LXW_UINT64(0xF9063FAA, 0x78BFEFD5), LXW_UINT64(0x106B0BB1, 0xFB384BB6)},
+    {LXW_UINT64(0xB747CF95, 0x16EFEBCA), LXW_UINT64(0x1485CE9E, 0x7A065EA4)},
+    {LXW_UINT64(0xE519C37A, 0x5CABE6BD), LXW_UINT64(0x19A74246, 0x1887F64D)},
+    {LXW_UINT64(0xAF301A2C, 0x79EB7036), LXW_UINT64(0x1008896B, 0xCF54F9F0)},
+    {LXW_UINT64(0xDAFC20B7, 0x98664C43), LXW_UINT64(0x140AABC6, 0xC32A386C)},
+    {LXW_UINT64(0x11BB28E5, 0x7E7FDF54), LXW_UINT64(0x190D56B8, 0x73F4C688)},
+    {LXW_UINT64(0x1629F31E, 0xDE1FD72A), LXW_UINT64(0x1F50AC66, 0x90F1F82A)},
+    {LXW_UINT64(0x4DDA37F3, 0x4AD3E67A), LXW_UINT64(0x13926BC0, 0x1A973B1A)},
+    {LXW_UINT64(0xE150C5F0, 0x1D88E019), LXW_UINT64(0x187706B0, 0x213D09E0)},
+    {LXW_UINT64(0x19A4F76C, 0x24EB181F), LXW_UINT64(0x1E94C85C, 0x298C4C59)},
+    {LXW_UINT64(0xB0071AA3, 0x9712EF13), LXW_UINT64(0x131CFD39, 0x99F7AFB7)},
+    {LXW_UINT64(0x9C08E14C, 0x7CD7AAD8), LXW_UINT64(0x17E43C88, 0x00759BA5)},
+    {LXW_UINT64(0x030B199F, 0x9C0D958E), LXW_UINT64(0x1DDD4BAA, 0x0093028F)},
+    {LXW_UINT64(0x61E6F003, 0xC1887D79), LXW_UINT64(0x12AA4F4A, 0x405BE199)},
+    {LXW_UINT64(0xBA60AC04, 0xB1EA9CD7), LXW_UINT64(0x1754E31C, 0xD072D9FF)},
+    {LXW_UINT64(0xA8F8D705, 0xDE65440D), LXW_UINT64(0x1D2A1BE4, 0x048F907F)},
+    {LXW_UINT64(0xC99B8663, 0xAAFF4A88), LXW_UINT64(0x123A516E, 0x82D9BA4F)},
+    {LXW_UINT64(0xBC0267FC, 0x95BF1D2A), LXW_UINT64(0x16C8E5CA, 0x239028E3)},
+    {LXW_UINT64(0xAB0301FB, 0xBB2EE474), LXW_UINT64(0x1C7B1F3C, 0xAC74331C)},
+    {LXW_UINT64(0xEAE1E13D, 0x54FD4EC9), LXW_UINT64(0x11CCF385, 0xEBC89FF1)},
+    {LXW_UINT64(0x659A598C, 0xAA3CA27B), LXW_UINT64(0x16403067, 0x66BAC7EE)},
+    {LXW_UINT64(0xFF00EFEF, 0xD4CBCB1A), LXW_UINT64(0x1BD03C81, 0x406979E9)},
+    {LXW_UINT64(0x3F6095F5, 0xE4FF5EF0), LXW_UINT64(0x116225D0, 0xC841EC32)},
+    {LXW_UINT64(0xCF38BB73, 0x5E3F36AC), LXW_UINT64(0x15BAAF44, 0xFA52673E)},
+    {LXW_UINT64(0x8306EA50, 0x35CF0457), LXW_UINT64(0x1B295B16, 0x38E7010E)},
+    {LXW_UINT64(0x11E45272, 0x21A162B6), LXW_UINT64(0x10F9D8ED, 0xE39060A9)},
+    {LXW_UINT64(0x565D670E, 0xAA09BB64), LXW_UINT64(0x15384F29, 0x5C7478D3)},
+    {LXW_UINT64(0x2BF4C0D2, 0x548C2A3D), LXW_UINT64(0x1A8662F3, 0xB3919708)},
+    {LXW_UINT64(0x1B78F883, 0x74D79A66), LXW_UINT64(0x1093FDD8, 0x503AFE65)},
+    {LXW_UINT64(0x625736A4, 0x520D8100), LXW_UINT64(0x14B8FD4E, 0x6449BDFE)},
+    {LXW_UINT64(0xFAED044D, 0x6690E140), LXW_UINT64(0x19E73CA1, 0xFD5C2D7D)},
+    {LXW_UINT64(0xBCD422B0, 0x601A8CC8), LXW_UINT64(0x103085E5, 0x3E599C6E)},
+    {LXW_UINT64(0x6C092B5C, 0x78212FFA), LXW_UINT64(0x143CA75E, 0x8DF0038A)},
+    {LXW_UINT64(0x070B7633, 0x96297BF8), LXW_UINT64(0x194BD136, 0x316C046D)},
+    {LXW_UINT64(0x48CE53C0, 0x7BB3DAF6), LXW_UINT64(0x1F9EC583, 0xBDC70588)},
+    {LXW_UINT64(0x2D80F458, 0x4D5068DA), LXW_UINT64(0x13C33B72, 0x569C6375)},
+    {LXW_UINT64(0x78E1316E, 0x60A48310), LXW_UINT64(0x18B40A4E, 0xEC437C52)}
+};
+
+/* Returns ceil(log2(5^e)), or 1 for e == 0. */
+STATIC int32_t
+_pow5_bits(int32_t e)
+{
+    return ((e * 1217359) >> 19) + 1;
+}
+
+/* Returns floor(log10(2^e)). */
+STATIC int32_t
+_log10_pow2(int32_t e)
+{
+    return (e * 78913) >> 18;
+}
+
+/* Returns floor(log10(5^e)). */
+STATIC int32_t
+_log10_pow5(int32_t e)
+{
+    return (e * 732923) >> 20;
+}
+
+/* Check if a non-zero value is divisible by 5^p. */
+STATIC uint8_t
+_multiple_of_pow5(uint64_t value, int32_t p)
+{
+    int32_t count = 0;
+
+    while (value % 5 == 0) {
+        value /= 5;
+        count++;
+    }
+
+    return count >= p;
+}
+
+/* Check if a value is divisible by 2^p, for p < 64. */
+STATIC uint8_t
+_multiple_of_pow2(uint64_t value, int32_t p)
+{
+    return (value & ((LXW_UINT64(0, 1) << p) - 1)) == 0;
+}
+
+/* Multiply two 64 bit values. Returns the low word of the 128 bit product
+ * and stores the high word in "high". */
+STATIC uint64_t
+_umul128(uint64_t a, uint64_t b, uint64_t *high)
+{
+    uint64_t a_lo = a & 0xFFFFFFFF;
+    uint64_t a_hi = a >> 32;
+    uint64_t b_lo = b & 0xFFFFFFFF;
+    uint64_t b_hi = b >> 32;
+    uint64_t b00 = a_lo * b_lo;
+    uint64_t b01 = a_lo * b_hi;
+    uint64_t b10 = a_hi * b_lo;
+    uint64_t b11 = a_hi * b_hi;
+    uint64_t mid1 = b10 + (b00 >> 32);
+    uint64_t mid2 = b01 + (mid1 & 0xFFFFFFFF);
+
+    *high = b11 + (mid1 >> 32) + (mid2 >> 32);
+
+    return (mid2 << 32) | (b00 & 0xFFFFFFFF);
+}
+
+/* Returns (m * mul) >> j where mul is a 128 bit {low, high} value and
+ * 64 < j < 128. */
+STATIC uint64_t
+_mul_shift64(uint64_t m, const uint64_t *mul, int32_t j)
+{
+    uint64_t high0;
+    uint64_t high1;
+    uint64_t low1;
+    uint64_t sum;
+    int32_t shift = j - 64;
+
+    (void) _umul128(m, mul[0], &high0);
+    low1 = _umul128(m, mul[1], &high1);
+
+    sum = high0 + low1;
+    if (sum < high0)
+        high1++;
+
+    return (high1 << (64 - shift)) | (sum >> shift);
+}
+
+/*
+ * Convert the mantissa and exponent of a finite, non-zero, double to the
+ * shortest decimal digits and power of 10 that round trip to the same value.
+ */
+STATIC void
+_dbl_to_decimal(uint64_t ieee_mantissa, uint32_t ieee_exponent,
+                uint64_t *decimal, int32_t *exponent)
+{
+    int32_t e2;
+    int32_t e10;
+    int32_t q;
+    int32_t i;
+    int32_t k;
+    int32_t removed = 0;
+    uint64_t m2;
+    uint64_t mv;
+    uint64_t vr;
+    uint64_t vp;
+    uint64_t vm;
+    uint64_t mm_shift;
+    uint8_t accept_bounds;
+    uint8_t vm_is_trailing_zeros = LXW_FALSE;
+    uint8_t vr_is_trailing_zeros = LXW_FALSE;
+    uint8_t last_removed_digit = 0;
+    uint8_t round_up = LXW_FALSE;
+
+    /* Subtract 2 from the exponent so that the halfway points between
+     * adjacent doubles are integers. */
+    if (ieee_exponent == 0) {
+        e2 = 1 - LXW_DBL_BIAS - LXW_DBL_MANTISSA_BITS - 2;
+        m2 = ieee_mantissa;
+    }
+    else {
+        e2 = (int32_t) ieee_exponent - LXW_DBL_BIAS
+            - LXW_DBL_MANTISSA_BITS - 2;
+        m2 = (LXW_UINT64(0, 1) << LXW_DBL_MANTISSA_BITS) | ieee_mantissa;
+    }
+
+    accept_bounds = (m2 & 1) == 0;
+
+    /* The value and the upper and lower halfway points, as mv * 2^e2. The
+     * lower gap is smaller at a power of 2 boundary. */
+    mv = 4 * m2;
+    mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+
+    /* Convert the value and bounds to decimal, with a power of 10 chosen
+     * so that the results fit into 64 bits. */
+    if (e2 >= 0) {
+        q = _log10_pow2(e2) - (e2 > 3);
+        e10 = q;
+        k = LXW_POW5_INV_BITCOUNT + _pow5_bits(q) - 1;
+        i = -e2 + q + k;
+
+        vr = _mul_shift64(4 * m2, lxw_pow5_inv_split[q], i);
+        vp = _mul_shift64(4 * m2 + 2, lxw_pow5_inv_split[q], i);
+        vm = _mul_shift64(4 * m2 - 1 - mm_shift, lxw_pow5_inv_split[q], i);
+
+        /* Only one of mp, mv and mm can be a multiple of 5, if any. */
+        if (q <= 21) {
+            if (mv % 5 == 0)
+                vr_is_trailing_zeros = _multiple_of_pow5(mv, q);
+            else if (accept_bounds)
+                vm_is_trailing_zeros =
+                    _multiple_of_pow5(mv - 1 - mm_shift, q);
+            else
+                vp -= _multiple_of_pow5(mv + 2, q);
+        }
+    }
+    else {
+        q = _log10_pow5(-e2) - (-e2 > 1);
+        e10 = q + e2;
+        i = -e2 - q;
+        k = _pow5_bits(i) - LXW_POW5_BITCOUNT;
+
+        vr = _mul_shift64(4 * m2, lxw_pow5_split[i], q - k);
+        vp = _mul_shift64(4 * m2 + 2, lxw_pow5_split[i], q - k);
+        vm = _mul_shift64(4 * m2 - 1 - mm_shift, lxw_pow5_split[i], q - k);
+
+        if (q <= 1) {
+            /* mv has at least 2 trailing zero bits. mm has 1 trailing zero
+             * bit if mm_shift is 1. mp has 1 trailing zero bit. */
+            vr_is_trailing_zeros = LXW_TRUE;
+
+            if (accept_bounds)
+                vm_is_trailing_zeros = mm_shift == 1;
+            else
+                vp--;
+        }
+        else if (q < 63) {
+            vr_is_trailing_zeros = _multiple_of_pow2(mv, q);
+        }
+    }
+
+    /* Remove digits while the upper and lower bounds still differ. */
+    if (vm_is_trailing_zeros || vr_is_trailing_zeros) {
+        /* General case, which happens rarely. */
+        while (vp / 10 > vm / 10) {
+            vm_is_trailing_zeros &= vm % 10 == 0;
+            vr_is_trailing_zeros &= last_removed_digit == 0;
+            last_removed_digit = (uint8_t) (vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+
+        if (vm_is_trailing_zeros) {
+            while (vm % 10 == 0) {
+                vr_is_trailing_zeros &= last_removed_digit == 0;
+                last_removed_digit = (uint8_t) (vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed++;
+            }
+        }
+
+        /* Round to even if the exact value is halfway between digits. */
+        if (vr_is_trailing_zeros && last_removed_digit == 5 && vr % 2 == 0)
+            last_removed_digit = 4;
+
+        *decimal = vr + ((vr == vm && (!accept_bounds
+                                       || !vm_is_trailing_zeros))
+                         || last_removed_digit >= 5);
+    }
+    else {
+        /* Common case. */
+        while (vp / 10 > vm / 10) {
+            round_up = vr % 10 >= 5;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+
+        *decimal = vr + (vr == vm || round_up);
+    }
+
+    *exponent = e10 + removed;
+}
+
 /*
- * Use third party function to handle sprintf of doubles for locale portable
- * code.
+ * Write a double to a string in "%.16G" style using the shortest digits that
+ * convert back to the same value. The string buffer should be at least
+ * LXW_ATTR_32 bytes. Returns the length of the string.
  */
-#ifdef USE_DTOA_LIBRARY
 int
 lxw_sprintf_dbl(char *data, double number)
 {
-    emyg_dtoa(number, data);
-    return 0;
+    char digits[20];
+    char *p = data;
+    uint64_t bits;
+    uint64_t ieee_mantissa;
+    uint32_t ieee_exponent;
+    uint64_t decimal;
+    int32_t exponent;
+    int32_t num_digits = 0;
+    int32_t i;
+
+    memcpy(&bits, &number, sizeof(bits));
+
+    ieee_mantissa = bits & ((LXW_UINT64(0, 1) << LXW_DBL_MANTISSA_BITS) - 1);
+    ieee_exponent = (uint32_t) (bits >> LXW_DBL_MANTISSA_BITS) & 0x7FF;
+
+    if (bits >> 63)
+        *p++ = '-';
+
+    /* Infinity and NaN. Excel doesn't support these but they are written the
+     * same way as sprintf() for consistency. */
+    if (ieee_exponent == 0x7FF) {
+        if (ieee_mantissa)
+            memcpy(p, "NAN", 4);
+        else
+            memcpy(p, "INF", 4);
+
+        return (int) (p - data) + 3;
+    }
+
+    /* Integer values, the most common case, don't need the full conversion.
+     * They are exact below 2^53 and have no shorter representation up to
+     * 1E16 where the exponential format begins. */
+    if (number > -1e16 && number < 1e16
+        && number == (double) (int64_t) number) {
+        decimal = (uint64_t) (number < 0 ? -number : number);
+        exponent = 0;
+
+        if (decimal == 0) {
+            *p++ = '0';
+            *p = '\0';
+            return (int) (p - data);
+        }
+    }
+    else {
+        _dbl_to_decimal(ieee_mantissa, ieee_exponent, &decimal, &exponent);
+    }
+
+    /* Remove any trailing zeros from the decimal digits. */
+    while (decimal % 10 == 0) {
+        decimal /= 10;
+        exponent++;
+    }
+
+    /* Convert the digits to characters, in reverse order. */
+    do {
+        digits[num_digits++] = (char) ('0' + decimal % 10);
+        decimal /= 10;
+    } while (decimal);
+
+    /* Convert the exponent to the scientific notation exponent. */
+    exponent += num_digits - 1;
+
+    if (exponent < -4 || exponent >= 16) {
+        /* Exponential format: 1.2345E+20. */
+        *p++ = digits[--num_digits];
+
+        if (num_digits) {
+            *p++ = '.';
+            while (num_digits)
+                *p++ = digits[--num_digits];
+        }
+
+        *p++ = 'E';
+
+        if (exponent < 0) {
+            *p++ = '-';
+            exponent = -exponent;
+        }
+        else {
+            *p++ = '+';
+        }
+
+        if (exponent >= 100) {
+            *p++ = (char) ('0' + exponent / 100);
+            exponent %= 100;
+        }
+
+        *p++ = (char) ('0' + exponent / 10);
+        *p++ = (char) ('0' + exponent % 10);
+    }
+    else if (exponent < 0) {
+        /* Fractional number: 0.0012345. */
+        *p++ = '0';
+        *p++ = '.';
+
+        for (i = -1; i > exponent; i--)
+            *p++ = '0';
+
+        while (num_digits)
+            *p++ = digits[--num_digits];
+    }
+    else {
+        /* Number with an integer part: 12345000 or 123.45. */
+        for (i = 0; i <= exponent; i++)
+            *p++ = num_digits ? digits[--num_digits] : '0';
+
+        if (num_digits) {
+            *p++ = '.';
+            while (num_digits)
+                *p++ = digits[--num_digits];
+        }
+    }
+
+    *p = '\0';
+
+    return (int) (p - data);
 }
-#endif
 
 /*
  * Retrieve runtime library version.
@@ -115,6 +115,7 @@ lxw_workbook_free(lxw_workbook *workbook)
     lxw_defined_name *defined_name;
     lxw_defined_name *defined_name_tmp;
     lxw_custom_property *custom_property;
+    lxw_compression_override *compression_override;
 
     if (!workbook)
         return;
@@ -153,6 +154,8 @@ lxw_workbook_free(lxw_workbook *workbook)
         free(workbook->charts);
     }
 
+    lxw_chart_range_taps_free(&workbook->chart_range_taps);
+
     /* Free the formats in the workbook. */
     if (workbook->formats) {
         while (!STAILQ_EMPTY(workbook->formats)) {
@@ -185,6 +188,19 @@ lxw_workbook_free(lxw_workbook *workbook)
         free(workbook->custom_properties);
     }
 
+    /* Free the compression overrides in the workbook. */
+    if (workbook->compression_overrides) {
+        while (!STAILQ_EMPTY(workbook->compression_overrides)) {
+            compression_override =
+                STAILQ_FIRST(workbook->compression_overrides);
+            STAILQ_REMOVE_HEAD(workbook->compression_overrides,
+                               list_pointers);
+            free(compression_override->part_name);
+            free(compression_override);
+        }
+        free(workbook->compression_overrides);
+    }
+
     if (workbook->worksheet_names) {
         for (worksheet_name =
              RB_MIN(lxw_worksheet_names, workbook->worksheet_names);
@@ -279,6 +295,7 @@ lxw_workbook_free(lxw_workbook *workbook)
 
     lxw_hash_free(workbook->used_xf_formats);
     lxw_hash_free(workbook->used_dxf_formats);
+    lxw_hash_free(workbook->interned_formats);
     lxw_sst_free(workbook->sst);
     free((void *) workbook->options.tmpdir);
     free(workbook->ordered_charts);
@@ -827,23 +844,26 @@ mem_error:
 
 /*
  * Populate the data cache of a chart data series by reading the data from the
- * relevant worksheet and adding it to the cached in the range object as a
- * list of points.
+ * relevant worksheet and adding it to the cache arrays in the range object.
  *
  * Note, the data cache isn't strictly required by Excel but it helps if the
  * chart is embedded in another application such as PowerPoint and it also
  * helps with comparison testing.
  */
 STATIC void
-_populate_range_data_cache(lxw_workbook *self, lxw_series_range *range)
+_populate_range_data_cache(lxw_workbook *self, lxw_series_range *range,
+                           lxw_hash_table *range_caches)
 {
     lxw_worksheet *worksheet;
-    lxw_row_t row_num;
-    lxw_col_t col_num;
-    lxw_row *row_obj;
+    lxw_range_iterator iterator;
+    lxw_chart_range_key key;
+    lxw_chart_range_key *new_key;
+    lxw_hash_element *element;
     lxw_cell *cell_obj;
-    struct lxw_series_data_point *data_point;
-    uint16_t num_data_points = 0;
+    uint32_t num_data_points;
+    uint32_t num_cells = 0;
+    uint32_t index;
+    lxw_error err = LXW_NO_ERROR;
 
     /* If ignore_cache is set then don't try to populate the cache. This flag
      * may be set manually, for testing, or due to a case where the cache
@@ -852,6 +872,10 @@ _populate_range_data_cache(lxw_workbook *self, lxw_series_range *range)
     if (range->ignore_cache)
         return;
 
+    /* Ranges set from arrays already have the cache populated. */
+    if (range->has_array_data)
+        return;
+
     /* Currently we only handle 2D ranges so ensure either the rows or cols
      * are the same.
      */
@@ -871,49 +895,77 @@ _populate_range_data_cache(lxw_workbook *self, lxw_series_range *range)
         return;
     }
 
-    /* We can't read the data when worksheet optimization is on. */
+    /* We can't read the data when worksheet optimization is on. Instead it
+     * is captured as the rows are written if the range was set in time. */
     if (worksheet->optimize) {
-        range->ignore_cache = LXW_TRUE;
+        if (!range->has_row_tap)
+            range->ignore_cache = LXW_TRUE;
         return;
     }
 
-    /* Iterate through the worksheet data and populate the range cache. */
-    for (row_num = range->first_row; row_num <= range->last_row; row_num++) {
-        row_obj = lxw_worksheet_find_row(worksheet, row_num);
+    /* Copy the cache of a range with the same data, if it has been read. */
+    memset(&key, 0, sizeof(key));
+    key.worksheet = worksheet;
+    key.first_row = range->first_row;
+    key.last_row = range->last_row;
+    key.first_col = range->first_col;
+    key.last_col = range->last_col;
 
-        for (col_num = range->first_col; col_num <= range->last_col;
-             col_num++) {
+    if (range_caches) {
+        element = lxw_hash_key_exists(range_caches, &key, sizeof(key));
 
-            data_point = calloc(1, sizeof(struct lxw_series_data_point));
-            if (!data_point) {
+        if (element) {
+            if (lxw_chart_copy_data_cache(range, element->value))
                 range->ignore_cache = LXW_TRUE;
-                return;
-            }
-
-            cell_obj = lxw_worksheet_find_cell_in_row(row_obj, col_num);
+            return;
+        }
+    }
 
-            if (cell_obj) {
-                if (cell_obj->type == NUMBER_CELL) {
-                    data_point->number = cell_obj->u.number;
-                }
+    /* Allocate the cache for all of the points in the range at once. The
+     * points start as empty and are filled from the stored cells. */
+    num_data_points = (uint32_t) (range->last_row - range->first_row + 1)
+        * (range->last_col - range->first_col + 1);
 
-                if (cell_obj->type == STRING_CELL) {
-                    data_point->string = lxw_strdup(cell_obj->sst_string);
-                    data_point->is_string = LXW_TRUE;
-                    range->has_string_cache = LXW_TRUE;
-                }
-            }
-            else {
-                data_point->no_data = LXW_TRUE;
-            }
+    if (lxw_chart_init_empty_data_cache(range, num_data_points)) {
+        range->ignore_cache = LXW_TRUE;
+        return;
+    }
 
-            STAILQ_INSERT_TAIL(range->data_cache, data_point, list_pointers);
-            num_data_points++;
+    /* Iterate through the worksheet data and populate the range cache. */
+    lxw_worksheet_range_iterator_init(&iterator, worksheet,
+                                      range->first_row, range->first_col,
+                                      range->last_row, range->last_col);
+
+    while ((cell_obj = lxw_worksheet_range_iterator_next(&iterator))) {
+        index = (uint32_t) (cell_obj->row_num - range->first_row)
+            * (range->last_col - range->first_col + 1)
+            + (cell_obj->col_num - range->first_col);
+
+        err = lxw_worksheet_cache_chart_cell(range, index, cell_obj);
+        if (err) {
+            lxw_chart_free_data_cache(range);
+            range->ignore_cache = LXW_TRUE;
+            return;
         }
+
+        num_cells++;
     }
 
-    range->num_data_points = num_data_points;
+    /* The empty point bitmap isn't needed if there are no empty points. */
+    if (num_cells == num_data_points) {
+        free(range->no_data_cache);
+        range->no_data_cache = NULL;
+    }
 
+    if (range_caches) {
+        new_key = malloc(sizeof(key));
+        if (new_key) {
+            memcpy(new_key, &key, sizeof(key));
+            if (!lxw_insert_hash_element(range_caches, new_key, range,
+                                         sizeof(key)))
+                free(new_key);
+        }
+    }
 }
 
 /* Convert a chart range such as Sheet1!$A$1:$A$5 to a sheet name and row-col
@@ -923,11 +975,6 @@ _populate_range_data_cache(lxw_workbook *self, lxw_series_range *range)
 STATIC void
 _populate_range_dimensions(lxw_workbook *self, lxw_series_range *range)
 {
-
-    char formula[LXW_MAX_FORMULA_RANGE_LENGTH] = { 0 };
-    char *tmp_str;
-    char *sheetname;
-
     /* If neither the range formula or sheetname is defined then this probably
      * isn't a valid range.
      */
@@ -942,83 +989,32 @@ _populate_range_dimensions(lxw_workbook *self, lxw_series_range *range)
     if (range->sheetname)
         return;
 
-    /* Ignore non-contiguous range like (Sheet1!$A$1:$A$2,Sheet1!$A$4:$A$5) */
-    if (range->formula[0] == '(') {
+    if (lxw_chart_parse_range_formula(range)) {
         range->ignore_cache = LXW_TRUE;
         return;
     }
 
-    /* Create a copy of the formula to modify and parse into parts. */
-    lxw_snprintf(formula, LXW_MAX_FORMULA_RANGE_LENGTH, "%s", range->formula);
-
-    /* Check for valid formula. Note, This needs stronger validation. */
-    tmp_str = strchr(formula, '!');
-
-    if (tmp_str == NULL) {
+    /* Check that the sheetname exists. */
+    if (!workbook_get_worksheet_by_name(self, range->sheetname)) {
+        LXW_WARN_FORMAT2("workbook_add_chart(): worksheet name '%s' "
+                         "in chart formula '%s' doesn't exist.",
+                         range->sheetname, range->formula);
         range->ignore_cache = LXW_TRUE;
         return;
     }
-    else {
-        /* Check for empty string. */
-        if (lxw_str_is_empty(tmp_str)) {
-            range->ignore_cache = LXW_TRUE;
-            return;
-        }
-
-        /* Split the formulas into sheetname and row-col data. */
-        *tmp_str = '\0';
-        tmp_str++;
-        sheetname = formula;
-
-        if (lxw_str_is_empty(tmp_str) || lxw_str_is_empty(sheetname)) {
-            range->ignore_cache = LXW_TRUE;
-            return;
-        }
-
-        /* Remove any worksheet quoting. */
-        if (sheetname[0] == '\'')
-            sheetname++;
-        if (strlen(sheetname) > 0 && sheetname[strlen(sheetname) - 1] == '\'') {
-            sheetname[strlen(sheetname) - 1] = '\0';
-        }
-
-        /* Check that the sheetname exists. */
-        if (!workbook_get_worksheet_by_name(self, sheetname)) {
-            LXW_WARN_FORMAT2("workbook_add_chart(): worksheet name '%s' "
-                             "in chart formula '%s' doesn't exist.",
-                             sheetname, range->formula);
-            range->ignore_cache = LXW_TRUE;
-            return;
-        }
-
-        range->sheetname = lxw_strdup(sheetname);
-        range->first_row = lxw_name_to_row(tmp_str);
-        range->first_col = lxw_name_to_col(tmp_str);
-
-        if (strchr(tmp_str, ':')) {
-            /* 2D range. */
-            range->last_row = lxw_name_to_row_2(tmp_str);
-            range->last_col = lxw_name_to_col_2(tmp_str);
-        }
-        else {
-            /* 1D range. */
-            range->last_row = range->first_row;
-            range->last_col = range->first_col;
-        }
-
-    }
 }
 
 /* Set the range dimensions and set the data cache.
  */
 STATIC void
-_populate_range(lxw_workbook *self, lxw_series_range *range)
+_populate_range(lxw_workbook *self, lxw_series_range *range,
+                lxw_hash_table *range_caches)
 {
     if (!range)
         return;
 
     _populate_range_dimensions(self, range);
-    _populate_range_data_cache(self, range);
+    _populate_range_data_cache(self, range, range_caches);
 }
 
 /*
@@ -1032,26 +1028,155 @@ _add_chart_cache_data(lxw_workbook *self)
     lxw_chart_series *series;
     uint16_t i;
 
+    /* Ranges that refer to the same worksheet data, which is common for
+     * series shared by several charts, are only read once. If the hash
+     * table can't be created each range is read separately. */
+    lxw_hash_table *range_caches = lxw_hash_new(128, 1, 0);
+
     STAILQ_FOREACH(chart, self->ordered_charts, ordered_list_pointers) {
 
-        _populate_range(self, chart->title.range);
-        _populate_range(self, chart->x_axis->title.range);
-        _populate_range(self, chart->y_axis->title.range);
+        _populate_range(self, chart->title.range, range_caches);
+        _populate_range(self, chart->x_axis->title.range, range_caches);
+        _populate_range(self, chart->y_axis->title.range, range_caches);
 
         if (STAILQ_EMPTY(chart->series_list))
             continue;
 
         STAILQ_FOREACH(series, chart->series_list, list_pointers) {
-            _populate_range(self, series->categories);
-            _populate_range(self, series->values);
-            _populate_range(self, series->title.range);
+            _populate_range(self, series->categories, range_caches);
+            _populate_range(self, series->values, range_caches);
+            _populate_range(self, series->title.range, range_caches);
 
             for (i = 0; i < series->data_label_count; i++) {
                 lxw_chart_custom_label *data_label = &series->data_labels[i];
-                _populate_range(self, data_label->range);
+                _populate_range(self, data_label->range, range_caches);
             }
         }
     }
+
+    lxw_hash_free(range_caches);
+}
+
+/*
+ * Write the data of chart series ranges set from arrays to hidden worksheets
+ * and point the ranges at the data. Each range is stored in a column and the
+ * data is written row by row so that it is streamed in constant_memory mode.
+ * The range data caches are already populated from the arrays.
+ */
+STATIC lxw_error
+_prepare_chart_array_data(lxw_workbook *self)
+{
+    lxw_chart *chart;
+    lxw_chart_series *series;
+    lxw_series_range *range;
+    lxw_series_range **ranges = NULL;
+    lxw_worksheet **data_sheets = NULL;
+    lxw_worksheet *worksheet;
+    uint32_t num_ranges = 0;
+    uint32_t num_sheets;
+    uint32_t max_points = 0;
+    uint32_t suffix = 1;
+    uint32_t i;
+    lxw_row_t row_num;
+    lxw_col_t col_num;
+    char sheetname[LXW_MAX_SHEETNAME_LENGTH];
+    lxw_error err = LXW_NO_ERROR;
+
+    /* Collect the ranges of the charts in use that were set from arrays. */
+    STAILQ_FOREACH(chart, self->charts, list_pointers) {
+        if (!chart->in_use)
+            continue;
+
+        STAILQ_FOREACH(series, chart->series_list, list_pointers) {
+            if (series->categories->has_array_data)
+                num_ranges++;
+            if (series->values->has_array_data)
+                num_ranges++;
+        }
+    }
+
+    if (!num_ranges)
+        return LXW_NO_ERROR;
+
+    ranges = calloc(num_ranges, sizeof(lxw_series_range *));
+    RETURN_ON_MEM_ERROR(ranges, LXW_ERROR_MEMORY_MALLOC_FAILED);
+
+    i = 0;
+    STAILQ_FOREACH(chart, self->charts, list_pointers) {
+        if (!chart->in_use)
+            continue;
+
+        STAILQ_FOREACH(series, chart->series_list, list_pointers) {
+            if (series->categories->has_array_data)
+                ranges[i++] = series->categories;
+            if (series->values->has_array_data)
+                ranges[i++] = series->values;
+        }
+    }
+
+    /* Add hidden worksheets, with names that aren't in use, for the data. */
+    num_sheets = (num_ranges + LXW_COL_MAX - 1) / LXW_COL_MAX;
+    data_sheets = calloc(num_sheets, sizeof(lxw_worksheet *));
+    GOTO_LABEL_ON_MEM_ERROR(data_sheets, mem_error);
+
+    for (i = 0; i < num_sheets; i++) {
+        do {
+            if (suffix == 1)
+                lxw_snprintf(sheetname, LXW_MAX_SHEETNAME_LENGTH,
+                             "_ChartData");
+            else
+                lxw_snprintf(sheetname, LXW_MAX_SHEETNAME_LENGTH,
+                             "_ChartData%u", (unsigned int) suffix);
+            suffix++;
+        } while (workbook_validate_sheet_name(self, sheetname));
+
+        data_sheets[i] = workbook_add_worksheet(self, sheetname);
+        GOTO_LABEL_ON_MEM_ERROR(data_sheets[i], mem_error);
+
+        worksheet_hide(data_sheets[i]);
+    }
+
+    /* Point each range at a column of the data worksheets. */
+    for (i = 0; i < num_ranges; i++) {
+        range = ranges[i];
+        worksheet = data_sheets[i / LXW_COL_MAX];
+        col_num = (lxw_col_t) (i % LXW_COL_MAX);
+
+        lxw_chart_set_range(range, worksheet->name, 0, col_num,
+                            range->num_data_points - 1, col_num);
+        GOTO_LABEL_ON_MEM_ERROR(range->formula, mem_error);
+
+        if (range->num_data_points > max_points)
+            max_points = range->num_data_points;
+    }
+
+    /* Write the data in row order. */
+    for (row_num = 0; row_num < max_points; row_num++) {
+        for (i = 0; i < num_ranges; i++) {
+            range = ranges[i];
+
+            if (row_num >= range->num_data_points)
+                continue;
+
+            worksheet = data_sheets[i / LXW_COL_MAX];
+            col_num = (lxw_col_t) (i % LXW_COL_MAX);
+
+            err = worksheet_write_number(worksheet, row_num, col_num,
+                                         range->data_cache[row_num], NULL);
+            if (err)
+                goto done;
+        }
+    }
+
+    goto done;
+
+mem_error:
+    err = LXW_ERROR_MEMORY_MALLOC_FAILED;
+
+done:
+    free(data_sheets);
+    free(ranges);
+    return err;
 }
 
 /*
@@ -1519,6 +1644,20 @@ _prepare_tables(lxw_workbook *self)
     }
 }
 
+/*
+ * Link a new format to the workbook's used format tables and format list.
+ */
+STATIC void
+_add_format_to_workbook(lxw_workbook *self, lxw_format *format)
+{
+    format->xf_format_indices = self->used_xf_formats;
+    format->dxf_format_indices = self->used_dxf_formats;
+    format->num_xf_formats = &self->num_xf_formats;
+    format->format_id = ++self->num_format_ids;
+
+    STAILQ_INSERT_TAIL(self->formats, format, list_pointers);
+}
+
 /*****************************************************************************
  *
  * XML functions.
@@ -1860,6 +1999,7 @@ workbook_new_opt(const char *filename, lxw_workbook_options *options)
 {
     lxw_format *format;
     lxw_workbook *workbook;
+    lxw_error error;
 
     /* Create the workbook object. */
     workbook = calloc(1, sizeof(lxw_workbook));
@@ -1948,12 +2088,23 @@ workbook_new_opt(const char *filename, lxw_workbook_options *options)
     workbook->used_dxf_formats = lxw_hash_new(128, 1, 0);
     GOTO_LABEL_ON_MEM_ERROR(workbook->used_dxf_formats, mem_error);
 
+    /* Add a hash table to find the formats returned by
+     * workbook_intern_format(). */
+    workbook->interned_formats = lxw_hash_new(128, 1, 0);
+    GOTO_LABEL_ON_MEM_ERROR(workbook->interned_formats, mem_error);
+
     /* Add the worksheets list. */
     workbook->custom_properties =
         calloc(1, sizeof(struct lxw_custom_properties));
     GOTO_LABEL_ON_MEM_ERROR(workbook->custom_properties, mem_error);
     STAILQ_INIT(workbook->custom_properties);
 
+    /* Add the compression overrides list. */
+    workbook->compression_overrides =
+        calloc(1, sizeof(struct lxw_compression_overrides));
+    GOTO_LABEL_ON_MEM_ERROR(workbook->compression_overrides, mem_error);
+    STAILQ_INIT(workbook->compression_overrides);
+
     /* Add the default cell format. */
     format = workbook_add_format(workbook);
     GOTO_LABEL_ON_MEM_ERROR(format, mem_error);
@@ -1973,6 +2124,42 @@ workbook_new_opt(const char *filename, lxw_workbook_options *options)
         workbook->options.use_zip64 = options->use_zip64;
         workbook->options.output_buffer = options->output_buffer;
         workbook->options.output_buffer_size = options->output_buffer_size;
+        workbook->options.num_threads = options->num_threads;
+        workbook->options.store_only = options->store_only;
+        workbook->options.output_sink = options->output_sink;
+        workbook->options.compact_cells = options->compact_cells;
+
+        if (options->compression_level <= 9) {
+            workbook->options.compression_level = options->compression_level;
+        }
+        else {
+            LXW_WARN_FORMAT1("workbook_new_opt(): 'compression_level' %d "
+                             "must be in the range 1-9. Using the default.",
+                             options->compression_level);
+        }
+
+        if (options->compression_strategy <= LXW_COMPRESSION_STRATEGY_FIXED) {
+            workbook->options.compression_strategy =
+                options->compression_strategy;
+        }
+        else {
+            LXW_WARN_FORMAT1("workbook_new_opt(): unknown "
+                             "'compression_strategy' %d. Using the default.",
+                             options->compression_strategy);
+        }
+
+        /* Store the shared strings in temp files in constant_memory mode. */
+        if (options->constant_memory && options->constant_memory_sst) {
+            workbook->options.constant_memory_sst = LXW_TRUE;
+
+            error = lxw_sst_use_tmpfiles(workbook->sst,
+                                         workbook->options.tmpdir);
+            if (error) {
+                LXW_ERROR("Error creating shared strings tmpfiles in "
+                          "'constant_memory' mode.");
+                goto mem_error;
+            }
+        }
     }
 
     workbook->max_url_length = 2079;
@@ -1998,7 +2185,7 @@ workbook_add_worksheet(lxw_workbook *self, const char *sheetname)
     lxw_worksheet_name *worksheet_name = NULL;
     lxw_error error;
     lxw_worksheet_init_data init_data =
-        { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+        { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
     char *new_name = NULL;
 
     if (sheetname) {
@@ -2034,6 +2221,7 @@ workbook_add_worksheet(lxw_workbook *self, const char *sheetname)
     init_data.index = self->num_sheets;
     init_data.sst = self->sst;
     init_data.optimize = self->options.constant_memory;
+    init_data.compact_cells = self->options.compact_cells;
     init_data.active_sheet = &self->active_sheet;
     init_data.first_sheet = &self->first_sheet;
     init_data.tmpdir = self->options.tmpdir;
@@ -2041,6 +2229,16 @@ workbook_add_worksheet(lxw_workbook *self, const char *sheetname)
     init_data.max_url_length = self->max_url_length;
     init_data.use_1904_epoch = self->use_1904_epoch;
 
+    /* In constant_memory mode the row data is deflated as it is written. */
+    init_data.deflate_rows = self->options.constant_memory
+        && !self->options.store_only;
+    init_data.compression_level = self->options.compression_level;
+    init_data.compression_strategy = self->options.compression_strategy;
+
+    /* In constant_memory mode chart data is captured as rows are written. */
+    if (self->options.constant_memory)
+        init_data.chart_range_taps = &self->chart_range_taps;
+
     /* Create a new worksheet object. */
     worksheet = lxw_worksheet_new(&init_data);
     GOTO_LABEL_ON_MEM_ERROR(worksheet, mem_error);
@@ -2084,7 +2282,7 @@ workbook_add_chartsheet(lxw_workbook *self, const char *sheetname)
     lxw_chartsheet_name *chartsheet_name = NULL;
     lxw_error error;
     lxw_worksheet_init_data init_data =
-        { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+        { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
     char *new_name = NULL;
 
     if (sheetname) {
@@ -2121,6 +2319,7 @@ workbook_add_chartsheet(lxw_workbook *self, const char *sheetname)
     init_data.index = self->num_sheets;
     init_data.sst = self->sst;
     init_data.optimize = self->options.constant_memory;
+    init_data.compact_cells = self->options.compact_cells;
     init_data.active_sheet = &self->active_sheet;
     init_data.first_sheet = &self->first_sheet;
     init_data.tmpdir = self->options.tmpdir;
@@ -2176,8 +2375,12 @@ workbook_add_chart(lxw_workbook *self, uint8_t type)
     /* Create a new chart object. */
     chart = lxw_chart_new(type);
 
-    if (chart)
+    if (chart) {
+        if (self->options.constant_memory)
+            chart->range_taps = &self->chart_range_taps;
+
         STAILQ_INSERT_TAIL(self->charts, chart, list_pointers);
+    }
 
     return chart;
 }
@@ -2192,15 +2395,55 @@ workbook_add_format(lxw_workbook *self)
     lxw_format *format = lxw_format_new();
     RETURN_ON_MEM_ERROR(format, NULL);
 
-    format->xf_format_indices = self->used_xf_formats;
-    format->dxf_format_indices = self->used_dxf_formats;
-    format->num_xf_formats = &self->num_xf_formats;
-
-    STAILQ_INSERT_TAIL(self->formats, format, list_pointers);
+    _add_format_to_workbook(self, format);
 
     return format;
 }
 
+/*
+ * Get the workbook format with the same properties as a format, adding a
+ * copy of the format if there isn't one.
+ */
+lxw_format *
+workbook_intern_format(lxw_workbook *self, lxw_format *format)
+{
+    lxw_format format_key;
+    lxw_format *key_copy;
+    lxw_format *interned;
+    lxw_hash_element *hash_element;
+
+    if (!format) {
+        LXW_WARN("workbook_intern_format(): format must be specified.");
+        return NULL;
+    }
+
+    lxw_format_set_intern_key(&format_key, format);
+
+    hash_element = lxw_hash_key_exists(self->interned_formats, &format_key,
+                                       sizeof(lxw_format));
+    if (hash_element)
+        return hash_element->value;
+
+    /* Create a copy of the format properties owned by the workbook. */
+    interned = lxw_format_new();
+    RETURN_ON_MEM_ERROR(interned, NULL);
+
+    memcpy(interned, &format_key, sizeof(lxw_format));
+    _add_format_to_workbook(self, interned);
+
+    /* The format is still usable if it can't be added to the hash table. */
+    key_copy = malloc(sizeof(lxw_format));
+    if (key_copy) {
+        memcpy(key_copy, &format_key, sizeof(lxw_format));
+
+        if (!lxw_insert_hash_element(self->interned_formats, key_copy,
+                                     interned, sizeof(lxw_format)))
+            free(key_copy);
+    }
+
+    return interned;
+}
+
 /*
  * Call finalization code and close file.
  */
@@ -2217,6 +2460,11 @@ workbook_close(lxw_workbook *self)
     if (!self->num_sheets)
         workbook_add_worksheet(self, NULL);
 
+    /* Write chart series data that was set from arrays to hidden sheets. */
+    error = _prepare_chart_array_data(self);
+    if (error)
+        goto mem_error;
+
     /* Ensure that at least one worksheet has been selected. */
     if (self->active_sheet == 0) {
         sheet = STAILQ_FIRST(self->sheets);
@@ -2278,6 +2526,15 @@ workbook_close(lxw_workbook *self)
     /* Prepare the drawings, charts and images. */
     _prepare_drawings(self);
 
+    /* Write the last row of constant_memory worksheets so that its data is
+     * captured for the chart caches. */
+    if (self->chart_range_taps.count) {
+        STAILQ_FOREACH(worksheet, self->worksheets, list_pointers) {
+            if (worksheet->optimize_row)
+                lxw_worksheet_write_single_row(worksheet);
+        }
+    }
+
     /* Add cached data to charts. */
     _add_chart_cache_data(self);
 
@@ -2287,7 +2544,8 @@ workbook_close(lxw_workbook *self)
     /* Create a packager object to assemble sub-elements into a zip file. */
     packager = lxw_packager_new(self->filename,
                                 self->options.tmpdir,
-                                self->options.use_zip64);
+                                self->options.use_zip64,
+                                self->options.output_sink);
 
     /* If the packager fails it is generally due to a zip permission error. */
     if (packager == NULL) {
@@ -2301,11 +2559,12 @@ workbook_close(lxw_workbook *self)
 
     /* Set the workbook object in the packager. */
     packager->workbook = self;
+    packager->num_threads = self->options.num_threads;
 
     /* Assemble all the sub-files in the xlsx package. */
     error = lxw_create_package(packager);
 
-    if (!self->filename) {
+    if (!self->filename && self->options.output_buffer) {
         *self->options.output_buffer = packager->output_buffer;
         *self->options.output_buffer_size = packager->output_buffer_size;
     }
@@ -2900,3 +3159,77 @@ workbook_set_size(lxw_workbook *workbook, uint16_t width, uint16_t height)
         workbook->window_height = height * 1440 / 96;
 
 }
+
+/*
+ * Get the number of total and unique strings in the shared string table.
+ */
+void
+workbook_get_string_stats(lxw_workbook *self, lxw_string_stats *stats)
+{
+    if (!stats)
+        return;
+
+    stats->total_strings = self->sst->string_count;
+    stats->unique_strings = self->sst->unique_count;
+    stats->string_bytes = self->sst->string_bytes;
+}
+
+/*
+ * Override the workbook compression options for some of the package parts.
+ */
+lxw_error
+workbook_set_part_compression(lxw_workbook *self, const char *part_name,
+                              lxw_part_compression *compression)
+{
+    lxw_compression_override *compression_override;
+
+    if (!part_name) {
+        LXW_WARN_FORMAT("workbook_set_part_compression(): "
+                        "parameter 'part_name' cannot be NULL.");
+        return LXW_ERROR_NULL_PARAMETER_IGNORED;
+    }
+
+    if (!compression) {
+        LXW_WARN_FORMAT("workbook_set_part_compression(): "
+                        "parameter 'compression' cannot be NULL.");
+        return LXW_ERROR_NULL_PARAMETER_IGNORED;
+    }
+
+    if (lxw_str_is_empty(part_name)) {
+        LXW_WARN_FORMAT("workbook_set_part_compression(): "
+                        "parameter 'part_name' cannot be an empty string.");
+        return LXW_ERROR_PARAMETER_IS_EMPTY;
+    }
+
+    if (compression->level > 9) {
+        LXW_WARN_FORMAT1("workbook_set_part_compression(): 'level' %d "
+                         "must be in the range 1-9.", compression->level);
+        return LXW_ERROR_PARAMETER_VALIDATION;
+    }
+
+    if (compression->strategy > LXW_COMPRESSION_STRATEGY_FIXED) {
+        LXW_WARN_FORMAT1("workbook_set_part_compression(): unknown "
+                         "'strategy' %d.", compression->strategy);
+        return LXW_ERROR_PARAMETER_VALIDATION;
+    }
+
+    compression_override = calloc(1, sizeof(lxw_compression_override));
+    RETURN_ON_MEM_ERROR(compression_override, LXW_ERROR_MEMORY_MALLOC_FAILED);
+
+    /* Part names in the zip file don't have a leading slash. */
+    if (part_name[0] == '/')
+        part_name++;
+
+    compression_override->part_name = lxw_strdup(part_name);
+    if (!compression_override->part_name) {
+        free(compression_override);
+        return LXW_ERROR_MEMORY_MALLOC_FAILED;
+    }
+
+    compression_override->compression = *compression;
+
+    STAILQ_INSERT_TAIL(self->compression_overrides, compression_override,
+                       list_pointers);
+
+    return LXW_NO_ERROR;
+}
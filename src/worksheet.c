@@ -14,8 +14,10 @@
 
 #include "xlsxwriter/xmlwriter.h"
 #include "xlsxwriter/worksheet.h"
+#include "xlsxwriter/workbook.h"
 #include "xlsxwriter/format.h"
 #include "xlsxwriter/utility.h"
+#include <zlib.h>
 
 #ifdef USE_OPENSSL_MD5
 #include <openssl/md5.h>
@@ -27,20 +29,39 @@
 
 #define LXW_STR_MAX                      32767
 #define LXW_BUFFER_SIZE                  4096
+#define LXW_SHEET_DATA_BUFFER_SIZE       65536
+#define LXW_SHEET_DATA_CELL_LENGTH       128
+#define LXW_SHEET_DATA_ROW_LENGTH        256
 #define LXW_PRINT_ACROSS                 1
 #define LXW_VALIDATION_MAX_TITLE_LENGTH  32
 #define LXW_VALIDATION_MAX_STRING_LENGTH 255
 #define LXW_THIS_ROW "[#This Row],"
+#define LXW_POOL_SLAB_MIN                64
+#define LXW_POOL_SLAB_MAX                8192
+#define LXW_COMPACT_CELLS_MIN            8
+#define LXW_COMPACT_FORMATS_MIN          16
+#define LXW_DEFLATE_ROWS_SIZE            262144
+#define LXW_DEFLATE_MEM_LEVEL            8
+
 /*
  * Forward declarations.
  */
 STATIC void _worksheet_write_rows(lxw_worksheet *self);
+STATIC void _worksheet_flush_sheet_data(lxw_worksheet *self);
 STATIC int _row_cmp(lxw_row *row1, lxw_row *row2);
 STATIC int _cell_cmp(lxw_cell *cell1, lxw_cell *cell2);
 STATIC int _drawing_rel_id_cmp(lxw_drawing_rel_id *tuple1,
                                lxw_drawing_rel_id *tuple2);
 STATIC int _cond_format_hash_cmp(lxw_cond_format_hash_element *elem_1,
                                  lxw_cond_format_hash_element *elem_2);
+STATIC lxw_col_t _compact_cell_index(lxw_row *row, lxw_col_t col_num);
+STATIC lxw_compact_cell *_find_compact_cell(lxw_row *row, lxw_col_t col_num);
+STATIC void _expand_compact_cell(lxw_worksheet *self, lxw_row *row,
+                                 lxw_compact_cell *compact, lxw_cell *cell);
+STATIC lxw_deflated_rows *_new_deflated_rows(lxw_worksheet_init_data
+                                             *init_data);
+STATIC void _free_deflated_rows(lxw_deflated_rows *rows);
+STATIC void _deflate_staged_rows(lxw_worksheet *self, uint8_t finish);
 
 #ifndef __clang_analyzer__
 LXW_RB_GENERATE_ROW(lxw_table_rows, lxw_row, tree_pointers, _row_cmp);
@@ -55,6 +76,27 @@ LXW_RB_GENERATE_COND_FORMAT_HASH(lxw_cond_format_hash,
                                  _cond_format_hash_cmp);
 #endif
 
+/*
+ * Cells and rows are allocated from per-worksheet pools rather than with a
+ * malloc() per object. The objects are carved from slabs that double in size
+ * up to a limit and that are freed in bulk along with the worksheet. Objects
+ * that are freed individually, such as overwritten cells or the cells of a
+ * flushed row in constant_memory mode, are kept on a free list for reuse.
+ */
+
+/* Slab header. The union keeps the objects that follow it aligned. */
+union lxw_pool_slab {
+    union lxw_pool_slab *next;
+    double align_double;
+    void *align_pointer;
+};
+
+/* A row and the head of its cell tree are allocated as one pool object. */
+typedef struct lxw_row_slot {
+    lxw_row row;
+    struct lxw_table_cells cells;
+} lxw_row_slot;
+
 /*****************************************************************************
  *
  * Private functions.
@@ -76,18 +118,150 @@ lxw_worksheet_find_row(lxw_worksheet *self, lxw_row_t row_num)
 
 /*
  * Find but don't create a cell object for a given row object and col number.
+ * A cell that is stored in compact form is expanded into compact_cell.
  */
 lxw_cell *
-lxw_worksheet_find_cell_in_row(lxw_row *row, lxw_col_t col_num)
+lxw_worksheet_find_cell_in_row(lxw_worksheet *self, lxw_row *row,
+                               lxw_col_t col_num, lxw_cell *compact_cell)
 {
     lxw_cell tmp_cell;
+    lxw_cell *cell;
+    lxw_compact_cell *compact;
 
     if (!row)
         return NULL;
 
     tmp_cell.col_num = col_num;
 
-    return RB_FIND(lxw_table_cells, row->cells, &tmp_cell);
+    cell = RB_FIND(lxw_table_cells, row->cells, &tmp_cell);
+    if (cell || !row->num_compact_cells)
+        return cell;
+
+    compact = _find_compact_cell(row, col_num);
+    if (!compact)
+        return NULL;
+
+    _expand_compact_cell(self, row, compact, compact_cell);
+
+    return compact_cell;
+}
+
+/*
+ * Position a range iterator at the first stored cell, at or after the first
+ * col, in the current row or the following rows of the range.
+ */
+STATIC void
+_range_iterator_start_row(lxw_range_iterator *iterator)
+{
+    lxw_row *row = iterator->row;
+    lxw_cell tmp_cell;
+
+    if (row && row->row_num > iterator->last_row)
+        row = NULL;
+
+    iterator->row = row;
+    iterator->cell = NULL;
+    iterator->compact_index = 0;
+
+    if (!row)
+        return;
+
+    tmp_cell.col_num = iterator->first_col;
+    iterator->cell = RB_NFIND(lxw_table_cells, row->cells, &tmp_cell);
+
+    if (row->num_compact_cells)
+        iterator->compact_index =
+            _compact_cell_index(row, iterator->first_col);
+}
+
+/*
+ * Initialize an iterator over the stored cells of a worksheet range.
+ */
+void
+lxw_worksheet_range_iterator_init(lxw_range_iterator *iterator,
+                                  lxw_worksheet *self,
+                                  lxw_row_t first_row, lxw_col_t first_col,
+                                  lxw_row_t last_row, lxw_col_t last_col)
+{
+    lxw_row tmp_row;
+
+    iterator->worksheet = self;
+    iterator->last_row = last_row;
+    iterator->first_col = first_col;
+    iterator->last_col = last_col;
+
+    tmp_row.row_num = first_row;
+    iterator->row = RB_NFIND(lxw_table_rows, self->table, &tmp_row);
+
+    _range_iterator_start_row(iterator);
+}
+
+/*
+ * Get the next stored cell in a worksheet range, or NULL at the end of the
+ * range. The cells of a row are merged from the row's cell tree and compact
+ * cell array in col order. A compact cell is expanded into the iterator.
+ */
+lxw_cell *
+lxw_worksheet_range_iterator_next(lxw_range_iterator *iterator)
+{
+    lxw_row *row;
+    lxw_cell *cell;
+    lxw_compact_cell *compact;
+
+    while ((row = iterator->row)) {
+        cell = iterator->cell;
+        if (cell && cell->col_num > iterator->last_col)
+            cell = NULL;
+
+        compact = NULL;
+        if (iterator->compact_index < row->num_compact_cells) {
+            compact = &row->compact_cells[iterator->compact_index];
+            if (compact->col_num > iterator->last_col)
+                compact = NULL;
+        }
+
+        if (compact && (!cell || compact->col_num < cell->col_num)) {
+            iterator->compact_index++;
+            _expand_compact_cell(iterator->worksheet, row, compact,
+                                 &iterator->compact_cell);
+            return &iterator->compact_cell;
+        }
+
+        if (cell) {
+            iterator->cell = RB_NEXT(lxw_table_cells, row->cells, cell);
+            return cell;
+        }
+
+        iterator->row = RB_NEXT(lxw_table_rows, iterator->worksheet->table,
+                                row);
+        _range_iterator_start_row(iterator);
+    }
+
+    return NULL;
+}
+
+/*
+ * Store the value of a cell in the data cache of a chart range. Strings that
+ * are only stored in the SST temp files can't be cached.
+ */
+lxw_error
+lxw_worksheet_cache_chart_cell(lxw_series_range *range, uint32_t index,
+                               lxw_cell *cell)
+{
+    if (cell->type == NUMBER_CELL)
+        lxw_chart_set_cache_number(range, index, cell->u.number);
+    else if (cell->type == STRING_CELL && cell->sst_element)
+        return lxw_chart_set_cache_string(range, index,
+                                          cell->sst_element->string);
+    else if (cell->type == STRING_CELL)
+        return LXW_ERROR_SHARED_STRING_INDEX_NOT_FOUND;
+    else if (cell->type == INLINE_STRING_CELL
+             || cell->type == INLINE_STATIC_STRING_CELL)
+        return lxw_chart_set_cache_string(range, index, cell->u.string);
+    else
+        lxw_chart_set_cache_number(range, index, 0);
+
+    return LXW_NO_ERROR;
 }
 
 /*
@@ -103,6 +277,9 @@ lxw_worksheet_new(lxw_worksheet_init_data *init_data)
     GOTO_LABEL_ON_MEM_ERROR(worksheet->table, mem_error);
     RB_INIT(worksheet->table);
 
+    worksheet->cell_pool.object_size = sizeof(lxw_cell);
+    worksheet->row_pool.object_size = sizeof(lxw_row_slot);
+
     worksheet->hyperlinks = calloc(1, sizeof(struct lxw_table_rows));
     GOTO_LABEL_ON_MEM_ERROR(worksheet->hyperlinks, mem_error);
     RB_INIT(worksheet->hyperlinks);
@@ -215,6 +392,14 @@ lxw_worksheet_new(lxw_worksheet_init_data *init_data)
         worksheet->optimize_tmpfile = tmpfile;
         GOTO_LABEL_ON_MEM_ERROR(worksheet->optimize_tmpfile, mem_error);
         worksheet->file = worksheet->optimize_tmpfile;
+
+        worksheet->sheet_data_buffer = malloc(LXW_SHEET_DATA_BUFFER_SIZE);
+        GOTO_LABEL_ON_MEM_ERROR(worksheet->sheet_data_buffer, mem_error);
+
+        if (init_data->deflate_rows) {
+            worksheet->deflated_rows = _new_deflated_rows(init_data);
+            GOTO_LABEL_ON_MEM_ERROR(worksheet->deflated_rows, mem_error);
+        }
     }
 
     worksheet->drawing_rel_ids =
@@ -237,6 +422,8 @@ lxw_worksheet_new(lxw_worksheet_init_data *init_data)
     worksheet->dim_colmax = 0;
     worksheet->dim_rowmin = LXW_ROW_MAX;
     worksheet->dim_colmin = LXW_COL_MAX;
+    worksheet->sheet_data_row_num = LXW_ROW_MAX;
+    worksheet->sheet_data_col_num = LXW_COL_MAX;
 
     worksheet->default_row_height = LXW_DEF_ROW_HEIGHT;
     worksheet->default_row_pixels = 20;
@@ -290,11 +477,14 @@ lxw_worksheet_new(lxw_worksheet_init_data *init_data)
         worksheet->hidden = init_data->hidden;
         worksheet->sst = init_data->sst;
         worksheet->optimize = init_data->optimize;
+        worksheet->compact_cells = init_data->compact_cells
+            && !init_data->optimize;
         worksheet->active_sheet = init_data->active_sheet;
         worksheet->first_sheet = init_data->first_sheet;
         worksheet->default_url_format = init_data->default_url_format;
         worksheet->max_url_length = init_data->max_url_length;
         worksheet->use_1904_epoch = init_data->use_1904_epoch;
+        worksheet->chart_range_taps = init_data->chart_range_taps;
     }
 
     return worksheet;
@@ -365,15 +555,89 @@ _free_filter_rules(lxw_worksheet *worksheet)
 }
 
 /*
- * Free a worksheet cell.
+ * Get a zeroed object from a pool.
+ */
+STATIC void *
+_pool_alloc(lxw_object_pool *pool)
+{
+    union lxw_pool_slab *slab;
+    void *object;
+
+    /* Reuse a freed object if there is one. */
+    if (pool->free_list) {
+        object = pool->free_list;
+        pool->free_list = *(void **) object;
+        memset(object, 0, pool->object_size);
+        return object;
+    }
+
+    /* Start a new slab when the current one is full. */
+    if (pool->slab_used == pool->slab_objects) {
+        if (pool->slab_objects < LXW_POOL_SLAB_MIN)
+            pool->slab_objects = LXW_POOL_SLAB_MIN;
+        else if (pool->slab_objects < LXW_POOL_SLAB_MAX)
+            pool->slab_objects *= 2;
+
+        slab = calloc(1, sizeof(union lxw_pool_slab)
+                      + pool->slab_objects * pool->object_size);
+        if (!slab) {
+            pool->slab_used = pool->slab_objects;
+            return NULL;
+        }
+
+        slab->next = pool->slabs;
+        pool->slabs = slab;
+        pool->slab_data = (char *) (slab + 1);
+        pool->slab_used = 0;
+    }
+
+    object = pool->slab_data + pool->slab_used * pool->object_size;
+    pool->slab_used++;
+
+    return object;
+}
+
+/*
+ * Return an object to its pool for reuse.
  */
 STATIC void
-_free_cell(lxw_cell *cell)
+_pool_free(lxw_object_pool *pool, void *object)
 {
-    if (!cell)
+    if (!object)
         return;
 
+    *(void **) object = pool->free_list;
+    pool->free_list = object;
+}
+
+/*
+ * Free all the slabs of a pool, and with them all of its objects.
+ */
+STATIC void
+_pool_destroy(lxw_object_pool *pool)
+{
+    union lxw_pool_slab *slab;
+    union lxw_pool_slab *next_slab;
+
+    for (slab = pool->slabs; slab; slab = next_slab) {
+        next_slab = slab->next;
+        free(slab);
+    }
+
+    pool->slabs = NULL;
+    pool->free_list = NULL;
+    pool->slab_used = pool->slab_objects;
+}
+
+/*
+ * Free the data owned by a worksheet cell but not the cell itself.
+ */
+STATIC void
+_free_cell_data(lxw_cell *cell)
+{
+
     if (cell->type != NUMBER_CELL && cell->type != STRING_CELL
+        && cell->type != INLINE_STATIC_STRING_CELL
         && cell->type != BLANK_CELL && cell->type != BOOLEAN_CELL
         && cell->type != ERROR_CELL) {
 
@@ -384,30 +648,43 @@ _free_cell(lxw_cell *cell)
     free(cell->user_data2);
 
     _free_vml_object(cell->comment);
+}
+
+/*
+ * Free a worksheet cell.
+ */
+STATIC void
+_free_cell(lxw_worksheet *self, lxw_cell *cell)
+{
+    if (!cell)
+        return;
 
-    free(cell);
+    _free_cell_data(cell);
+    _pool_free(&self->cell_pool, cell);
 }
 
 /*
- * Free a worksheet row.
+ * Free the data owned by the cells in a table of rows. The row and cell
+ * objects themselves are freed in bulk with the worksheet pools.
  */
 STATIC void
-_free_row(lxw_row *row)
+_free_table_data(struct lxw_table_rows *table)
 {
+    lxw_row *row;
     lxw_cell *cell;
-    lxw_cell *next_cell;
 
-    if (!row)
+    if (!table)
         return;
 
-    for (cell = RB_MIN(lxw_table_cells, row->cells); cell; cell = next_cell) {
-        next_cell = RB_NEXT(lxw_table_cells, row->cells, cell);
-        RB_REMOVE(lxw_table_cells, row->cells, cell);
-        _free_cell(cell);
+    RB_FOREACH(row, lxw_table_rows, table) {
+        RB_FOREACH(cell, lxw_table_cells, row->cells) {
+            _free_cell_data(cell);
+        }
+
+        free(row->compact_cells);
     }
 
-    free(row->cells);
-    free(row);
+    free(table);
 }
 
 /*
@@ -528,8 +805,6 @@ _free_worksheet_table(lxw_table_obj *table)
 void
 lxw_worksheet_free(lxw_worksheet *worksheet)
 {
-    lxw_row *row;
-    lxw_row *next_row;
     lxw_col_t col;
     lxw_merged_range *merged_range;
     lxw_object_properties *object_props;
@@ -557,42 +832,19 @@ lxw_worksheet_free(lxw_worksheet *worksheet)
     free(worksheet->col_options);
     free(worksheet->col_sizes);
     free(worksheet->col_formats);
+    free(worksheet->col_offsets);
+    free(worksheet->row_offset_rows);
+    free(worksheet->row_offset_sums);
+    free(worksheet->block_spans);
+    free(worksheet->row_taps);
+    free(worksheet->sheet_data_buffer);
+    _free_deflated_rows(worksheet->deflated_rows);
 
-    if (worksheet->table) {
-        for (row = RB_MIN(lxw_table_rows, worksheet->table); row;
-             row = next_row) {
-
-            next_row = RB_NEXT(lxw_table_rows, worksheet->table, row);
-            RB_REMOVE(lxw_table_rows, worksheet->table, row);
-            _free_row(row);
-        }
-
-        free(worksheet->table);
-    }
-
-    if (worksheet->hyperlinks) {
-        for (row = RB_MIN(lxw_table_rows, worksheet->hyperlinks); row;
-             row = next_row) {
-
-            next_row = RB_NEXT(lxw_table_rows, worksheet->hyperlinks, row);
-            RB_REMOVE(lxw_table_rows, worksheet->hyperlinks, row);
-            _free_row(row);
-        }
-
-        free(worksheet->hyperlinks);
-    }
-
-    if (worksheet->comments) {
-        for (row = RB_MIN(lxw_table_rows, worksheet->comments); row;
-             row = next_row) {
+    _free_table_data(worksheet->table);
 
-            next_row = RB_NEXT(lxw_table_rows, worksheet->comments, row);
-            RB_REMOVE(lxw_table_rows, worksheet->comments, row);
-            _free_row(row);
-        }
+    _free_table_data(worksheet->hyperlinks);
 
-        free(worksheet->comments);
-    }
+    _free_table_data(worksheet->comments);
 
     if (worksheet->merged_ranges) {
         while (!STAILQ_EMPTY(worksheet->merged_ranges)) {
@@ -791,11 +1043,16 @@ lxw_worksheet_free(lxw_worksheet *worksheet)
 
     if (worksheet->array) {
         for (col = 0; col < LXW_COL_MAX; col++) {
-            _free_cell(worksheet->array[col]);
+            if (worksheet->array[col])
+                _free_cell_data(worksheet->array[col]);
         }
         free(worksheet->array);
     }
 
+    _pool_destroy(&worksheet->cell_pool);
+    _pool_destroy(&worksheet->row_pool);
+    free(worksheet->compact_formats);
+
     if (worksheet->optimize_row)
         free(worksheet->optimize_row);
 
@@ -830,23 +1087,18 @@ lxw_worksheet_free(lxw_worksheet *worksheet)
  * Create a new worksheet row object.
  */
 STATIC lxw_row *
-_new_row(lxw_row_t row_num)
+_new_row(lxw_worksheet *self, lxw_row_t row_num)
 {
-    lxw_row *row = calloc(1, sizeof(lxw_row));
+    lxw_row_slot *slot = _pool_alloc(&self->row_pool);
+    lxw_row *row;
 
-    if (row) {
-        row->row_num = row_num;
-        row->cells = calloc(1, sizeof(struct lxw_table_cells));
-        row->height = LXW_DEF_ROW_HEIGHT;
+    RETURN_ON_MEM_ERROR(slot, NULL);
 
-        if (row->cells)
-            RB_INIT(row->cells);
-        else
-            LXW_MEM_ERROR();
-    }
-    else {
-        LXW_MEM_ERROR();
-    }
+    row = &slot->row;
+    row->row_num = row_num;
+    row->cells = &slot->cells;
+    row->height = LXW_DEF_ROW_HEIGHT;
+    RB_INIT(row->cells);
 
     return row;
 }
@@ -855,10 +1107,10 @@ _new_row(lxw_row_t row_num)
  * Create a new worksheet number cell object.
  */
 STATIC lxw_cell *
-_new_number_cell(lxw_row_t row_num,
+_new_number_cell(lxw_worksheet *self, lxw_row_t row_num,
                  lxw_col_t col_num, double value, lxw_format *format)
 {
-    lxw_cell *cell = calloc(1, sizeof(lxw_cell));
+    lxw_cell *cell = _pool_alloc(&self->cell_pool);
     RETURN_ON_MEM_ERROR(cell, cell);
 
     cell->row_num = row_num;
@@ -874,11 +1126,11 @@ _new_number_cell(lxw_row_t row_num,
  * Create a new worksheet string cell object.
  */
 STATIC lxw_cell *
-_new_string_cell(lxw_row_t row_num,
-                 lxw_col_t col_num, int32_t string_id, char *sst_string,
-                 lxw_format *format)
+_new_string_cell(lxw_worksheet *self, lxw_row_t row_num,
+                 lxw_col_t col_num, uint32_t string_id,
+                 struct sst_element *sst_element, lxw_format *format)
 {
-    lxw_cell *cell = calloc(1, sizeof(lxw_cell));
+    lxw_cell *cell = _pool_alloc(&self->cell_pool);
     RETURN_ON_MEM_ERROR(cell, cell);
 
     cell->row_num = row_num;
@@ -886,7 +1138,7 @@ _new_string_cell(lxw_row_t row_num,
     cell->type = STRING_CELL;
     cell->format = format;
     cell->u.string_id = string_id;
-    cell->sst_string = sst_string;
+    cell->sst_element = sst_element;
 
     return cell;
 }
@@ -895,10 +1147,10 @@ _new_string_cell(lxw_row_t row_num,
  * Create a new worksheet inline_string cell object.
  */
 STATIC lxw_cell *
-_new_inline_string_cell(lxw_row_t row_num,
+_new_inline_string_cell(lxw_worksheet *self, lxw_row_t row_num,
                         lxw_col_t col_num, char *string, lxw_format *format)
 {
-    lxw_cell *cell = calloc(1, sizeof(lxw_cell));
+    lxw_cell *cell = _pool_alloc(&self->cell_pool);
     RETURN_ON_MEM_ERROR(cell, cell);
 
     cell->row_num = row_num;
@@ -914,11 +1166,11 @@ _new_inline_string_cell(lxw_row_t row_num,
  * Create a new worksheet inline_string cell object for rich strings.
  */
 STATIC lxw_cell *
-_new_inline_rich_string_cell(lxw_row_t row_num,
+_new_inline_rich_string_cell(lxw_worksheet *self, lxw_row_t row_num,
                              lxw_col_t col_num, const char *string,
                              lxw_format *format)
 {
-    lxw_cell *cell = calloc(1, sizeof(lxw_cell));
+    lxw_cell *cell = _pool_alloc(&self->cell_pool);
     RETURN_ON_MEM_ERROR(cell, cell);
 
     cell->row_num = row_num;
@@ -934,10 +1186,10 @@ _new_inline_rich_string_cell(lxw_row_t row_num,
  * Create a new worksheet formula cell object.
  */
 STATIC lxw_cell *
-_new_formula_cell(lxw_row_t row_num,
+_new_formula_cell(lxw_worksheet *self, lxw_row_t row_num,
                   lxw_col_t col_num, char *formula, lxw_format *format)
 {
-    lxw_cell *cell = calloc(1, sizeof(lxw_cell));
+    lxw_cell *cell = _pool_alloc(&self->cell_pool);
     RETURN_ON_MEM_ERROR(cell, cell);
 
     cell->row_num = row_num;
@@ -953,10 +1205,11 @@ _new_formula_cell(lxw_row_t row_num,
  * Create a new worksheet array formula cell object.
  */
 STATIC lxw_cell *
-_new_array_formula_cell(lxw_row_t row_num, lxw_col_t col_num, char *formula,
+_new_array_formula_cell(lxw_worksheet *self, lxw_row_t row_num,
+                        lxw_col_t col_num, char *formula,
                         char *range, lxw_format *format, uint8_t is_dynamic)
 {
-    lxw_cell *cell = calloc(1, sizeof(lxw_cell));
+    lxw_cell *cell = _pool_alloc(&self->cell_pool);
     RETURN_ON_MEM_ERROR(cell, cell);
 
     cell->row_num = row_num;
@@ -977,9 +1230,10 @@ _new_array_formula_cell(lxw_row_t row_num, lxw_col_t col_num, char *formula,
  * Create a new worksheet blank cell object.
  */
 STATIC lxw_cell *
-_new_blank_cell(lxw_row_t row_num, lxw_col_t col_num, lxw_format *format)
+_new_blank_cell(lxw_worksheet *self, lxw_row_t row_num, lxw_col_t col_num,
+                lxw_format *format)
 {
-    lxw_cell *cell = calloc(1, sizeof(lxw_cell));
+    lxw_cell *cell = _pool_alloc(&self->cell_pool);
     RETURN_ON_MEM_ERROR(cell, cell);
 
     cell->row_num = row_num;
@@ -994,10 +1248,10 @@ _new_blank_cell(lxw_row_t row_num, lxw_col_t col_num, lxw_format *format)
  * Create a new worksheet boolean cell object.
  */
 STATIC lxw_cell *
-_new_boolean_cell(lxw_row_t row_num, lxw_col_t col_num, int value,
-                  lxw_format *format)
+_new_boolean_cell(lxw_worksheet *self, lxw_row_t row_num, lxw_col_t col_num,
+                  int value, lxw_format *format)
 {
-    lxw_cell *cell = calloc(1, sizeof(lxw_cell));
+    lxw_cell *cell = _pool_alloc(&self->cell_pool);
     RETURN_ON_MEM_ERROR(cell, cell);
 
     cell->row_num = row_num;
@@ -1013,10 +1267,10 @@ _new_boolean_cell(lxw_row_t row_num, lxw_col_t col_num, int value,
  * Create a new worksheet error cell object.
  */
 STATIC lxw_cell *
-_new_error_cell(lxw_row_t row_num, lxw_col_t col_num, uint32_t value,
-                lxw_format *format)
+_new_error_cell(lxw_worksheet *self, lxw_row_t row_num, lxw_col_t col_num,
+                uint32_t value, lxw_format *format)
 {
-    lxw_cell *cell = calloc(1, sizeof(lxw_cell));
+    lxw_cell *cell = _pool_alloc(&self->cell_pool);
     RETURN_ON_MEM_ERROR(cell, cell);
 
     cell->row_num = row_num;
@@ -1032,10 +1286,10 @@ _new_error_cell(lxw_row_t row_num, lxw_col_t col_num, uint32_t value,
  * Create a new comment cell object.
  */
 STATIC lxw_cell *
-_new_comment_cell(lxw_row_t row_num, lxw_col_t col_num,
+_new_comment_cell(lxw_worksheet *self, lxw_row_t row_num, lxw_col_t col_num,
                   lxw_vml_obj *comment_obj)
 {
-    lxw_cell *cell = calloc(1, sizeof(lxw_cell));
+    lxw_cell *cell = _pool_alloc(&self->cell_pool);
     RETURN_ON_MEM_ERROR(cell, cell);
 
     cell->row_num = row_num;
@@ -1050,11 +1304,11 @@ _new_comment_cell(lxw_row_t row_num, lxw_col_t col_num,
  * Create a new worksheet hyperlink cell object.
  */
 STATIC lxw_cell *
-_new_hyperlink_cell(lxw_row_t row_num, lxw_col_t col_num,
+_new_hyperlink_cell(lxw_worksheet *self, lxw_row_t row_num, lxw_col_t col_num,
                     enum cell_types link_type, char *url, char *string,
                     char *tooltip)
 {
-    lxw_cell *cell = calloc(1, sizeof(lxw_cell));
+    lxw_cell *cell = _pool_alloc(&self->cell_pool);
     RETURN_ON_MEM_ERROR(cell, cell);
 
     cell->row_num = row_num;
@@ -1071,7 +1325,8 @@ _new_hyperlink_cell(lxw_row_t row_num, lxw_col_t col_num,
  * Get or create the row object for a given row number.
  */
 STATIC lxw_row *
-_get_row_list(struct lxw_table_rows *table, lxw_row_t row_num)
+_get_row_list(lxw_worksheet *self, struct lxw_table_rows *table,
+              lxw_row_t row_num)
 {
     lxw_row *row;
     lxw_row *existing_row;
@@ -1080,15 +1335,19 @@ _get_row_list(struct lxw_table_rows *table, lxw_row_t row_num)
         return table->cached_row;
 
     /* Create a new row and try and insert it. */
-    row = _new_row(row_num);
+    row = _new_row(self, row_num);
     existing_row = RB_INSERT(lxw_table_rows, table, row);
 
     /* If existing_row is not NULL, then it already existed. Free new row */
     /* and return existing_row. */
     if (existing_row) {
-        _free_row(row);
+        _pool_free(&self->row_pool, row);
         row = existing_row;
     }
+    else if (table == self->table) {
+        /* A new row may change the cached row offsets. */
+        self->row_offsets_valid = LXW_FALSE;
+    }
 
     table->cached_row = row;
     table->cached_row_num = row_num;
@@ -1105,7 +1364,7 @@ _get_row(lxw_worksheet *self, lxw_row_t row_num)
     lxw_row *row;
 
     if (!self->optimize) {
-        row = _get_row_list(self->table, row_num);
+        row = _get_row_list(self, self->table, row_num);
         return row;
     }
     else {
@@ -1129,7 +1388,7 @@ _get_row(lxw_worksheet *self, lxw_row_t row_num)
  * Insert a cell object in the cell list of a row object.
  */
 STATIC void
-_insert_cell_list(struct lxw_table_cells *cell_list,
+_insert_cell_list(lxw_worksheet *self, struct lxw_table_cells *cell_list,
                   lxw_cell *cell, lxw_col_t col_num)
 {
     lxw_cell *existing_cell;
@@ -1145,153 +1404,706 @@ _insert_cell_list(struct lxw_table_cells *cell_list,
 
         /* Add it in again. */
         RB_INSERT(lxw_table_cells, cell_list, cell);
-        _free_cell(existing_cell);
+        _free_cell(self, existing_cell);
     }
 
     return;
 }
 
 /*
- * Insert a cell object into the cell list or array.
+ * Find the position of a column in the sorted compact cells of a row. Returns
+ * the index of the cell or, if there isn't one, the index to insert it at.
  */
-STATIC void
-_insert_cell(lxw_worksheet *self, lxw_row_t row_num, lxw_col_t col_num,
-             lxw_cell *cell)
+STATIC lxw_col_t
+_compact_cell_index(lxw_row *row, lxw_col_t col_num)
 {
-    lxw_row *row = _get_row(self, row_num);
+    lxw_col_t low = 0;
+    lxw_col_t high = row->num_compact_cells;
+    lxw_col_t mid;
 
-    if (!self->optimize) {
-        row->data_changed = LXW_TRUE;
-        _insert_cell_list(row->cells, cell, col_num);
-    }
-    else {
-        if (row) {
-            row->data_changed = LXW_TRUE;
+    /* Cells are usually written in column order so check the end first. */
+    if (high == 0 || row->compact_cells[high - 1].col_num < col_num)
+        return high;
 
-            /* Overwrite an existing cell if necessary. */
-            if (self->array[col_num])
-                _free_cell(self->array[col_num]);
+    while (low < high) {
+        mid = low + (high - low) / 2;
 
-            self->array[col_num] = cell;
-        }
+        if (row->compact_cells[mid].col_num < col_num)
+            low = mid + 1;
+        else
+            high = mid;
     }
+
+    return low;
 }
 
 /*
- * Insert a blank placeholder cell in the cells RB tree in the same position
- * as a comment so that the rows "spans" calculation is correct. Since the
- * blank cell doesn't have a format it is ignored when writing. If there is
- * already a cell in the required position we don't have add a new cell.
+ * Find but don't create a compact cell for a given row and col number.
  */
-STATIC void
-_insert_cell_placeholder(lxw_worksheet *self, lxw_row_t row_num,
-                         lxw_col_t col_num)
+STATIC lxw_compact_cell *
+_find_compact_cell(lxw_row *row, lxw_col_t col_num)
 {
-    lxw_row *row;
-    lxw_cell *cell;
-
-    /* The spans calculation isn't required in constant_memory mode. */
-    if (self->optimize)
-        return;
+    lxw_col_t index = _compact_cell_index(row, col_num);
 
-    cell = _new_blank_cell(row_num, col_num, NULL);
-    if (!cell)
-        return;
+    if (index < row->num_compact_cells
+        && row->compact_cells[index].col_num == col_num)
+        return &row->compact_cells[index];
 
-    /* Only add a cell if one doesn't already exist. */
-    row = _get_row(self, row_num);
-    if (!RB_FIND(lxw_table_cells, row->cells, cell)) {
-        _insert_cell_list(row->cells, cell, col_num);
-    }
-    else {
-        _free_cell(cell);
-    }
+    return NULL;
 }
 
 /*
- * Insert a hyperlink object into the hyperlink RB tree.
+ * Remove the compact cell, if there is one, at a given col number.
  */
 STATIC void
-_insert_hyperlink(lxw_worksheet *self, lxw_row_t row_num, lxw_col_t col_num,
-                  lxw_cell *link)
+_remove_compact_cell(lxw_row *row, lxw_col_t col_num)
 {
-    lxw_row *row = _get_row_list(self->hyperlinks, row_num);
+    lxw_compact_cell *compact = _find_compact_cell(row, col_num);
+    lxw_col_t index;
+
+    if (!compact)
+        return;
+
+    index = (lxw_col_t) (compact - row->compact_cells);
+    row->num_compact_cells--;
 
-    _insert_cell_list(row->cells, link, col_num);
+    memmove(compact, compact + 1,
+            (row->num_compact_cells - index) * sizeof(lxw_compact_cell));
 }
 
 /*
- * Insert a comment into the comment RB tree.
+ * Get the id used to store a format in a compact cell and add the format to
+ * the worksheet compact_formats table. The id is 0 for no format. Returns
+ * false if the format can't be stored compactly, for example if it wasn't
+ * created with workbook_add_format().
  */
-STATIC void
-_insert_comment(lxw_worksheet *self, lxw_row_t row_num, lxw_col_t col_num,
-                lxw_cell *link)
+STATIC uint8_t
+_get_compact_format_id(lxw_worksheet *self, lxw_format *format,
+                       uint32_t *format_id)
 {
-    lxw_row *row = _get_row_list(self->comments, row_num);
+    lxw_format **formats;
+    uint32_t size;
+
+    *format_id = 0;
+
+    if (!format)
+        return LXW_TRUE;
+
+    if (!format->format_id)
+        return LXW_FALSE;
+
+    if (format->format_id >= self->compact_formats_size) {
+        size = self->compact_formats_size;
+        if (!size)
+            size = LXW_COMPACT_FORMATS_MIN;
+
+        while (size <= format->format_id)
+            size *= 2;
 
-    _insert_cell_list(row->cells, link, col_num);
+        formats = realloc(self->compact_formats, size * sizeof(lxw_format *));
+        if (!formats)
+            return LXW_FALSE;
+
+        memset(formats + self->compact_formats_size, 0,
+               (size - self->compact_formats_size) * sizeof(lxw_format *));
+
+        self->compact_formats = formats;
+        self->compact_formats_size = size;
+    }
+
+    self->compact_formats[format->format_id] = format;
+    *format_id = format->format_id;
+
+    return LXW_TRUE;
 }
 
 /*
- * Next power of two for column reallocs. Taken from bithacks in the public
- * domain.
+ * Expand a compact cell into a full cell object, for writing or lookups.
  */
-STATIC lxw_col_t
-_next_power_of_two(uint16_t col)
+STATIC void
+_expand_compact_cell(lxw_worksheet *self, lxw_row *row,
+                     lxw_compact_cell *compact, lxw_cell *cell)
 {
-    col--;
-    col |= col >> 1;
-    col |= col >> 2;
-    col |= col >> 4;
-    col |= col >> 8;
-    col++;
+    memset(cell, 0, sizeof(lxw_cell));
 
-    return col;
+    cell->row_num = row->row_num;
+    cell->col_num = compact->col_num;
+    cell->type = (enum cell_types) compact->type;
+
+    if (compact->format_id)
+        cell->format = self->compact_formats[compact->format_id];
+
+    if (compact->type == STRING_CELL) {
+        cell->u.string_id = compact->u.sst_element->index;
+        cell->sst_element = compact->u.sst_element;
+    }
+    else {
+        cell->u.number = compact->u.number;
+    }
 }
 
 /*
- * Check that row and col are within the allowed Excel range and store max
- * and min values for use in other methods/elements.
- *
- * The ignore_row/ignore_col flags are used to indicate that we wish to
- * perform the dimension check without storing the value.
+ * Insert a cell object into a row in compact_cells mode. Number, shared
+ * string, boolean, blank and error cells are stored in the row's sorted array
+ * of compact cells and the cell object is returned to the pool. Other cell
+ * types, such as formulas, are stored in the row's cell tree.
  */
-STATIC lxw_error
-_check_dimensions(lxw_worksheet *self,
-                  lxw_row_t row_num,
-                  lxw_col_t col_num, int8_t ignore_row, int8_t ignore_col)
+STATIC void
+_insert_compact_cell(lxw_worksheet *self, lxw_row *row, lxw_cell *cell,
+                     lxw_col_t col_num)
 {
-    if (row_num >= LXW_ROW_MAX)
-        return LXW_ERROR_WORKSHEET_INDEX_OUT_OF_RANGE;
+    lxw_compact_cell *compact;
+    lxw_cell *existing_cell;
+    uint32_t format_id;
+    lxw_col_t index;
+    lxw_col_t size;
 
-    if (col_num >= LXW_COL_MAX)
-        return LXW_ERROR_WORKSHEET_INDEX_OUT_OF_RANGE;
+    if ((cell->type != NUMBER_CELL && cell->type != STRING_CELL
+         && cell->type != BOOLEAN_CELL && cell->type != BLANK_CELL
+         && cell->type != ERROR_CELL)
+        || !_get_compact_format_id(self, cell->format, &format_id)) {
 
-    /* In optimization mode we don't change dimensions for rows that are */
-    /* already written. */
-    if (!ignore_row && !ignore_col && self->optimize) {
-        if (row_num < self->optimize_row->row_num)
-            return LXW_ERROR_WORKSHEET_INDEX_OUT_OF_RANGE;
+        _remove_compact_cell(row, col_num);
+        _insert_cell_list(self, row->cells, cell, col_num);
+        return;
     }
 
-    if (!ignore_row) {
-        if (row_num < self->dim_rowmin)
-            self->dim_rowmin = row_num;
-        if (row_num > self->dim_rowmax)
-            self->dim_rowmax = row_num;
-    }
+    index = _compact_cell_index(row, col_num);
 
-    if (!ignore_col) {
-        if (col_num < self->dim_colmin)
-            self->dim_colmin = col_num;
-        if (col_num > self->dim_colmax)
-            self->dim_colmax = col_num;
+    if (index == row->num_compact_cells
+        || row->compact_cells[index].col_num != col_num) {
+
+        /* Grow the array if required. Store the cell in the tree instead if
+         * the allocation fails. */
+        if (row->num_compact_cells == row->compact_cells_size) {
+            size = row->compact_cells_size;
+            size = size ? size * 2 : LXW_COMPACT_CELLS_MIN;
+
+            compact = realloc(row->compact_cells,
+                              size * sizeof(lxw_compact_cell));
+            if (!compact) {
+                _insert_cell_list(self, row->cells, cell, col_num);
+                return;
+            }
+
+            row->compact_cells = compact;
+            row->compact_cells_size = size;
+        }
+
+        memmove(&row->compact_cells[index + 1], &row->compact_cells[index],
+                (row->num_compact_cells - index) * sizeof(lxw_compact_cell));
+        row->num_compact_cells++;
     }
 
-    return LXW_NO_ERROR;
-}
+    /* Remove any existing cell at the same position in the tree. */
+    cell->col_num = col_num;
 
-/*
+    if (!RB_EMPTY(row->cells)) {
+        existing_cell = RB_FIND(lxw_table_cells, row->cells, cell);
+
+        if (existing_cell) {
+            RB_REMOVE(lxw_table_cells, row->cells, existing_cell);
+            _free_cell(self, existing_cell);
+        }
+    }
+
+    compact = &row->compact_cells[index];
+    compact->col_num = col_num;
+    compact->type = (uint8_t) cell->type;
+    compact->format_id = format_id;
+
+    if (cell->type == STRING_CELL)
+        compact->u.sst_element = cell->sst_element;
+    else
+        compact->u.number = cell->u.number;
+
+    _free_cell(self, cell);
+}
+
+/*
+ * Get the first and last col numbers of the cells in a row. Returns false if
+ * the row doesn't have any cells.
+ */
+STATIC uint8_t
+_get_row_col_range(lxw_row *row, lxw_col_t *col_min, lxw_col_t *col_max)
+{
+    lxw_cell *cell;
+
+    if (RB_EMPTY(row->cells)) {
+        if (!row->num_compact_cells)
+            return LXW_FALSE;
+
+        *col_min = row->compact_cells[0].col_num;
+        *col_max = row->compact_cells[row->num_compact_cells - 1].col_num;
+        return LXW_TRUE;
+    }
+
+    cell = RB_MIN(lxw_table_cells, row->cells);
+    *col_min = cell->col_num;
+    cell = RB_MAX(lxw_table_cells, row->cells);
+    *col_max = cell->col_num;
+
+    if (row->num_compact_cells) {
+        if (row->compact_cells[0].col_num < *col_min)
+            *col_min = row->compact_cells[0].col_num;
+
+        if (row->compact_cells[row->num_compact_cells - 1].col_num > *col_max)
+            *col_max = row->compact_cells[row->num_compact_cells - 1].col_num;
+    }
+
+    return LXW_TRUE;
+}
+
+/*
+ * Extend the first and last column of the block of 16 rows that contains a
+ * new cell, for use in the row "spans" attribute. If the block array can't
+ * be resized the tracking is turned off and all the spans are calculated
+ * from the rows in _calculate_spans().
+ */
+STATIC void
+_update_block_span(lxw_worksheet *self, lxw_row_t row_num, lxw_col_t col_num)
+{
+    uint32_t block_num = row_num / 16;
+    lxw_block_span *span;
+
+    if (self->block_spans_invalid)
+        return;
+
+    if (block_num >= self->block_spans_max) {
+        uint32_t old_size = self->block_spans_max;
+        uint32_t new_size = old_size ? old_size : 16;
+        uint32_t i;
+        lxw_block_span *new_ptr;
+
+        while (new_size <= block_num)
+            new_size *= 2;
+
+        new_ptr = realloc(self->block_spans,
+                          new_size * sizeof(lxw_block_span));
+        if (!new_ptr) {
+            self->block_spans_invalid = LXW_TRUE;
+            return;
+        }
+
+        for (i = old_size; i < new_size; i++) {
+            new_ptr[i].col_min = LXW_COL_MAX;
+            new_ptr[i].col_max = 0;
+        }
+
+        self->block_spans = new_ptr;
+        self->block_spans_max = new_size;
+    }
+
+    span = &self->block_spans[block_num];
+
+    if (col_num < span->col_min)
+        span->col_min = col_num;
+
+    if (col_num > span->col_max)
+        span->col_max = col_num;
+}
+
+/*
+ * Insert a cell object into the cell list or array of a row object.
+ */
+STATIC void
+_insert_cell_in_row(lxw_worksheet *self, lxw_row *row, lxw_col_t col_num,
+                    lxw_cell *cell)
+{
+    if (!self->optimize) {
+        row->data_changed = LXW_TRUE;
+        _update_block_span(self, row->row_num, col_num);
+
+        if (self->compact_cells)
+            _insert_compact_cell(self, row, cell, col_num);
+        else
+            _insert_cell_list(self, row->cells, cell, col_num);
+    }
+    else {
+        if (row) {
+            row->data_changed = LXW_TRUE;
+
+            /* Overwrite an existing cell if necessary. */
+            if (self->array[col_num])
+                _free_cell(self, self->array[col_num]);
+
+            self->array[col_num] = cell;
+        }
+    }
+}
+
+/*
+ * Insert a cell object into a row when the cells are added in column order.
+ * A cell after the last cell in the row's cell tree is linked in as the right
+ * child of the last cell, which avoids searching the tree from the root, and
+ * becomes the new last cell. Other cells are inserted in the normal way.
+ */
+STATIC void
+_append_cell_in_row(lxw_worksheet *self, lxw_row *row, lxw_col_t col_num,
+                    lxw_cell *cell, lxw_cell **last_cell)
+{
+    lxw_cell *last = *last_cell;
+
+    if (self->optimize || self->compact_cells || !last
+        || col_num <= last->col_num) {
+
+        _insert_cell_in_row(self, row, col_num, cell);
+
+        if (!self->optimize && !self->compact_cells)
+            *last_cell = RB_MAX(lxw_table_cells, row->cells);
+
+        return;
+    }
+
+    cell->col_num = col_num;
+    RB_SET(cell, last, tree_pointers);
+    RB_RIGHT(last, tree_pointers) = cell;
+    lxw_table_cells_RB_INSERT_COLOR(row->cells, cell);
+
+    row->data_changed = LXW_TRUE;
+    _update_block_span(self, row->row_num, col_num);
+    *last_cell = cell;
+}
+
+/*
+ * Insert a cell object into the cell list or array.
+ */
+STATIC void
+_insert_cell(lxw_worksheet *self, lxw_row_t row_num, lxw_col_t col_num,
+             lxw_cell *cell)
+{
+    _insert_cell_in_row(self, _get_row(self, row_num), col_num, cell);
+}
+
+/*
+ * Insert a blank placeholder cell in the cells RB tree in the same position
+ * as a comment so that the rows "spans" calculation is correct. Since the
+ * blank cell doesn't have a format it is ignored when writing. If there is
+ * already a cell in the required position we don't have add a new cell.
+ */
+STATIC void
+_insert_cell_placeholder(lxw_worksheet *self, lxw_row_t row_num,
+                         lxw_col_t col_num)
+{
+    lxw_row *row;
+    lxw_cell *cell;
+
+    /* The spans calculation isn't required in constant_memory mode. */
+    if (self->optimize)
+        return;
+
+    cell = _new_blank_cell(self, row_num, col_num, NULL);
+    if (!cell)
+        return;
+
+    /* Only add a cell if one doesn't already exist. */
+    row = _get_row(self, row_num);
+    if (!RB_FIND(lxw_table_cells, row->cells, cell)
+        && !_find_compact_cell(row, col_num)) {
+
+        _update_block_span(self, row_num, col_num);
+
+        if (self->compact_cells)
+            _insert_compact_cell(self, row, cell, col_num);
+        else
+            _insert_cell_list(self, row->cells, cell, col_num);
+    }
+    else {
+        _free_cell(self, cell);
+    }
+}
+
+/*
+ * Insert a hyperlink object into the hyperlink RB tree.
+ */
+STATIC void
+_insert_hyperlink(lxw_worksheet *self, lxw_row_t row_num, lxw_col_t col_num,
+                  lxw_cell *link)
+{
+    lxw_row *row = _get_row_list(self, self->hyperlinks, row_num);
+
+    _insert_cell_list(self, row->cells, link, col_num);
+}
+
+/*
+ * Insert a comment into the comment RB tree.
+ */
+STATIC void
+_insert_comment(lxw_worksheet *self, lxw_row_t row_num, lxw_col_t col_num,
+                lxw_cell *link)
+{
+    lxw_row *row = _get_row_list(self, self->comments, row_num);
+
+    _insert_cell_list(self, row->cells, link, col_num);
+}
+
+/*
+ * Check if a string is longer than the Excel limit. The UTF-8 characters are
+ * only counted if the number of bytes is over the limit.
+ */
+STATIC uint8_t
+_string_too_long(const char *string, size_t length)
+{
+    size_t char_count = 0;
+    size_t i;
+
+    if (length <= LXW_STR_MAX)
+        return LXW_FALSE;
+
+    for (i = 0; i < length; i++) {
+        if ((string[i] & 0xc0) != 0x80)
+            char_count++;
+    }
+
+    return char_count > LXW_STR_MAX;
+}
+
+/*
+ * Create a string cell from a string of known length. The string is stored
+ * in the shared string table or, in constant_memory mode, in the SST temp
+ * files or inline in the cell. Static strings aren't copied.
+ */
+STATIC lxw_error
+_create_string_cell_len(lxw_worksheet *self, lxw_row_t row_num,
+                        lxw_col_t col_num, const char *string, size_t length,
+                        lxw_format *format, uint8_t flags, lxw_cell **cell)
+{
+    uint8_t is_static = (flags & LXW_STRING_STATIC) ? LXW_TRUE : LXW_FALSE;
+    uint8_t is_validated = (flags & LXW_STRING_VALIDATED) ? LXW_TRUE
+        : LXW_FALSE;
+    char *string_copy;
+    char *escaped_string;
+    struct sst_element *sst_element;
+    uint32_t string_id;
+    lxw_error err;
+
+    if (_string_too_long(string, length))
+        return LXW_ERROR_MAX_STRING_LENGTH_EXCEEDED;
+
+    if (!self->optimize) {
+        /* Get the SST element and string id. */
+        sst_element = lxw_get_sst_index_len(self->sst, string, length,
+                                            is_static, is_validated);
+
+        if (!sst_element)
+            return LXW_ERROR_SHARED_STRING_INDEX_NOT_FOUND;
+
+        *cell = _new_string_cell(self, row_num, col_num, sst_element->index,
+                                 sst_element, format);
+    }
+    else if (self->sst->use_tmpfiles) {
+        /* Get the string id from the SST temp files. */
+        err = lxw_get_sst_id_len(self->sst, string, length, is_validated,
+                                 &string_id);
+        if (err)
+            return err;
+
+        *cell = _new_string_cell(self, row_num, col_num, string_id, NULL,
+                                 format);
+    }
+    else if (is_static
+             && (is_validated || !lxw_has_control_characters(string))) {
+        /* Static strings without control chars are used in place. */
+        *cell = _new_inline_string_cell(self, row_num, col_num,
+                                        (char *) string, format);
+        if (*cell)
+            (*cell)->type = INLINE_STATIC_STRING_CELL;
+    }
+    else {
+        string_copy = malloc(length + 1);
+        RETURN_ON_MEM_ERROR(string_copy, LXW_ERROR_MEMORY_MALLOC_FAILED);
+
+        memcpy(string_copy, string, length);
+        string_copy[length] = '\0';
+
+        /* Look for and escape control chars in the string. */
+        if (!is_validated && lxw_has_control_characters(string_copy)) {
+            escaped_string = lxw_escape_control_characters(string_copy);
+            free(string_copy);
+            string_copy = escaped_string;
+        }
+
+        *cell = _new_inline_string_cell(self, row_num, col_num, string_copy,
+                                        format);
+    }
+
+    return LXW_NO_ERROR;
+}
+
+/*
+ * Create a string cell from a null terminated string.
+ */
+STATIC lxw_error
+_create_string_cell(lxw_worksheet *self, lxw_row_t row_num,
+                    lxw_col_t col_num, const char *string,
+                    lxw_format *format, lxw_cell **cell)
+{
+    return _create_string_cell_len(self, row_num, col_num, string,
+                                   strlen(string), format,
+                                   LXW_STRING_DEFAULT, cell);
+}
+
+/*
+ * Next power of two for column reallocs. Taken from bithacks in the public
+ * domain.
+ */
+STATIC lxw_col_t
+_next_power_of_two(uint16_t col)
+{
+    col--;
+    col |= col >> 1;
+    col |= col >> 2;
+    col |= col >> 4;
+    col |= col >> 8;
+    col++;
+
+    return col;
+}
+
+/*
+ * Check that row and col are within the allowed Excel range and store max
+ * and min values for use in other methods/elements.
+ *
+ * The ignore_row/ignore_col flags are used to indicate that we wish to
+ * perform the dimension check without storing the value.
+ */
+STATIC lxw_error
+_check_dimensions(lxw_worksheet *self,
+                  lxw_row_t row_num,
+                  lxw_col_t col_num, int8_t ignore_row, int8_t ignore_col)
+{
+    if (row_num >= LXW_ROW_MAX)
+        return LXW_ERROR_WORKSHEET_INDEX_OUT_OF_RANGE;
+
+    if (col_num >= LXW_COL_MAX)
+        return LXW_ERROR_WORKSHEET_INDEX_OUT_OF_RANGE;
+
+    /* In optimization mode we don't change dimensions for rows that are */
+    /* already written. */
+    if (!ignore_row && !ignore_col && self->optimize) {
+        if (row_num < self->optimize_row->row_num)
+            return LXW_ERROR_WORKSHEET_INDEX_OUT_OF_RANGE;
+    }
+
+    if (!ignore_row) {
+        if (row_num < self->dim_rowmin)
+            self->dim_rowmin = row_num;
+        if (row_num > self->dim_rowmax)
+            self->dim_rowmax = row_num;
+    }
+
+    if (!ignore_col) {
+        if (col_num < self->dim_colmin)
+            self->dim_colmin = col_num;
+        if (col_num > self->dim_colmax)
+            self->dim_colmax = col_num;
+    }
+
+    return LXW_NO_ERROR;
+}
+
+/*
+ * Write a 2D array of numbers or strings, in row order, to a range of cells.
+ * If "formats" is NULL the single "format" is used for all of the cells. The
+ * range is checked once and each row is looked up once, instead of for every
+ * cell, and the cells are appended to the row in column order.
+ */
+STATIC lxw_error
+_write_array(lxw_worksheet *self, lxw_row_t first_row, lxw_col_t first_col,
+             lxw_row_t num_rows, lxw_col_t num_cols, uint8_t type,
+             const void *data, lxw_format **formats, lxw_format *format)
+{
+    const double *numbers = (const double *) data;
+    const char *const *strings = (const char *const *) data;
+    const char *string;
+    lxw_row_t row_num;
+    lxw_row_t last_row;
+    lxw_col_t col_num;
+    lxw_col_t last_col;
+    lxw_format *cell_format = format;
+    lxw_row *row;
+    lxw_cell *cell;
+    lxw_cell *last_cell = NULL;
+    lxw_error err;
+
+    if (!data)
+        return LXW_ERROR_NULL_PARAMETER_IGNORED;
+
+    if (type != LXW_ARRAY_NUMBER && type != LXW_ARRAY_STRING)
+        return LXW_ERROR_PARAMETER_VALIDATION;
+
+    if (!num_rows || !num_cols)
+        return LXW_NO_ERROR;
+
+    if (first_row >= LXW_ROW_MAX || num_rows > LXW_ROW_MAX - first_row)
+        return LXW_ERROR_WORKSHEET_INDEX_OUT_OF_RANGE;
+
+    if (first_col >= LXW_COL_MAX || num_cols > LXW_COL_MAX - first_col)
+        return LXW_ERROR_WORKSHEET_INDEX_OUT_OF_RANGE;
+
+    last_row = first_row + num_rows - 1;
+    last_col = (lxw_col_t) (first_col + num_cols - 1);
+
+    /* In constant_memory mode rows before the current row are written. */
+    if (self->optimize && first_row < self->optimize_row->row_num)
+        return LXW_ERROR_WORKSHEET_INDEX_OUT_OF_RANGE;
+
+    /* Every number cell is written so the dimensions are set once. Null
+     * strings are skipped so string cells are checked individually. */
+    if (type == LXW_ARRAY_NUMBER) {
+        _check_dimensions(self, first_row, first_col, LXW_FALSE, LXW_FALSE);
+        _check_dimensions(self, last_row, last_col, LXW_FALSE, LXW_FALSE);
+    }
+
+    for (row_num = first_row; row_num <= last_row; row_num++) {
+        row = NULL;
+
+        for (col_num = first_col; col_num <= last_col; col_num++) {
+            if (formats)
+                cell_format = formats[col_num - first_col];
+
+            if (type == LXW_ARRAY_NUMBER) {
+                cell = _new_number_cell(self, row_num, col_num, *numbers++,
+                                        cell_format);
+            }
+            else {
+                string = *strings++;
+
+                if (!string || !*string) {
+                    /* Empty strings are only written if they have a format,
+                     * as blank cells. */
+                    if (!cell_format)
+                        continue;
+
+                    cell = _new_blank_cell(self, row_num, col_num,
+                                           cell_format);
+                }
+                else {
+                    err = _create_string_cell(self, row_num, col_num, string,
+                                              cell_format, &cell);
+                    if (err)
+                        return err;
+                }
+
+                _check_dimensions(self, row_num, col_num, LXW_FALSE,
+                                  LXW_FALSE);
+            }
+
+            if (!row) {
+                row = _get_row(self, row_num);
+
+                if (!self->optimize)
+                    last_cell = RB_MAX(lxw_table_cells, row->cells);
+            }
+
+            _append_cell_in_row(self, row, col_num, cell, &last_cell);
+        }
+    }
+
+    return LXW_NO_ERROR;
+}
+
+/*
  * Comparator for the row structure red/black tree.
  */
 STATIC int
@@ -2568,7 +3380,23 @@ _worksheet_write_optimized_sheet_data(lxw_worksheet *self)
 
         lxw_xml_start_tag(self->file, "sheetData", NULL);
 
-        /* Flush the temp file. */
+        if (self->deflated_rows) {
+            /* Deflate the remaining rows and store the position where the
+             * packager should insert them instead of copying them. */
+            _deflate_staged_rows(self, LXW_TRUE);
+            fflush(self->file);
+            self->deflated_rows->offset = ftell(self->file);
+            self->deflated_rows->complete = LXW_TRUE;
+
+            fclose(self->optimize_tmpfile);
+            free(self->optimize_buffer);
+
+            lxw_xml_end_tag(self->file, "sheetData");
+            return;
+        }
+
+        /* Write any buffered row data and flush the temp file. */
+        _worksheet_flush_sheet_data(self);
         fflush(self->optimize_tmpfile);
 
         if (self->optimize_buffer) {
@@ -2587,153 +3415,541 @@ _worksheet_write_optimized_sheet_data(lxw_worksheet *self)
             }
         }
 
-        fclose(self->optimize_tmpfile);
-        free(self->optimize_buffer);
+        fclose(self->optimize_tmpfile);
+        free(self->optimize_buffer);
+
+        lxw_xml_end_tag(self->file, "sheetData");
+    }
+}
+
+/*
+ * Write the <pageMargins> element.
+ */
+STATIC void
+_worksheet_write_page_margins(lxw_worksheet *self)
+{
+    struct xml_attribute_list attributes;
+    struct xml_attribute *attribute;
+    double left = self->margin_left;
+    double right = self->margin_right;
+    double top = self->margin_top;
+    double bottom = self->margin_bottom;
+    double header = self->margin_header;
+    double footer = self->margin_footer;
+
+    LXW_INIT_ATTRIBUTES();
+    LXW_PUSH_ATTRIBUTES_DBL("left", left);
+    LXW_PUSH_ATTRIBUTES_DBL("right", right);
+    LXW_PUSH_ATTRIBUTES_DBL("top", top);
+    LXW_PUSH_ATTRIBUTES_DBL("bottom", bottom);
+    LXW_PUSH_ATTRIBUTES_DBL("header", header);
+    LXW_PUSH_ATTRIBUTES_DBL("footer", footer);
+
+    lxw_xml_empty_tag(self->file, "pageMargins", &attributes);
+
+    LXW_FREE_ATTRIBUTES();
+}
+
+/*
+ * Write the <pageSetup> element.
+ * The following is an example taken from Excel.
+ * <pageSetup
+ *     paperSize="9"
+ *     scale="110"
+ *     fitToWidth="2"
+ *     fitToHeight="2"
+ *     pageOrder="overThenDown"
+ *     orientation="portrait"
+ *     blackAndWhite="1"
+ *     draft="1"
+ *     horizontalDpi="200"
+ *     verticalDpi="200"
+ *     r:id="rId1"
+ * />
+ */
+STATIC void
+_worksheet_write_page_setup(lxw_worksheet *self)
+{
+    struct xml_attribute_list attributes;
+    struct xml_attribute *attribute;
+
+    LXW_INIT_ATTRIBUTES();
+
+    if (!self->page_setup_changed)
+        return;
+
+    /* Set paper size. */
+    if (self->paper_size)
+        LXW_PUSH_ATTRIBUTES_INT("paperSize", self->paper_size);
+
+    /* Set the print_scale. */
+    if (self->print_scale != 100)
+        LXW_PUSH_ATTRIBUTES_INT("scale", self->print_scale);
+
+    /* Set the "Fit to page" properties. */
+    if (self->fit_page && self->fit_width != 1)
+        LXW_PUSH_ATTRIBUTES_INT("fitToWidth", self->fit_width);
+
+    if (self->fit_page && self->fit_height != 1)
+        LXW_PUSH_ATTRIBUTES_INT("fitToHeight", self->fit_height);
+
+    /* Set the page print direction. */
+    if (self->page_order)
+        LXW_PUSH_ATTRIBUTES_STR("pageOrder", "overThenDown");
+
+    /* Set start page. */
+    if (self->page_start > 1)
+        LXW_PUSH_ATTRIBUTES_INT("firstPageNumber", self->page_start);
+
+    /* Set page orientation. */
+    if (self->orientation)
+        LXW_PUSH_ATTRIBUTES_STR("orientation", "portrait");
+    else
+        LXW_PUSH_ATTRIBUTES_STR("orientation", "landscape");
+
+    if (self->black_white)
+        LXW_PUSH_ATTRIBUTES_STR("blackAndWhite", "1");
+
+    /* Set start page active flag. */
+    if (self->page_start)
+        LXW_PUSH_ATTRIBUTES_INT("useFirstPageNumber", 1);
+
+    /* Set the DPI. Mainly only for testing. */
+    if (self->horizontal_dpi)
+        LXW_PUSH_ATTRIBUTES_INT("horizontalDpi", self->horizontal_dpi);
+
+    if (self->vertical_dpi)
+        LXW_PUSH_ATTRIBUTES_INT("verticalDpi", self->vertical_dpi);
+
+    lxw_xml_empty_tag(self->file, "pageSetup", &attributes);
+
+    LXW_FREE_ATTRIBUTES();
+}
+
+/*
+ * Write the <printOptions> element.
+ */
+STATIC void
+_worksheet_write_print_options(lxw_worksheet *self)
+{
+    struct xml_attribute_list attributes;
+    struct xml_attribute *attribute;
+    if (!self->print_options_changed)
+        return;
+
+    LXW_INIT_ATTRIBUTES();
+
+    /* Set horizontal centering. */
+    if (self->hcenter) {
+        LXW_PUSH_ATTRIBUTES_STR("horizontalCentered", "1");
+    }
+
+    /* Set vertical centering. */
+    if (self->vcenter) {
+        LXW_PUSH_ATTRIBUTES_STR("verticalCentered", "1");
+    }
+
+    /* Enable row and column headers. */
+    if (self->print_headers) {
+        LXW_PUSH_ATTRIBUTES_STR("headings", "1");
+    }
+
+    /* Set printed gridlines. */
+    if (self->print_gridlines) {
+        LXW_PUSH_ATTRIBUTES_STR("gridLines", "1");
+    }
+
+    lxw_xml_empty_tag(self->file, "printOptions", &attributes);
+
+    LXW_FREE_ATTRIBUTES();
+}
+
+/*
+ * The <sheetData> rows and cells are the bulk of a worksheet file so they are
+ * formatted with the specialized routines below, instead of fprintf() and the
+ * xmlwriter functions, and collected in a per-worksheet buffer that is
+ * written to the file in large blocks.
+ */
+
+/* Append a string literal to a sheetData buffer. */
+#define LXW_SHEET_DATA_PUT(p, str)                  \
+    do {                                            \
+        memcpy((p), (str), sizeof(str) - 1);        \
+        (p) += sizeof(str) - 1;                     \
+    } while (0)
+
+/*
+ * In constant_memory mode the rows are written to a staging tmpfile that is
+ * deflated into a second tmpfile each time it grows past a threshold. The
+ * packager then splices the deflated rows into the zip file between the
+ * worksheet XML that comes before and after the <sheetData> rows. This
+ * avoids copying the uncompressed row data into the worksheet file and
+ * compressing it again at close.
+ */
+
+/*
+ * Convert the workbook compression strategy to a zlib strategy.
+ */
+STATIC int
+_deflate_rows_strategy(uint8_t strategy)
+{
+    switch (strategy) {
+        case LXW_COMPRESSION_STRATEGY_FILTERED:
+            return Z_FILTERED;
+        case LXW_COMPRESSION_STRATEGY_HUFFMAN_ONLY:
+            return Z_HUFFMAN_ONLY;
+        case LXW_COMPRESSION_STRATEGY_RLE:
+            return Z_RLE;
+        case LXW_COMPRESSION_STRATEGY_FIXED:
+            return Z_FIXED;
+        default:
+            return Z_DEFAULT_STRATEGY;
+    }
+}
+
+/*
+ * Free a deflated rows object.
+ */
+STATIC void
+_free_deflated_rows(lxw_deflated_rows *rows)
+{
+    if (!rows)
+        return;
+
+    if (rows->stream) {
+        deflateEnd((z_stream *) rows->stream);
+        free(rows->stream);
+    }
+
+    if (rows->file)
+        fclose(rows->file);
+
+    free(rows->buffer);
+    free(rows);
+}
+
+/*
+ * Create a deflated rows object with a raw deflate stream and a tmpfile for
+ * the compressed data.
+ */
+STATIC lxw_deflated_rows *
+_new_deflated_rows(lxw_worksheet_init_data *init_data)
+{
+    lxw_deflated_rows *rows;
+    z_stream *stream;
+    int level = Z_DEFAULT_COMPRESSION;
+
+    rows = calloc(1, sizeof(lxw_deflated_rows));
+    RETURN_ON_MEM_ERROR(rows, NULL);
+
+    rows->level = init_data->compression_level;
+    rows->strategy = init_data->compression_strategy;
+    rows->crc = crc32(0L, Z_NULL, 0);
+
+    if (rows->level)
+        level = rows->level;
+
+    stream = calloc(1, sizeof(z_stream));
+    GOTO_LABEL_ON_MEM_ERROR(stream, mem_error);
+
+    if (deflateInit2(stream, level, Z_DEFLATED, -MAX_WBITS,
+                     LXW_DEFLATE_MEM_LEVEL,
+                     _deflate_rows_strategy(rows->strategy)) != Z_OK) {
+        free(stream);
+        goto mem_error;
+    }
+
+    rows->stream = stream;
+
+    rows->file = lxw_get_filehandle(&rows->buffer, &rows->buffer_size,
+                                    init_data->tmpdir);
+    if (!rows->file) {
+        LXW_ERROR("Error creating tmpfile() for worksheet in "
+                  "'constant_memory' mode.");
+        goto mem_error;
+    }
+
+    return rows;
+
+mem_error:
+    _free_deflated_rows(rows);
+    return NULL;
+}
+
+/*
+ * Deflate a block of row data, or finish the current block of the stream if
+ * data is NULL, and write the output to the deflated rows tmpfile.
+ */
+STATIC void
+_deflate_rows_data(lxw_deflated_rows *rows, char *data, size_t length)
+{
+    z_stream *stream = (z_stream *) rows->stream;
+    unsigned char output[LXW_BUFFER_SIZE];
+    int flush = data ? Z_NO_FLUSH : Z_SYNC_FLUSH;
+    size_t output_size;
+    int status;
+
+    if (data) {
+        rows->crc = crc32(rows->crc, (const Bytef *) data, (uInt) length);
+        rows->uncompressed_size += length;
+    }
+
+    stream->next_in = (Bytef *) data;
+    stream->avail_in = (uInt) length;
+
+    do {
+        stream->next_out = output;
+        stream->avail_out = LXW_BUFFER_SIZE;
+
+        status = deflate(stream, flush);
+        if (status == Z_STREAM_ERROR) {
+            rows->error = LXW_TRUE;
+            return;
+        }
+
+        output_size = LXW_BUFFER_SIZE - stream->avail_out;
+        if (fwrite(output, 1, output_size, rows->file) != output_size) {
+            rows->error = LXW_TRUE;
+            return;
+        }
+    } while (stream->avail_out == 0);
+}
+
+/*
+ * Deflate the row data in the staging tmpfile and rewind it for reuse. If
+ * "finish" is set the deflate stream is flushed to a byte boundary so that
+ * the worksheet XML after the rows can be appended to it.
+ */
+STATIC void
+_deflate_staged_rows(lxw_worksheet *self, uint8_t finish)
+{
+    lxw_deflated_rows *rows = self->deflated_rows;
+    long staged_size;
+    size_t read_size;
+
+    _worksheet_flush_sheet_data(self);
+    fflush(self->optimize_tmpfile);
+    staged_size = ftell(self->optimize_tmpfile);
+
+    if (staged_size < 0) {
+        rows->error = LXW_TRUE;
+        return;
+    }
+
+    if (self->optimize_buffer) {
+        _deflate_rows_data(rows, self->optimize_buffer, (size_t) staged_size);
+    }
+    else {
+        /* The sheetData buffer is empty after the flush so it is used to
+         * read back the staged data. Only the data written since the last
+         * rewind is read since the file may contain older data after it. */
+        rewind(self->optimize_tmpfile);
+
+        while (staged_size > 0) {
+            read_size = LXW_SHEET_DATA_BUFFER_SIZE;
+            if ((long) read_size > staged_size)
+                read_size = (size_t) staged_size;
+
+            if (fread(self->sheet_data_buffer, 1, read_size,
+                      self->optimize_tmpfile) != read_size) {
+                rows->error = LXW_TRUE;
+                return;
+            }
+
+            _deflate_rows_data(rows, self->sheet_data_buffer, read_size);
+            staged_size -= (long) read_size;
+        }
+    }
+
+    if (finish)
+        _deflate_rows_data(rows, NULL, 0);
 
-        lxw_xml_end_tag(self->file, "sheetData");
-    }
+    rewind(self->optimize_tmpfile);
 }
 
 /*
- * Write the <pageMargins> element.
+ * Write any buffered sheetData to the worksheet file. In constant_memory mode
+ * the row data always belongs to the optimization tmpfile since the packager
+ * replaces the worksheet file before the rows are copied into it.
  */
 STATIC void
-_worksheet_write_page_margins(lxw_worksheet *self)
+_worksheet_flush_sheet_data(lxw_worksheet *self)
 {
-    struct xml_attribute_list attributes;
-    struct xml_attribute *attribute;
-    double left = self->margin_left;
-    double right = self->margin_right;
-    double top = self->margin_top;
-    double bottom = self->margin_bottom;
-    double header = self->margin_header;
-    double footer = self->margin_footer;
-
-    LXW_INIT_ATTRIBUTES();
-    LXW_PUSH_ATTRIBUTES_DBL("left", left);
-    LXW_PUSH_ATTRIBUTES_DBL("right", right);
-    LXW_PUSH_ATTRIBUTES_DBL("top", top);
-    LXW_PUSH_ATTRIBUTES_DBL("bottom", bottom);
-    LXW_PUSH_ATTRIBUTES_DBL("header", header);
-    LXW_PUSH_ATTRIBUTES_DBL("footer", footer);
+    FILE *file = self->optimize ? self->optimize_tmpfile : self->file;
 
-    lxw_xml_empty_tag(self->file, "pageMargins", &attributes);
+    if (!self->sheet_data_length)
+        return;
 
-    LXW_FREE_ATTRIBUTES();
+    /* Ignore return value. There is no easy way to raise error. */
+    (void) fwrite(self->sheet_data_buffer, 1, self->sheet_data_length, file);
+    self->sheet_data_length = 0;
 }
 
 /*
- * Write the <pageSetup> element.
- * The following is an example taken from Excel.
- * <pageSetup
- *     paperSize="9"
- *     scale="110"
- *     fitToWidth="2"
- *     fitToHeight="2"
- *     pageOrder="overThenDown"
- *     orientation="portrait"
- *     blackAndWhite="1"
- *     draft="1"
- *     horizontalDpi="200"
- *     verticalDpi="200"
- *     r:id="rId1"
- * />
+ * Append data to the sheetData buffer. If there isn't a buffer, or the data
+ * is too large for it, the data is written directly to the file.
  */
 STATIC void
-_worksheet_write_page_setup(lxw_worksheet *self)
+_worksheet_append_sheet_data(lxw_worksheet *self, const char *data,
+                             size_t length)
 {
-    struct xml_attribute_list attributes;
-    struct xml_attribute *attribute;
-
-    LXW_INIT_ATTRIBUTES();
+    if (self->sheet_data_length + length > LXW_SHEET_DATA_BUFFER_SIZE)
+        _worksheet_flush_sheet_data(self);
 
-    if (!self->page_setup_changed)
+    if (!self->sheet_data_buffer || length > LXW_SHEET_DATA_BUFFER_SIZE) {
+        /* Ignore return value. There is no easy way to raise error. */
+        (void) fwrite(data, 1, length, self->file);
         return;
+    }
 
-    /* Set paper size. */
-    if (self->paper_size)
-        LXW_PUSH_ATTRIBUTES_INT("paperSize", self->paper_size);
-
-    /* Set the print_scale. */
-    if (self->print_scale != 100)
-        LXW_PUSH_ATTRIBUTES_INT("scale", self->print_scale);
+    memcpy(self->sheet_data_buffer + self->sheet_data_length, data, length);
+    self->sheet_data_length += length;
+}
 
-    /* Set the "Fit to page" properties. */
-    if (self->fit_page && self->fit_width != 1)
-        LXW_PUSH_ATTRIBUTES_INT("fitToWidth", self->fit_width);
+/*
+ * Append a string to the sheetData buffer, escaping the XML data characters
+ * as runs of unescaped data are found instead of making an escaped copy.
+ */
+STATIC void
+_append_escaped_sheet_data(lxw_worksheet *self, const char *string,
+                           size_t length)
+{
+    const char *end = string + length;
+    const char *start = string;
+    const char *p;
 
-    if (self->fit_page && self->fit_height != 1)
-        LXW_PUSH_ATTRIBUTES_INT("fitToHeight", self->fit_height);
+    for (p = string; p < end; p++) {
+        if (*p != '&' && *p != '<' && *p != '>')
+            continue;
 
-    /* Set the page print direction. */
-    if (self->page_order)
-        LXW_PUSH_ATTRIBUTES_STR("pageOrder", "overThenDown");
+        _worksheet_append_sheet_data(self, start, (size_t) (p - start));
 
-    /* Set start page. */
-    if (self->page_start > 1)
-        LXW_PUSH_ATTRIBUTES_INT("firstPageNumber", self->page_start);
+        if (*p == '&')
+            _worksheet_append_sheet_data(self, "&amp;", 5);
+        else if (*p == '<')
+            _worksheet_append_sheet_data(self, "&lt;", 4);
+        else
+            _worksheet_append_sheet_data(self, "&gt;", 4);
 
-    /* Set page orientation. */
-    if (self->orientation)
-        LXW_PUSH_ATTRIBUTES_STR("orientation", "portrait");
-    else
-        LXW_PUSH_ATTRIBUTES_STR("orientation", "landscape");
+        start = p + 1;
+    }
 
-    if (self->black_white)
-        LXW_PUSH_ATTRIBUTES_STR("blackAndWhite", "1");
+    _worksheet_append_sheet_data(self, start, (size_t) (end - start));
+}
 
-    /* Set start page active flag. */
-    if (self->page_start)
-        LXW_PUSH_ATTRIBUTES_INT("useFirstPageNumber", 1);
+/*
+ * Format an unsigned integer in decimal. Returns the end of the string.
+ */
+STATIC char *
+_sheet_data_uint(char *p, uint32_t number)
+{
+    char digits[10];
+    int i = 0;
 
-    /* Set the DPI. Mainly only for testing. */
-    if (self->horizontal_dpi)
-        LXW_PUSH_ATTRIBUTES_INT("horizontalDpi", self->horizontal_dpi);
+    do {
+        digits[i++] = (char) ('0' + number % 10);
+        number /= 10;
+    } while (number);
 
-    if (self->vertical_dpi)
-        LXW_PUSH_ATTRIBUTES_INT("verticalDpi", self->vertical_dpi);
+    while (i)
+        *p++ = digits[--i];
 
-    lxw_xml_empty_tag(self->file, "pageSetup", &attributes);
+    return p;
+}
 
-    LXW_FREE_ATTRIBUTES();
+/*
+ * Format a double with lxw_sprintf_dbl(). Returns the end of the string.
+ */
+STATIC char *
+_sheet_data_dbl(char *p, double number)
+{
+    return p + lxw_sprintf_dbl(p, number);
 }
 
 /*
- * Write the <printOptions> element.
+ * Format a zero indexed row and column as an A1 style cell reference.
+ * Returns the end of the string.
+ *
+ * Cells are written in row order, and mostly in adjacent columns, so the row
+ * digits and column letters of the previous reference are kept and only
+ * updated when they change. The column letters are incremented in place for
+ * the next column rather than being recalculated.
  */
-STATIC void
-_worksheet_write_print_options(lxw_worksheet *self)
+STATIC char *
+_sheet_data_cell_ref(lxw_worksheet *self, char *p, lxw_row_t row_num,
+                     lxw_col_t col_num)
 {
-    struct xml_attribute_list attributes;
-    struct xml_attribute *attribute;
-    if (!self->print_options_changed)
-        return;
+    char *name = self->sheet_data_col_name;
+    uint8_t length = self->sheet_data_col_name_length;
+    uint32_t col;
+    int i;
 
-    LXW_INIT_ATTRIBUTES();
+    if (col_num == self->sheet_data_col_num + 1) {
+        /* Increment the letters: "AZ" -> "BA", "ZZ" -> "AAA". */
+        for (i = length - 1; i >= 0 && name[i] == 'Z'; i--)
+            name[i] = 'A';
 
-    /* Set horizontal centering. */
-    if (self->hcenter) {
-        LXW_PUSH_ATTRIBUTES_STR("horizontalCentered", "1");
+        if (i >= 0) {
+            name[i]++;
+        }
+        else {
+            memmove(name + 1, name, length);
+            name[0] = 'A';
+            length++;
+        }
     }
+    else if (col_num != self->sheet_data_col_num) {
+        char letters[3];
 
-    /* Set vertical centering. */
-    if (self->vcenter) {
-        LXW_PUSH_ATTRIBUTES_STR("verticalCentered", "1");
-    }
+        col = (uint32_t) col_num + 1;
+        length = 0;
 
-    /* Enable row and column headers. */
-    if (self->print_headers) {
-        LXW_PUSH_ATTRIBUTES_STR("headings", "1");
+        while (col && length < 3) {
+            col--;
+            letters[length++] = (char) ('A' + col % 26);
+            col /= 26;
+        }
+
+        for (i = 0; i < length; i++)
+            name[i] = letters[length - 1 - i];
     }
 
-    /* Set printed gridlines. */
-    if (self->print_gridlines) {
-        LXW_PUSH_ATTRIBUTES_STR("gridLines", "1");
+    self->sheet_data_col_num = col_num;
+    self->sheet_data_col_name_length = length;
+
+    if (row_num != self->sheet_data_row_num) {
+        char *end = _sheet_data_uint(self->sheet_data_row_name, row_num + 1);
+
+        self->sheet_data_row_num = row_num;
+        self->sheet_data_row_name_length =
+            (uint8_t) (end - self->sheet_data_row_name);
     }
 
-    lxw_xml_empty_tag(self->file, "printOptions", &attributes);
+    memcpy(p, name, length);
+    p += length;
+    memcpy(p, self->sheet_data_row_name, self->sheet_data_row_name_length);
 
-    LXW_FREE_ATTRIBUTES();
+    return p + self->sheet_data_row_name_length;
+}
+
+/*
+ * Format the common start of a cell element: <c r="A1" s="1"
+ */
+STATIC char *
+_sheet_data_cell_start(lxw_worksheet *self, char *p, lxw_cell *cell,
+                       int32_t style_index)
+{
+    LXW_SHEET_DATA_PUT(p, "<c r=\"");
+    p = _sheet_data_cell_ref(self, p, cell->row_num, cell->col_num);
+    *p++ = '"';
+
+    if (style_index) {
+        LXW_SHEET_DATA_PUT(p, " s=\"");
+        p = _sheet_data_uint(p, (uint32_t) style_index);
+        *p++ = '"';
+    }
+
+    return p;
 }
 
 /*
@@ -2742,8 +3958,8 @@ _worksheet_write_print_options(lxw_worksheet *self)
 STATIC void
 _write_row(lxw_worksheet *self, lxw_row *row, char *spans)
 {
-    struct xml_attribute_list attributes;
-    struct xml_attribute *attribute;
+    char data[LXW_SHEET_DATA_ROW_LENGTH];
+    char *p = data;
     int32_t xf_index = 0;
     double height;
 
@@ -2756,119 +3972,327 @@ _write_row(lxw_worksheet *self, lxw_row *row, char *spans)
     else
         height = self->default_row_height;
 
-    LXW_INIT_ATTRIBUTES();
-    LXW_PUSH_ATTRIBUTES_INT("r", row->row_num + 1);
+    LXW_SHEET_DATA_PUT(p, "<row r=\"");
+    p = _sheet_data_uint(p, row->row_num + 1);
+    *p++ = '"';
 
-    if (spans)
-        LXW_PUSH_ATTRIBUTES_STR("spans", spans);
+    if (spans) {
+        size_t length = strlen(spans);
 
-    if (xf_index)
-        LXW_PUSH_ATTRIBUTES_INT("s", xf_index);
+        LXW_SHEET_DATA_PUT(p, " spans=\"");
+        memcpy(p, spans, length);
+        p += length;
+        *p++ = '"';
+    }
+
+    if (xf_index) {
+        LXW_SHEET_DATA_PUT(p, " s=\"");
+        p = _sheet_data_uint(p, (uint32_t) xf_index);
+        *p++ = '"';
+    }
 
     if (row->format)
-        LXW_PUSH_ATTRIBUTES_STR("customFormat", "1");
+        LXW_SHEET_DATA_PUT(p, " customFormat=\"1\"");
 
-    if (height != LXW_DEF_ROW_HEIGHT)
-        LXW_PUSH_ATTRIBUTES_DBL("ht", height);
+    if (height != LXW_DEF_ROW_HEIGHT) {
+        LXW_SHEET_DATA_PUT(p, " ht=\"");
+        p = _sheet_data_dbl(p, height);
+        *p++ = '"';
+    }
 
     if (row->hidden)
-        LXW_PUSH_ATTRIBUTES_STR("hidden", "1");
+        LXW_SHEET_DATA_PUT(p, " hidden=\"1\"");
 
     if (height != LXW_DEF_ROW_HEIGHT)
-        LXW_PUSH_ATTRIBUTES_STR("customHeight", "1");
+        LXW_SHEET_DATA_PUT(p, " customHeight=\"1\"");
 
-    if (row->level)
-        LXW_PUSH_ATTRIBUTES_INT("outlineLevel", row->level);
+    if (row->level) {
+        LXW_SHEET_DATA_PUT(p, " outlineLevel=\"");
+        p = _sheet_data_uint(p, row->level);
+        *p++ = '"';
+    }
 
     if (row->collapsed)
-        LXW_PUSH_ATTRIBUTES_STR("collapsed", "1");
+        LXW_SHEET_DATA_PUT(p, " collapsed=\"1\"");
 
     if (self->excel_version == 2010)
-        LXW_PUSH_ATTRIBUTES_STR("x14ac:dyDescent", "0.25");
+        LXW_SHEET_DATA_PUT(p, " x14ac:dyDescent=\"0.25\"");
 
     if (!row->data_changed)
-        lxw_xml_empty_tag(self->file, "row", &attributes);
+        LXW_SHEET_DATA_PUT(p, "/>");
     else
-        lxw_xml_start_tag(self->file, "row", &attributes);
+        *p++ = '>';
 
-    LXW_FREE_ATTRIBUTES();
+    _worksheet_append_sheet_data(self, data, (size_t) (p - data));
+}
+
+/*
+ * Convert the width of a column range from user's units to pixels. Excel
+ * rounds the column width to the nearest pixel. If the column is hidden it
+ * has a value of zero.
+ */
+STATIC uint32_t
+_worksheet_col_options_pixels(lxw_col_options *col_opt, uint8_t anchor)
+{
+    double width = col_opt->width;
+    double max_digit_width = 7.0;       /* For Calabri 11. */
+    double padding = 5.0;
+
+    if (col_opt->hidden && anchor != LXW_OBJECT_MOVE_AND_SIZE_AFTER)
+        return 0;
+    else if (width < 1.0)
+        return (uint32_t) (width * (max_digit_width + padding) + 0.5);
+    else
+        return (uint32_t) (width * max_digit_width + 0.5) + 5;
 }
 
 /*
- * Convert the width of a cell from user's units to pixels. Excel rounds the
- * column width to the nearest pixel. If the width hasn't been set by the user
- * we use the default value. If the column is hidden it has a value of zero.
+ * Convert the width of a cell from user's units to pixels. If the width
+ * hasn't been set by the user we use the default value.
  */
 STATIC int32_t
 _worksheet_size_col(lxw_worksheet *self, lxw_col_t col_num, uint8_t anchor)
 {
-    lxw_col_options *col_opt = NULL;
+    lxw_col_options *col_opt = NULL;
+    uint32_t pixels;
+    lxw_col_t col_index;
+
+    /* Search for the col number in the array of col_options. Each col_option
+     * entry contains the start and end column for a range.
+     */
+    for (col_index = 0; col_index < self->col_options_max; col_index++) {
+        col_opt = self->col_options[col_index];
+
+        if (col_opt) {
+            if (col_num >= col_opt->firstcol && col_num <= col_opt->lastcol)
+                break;
+            else
+                col_opt = NULL;
+        }
+    }
+
+    if (col_opt)
+        pixels = _worksheet_col_options_pixels(col_opt, anchor);
+    else
+        pixels = self->default_col_pixels;
+
+    return pixels;
+}
+
+/*
+ * Convert the height of a row object from user's units to pixels. If the row
+ * doesn't exist we use the default value. If the row is hidden it has a value
+ * of zero.
+ */
+STATIC uint32_t
+_worksheet_row_pixels(lxw_worksheet *self, lxw_row *row, uint8_t anchor)
+{
+    /* Note, the 0.75 below is due to the difference between 72/96 DPI. */
+    if (!row)
+        return (uint32_t) (self->default_row_height / 0.75);
+    else if (row->hidden && anchor != LXW_OBJECT_MOVE_AND_SIZE_AFTER)
+        return 0;
+    else
+        return (uint32_t) (row->height / 0.75);
+}
+
+/*
+ * Convert the height of a cell from user's units to pixels. If the height
+ * hasn't been set by the user we use the default value. If the row is hidden
+ * it has a value of zero.
+ */
+STATIC int32_t
+_worksheet_size_row(lxw_worksheet *self, lxw_row_t row_num, uint8_t anchor)
+{
+    lxw_row *row = lxw_worksheet_find_row(self, row_num);
+
+    return _worksheet_row_pixels(self, row, anchor);
+}
+
+/*
+ * Build the prefix sums of the column widths, in pixels, used to find the
+ * absolute horizontal position of an object. Entry n is the offset of the
+ * left edge of column n. Columns after the last column range all have the
+ * default width.
+ */
+STATIC lxw_error
+_worksheet_build_col_offsets(lxw_worksheet *self)
+{
+    lxw_col_options *col_opt;
+    lxw_col_t col_index;
+    lxw_col_t col;
+    lxw_col_t next_col = 0;
+    lxw_col_t num_cols = 0;
+    uint32_t pixels;
+    uint32_t *offsets;
+
+    for (col_index = 0; col_index < self->col_options_max; col_index++) {
+        col_opt = self->col_options[col_index];
+
+        if (col_opt && col_opt->lastcol >= num_cols)
+            num_cols = col_opt->lastcol + 1;
+    }
+
+    offsets = realloc(self->col_offsets, (num_cols + 1) * sizeof(uint32_t));
+    RETURN_ON_MEM_ERROR(offsets, LXW_ERROR_MEMORY_MALLOC_FAILED);
+    self->col_offsets = offsets;
+
+    /* Store the width of each column in the following entry. The col_options
+     * array is ordered by first column and _worksheet_size_col() uses the
+     * first range that contains a column, so each range only sets the
+     * columns after the end of the preceding ranges. */
+    for (col = 0; col < num_cols; col++)
+        offsets[col + 1] = self->default_col_pixels;
+
+    for (col_index = 0; col_index < self->col_options_max; col_index++) {
+        col_opt = self->col_options[col_index];
+
+        if (!col_opt || col_opt->lastcol < next_col)
+            continue;
+
+        pixels = _worksheet_col_options_pixels(col_opt,
+                                               LXW_OBJECT_POSITION_DEFAULT);
+
+        col = col_opt->firstcol > next_col ? col_opt->firstcol : next_col;
+
+        for (; col <= col_opt->lastcol; col++)
+            offsets[col + 1] = pixels;
+
+        next_col = col_opt->lastcol + 1;
+    }
+
+    /* Convert the widths to offsets. */
+    offsets[0] = 0;
+    for (col = 0; col < num_cols; col++)
+        offsets[col + 1] += offsets[col];
+
+    self->col_offsets_max = num_cols;
+    self->col_offsets_valid = LXW_TRUE;
+
+    return LXW_NO_ERROR;
+}
+
+/*
+ * Get the absolute horizontal offset, in pixels, of the left edge of a
+ * column.
+ */
+STATIC uint32_t
+_worksheet_col_offset(lxw_worksheet *self, lxw_col_t col_num)
+{
+    uint32_t offset = 0;
+    lxw_col_t col;
+
+    /* Optimization for when the column widths haven't changed. */
+    if (!self->col_size_changed)
+        return self->default_col_pixels * col_num;
+
+    if (!self->col_offsets_valid && _worksheet_build_col_offsets(self)) {
+        /* Fall back to summing the widths if the cache can't be built. */
+        for (col = 0; col < col_num; col++)
+            offset += _worksheet_size_col(self, col,
+                                          LXW_OBJECT_POSITION_DEFAULT);
+        return offset;
+    }
+
+    if (col_num <= self->col_offsets_max)
+        return self->col_offsets[col_num];
+
+    return self->col_offsets[self->col_offsets_max]
+        + self->default_col_pixels * (col_num - self->col_offsets_max);
+}
+
+/*
+ * Build a sparse index of the rows whose height differs from the default
+ * height, along with the running total of the differences, used to find the
+ * absolute vertical position of an object.
+ */
+STATIC lxw_error
+_worksheet_build_row_offsets(lxw_worksheet *self)
+{
+    lxw_row *row;
+    lxw_row_t count = 0;
+    lxw_row_t *rows;
+    uint32_t *sums;
     uint32_t pixels;
-    double width;
-    double max_digit_width = 7.0;       /* For Calabri 11. */
-    double padding = 5.0;
-    lxw_col_t col_index;
+    uint32_t sum = 0;
+    uint32_t default_pixels = (uint32_t) (self->default_row_height / 0.75);
 
-    /* Search for the col number in the array of col_options. Each col_option
-     * entry contains the start and end column for a range.
-     */
-    for (col_index = 0; col_index < self->col_options_max; col_index++) {
-        col_opt = self->col_options[col_index];
-
-        if (col_opt) {
-            if (col_num >= col_opt->firstcol && col_num <= col_opt->lastcol)
-                break;
-            else
-                col_opt = NULL;
-        }
+    RB_FOREACH(row, lxw_table_rows, self->table) {
+        if (_worksheet_row_pixels(self, row, LXW_OBJECT_POSITION_DEFAULT)
+            != default_pixels)
+            count++;
     }
 
-    if (col_opt) {
-        width = col_opt->width;
+    rows = realloc(self->row_offset_rows, (count + 1) * sizeof(lxw_row_t));
+    RETURN_ON_MEM_ERROR(rows, LXW_ERROR_MEMORY_MALLOC_FAILED);
+    self->row_offset_rows = rows;
 
-        /* Convert to pixels. */
-        if (col_opt->hidden && anchor != LXW_OBJECT_MOVE_AND_SIZE_AFTER) {
-            pixels = 0;
-        }
-        else if (width < 1.0) {
-            pixels = (uint32_t) (width * (max_digit_width + padding) + 0.5);
-        }
-        else {
-            pixels = (uint32_t) (width * max_digit_width + 0.5) + 5;
+    sums = realloc(self->row_offset_sums, (count + 1) * sizeof(uint32_t));
+    RETURN_ON_MEM_ERROR(sums, LXW_ERROR_MEMORY_MALLOC_FAILED);
+    self->row_offset_sums = sums;
+
+    /* The differences are summed modulo 2^32, like the row heights. */
+    count = 0;
+    RB_FOREACH(row, lxw_table_rows, self->table) {
+        pixels = _worksheet_row_pixels(self, row,
+                                       LXW_OBJECT_POSITION_DEFAULT);
+
+        if (pixels != default_pixels) {
+            sum += pixels - default_pixels;
+            rows[count] = row->row_num;
+            sums[count] = sum;
+            count++;
         }
     }
-    else {
-        pixels = self->default_col_pixels;
-    }
 
-    return pixels;
+    self->row_offsets_count = count;
+    self->row_offsets_valid = LXW_TRUE;
+
+    return LXW_NO_ERROR;
 }
 
 /*
- * Convert the height of a cell from user's units to pixels. If the height
- * hasn't been set by the user we use the default value. If the row is hidden
- * it has a value of zero.
+ * Get the absolute vertical offset, in pixels, of the top edge of a row.
  */
-STATIC int32_t
-_worksheet_size_row(lxw_worksheet *self, lxw_row_t row_num, uint8_t anchor)
+STATIC uint32_t
+_worksheet_row_offset(lxw_worksheet *self, lxw_row_t row_num)
 {
-    lxw_row *row;
-    uint32_t pixels;
+    uint32_t offset = 0;
+    lxw_row_t low = 0;
+    lxw_row_t high;
+    lxw_row_t mid;
+    lxw_row_t row;
 
-    row = lxw_worksheet_find_row(self, row_num);
+    /* Optimization for when the row heights haven't changed. */
+    if (!self->row_size_changed)
+        return self->default_row_pixels * row_num;
 
-    /* Note, the 0.75 below is due to the difference between 72/96 DPI. */
-    if (row) {
-        if (row->hidden && anchor != LXW_OBJECT_MOVE_AND_SIZE_AFTER)
-            pixels = 0;
-        else
-            pixels = (uint32_t) (row->height / 0.75);
+    if (!self->row_offsets_valid && _worksheet_build_row_offsets(self)) {
+        /* Fall back to summing the heights if the cache can't be built. */
+        for (row = 0; row < row_num; row++)
+            offset += _worksheet_size_row(self, row,
+                                          LXW_OBJECT_POSITION_DEFAULT);
+        return offset;
     }
-    else {
-        pixels = (uint32_t) (self->default_row_height / 0.75);
+
+    /* Find the number of non-default rows before row_num. */
+    high = self->row_offsets_count;
+    while (low < high) {
+        mid = low + (high - low) / 2;
+
+        if (self->row_offset_rows[mid] < row_num)
+            low = mid + 1;
+        else
+            high = mid;
     }
 
-    return pixels;
+    offset = _worksheet_row_pixels(self, NULL, LXW_OBJECT_POSITION_DEFAULT)
+        * row_num;
+
+    if (low > 0)
+        offset += self->row_offset_sums[low - 1];
+
+    return offset;
 }
 
 /*
@@ -2926,10 +4350,9 @@ _worksheet_position_object_pixels(lxw_worksheet *self,
     double width;               /* Width of object frame.                */
     double height;              /* Height of object frame.               */
 
-    uint32_t x_abs = 0;         /* Abs. distance to left side of object. */
-    uint32_t y_abs = 0;         /* Abs. distance to top  side of object. */
+    uint32_t x_abs;             /* Abs. distance to left side of object. */
+    uint32_t y_abs;             /* Abs. distance to top  side of object. */
 
-    uint32_t i;
     uint8_t anchor = drawing_object->anchor;
     uint8_t ignore_anchor = LXW_OBJECT_POSITION_DEFAULT;
 
@@ -2960,29 +4383,10 @@ _worksheet_position_object_pixels(lxw_worksheet *self,
         y1 = 0;
 
     /* Calculate the absolute x offset of the top-left vertex. */
-    if (self->col_size_changed) {
-        for (i = 0; i < col_start; i++)
-            x_abs += _worksheet_size_col(self, i, ignore_anchor);
-    }
-    else {
-        /* Optimization for when the column widths haven't changed. */
-        x_abs += self->default_col_pixels * col_start;
-    }
-
-    x_abs += x1;
+    x_abs = _worksheet_col_offset(self, col_start) + x1;
 
     /* Calculate the absolute y offset of the top-left vertex. */
-    /* Store the column change to allow optimizations. */
-    if (self->row_size_changed) {
-        for (i = 0; i < row_start; i++)
-            y_abs += _worksheet_size_row(self, i, ignore_anchor);
-    }
-    else {
-        /* Optimization for when the row heights haven"t changed. */
-        y_abs += self->default_row_pixels * row_start;
-    }
-
-    y_abs += y1;
+    y_abs = _worksheet_row_offset(self, row_start) + y1;
 
     /* Adjust start col for offsets that are greater than the col width. */
     while (x1 >= _worksheet_size_col(self, col_start, anchor)) {
@@ -4396,30 +5800,16 @@ mem_error:
  * optimization in the inner cell writing loop.
  */
 STATIC void
-_write_number_cell(lxw_worksheet *self, char *range,
-                   int32_t style_index, lxw_cell *cell)
+_write_number_cell(lxw_worksheet *self, int32_t style_index, lxw_cell *cell)
 {
-#ifdef USE_DTOA_LIBRARY
-    char data[LXW_ATTR_32];
+    char data[LXW_SHEET_DATA_CELL_LENGTH];
+    char *p = _sheet_data_cell_start(self, data, cell, style_index);
 
-    lxw_sprintf_dbl(data, cell->u.number);
-
-    if (style_index)
-        fprintf(self->file,
-                "<c r=\"%s\" s=\"%d\"><v>%s</v></c>",
-                range, style_index, data);
-    else
-        fprintf(self->file, "<c r=\"%s\"><v>%s</v></c>", range, data);
-#else
-    if (style_index)
-        fprintf(self->file,
-                "<c r=\"%s\" s=\"%d\"><v>%.16G</v></c>",
-                range, style_index, cell->u.number);
-    else
-        fprintf(self->file,
-                "<c r=\"%s\"><v>%.16G</v></c>", range, cell->u.number);
+    LXW_SHEET_DATA_PUT(p, "><v>");
+    p = _sheet_data_dbl(p, cell->u.number);
+    LXW_SHEET_DATA_PUT(p, "</v></c>");
 
-#endif
+    _worksheet_append_sheet_data(self, data, (size_t) (p - data));
 }
 
 /*
@@ -4427,18 +5817,16 @@ _write_number_cell(lxw_worksheet *self, char *range,
  * optimization in the inner cell writing loop.
  */
 STATIC void
-_write_string_cell(lxw_worksheet *self, char *range,
-                   int32_t style_index, lxw_cell *cell)
+_write_string_cell(lxw_worksheet *self, int32_t style_index, lxw_cell *cell)
 {
+    char data[LXW_SHEET_DATA_CELL_LENGTH];
+    char *p = _sheet_data_cell_start(self, data, cell, style_index);
 
-    if (style_index)
-        fprintf(self->file,
-                "<c r=\"%s\" s=\"%d\" t=\"s\"><v>%d</v></c>",
-                range, style_index, cell->u.string_id);
-    else
-        fprintf(self->file,
-                "<c r=\"%s\" t=\"s\"><v>%d</v></c>",
-                range, cell->u.string_id);
+    LXW_SHEET_DATA_PUT(p, " t=\"s\"><v>");
+    p = _sheet_data_uint(p, (uint32_t) cell->u.string_id);
+    LXW_SHEET_DATA_PUT(p, "</v></c>");
+
+    _worksheet_append_sheet_data(self, data, (size_t) (p - data));
 }
 
 /*
@@ -4446,38 +5834,26 @@ _write_string_cell(lxw_worksheet *self, char *range,
  * optimization in the inner cell writing loop.
  */
 STATIC void
-_write_inline_string_cell(lxw_worksheet *self, char *range,
-                          int32_t style_index, lxw_cell *cell)
+_write_inline_string_cell(lxw_worksheet *self, int32_t style_index,
+                          lxw_cell *cell)
 {
-    char *string = lxw_escape_data(cell->u.string);
+    char data[LXW_SHEET_DATA_CELL_LENGTH];
+    char *p = _sheet_data_cell_start(self, data, cell, style_index);
+    const char *string = cell->u.string;
+    size_t length = strlen(string);
 
     /* Add attribute to preserve leading or trailing whitespace. */
     if (isspace((unsigned char) string[0])
-        || isspace((unsigned char) string[strlen(string) - 1])) {
-
-        if (style_index)
-            fprintf(self->file,
-                    "<c r=\"%s\" s=\"%d\" t=\"inlineStr\"><is>"
-                    "<t xml:space=\"preserve\">%s</t></is></c>",
-                    range, style_index, string);
-        else
-            fprintf(self->file,
-                    "<c r=\"%s\" t=\"inlineStr\"><is>"
-                    "<t xml:space=\"preserve\">%s</t></is></c>",
-                    range, string);
-    }
-    else {
-        if (style_index)
-            fprintf(self->file,
-                    "<c r=\"%s\" s=\"%d\" t=\"inlineStr\">"
-                    "<is><t>%s</t></is></c>", range, style_index, string);
-        else
-            fprintf(self->file,
-                    "<c r=\"%s\" t=\"inlineStr\">"
-                    "<is><t>%s</t></is></c>", range, string);
-    }
+        || isspace((unsigned char) string[length - 1]))
+        LXW_SHEET_DATA_PUT(p, " t=\"inlineStr\"><is>"
+                           "<t xml:space=\"preserve\">");
+    else
+        LXW_SHEET_DATA_PUT(p, " t=\"inlineStr\"><is><t>");
 
-    free(string);
+    _worksheet_append_sheet_data(self, data, (size_t) (p - data));
+    _append_escaped_sheet_data(self, string, length);
+    _worksheet_append_sheet_data(self, "</t></is></c>",
+                                 sizeof("</t></is></c>") - 1);
 }
 
 /*
@@ -4485,19 +5861,54 @@ _write_inline_string_cell(lxw_worksheet *self, char *range,
  * optimization in the inner cell writing loop.
  */
 STATIC void
-_write_inline_rich_string_cell(lxw_worksheet *self, char *range,
-                               int32_t style_index, lxw_cell *cell)
+_write_inline_rich_string_cell(lxw_worksheet *self, int32_t style_index,
+                               lxw_cell *cell)
 {
+    char data[LXW_SHEET_DATA_CELL_LENGTH];
+    char *p = _sheet_data_cell_start(self, data, cell, style_index);
     const char *string = cell->u.string;
 
-    if (style_index)
-        fprintf(self->file,
-                "<c r=\"%s\" s=\"%d\" t=\"inlineStr\">"
-                "<is>%s</is></c>", range, style_index, string);
-    else
-        fprintf(self->file,
-                "<c r=\"%s\" t=\"inlineStr\">"
-                "<is>%s</is></c>", range, string);
+    LXW_SHEET_DATA_PUT(p, " t=\"inlineStr\"><is>");
+
+    _worksheet_append_sheet_data(self, data, (size_t) (p - data));
+    _worksheet_append_sheet_data(self, string, strlen(string));
+    _worksheet_append_sheet_data(self, "</is></c>", sizeof("</is></c>") - 1);
+}
+
+/*
+ * Write out a boolean worksheet cell. Doesn't use the xml functions as an
+ * optimization in the inner cell writing loop.
+ */
+STATIC void
+_write_boolean_cell(lxw_worksheet *self, int32_t style_index, lxw_cell *cell)
+{
+    char data[LXW_SHEET_DATA_CELL_LENGTH];
+    char *p = _sheet_data_cell_start(self, data, cell, style_index);
+
+    LXW_SHEET_DATA_PUT(p, " t=\"b\"><v>");
+    *p++ = cell->u.number == 0.0 ? '0' : '1';
+    LXW_SHEET_DATA_PUT(p, "</v></c>");
+
+    _worksheet_append_sheet_data(self, data, (size_t) (p - data));
+}
+
+/*
+ * Write out a blank worksheet cell. Blank cells are only written if they
+ * have a format.
+ */
+STATIC void
+_write_blank_cell(lxw_worksheet *self, int32_t style_index, lxw_cell *cell)
+{
+    char data[LXW_SHEET_DATA_CELL_LENGTH];
+    char *p;
+
+    if (!cell->format)
+        return;
+
+    p = _sheet_data_cell_start(self, data, cell, style_index);
+    LXW_SHEET_DATA_PUT(p, "/>");
+
+    _worksheet_append_sheet_data(self, data, (size_t) (p - data));
 }
 
 /*
@@ -4545,24 +5956,6 @@ _write_array_formula_num_cell(lxw_worksheet *self, lxw_cell *cell)
     LXW_FREE_ATTRIBUTES();
 }
 
-/*
- * Write out a boolean worksheet cell.
- */
-STATIC void
-_write_boolean_cell(lxw_worksheet *self, lxw_cell *cell)
-{
-    char data[LXW_ATTR_32];
-
-    if (cell->u.number == 0.0)
-        data[0] = '0';
-    else
-        data[0] = '1';
-
-    data[1] = '\0';
-
-    lxw_xml_data_element(self->file, "v", data, NULL);
-}
-
 /*
  * Write out a error worksheet cell.
  */
@@ -4577,29 +5970,38 @@ _write_error_cell(lxw_worksheet *self)
  * optimization and isn't strictly required. However, it makes comparing
  * files easier.
  *
- * The span is the same for each block of 16 rows.
+ * The span is the same for each block of 16 rows. It is normally stored as
+ * the cells are added, otherwise it is calculated from the rows in the block.
  */
 STATIC void
-_calculate_spans(struct lxw_row *row, char *span, int32_t *block_num)
+_calculate_spans(lxw_worksheet *self, struct lxw_row *row, char *span,
+                 int32_t *block_num)
 {
-    lxw_cell *cell_min = RB_MIN(lxw_table_cells, row->cells);
-    lxw_cell *cell_max = RB_MAX(lxw_table_cells, row->cells);
-    lxw_col_t span_col_min = cell_min->col_num;
-    lxw_col_t span_col_max = cell_max->col_num;
+    lxw_col_t span_col_min = 0;
+    lxw_col_t span_col_max = 0;
     lxw_col_t col_min;
     lxw_col_t col_max;
+    lxw_block_span *block_span;
     *block_num = row->row_num / 16;
 
+    if (!self->block_spans_invalid
+        && (uint32_t) *block_num < self->block_spans_max) {
+        block_span = &self->block_spans[*block_num];
+
+        if (block_span->col_min <= block_span->col_max) {
+            lxw_snprintf(span, LXW_MAX_CELL_RANGE_LENGTH, "%d:%d",
+                         block_span->col_min + 1, block_span->col_max + 1);
+            return;
+        }
+    }
+
+    _get_row_col_range(row, &span_col_min, &span_col_max);
+
     row = RB_NEXT(lxw_table_rows, root, row);
 
     while (row && (int32_t) (row->row_num / 16) == *block_num) {
 
-        if (!RB_EMPTY(row->cells)) {
-            cell_min = RB_MIN(lxw_table_cells, row->cells);
-            cell_max = RB_MAX(lxw_table_cells, row->cells);
-            col_min = cell_min->col_num;
-            col_max = cell_max->col_num;
-
+        if (_get_row_col_range(row, &col_min, &col_max)) {
             if (col_min < span_col_min)
                 span_col_min = col_min;
 
@@ -4622,13 +6024,10 @@ _write_cell(lxw_worksheet *self, lxw_cell *cell, lxw_format *row_format)
 {
     struct xml_attribute_list attributes;
     struct xml_attribute *attribute;
-    char range[LXW_MAX_CELL_NAME_LENGTH] = { 0 };
-    lxw_row_t row_num = cell->row_num;
+    char range[LXW_MAX_CELL_NAME_LENGTH];
     lxw_col_t col_num = cell->col_num;
     int32_t style_index = 0;
 
-    lxw_rowcol_to_cell(range, row_num, col_num);
-
     if (cell->format) {
         style_index = lxw_format_get_xf_index(cell->format);
     }
@@ -4641,26 +6040,41 @@ _write_cell(lxw_worksheet *self, lxw_cell *cell, lxw_format *row_format)
 
     /* Unrolled optimization for most commonly written cell types. */
     if (cell->type == NUMBER_CELL) {
-        _write_number_cell(self, range, style_index, cell);
+        _write_number_cell(self, style_index, cell);
         return;
     }
 
     if (cell->type == STRING_CELL) {
-        _write_string_cell(self, range, style_index, cell);
+        _write_string_cell(self, style_index, cell);
         return;
     }
 
-    if (cell->type == INLINE_STRING_CELL) {
-        _write_inline_string_cell(self, range, style_index, cell);
+    if (cell->type == INLINE_STRING_CELL
+        || cell->type == INLINE_STATIC_STRING_CELL) {
+        _write_inline_string_cell(self, style_index, cell);
         return;
     }
 
     if (cell->type == INLINE_RICH_STRING_CELL) {
-        _write_inline_rich_string_cell(self, range, style_index, cell);
+        _write_inline_rich_string_cell(self, style_index, cell);
+        return;
+    }
+
+    if (cell->type == BOOLEAN_CELL) {
+        _write_boolean_cell(self, style_index, cell);
         return;
     }
 
-    /* For other cell types use the general functions. */
+    if (cell->type == BLANK_CELL) {
+        _write_blank_cell(self, style_index, cell);
+        return;
+    }
+
+    /* For other cell types use the general functions. The buffered sheetData
+     * must be written out first to keep the output in order. */
+    _worksheet_flush_sheet_data(self);
+    *_sheet_data_cell_ref(self, range, cell->row_num, col_num) = '\0';
+
     LXW_INIT_ATTRIBUTES();
     LXW_PUSH_ATTRIBUTES_STR("r", range);
 
@@ -4681,16 +6095,6 @@ _write_cell(lxw_worksheet *self, lxw_cell *cell, lxw_format *row_format)
 
         lxw_xml_end_tag(self->file, "c");
     }
-    else if (cell->type == BLANK_CELL) {
-        if (cell->format)
-            lxw_xml_empty_tag(self->file, "c", &attributes);
-    }
-    else if (cell->type == BOOLEAN_CELL) {
-        LXW_PUSH_ATTRIBUTES_STR("t", "b");
-        lxw_xml_start_tag(self->file, "c", &attributes);
-        _write_boolean_cell(self, cell);
-        lxw_xml_end_tag(self->file, "c");
-    }
     else if (cell->type == ARRAY_FORMULA_CELL) {
         lxw_xml_start_tag(self->file, "c", &attributes);
         _write_array_formula_num_cell(self, cell);
@@ -4713,6 +6117,33 @@ _write_cell(lxw_worksheet *self, lxw_cell *cell, lxw_format *row_format)
     LXW_FREE_ATTRIBUTES();
 }
 
+/*
+ * Write out the cells of a row in compact_cells mode, merging the compact
+ * cells and the cells in the row's cell tree in column order.
+ */
+STATIC void
+_write_compact_row_cells(lxw_worksheet *self, lxw_row *row)
+{
+    lxw_cell *cell = RB_MIN(lxw_table_cells, row->cells);
+    lxw_cell compact_cell;
+    lxw_col_t i = 0;
+
+    while (cell || i < row->num_compact_cells) {
+        if (cell && (i == row->num_compact_cells
+                     || cell->col_num < row->compact_cells[i].col_num)) {
+
+            _write_cell(self, cell, row->format);
+            cell = RB_NEXT(lxw_table_cells, row->cells, cell);
+        }
+        else {
+            _expand_compact_cell(self, row, &row->compact_cells[i],
+                                 &compact_cell);
+            _write_cell(self, &compact_cell, row->format);
+            i++;
+        }
+    }
+}
+
 /*
  * Write out the worksheet data as a series of rows and cells.
  */
@@ -4724,9 +6155,14 @@ _worksheet_write_rows(lxw_worksheet *self)
     int32_t block_num = -1;
     char spans[LXW_MAX_CELL_RANGE_LENGTH] = { 0 };
 
+    /* Buffer the row data. If the allocation fails the data is written
+     * directly to the file instead. */
+    self->sheet_data_buffer = malloc(LXW_SHEET_DATA_BUFFER_SIZE);
+    self->sheet_data_length = 0;
+
     RB_FOREACH(row, lxw_table_rows, self->table) {
 
-        if (RB_EMPTY(row->cells)) {
+        if (RB_EMPTY(row->cells) && !row->num_compact_cells) {
             /* Row contains no cells but has height, format or other data. */
 
             /* Write a default span for default rows. */
@@ -4738,16 +6174,127 @@ _worksheet_write_rows(lxw_worksheet *self)
         else {
             /* Row and cell data. */
             if ((int32_t) row->row_num / 16 > block_num)
-                _calculate_spans(row, spans, &block_num);
+                _calculate_spans(self, row, spans, &block_num);
 
             _write_row(self, row, spans);
 
             if (row->data_changed) {
-                RB_FOREACH(cell, lxw_table_cells, row->cells) {
-                    _write_cell(self, cell, row->format);
+                if (row->num_compact_cells) {
+                    _write_compact_row_cells(self, row);
+                }
+                else {
+                    RB_FOREACH(cell, lxw_table_cells, row->cells) {
+                        _write_cell(self, cell, row->format);
+                    }
                 }
 
-                lxw_xml_end_tag(self->file, "row");
+                _worksheet_append_sheet_data(self, "</row>",
+                                             sizeof("</row>") - 1);
+            }
+        }
+    }
+
+    _worksheet_flush_sheet_data(self);
+    free(self->sheet_data_buffer);
+    self->sheet_data_buffer = NULL;
+}
+
+/*
+ * Add the chart ranges that refer to the worksheet, and that were added since
+ * the last check, to the ranges captured as rows are written. Ranges that
+ * start before the current row may have missed some data so they don't get a
+ * cache, as before.
+ */
+STATIC void
+_worksheet_add_row_taps(lxw_worksheet *self)
+{
+    lxw_chart_range_taps *range_taps = self->chart_range_taps;
+    lxw_series_range *range;
+    lxw_series_range **new_taps;
+    uint32_t new_size;
+    uint32_t num_data_points;
+
+    while (self->chart_range_taps_seen < range_taps->count) {
+        range = range_taps->ranges[self->chart_range_taps_seen++];
+
+        if (!range->sheetname || strcmp(range->sheetname, self->name))
+            continue;
+
+        if (range->last_row < range->first_row
+            || range->last_col < range->first_col
+            || range->first_row < self->optimize_row->row_num)
+            continue;
+
+        /* Only 1D ranges are cached. */
+        if (range->first_row != range->last_row
+            && range->first_col != range->last_col)
+            continue;
+
+        if (self->row_taps_count == self->row_taps_size) {
+            new_size = self->row_taps_size ? self->row_taps_size * 2 : 8;
+            new_taps = realloc(self->row_taps,
+                               new_size * sizeof(lxw_series_range *));
+            if (!new_taps)
+                return;
+
+            self->row_taps = new_taps;
+            self->row_taps_size = new_size;
+        }
+
+        num_data_points = (uint32_t) (range->last_row - range->first_row + 1)
+            * (range->last_col - range->first_col + 1);
+
+        if (lxw_chart_init_empty_data_cache(range, num_data_points))
+            continue;
+
+        range->has_row_tap = LXW_TRUE;
+        self->row_taps[self->row_taps_count++] = range;
+    }
+}
+
+/*
+ * Capture the cells of the row that is being written into the data caches of
+ * the chart ranges that refer to it.
+ */
+STATIC void
+_worksheet_tap_row(lxw_worksheet *self, lxw_row_t row_num)
+{
+    lxw_series_range *range;
+    lxw_col_t col;
+    lxw_col_t first_col;
+    lxw_col_t last_col;
+    uint32_t index;
+    uint32_t i;
+
+    for (i = 0; i < self->row_taps_count; i++) {
+        range = self->row_taps[i];
+
+        if (!range->has_row_tap || row_num < range->first_row
+            || row_num > range->last_row)
+            continue;
+
+        /* The range may have been moved to another worksheet. */
+        if (strcmp(range->sheetname, self->name))
+            continue;
+
+        first_col = range->first_col > self->dim_colmin
+            ? range->first_col : self->dim_colmin;
+        last_col = range->last_col < self->dim_colmax
+            ? range->last_col : self->dim_colmax;
+
+        for (col = first_col; col <= last_col; col++) {
+            if (!self->array[col])
+                continue;
+
+            index = (uint32_t) (row_num - range->first_row)
+                * (range->last_col - range->first_col + 1)
+                + (col - range->first_col);
+
+            if (lxw_worksheet_cache_chart_cell(range, index,
+                                               self->array[col])) {
+                lxw_chart_free_data_cache(range);
+                range->has_row_tap = LXW_FALSE;
+                break;
             }
         }
     }
@@ -4769,6 +6316,15 @@ lxw_worksheet_write_single_row(lxw_worksheet *self)
     if (!(row->row_changed || row->data_changed))
         return;
 
+    /* Capture the data of any chart ranges that refer to the row. */
+    if (self->chart_range_taps && row->data_changed) {
+        if (self->chart_range_taps_seen != self->chart_range_taps->count)
+            _worksheet_add_row_taps(self);
+
+        if (self->row_taps_count)
+            _worksheet_tap_row(self, row->row_num);
+    }
+
     /* Write the cells if the row contains data. */
     if (!row->data_changed) {
         /* Row data only. No cells. */
@@ -4781,14 +6337,20 @@ lxw_worksheet_write_single_row(lxw_worksheet *self)
         for (col = self->dim_colmin; col <= self->dim_colmax; col++) {
             if (self->array[col]) {
                 _write_cell(self, self->array[col], row->format);
-                _free_cell(self->array[col]);
+                _free_cell(self, self->array[col]);
                 self->array[col] = NULL;
             }
         }
 
-        lxw_xml_end_tag(self->file, "row");
+        _worksheet_append_sheet_data(self, "</row>", sizeof("</row>") - 1);
     }
 
+    /* Deflate the staged rows once there is enough data to compress well. */
+    if (self->deflated_rows
+        && ftell(self->optimize_tmpfile) + (long) self->sheet_data_length
+        >= LXW_DEFLATE_ROWS_SIZE)
+        _deflate_staged_rows(self, LXW_FALSE);
+
     /* Reset the row. */
     row->height = LXW_DEF_ROW_HEIGHT;
     row->format = NULL;
@@ -7919,7 +9481,7 @@ worksheet_write_number(lxw_worksheet *self,
     if (err)
         return err;
 
-    cell = _new_number_cell(row_num, col_num, value, format);
+    cell = _new_number_cell(self, row_num, col_num, value, format);
 
     _insert_cell(self, row_num, col_num, cell);
 
@@ -7936,9 +9498,6 @@ worksheet_write_string(lxw_worksheet *self,
                        lxw_format *format)
 {
     lxw_cell *cell;
-    int32_t string_id;
-    char *string_copy;
-    struct sst_element *sst_element;
     lxw_error err;
 
     if (!string || !*string) {
@@ -7954,36 +9513,87 @@ worksheet_write_string(lxw_worksheet *self,
     if (err)
         return err;
 
-    if (lxw_utf8_strlen(string) > LXW_STR_MAX)
-        return LXW_ERROR_MAX_STRING_LENGTH_EXCEEDED;
+    err = _create_string_cell(self, row_num, col_num, string, format, &cell);
+    if (err)
+        return err;
 
-    if (!self->optimize) {
-        /* Get the SST element and string id. */
-        sst_element = lxw_get_sst_index(self->sst, string, LXW_FALSE);
+    _insert_cell(self, row_num, col_num, cell);
 
-        if (!sst_element)
-            return LXW_ERROR_SHARED_STRING_INDEX_NOT_FOUND;
+    return LXW_NO_ERROR;
+}
 
-        string_id = sst_element->index;
-        cell = _new_string_cell(row_num, col_num, string_id,
-                                sst_element->string, format);
-    }
-    else {
-        /* Look for and escape control chars in the string. */
-        if (lxw_has_control_characters(string)) {
-            string_copy = lxw_escape_control_characters(string);
-        }
-        else {
-            string_copy = lxw_strdup(string);
-        }
-        cell = _new_inline_string_cell(row_num, col_num, string_copy, format);
+/*
+ * Write a string of known length to an Excel file.
+ */
+lxw_error
+worksheet_write_string_len(lxw_worksheet *self,
+                           lxw_row_t row_num,
+                           lxw_col_t col_num, const char *string,
+                           size_t length, lxw_format *format, uint8_t flags)
+{
+    lxw_cell *cell;
+    lxw_error err;
+
+    if (!string || !length) {
+        /* Treat a NULL or empty string with formatting as a blank cell. */
+        /* Null strings without formats should be ignored.      */
+        if (format)
+            return worksheet_write_blank(self, row_num, col_num, format);
+        else
+            return LXW_NO_ERROR;
     }
 
+    err = _check_dimensions(self, row_num, col_num, LXW_FALSE, LXW_FALSE);
+    if (err)
+        return err;
+
+    err = _create_string_cell_len(self, row_num, col_num, string, length,
+                                  format, flags, &cell);
+    if (err)
+        return err;
+
     _insert_cell(self, row_num, col_num, cell);
 
     return LXW_NO_ERROR;
 }
 
+/*
+ * Write an array of numbers to a row.
+ */
+lxw_error
+worksheet_write_row_numbers(lxw_worksheet *self, lxw_row_t row_num,
+                            lxw_col_t first_col, const double *numbers,
+                            lxw_col_t num_values, lxw_format *format)
+{
+    return _write_array(self, row_num, first_col, 1, num_values,
+                        LXW_ARRAY_NUMBER, numbers, NULL, format);
+}
+
+/*
+ * Write an array of numbers to a column.
+ */
+lxw_error
+worksheet_write_column_numbers(lxw_worksheet *self, lxw_row_t first_row,
+                               lxw_col_t col_num, const double *numbers,
+                               lxw_row_t num_values, lxw_format *format)
+{
+    return _write_array(self, first_row, col_num, num_values, 1,
+                        LXW_ARRAY_NUMBER, numbers, NULL, format);
+}
+
+/*
+ * Write a 2D array of numbers or strings to a range of cells.
+ */
+lxw_error
+worksheet_write_array(lxw_worksheet *self, lxw_row_t first_row,
+                      lxw_col_t first_col, lxw_row_t num_rows,
+                      lxw_col_t num_cols, uint8_t type, const void *data,
+                      lxw_format **formats)
+{
+    return _write_array(self, first_row, first_col, num_rows, num_cols,
+                        type, data, formats, NULL);
+}
+
 /*
  * Write a formula with a numerical result to a cell in Excel.
  */
@@ -8014,7 +9624,7 @@ worksheet_write_formula_num(lxw_worksheet *self,
     else
         formula_copy = lxw_strdup(formula);
 
-    cell = _new_formula_cell(row_num, col_num, formula_copy, format);
+    cell = _new_formula_cell(self, row_num, col_num, formula_copy, format);
     cell->formula_result = result;
 
     _insert_cell(self, row_num, col_num, cell);
@@ -8052,7 +9662,7 @@ worksheet_write_formula_str(lxw_worksheet *self,
     else
         formula_copy = lxw_strdup(formula);
 
-    cell = _new_formula_cell(row_num, col_num, formula_copy, format);
+    cell = _new_formula_cell(self, row_num, col_num, formula_copy, format);
     cell->user_data2 = lxw_strdup(result);
 
     _insert_cell(self, row_num, col_num, cell);
@@ -8151,7 +9761,7 @@ _store_array_formula(lxw_worksheet *self,
     }
 
     /* Create a new array formula cell object. */
-    cell = _new_array_formula_cell(first_row, first_col,
+    cell = _new_array_formula_cell(self, first_row, first_col,
                                    formula_copy, range, format, is_dynamic);
 
     cell->formula_result = result;
@@ -8288,7 +9898,7 @@ worksheet_write_blank(lxw_worksheet *self,
     if (err)
         return err;
 
-    cell = _new_blank_cell(row_num, col_num, format);
+    cell = _new_blank_cell(self, row_num, col_num, format);
 
     _insert_cell(self, row_num, col_num, cell);
 
@@ -8310,7 +9920,7 @@ worksheet_write_boolean(lxw_worksheet *self,
     if (err)
         return err;
 
-    cell = _new_boolean_cell(row_num, col_num, value, format);
+    cell = _new_boolean_cell(self, row_num, col_num, value, format);
 
     _insert_cell(self, row_num, col_num, cell);
 
@@ -8341,7 +9951,7 @@ worksheet_write_datetime(lxw_worksheet *self,
     excel_date =
         lxw_datetime_to_excel_date_with_epoch(datetime, self->use_1904_epoch);
 
-    cell = _new_number_cell(row_num, col_num, excel_date, format);
+    cell = _new_number_cell(self, row_num, col_num, excel_date, format);
 
     _insert_cell(self, row_num, col_num, cell);
 
@@ -8368,7 +9978,7 @@ worksheet_write_unixtime(lxw_worksheet *self,
     excel_date =
         lxw_unixtime_to_excel_date_with_epoch(unixtime, self->use_1904_epoch);
 
-    cell = _new_number_cell(row_num, col_num, excel_date, format);
+    cell = _new_number_cell(self, row_num, col_num, excel_date, format);
 
     _insert_cell(self, row_num, col_num, cell);
 
@@ -8554,7 +10164,7 @@ worksheet_write_url_opt(lxw_worksheet *self,
     /* Reset default error condition. */
     err = LXW_ERROR_MEMORY_MALLOC_FAILED;
 
-    link = _new_hyperlink_cell(row_num, col_num, link_type, url_copy,
+    link = _new_hyperlink_cell(self, row_num, col_num, link_type, url_copy,
                                url_string, tooltip_copy);
     GOTO_LABEL_ON_MEM_ERROR(link, mem_error);
 
@@ -8601,8 +10211,8 @@ worksheet_write_rich_string(lxw_worksheet *self,
                             lxw_format *format)
 {
     lxw_cell *cell;
-    int32_t string_id;
     struct sst_element *sst_element;
+    uint32_t string_id;
     lxw_error err;
     uint8_t i;
     long file_size;
@@ -8707,9 +10317,19 @@ worksheet_write_rich_string(lxw_worksheet *self,
         if (!sst_element)
             return LXW_ERROR_SHARED_STRING_INDEX_NOT_FOUND;
 
-        string_id = sst_element->index;
-        cell = _new_string_cell(row_num, col_num, string_id,
-                                sst_element->string, format);
+        cell = _new_string_cell(self, row_num, col_num, sst_element->index,
+                                sst_element, format);
+    }
+    else if (self->sst->use_tmpfiles) {
+        /* Get the string id from the SST temp files. */
+        err = lxw_get_sst_id(self->sst, rich_string, LXW_TRUE, &string_id);
+        free((void *) rich_string);
+
+        if (err)
+            return err;
+
+        cell = _new_string_cell(self, row_num, col_num, string_id, NULL,
+                                format);
     }
     else {
         /* Look for and escape control chars in the string. */
@@ -8720,7 +10340,7 @@ worksheet_write_rich_string(lxw_worksheet *self,
         else {
             string_copy = rich_string;
         }
-        cell = _new_inline_rich_string_cell(row_num, col_num, string_copy,
+        cell = _new_inline_rich_string_cell(self, row_num, col_num, string_copy,
                                             format);
     }
 
@@ -8770,7 +10390,7 @@ worksheet_write_comment_opt(lxw_worksheet *self,
     comment->row = row_num;
     comment->col = col_num;
 
-    cell = _new_comment_cell(row_num, col_num, comment);
+    cell = _new_comment_cell(self, row_num, col_num, comment);
     GOTO_LABEL_ON_MEM_ERROR(cell, mem_error);
 
     _insert_comment(self, row_num, col_num, cell);
@@ -8923,6 +10543,7 @@ worksheet_set_column_opt(lxw_worksheet *self,
 
     /* Store the column change to allow optimizations. */
     self->col_size_changed = LXW_TRUE;
+    self->col_offsets_valid = LXW_FALSE;
 
     return LXW_NO_ERROR;
 }
@@ -9028,6 +10649,7 @@ worksheet_set_row_opt(lxw_worksheet *self,
     row->level = level;
     row->collapsed = collapsed;
     row->row_changed = LXW_TRUE;
+    self->row_offsets_valid = LXW_FALSE;
 
     if (height != self->default_row_height)
         row->height_changed = LXW_TRUE;
@@ -10458,6 +12080,7 @@ worksheet_set_default_row(lxw_worksheet *self, double height,
     if (height != self->default_row_height) {
         self->default_row_height = height;
         self->row_size_changed = LXW_TRUE;
+        self->row_offsets_valid = LXW_FALSE;
     }
 
     if (hide_unused_rows)
@@ -11078,7 +12701,8 @@ worksheet_insert_chart_opt(lxw_worksheet *self,
 
     /* Check that the chart has a 'values' series. */
     STAILQ_FOREACH(series, chart->series_list, list_pointers) {
-        if (!series->values->formula && !series->values->sheetname) {
+        if (!series->values->formula && !series->values->sheetname
+            && !series->values->has_array_data) {
             LXW_WARN("worksheet_insert_chart()/_opt(): chart must have a "
                      "'values' series.");
 
@@ -11760,7 +13384,7 @@ worksheet_set_error_cell(lxw_worksheet *self,
     lxw_col_t col_num = object_props->col;
 
     lxw_cell *cell =
-        _new_error_cell(row_num, col_num, ref_id, object_props->format);
+        _new_error_cell(self, row_num, col_num, ref_id, object_props->format);
     _insert_cell(self, row_num, col_num, cell);
 
 }
@@ -20,12 +20,7 @@
 #define LXW_QUOT "&quot;"
 #define LXW_NL   "&#xA;"
 
-/* Defines. */
-#define LXW_MAX_ENCODED_ATTRIBUTE_LENGTH (LXW_MAX_ATTRIBUTE_LENGTH*6)
-
 /* Forward declarations. */
-STATIC char *_escape_attributes(struct xml_attribute *attribute);
-
 char *lxw_escape_data(const char *data);
 
 STATIC void _fprint_escaped_attributes(FILE *xmlfile,
@@ -152,49 +147,6 @@ lxw_xml_rich_si_element(FILE *xmlfile, const char *string)
     fprintf(xmlfile, "<si>%s</si>", string);
 }
 
-/*
- * Escape XML characters in attributes.
- */
-STATIC char *
-_escape_attributes(struct xml_attribute *attribute)
-{
-    char *encoded = (char *) calloc(LXW_MAX_ENCODED_ATTRIBUTE_LENGTH, 1);
-    char *p_encoded = encoded;
-    char *p_attr = attribute->value;
-
-    while (*p_attr) {
-        switch (*p_attr) {
-            case '&':
-                memcpy(p_encoded, LXW_AMP, sizeof(LXW_AMP) - 1);
-                p_encoded += sizeof(LXW_AMP) - 1;
-                break;
-            case '<':
-                memcpy(p_encoded, LXW_LT, sizeof(LXW_LT) - 1);
-                p_encoded += sizeof(LXW_LT) - 1;
-                break;
-            case '>':
-                memcpy(p_encoded, LXW_GT, sizeof(LXW_GT) - 1);
-                p_encoded += sizeof(LXW_GT) - 1;
-                break;
-            case '"':
-                memcpy(p_encoded, LXW_QUOT, sizeof(LXW_QUOT) - 1);
-                p_encoded += sizeof(LXW_QUOT) - 1;
-                break;
-            case '\n':
-                memcpy(p_encoded, LXW_NL, sizeof(LXW_NL) - 1);
-                p_encoded += sizeof(LXW_NL) - 1;
-                break;
-            default:
-                *p_encoded = *p_attr;
-                p_encoded++;
-                break;
-        }
-        p_attr++;
-    }
-
-    return encoded;
-}
-
 /*
  * Escape XML characters in data sections of tags.
  * Note, this is different from _escape_attributes()
@@ -368,6 +320,49 @@ lxw_escape_url_characters(const char *string, uint8_t escape_hash)
     return encoded;
 }
 
+/*
+ * Write out a string with the XML characters in the escapes string replaced
+ * with entities. The string is written in runs between the escaped
+ * characters so that no intermediate buffer is required.
+ */
+STATIC void
+_fprint_escaped(FILE *xmlfile, const char *string, const char *escapes)
+{
+    size_t length;
+
+    while (*string) {
+        length = strcspn(string, escapes);
+
+        if (length)
+            fwrite(string, 1, length, xmlfile);
+
+        string += length;
+
+        switch (*string) {
+            case '&':
+                fputs(LXW_AMP, xmlfile);
+                break;
+            case '<':
+                fputs(LXW_LT, xmlfile);
+                break;
+            case '>':
+                fputs(LXW_GT, xmlfile);
+                break;
+            case '"':
+                fputs(LXW_QUOT, xmlfile);
+                break;
+            case '\n':
+                fputs(LXW_NL, xmlfile);
+                break;
+            default:
+                /* End of string. */
+                return;
+        }
+
+        string++;
+    }
+}
+
 /* Write out escaped attributes. */
 STATIC void
 _fprint_escaped_attributes(FILE *xmlfile,
@@ -377,73 +372,167 @@ _fprint_escaped_attributes(FILE *xmlfile,
 
     if (attributes) {
         STAILQ_FOREACH(attribute, attributes, list_entries) {
-            fprintf(xmlfile, " %s=", attribute->key);
-
-            if (!strpbrk(attribute->value, "&<>\"\n")) {
-                fprintf(xmlfile, "\"%s\"", attribute->value);
-            }
-            else {
-                char *encoded = _escape_attributes(attribute);
-
-                if (encoded) {
-                    fprintf(xmlfile, "\"%s\"", encoded);
-
-                    free(encoded);
-                }
-            }
+            fprintf(xmlfile, " %s=\"", attribute->key);
+            _fprint_escaped(xmlfile, attribute->value, "&<>\"\n");
+            fputc('"', xmlfile);
         }
     }
 }
 
-/* Write out escaped XML data. */
+/* Write out escaped XML data. Double quotes are not escaped by Excel. */
 STATIC void
 _fprint_escaped_data(FILE *xmlfile, const char *data)
 {
-    /* Escape the data section of the XML element. */
-    if (!strpbrk(data, "&<>")) {
-        fprintf(xmlfile, "%s", data);
+    _fprint_escaped(xmlfile, data, "&<>");
+}
+
+/* Get the length of an attribute key or value, limited to the maximum
+ * attribute length. */
+STATIC size_t
+_attribute_length(const char *string)
+{
+    size_t length = strlen(string);
+
+    if (length > LXW_MAX_ATTRIBUTE_LENGTH - 1)
+        length = LXW_MAX_ATTRIBUTE_LENGTH - 1;
+
+    return length;
+}
+
+/*
+ * Allocate an attribute followed by string space of the given length from
+ * the list's storage, adding a heap block if the storage is full. The key
+ * points to the string space.
+ */
+STATIC struct xml_attribute *
+_alloc_attribute(struct xml_attribute_list *attributes, size_t length)
+{
+    struct xml_attribute *attribute;
+    struct xml_attribute_block *block;
+    size_t align = sizeof(void *);
+    size_t size = sizeof(struct xml_attribute) + length;
+    size_t offset = (attributes->used + align - 1) & ~(align - 1);
+
+    if (offset + size > attributes->size) {
+        size_t block_size = LXW_ATTRIBUTE_BUFFER_SIZE;
+
+        if (size > block_size)
+            block_size = size;
+
+        block = malloc(sizeof(struct xml_attribute_block) + block_size);
+        RETURN_ON_MEM_ERROR(block, NULL);
+
+        block->next = attributes->blocks;
+        block->size = block_size;
+        attributes->blocks = block;
+        attributes->buffer = (char *) (block + 1);
+        attributes->size = block_size;
+        offset = 0;
     }
-    else {
-        char *encoded = lxw_escape_data(data);
-        if (encoded) {
-            fprintf(xmlfile, "%s", encoded);
-            free(encoded);
-        }
+
+    attribute = (struct xml_attribute *) (attributes->buffer + offset);
+    attribute->key = (char *) (attribute + 1);
+    attributes->used = offset + size;
+
+    return attribute;
+}
+
+/* Initialize an attribute list and its storage. */
+void
+lxw_init_attributes(struct xml_attribute_list *attributes)
+{
+    STAILQ_INIT(attributes);
+
+    attributes->buffer = attributes->storage.data;
+    attributes->used = 0;
+    attributes->size = LXW_ATTRIBUTE_BUFFER_SIZE;
+    attributes->blocks = NULL;
+}
+
+/* Free any heap storage of an attribute list and reset it for reuse. */
+void
+lxw_free_attributes(struct xml_attribute_list *attributes)
+{
+    struct xml_attribute_block *block;
+
+    while (attributes->blocks) {
+        block = attributes->blocks;
+        attributes->blocks = block->next;
+        free(block);
     }
+
+    lxw_init_attributes(attributes);
 }
 
 /* Create a new string XML attribute. */
 struct xml_attribute *
-lxw_new_attribute_str(const char *key, const char *value)
+lxw_new_attribute_str(struct xml_attribute_list *attributes,
+                      const char *key, const char *value)
 {
-    struct xml_attribute *attribute = malloc(sizeof(struct xml_attribute));
+    size_t key_length = _attribute_length(key);
+    size_t value_length = _attribute_length(value);
+    struct xml_attribute *attribute;
+
+    attribute = _alloc_attribute(attributes, key_length + value_length + 2);
+    if (!attribute)
+        return NULL;
 
-    LXW_ATTRIBUTE_COPY(attribute->key, key);
-    LXW_ATTRIBUTE_COPY(attribute->value, value);
+    memcpy(attribute->key, key, key_length);
+    attribute->key[key_length] = '\0';
+
+    attribute->value = attribute->key + key_length + 1;
+    memcpy(attribute->value, value, value_length);
+    attribute->value[value_length] = '\0';
 
     return attribute;
 }
 
 /* Create a new integer XML attribute. */
 struct xml_attribute *
-lxw_new_attribute_int(const char *key, int32_t value)
+lxw_new_attribute_int(struct xml_attribute_list *attributes,
+                      const char *key, int32_t value)
 {
-    struct xml_attribute *attribute = malloc(sizeof(struct xml_attribute));
+    size_t key_length = _attribute_length(key);
+    struct xml_attribute *attribute;
+    int length;
+
+    attribute = _alloc_attribute(attributes, key_length + 1 + LXW_ATTR_32);
+    if (!attribute)
+        return NULL;
 
-    LXW_ATTRIBUTE_COPY(attribute->key, key);
-    lxw_snprintf(attribute->value, LXW_MAX_ATTRIBUTE_LENGTH, "%d", value);
+    memcpy(attribute->key, key, key_length);
+    attribute->key[key_length] = '\0';
+
+    attribute->value = attribute->key + key_length + 1;
+    length = lxw_snprintf(attribute->value, LXW_ATTR_32, "%d", value);
+
+    /* Return the unused part of the number space to the storage. */
+    attributes->used -= LXW_ATTR_32 - (length + 1);
 
     return attribute;
 }
 
 /* Create a new double XML attribute. */
 struct xml_attribute *
-lxw_new_attribute_dbl(const char *key, double value)
+lxw_new_attribute_dbl(struct xml_attribute_list *attributes,
+                      const char *key, double value)
 {
-    struct xml_attribute *attribute = malloc(sizeof(struct xml_attribute));
+    size_t key_length = _attribute_length(key);
+    struct xml_attribute *attribute;
+    int length;
+
+    attribute = _alloc_attribute(attributes, key_length + 1 + LXW_ATTR_32);
+    if (!attribute)
+        return NULL;
+
+    memcpy(attribute->key, key, key_length);
+    attribute->key[key_length] = '\0';
+
+    attribute->value = attribute->key + key_length + 1;
+    length = lxw_sprintf_dbl(attribute->value, value);
 
-    LXW_ATTRIBUTE_COPY(attribute->key, key);
-    lxw_sprintf_dbl(attribute->value, value);
+    /* Return the unused part of the number space to the storage. */
+    attributes->used -= LXW_ATTR_32 - (length + 1);
 
     return attribute;
 }
@@ -0,0 +1,28 @@
+/*****************************************************************************
+ * Test cases for libxlsxwriter.
+ *
+ * Test case for compact cells with comment placeholder cells.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ * Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+ *
+ */
+
+#include "xlsxwriter.h"
+
+int main() {
+
+    lxw_workbook_options options = {0};
+    options.compact_cells = LXW_TRUE;
+
+    lxw_workbook  *workbook  = workbook_new_opt("test_compact_cells03.xlsx", &options);
+    lxw_worksheet *worksheet = workbook_add_worksheet(workbook, NULL);
+
+    worksheet_write_string(worksheet, CELL("A1"), "Foo", NULL);
+    worksheet_write_comment(worksheet, CELL("A1"), "Some text");
+    worksheet_write_comment(worksheet, CELL("XFD1048576"), "Some text");
+
+    worksheet_set_comments_author(worksheet, "John");
+
+    return workbook_close(workbook);
+}
@@ -0,0 +1,30 @@
+/*****************************************************************************
+ * Test cases for libxlsxwriter.
+ *
+ * Test case for compact cells with hyperlinks.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ * Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+ *
+ */
+
+#include "xlsxwriter.h"
+
+int main() {
+
+    lxw_workbook_options options = {0};
+    options.compact_cells = LXW_TRUE;
+
+    lxw_workbook  *workbook  = workbook_new_opt("test_compact_cells05.xlsx", &options);
+    lxw_worksheet *worksheet = workbook_add_worksheet(workbook, NULL);
+
+    workbook_unset_default_url_format(workbook);
+
+    worksheet_write_url(worksheet, CELL("A1"),  "http://www.perl.org/", NULL);
+    worksheet_write_url(worksheet, CELL("D4"),  "http://www.perl.org/", NULL);
+    worksheet_write_url(worksheet, CELL("A8"),  "http://www.perl.org/", NULL);
+    worksheet_write_url(worksheet, CELL("B6"),  "http://www.cpan.org/", NULL);
+    worksheet_write_url(worksheet, CELL("F12"), "http://www.cpan.org/", NULL);
+
+    return workbook_close(workbook);
+}
@@ -0,0 +1,35 @@
+/*****************************************************************************
+ * Test cases for libxlsxwriter.
+ *
+ * Test case for per-part compression settings with threads.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ * Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+ *
+ */
+
+#include "xlsxwriter.h"
+
+int main() {
+
+    lxw_workbook_options options = {0};
+    options.compression_level = 9;
+    options.compression_strategy = LXW_COMPRESSION_STRATEGY_FILTERED;
+    options.num_threads = 2;
+
+    lxw_part_compression fast  = {0};
+    lxw_part_compression store = {0};
+
+    fast.level = 1;
+    store.store_only = LXW_TRUE;
+
+    lxw_workbook  *workbook  = workbook_new_opt("test_compression03.xlsx", &options);
+    lxw_worksheet *worksheet = workbook_add_worksheet(workbook, NULL);
+
+    workbook_set_part_compression(workbook, "xl/worksheets/sheet*.xml", &fast);
+    workbook_set_part_compression(workbook, "xl/media/", &store);
+
+    worksheet_insert_image(worksheet, CELL("E9"), "images/red.png");
+
+    return workbook_close(workbook);
+}
@@ -0,0 +1,46 @@
+/*****************************************************************************
+ * Test cases for libxlsxwriter.
+ *
+ * Test case for writing the reused chart parts with threads.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ * Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+ *
+ */
+
+#include "xlsxwriter.h"
+
+int main() {
+
+    lxw_workbook_options options = {0};
+    options.num_threads = 2;
+
+    lxw_workbook  *workbook  = workbook_new_opt("test_compression04.xlsx", &options);
+    lxw_worksheet *worksheet = workbook_add_worksheet(workbook, NULL);
+    lxw_chart     *chart     = workbook_add_chart(workbook, LXW_CHART_COLUMN);
+
+    /* For testing, copy the randomly generated axis ids in the target file. */
+    chart->axis_id_1 = 43424000;
+    chart->axis_id_2 = 43434368;
+
+    uint8_t data[5][3] = {
+        {1, 2,  3},
+        {2, 4,  6},
+        {3, 6,  9},
+        {4, 8,  12},
+        {5, 10, 15}
+    };
+
+    int row, col;
+    for (row = 0; row < 5; row++)
+        for (col = 0; col < 3; col++)
+            worksheet_write_number(worksheet, row, col, data[row][col] , NULL);
+
+    chart_add_series(chart, NULL, "=Sheet1!$A$1:$A$5");
+    chart_add_series(chart, NULL, "=Sheet1!$B$1:$B$5");
+    chart_add_series(chart, NULL, "=Sheet1!$C$1:$C$5");
+
+    worksheet_insert_chart(worksheet, CELL("E9"), chart);
+
+    return workbook_close(workbook);
+}
@@ -0,0 +1,32 @@
+/*****************************************************************************
+ * Test cases for libxlsxwriter.
+ *
+ * Test case for a constant_memory worksheet with a different compression to
+ * the row data.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ * Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+ *
+ */
+
+#include "xlsxwriter.h"
+
+int main() {
+
+    lxw_workbook_options options = {0};
+    options.constant_memory = LXW_TRUE;
+
+    lxw_part_compression compression = {0};
+    compression.level = 9;
+    compression.strategy = LXW_COMPRESSION_STRATEGY_FILTERED;
+
+    lxw_workbook  *workbook  = workbook_new_opt("test_compression05.xlsx", &options);
+    lxw_worksheet *worksheet = workbook_add_worksheet(workbook, NULL);
+
+    workbook_set_part_compression(workbook, "xl/worksheets/sheet1.xml", &compression);
+
+    worksheet_write_string(worksheet, 0, 0, "Hello", NULL);
+    worksheet_write_number(worksheet, 1, 0, 123,     NULL);
+
+    return workbook_close(workbook);
+}
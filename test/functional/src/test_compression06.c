@@ -0,0 +1,26 @@
+/*****************************************************************************
+ * Test cases for libxlsxwriter.
+ *
+ * Test case for a constant_memory worksheet with threads.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ * Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+ *
+ */
+
+#include "xlsxwriter.h"
+
+int main() {
+
+    lxw_workbook_options options = {0};
+    options.constant_memory = LXW_TRUE;
+    options.num_threads = 2;
+
+    lxw_workbook  *workbook  = workbook_new_opt("test_compression06.xlsx", &options);
+    lxw_worksheet *worksheet = workbook_add_worksheet(workbook, NULL);
+
+    worksheet_write_string(worksheet, 0, 0, "Hello", NULL);
+    worksheet_write_number(worksheet, 1, 0, 123,     NULL);
+
+    return workbook_close(workbook);
+}
@@ -14,9 +14,7 @@
 int main() {
 
     /* Test that the module works if the locale is changed. */
-#ifdef USE_DTOA_LIBRARY
     setlocale(LC_NUMERIC, "de_DE");
-#endif
 
     lxw_workbook  *workbook  = workbook_new("test_data08.xlsx");
     lxw_worksheet *worksheet = workbook_add_worksheet(workbook, NULL);
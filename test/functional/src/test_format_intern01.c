@@ -0,0 +1,39 @@
+/*****************************************************************************
+ * Test cases for libxlsxwriter.
+ *
+ * Test case for formats returned by workbook_intern_format().
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ * Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+ *
+ */
+
+#include "xlsxwriter.h"
+
+int main() {
+
+    lxw_workbook  *workbook  = workbook_new("test_format_intern01.xlsx");
+    lxw_worksheet *worksheet = workbook_add_worksheet(workbook, NULL);
+
+    lxw_format    *template  = workbook_add_format(workbook);
+    lxw_format    *format1;
+    lxw_format    *format2;
+
+    format_set_num_format_index(template, 2);
+    format1 = workbook_intern_format(workbook, template);
+
+    format_set_num_format_index(template, 12);
+    format2 = workbook_intern_format(workbook, template);
+
+    /* This should return format1 rather than add a new format. */
+    format_set_num_format_index(template, 2);
+    format1 = workbook_intern_format(workbook, template);
+
+    worksheet_write_number(worksheet, 0, 0, 1.2222, NULL);
+    worksheet_write_number(worksheet, 1, 0, 1.2222, format1);
+    worksheet_write_number(worksheet, 2, 0, 1.2222, format2);
+    worksheet_write_number(worksheet, 3, 0, 1.2222, NULL);
+    worksheet_write_number(worksheet, 4, 0, 1.2222, NULL);
+
+    return workbook_close(workbook);
+}
@@ -0,0 +1,24 @@
+/*****************************************************************************
+ * Test cases for libxlsxwriter.
+ *
+ * Test case for compressing the xlsx file with threads, with an image.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ * Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+ *
+ */
+
+#include "xlsxwriter.h"
+
+int main() {
+
+    lxw_workbook_options options = {0};
+    options.num_threads = 2;
+
+    lxw_workbook  *workbook  = workbook_new_opt("test_num_threads02.xlsx", &options);
+    lxw_worksheet *worksheet = workbook_add_worksheet(workbook, NULL);
+
+    worksheet_insert_image(worksheet, CELL("E9"), "images/red.png");
+
+    return workbook_close(workbook);
+}
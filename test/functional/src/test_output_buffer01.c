@@ -13,11 +13,9 @@
 int main() {
     const char *output_buffer;
     size_t output_buffer_size;
-    lxw_workbook_options options = {LXW_FALSE,
-                                    ".",
-                                    LXW_FALSE,
-                                    &output_buffer,
-                                    &output_buffer_size};
+    lxw_workbook_options options = {.tmpdir = ".",
+                                    .output_buffer = &output_buffer,
+                                    .output_buffer_size = &output_buffer_size};
 
     lxw_workbook  *workbook  = workbook_new_opt(NULL, &options);
     lxw_worksheet *worksheet = workbook_add_worksheet(workbook, NULL);
@@ -0,0 +1,40 @@
+/*****************************************************************************
+ * Test cases for libxlsxwriter.
+ *
+ * Simple test case to test streaming to an output sink.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ * Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+ *
+ */
+
+#include "xlsxwriter.h"
+
+/* Write the streamed data sequentially to a file. */
+size_t sink_write(void *user_data, const void *data, size_t size) {
+    return fwrite(data, 1, size, (FILE *)user_data);
+}
+
+int sink_flush(void *user_data) {
+    return fflush((FILE *)user_data);
+}
+
+int sink_close(void *user_data) {
+    return fclose((FILE *)user_data);
+}
+
+int main() {
+    lxw_output_sink sink = {sink_write, sink_flush, sink_close, NULL};
+    lxw_workbook_options options = {0};
+
+    sink.user_data = fopen("test_output_sink01.xlsx", "wb");
+    options.output_sink = &sink;
+
+    lxw_workbook  *workbook  = workbook_new_opt(NULL, &options);
+    lxw_worksheet *worksheet = workbook_add_worksheet(workbook, NULL);
+
+    worksheet_write_string(worksheet, 0, 0, "Hello", NULL);
+    worksheet_write_number(worksheet, 1, 0, 123,     NULL);
+
+    return workbook_close(workbook);
+}
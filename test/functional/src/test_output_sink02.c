@@ -0,0 +1,40 @@
+/*****************************************************************************
+ * Test cases for libxlsxwriter.
+ *
+ * Test case for streaming to an output sink with threads and an image.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ * Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+ *
+ */
+
+#include "xlsxwriter.h"
+
+/* Write the streamed data sequentially to a file. */
+size_t sink_write(void *user_data, const void *data, size_t size) {
+    return fwrite(data, 1, size, (FILE *)user_data);
+}
+
+int sink_flush(void *user_data) {
+    return fflush((FILE *)user_data);
+}
+
+int sink_close(void *user_data) {
+    return fclose((FILE *)user_data);
+}
+
+int main() {
+    lxw_output_sink sink = {sink_write, sink_flush, sink_close, NULL};
+    lxw_workbook_options options = {0};
+
+    sink.user_data = fopen("test_output_sink02.xlsx", "wb");
+    options.output_sink = &sink;
+    options.num_threads = 2;
+
+    lxw_workbook  *workbook  = workbook_new_opt(NULL, &options);
+    lxw_worksheet *worksheet = workbook_add_worksheet(workbook, NULL);
+
+    worksheet_insert_image(worksheet, CELL("E9"), "images/red.png");
+
+    return workbook_close(workbook);
+}
@@ -0,0 +1,31 @@
+/*****************************************************************************
+ * Test cases for libxlsxwriter.
+ *
+ * Test case for writing static strings in constant_memory mode.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ * Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+ *
+ */
+
+#include "xlsxwriter.h"
+
+int main() {
+
+    const char *hello = "Hello";
+
+    lxw_workbook_options options = {.constant_memory = LXW_TRUE};
+
+    lxw_workbook  *workbook  = workbook_new_opt("test_string_len02.xlsx", &options);
+    lxw_worksheet *worksheet = workbook_add_worksheet(workbook, NULL);
+
+    worksheet_write_string_len(worksheet, 0, 0, hello, 5, NULL,
+                               LXW_STRING_STATIC | LXW_STRING_VALIDATED);
+    /* For testing overwrite the 0, 0 cell to ensure the original isn't freed. */
+    worksheet_write_string_len(worksheet, 0, 0, hello, 5, NULL,
+                               LXW_STRING_STATIC);
+
+    worksheet_write_number(worksheet, 1, 0, 123,     NULL);
+
+    return workbook_close(workbook);
+}
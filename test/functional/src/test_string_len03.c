@@ -0,0 +1,29 @@
+/*****************************************************************************
+ * Test cases for libxlsxwriter.
+ *
+ * Test case for writing strings of known length to shared strings in
+ * constant_memory mode.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ * Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+ *
+ */
+
+#include "xlsxwriter.h"
+
+int main() {
+
+    const char record[] = {'H', 'e', 'l', 'l', 'o', 'W', 'o', 'r', 'l', 'd'};
+
+    lxw_workbook_options options = {.constant_memory = LXW_TRUE,
+                                    .constant_memory_sst = LXW_TRUE};
+
+    lxw_workbook  *workbook  = workbook_new_opt("test_string_len03.xlsx", &options);
+    lxw_worksheet *worksheet = workbook_add_worksheet(workbook, NULL);
+
+    worksheet_write_string_len(worksheet, 0, 0, record, 5, NULL,
+                               LXW_STRING_VALIDATED);
+    worksheet_write_number(worksheet, 1, 0, 123,     NULL);
+
+    return workbook_close(workbook);
+}
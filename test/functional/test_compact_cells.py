@@ -0,0 +1,33 @@
+###############################################################################
+#
+# Tests for libxlsxwriter.
+#
+# SPDX-License-Identifier: BSD-2-Clause
+# Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+#
+
+import base_test_class
+
+class TestCompareXLSXFiles(base_test_class.XLSXBaseTest):
+    """
+    Test file created with libxlsxwriter against a file created by Excel.
+
+    """
+
+    def test_compact_cells01(self):
+        self.run_exe_test('test_compact_cells01', 'rich_string01.xlsx')
+
+    def test_compact_cells02(self):
+        self.run_exe_test('test_compact_cells02', 'chart_column10.xlsx')
+
+    def test_compact_cells03(self):
+        self.run_exe_test('test_compact_cells03', 'comment03.xlsx')
+
+    def test_compact_cells04(self):
+        self.ignore_files = ['xl/calcChain.xml',
+                             '[Content_Types].xml',
+                             'xl/_rels/workbook.xml.rels']
+        self.run_exe_test('test_compact_cells04', 'outline01.xlsx')
+
+    def test_compact_cells05(self):
+        self.run_exe_test('test_compact_cells05', 'hyperlink02.xlsx')
@@ -0,0 +1,28 @@
+###############################################################################
+#
+# Tests for libxlsxwriter.
+#
+# SPDX-License-Identifier: BSD-2-Clause
+# Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+#
+
+import base_test_class
+
+class TestCompareXLSXFiles(base_test_class.XLSXBaseTest):
+    """
+    Test writing shared strings in constant_memory mode. The rows don't have
+    the optional spans attribute in constant_memory mode so they are ignored.
+
+    """
+
+    def test_constant_memory_sst01(self):
+        self.ignore_elements = {'xl/worksheets/sheet1.xml': ['<row']}
+        self.run_exe_test('test_constant_memory_sst01', 'simple01.xlsx')
+
+    def test_constant_memory_sst02(self):
+        self.ignore_elements = {'xl/worksheets/sheet1.xml': ['<row']}
+        self.run_exe_test('test_constant_memory_sst02', 'escapes03.xlsx')
+
+    def test_constant_memory_sst03(self):
+        self.ignore_elements = {'xl/worksheets/sheet1.xml': ['<row']}
+        self.run_exe_test('test_constant_memory_sst03', 'autofilter00.xlsx')
@@ -61,3 +61,6 @@ class TestCompareXLSXFiles(base_test_class.XLSXBaseTest):
 
     def test_format52(self):
         self.run_exe_test('test_format52')
+
+    def test_format_intern01(self):
+        self.run_exe_test('test_format_intern01', 'format06.xlsx')
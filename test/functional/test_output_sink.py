@@ -0,0 +1,21 @@
+###############################################################################
+#
+# Tests for libxlsxwriter.
+#
+# SPDX-License-Identifier: BSD-2-Clause
+# Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+#
+
+import base_test_class
+
+class TestCompareXLSXFiles(base_test_class.XLSXBaseTest):
+    """
+    Test file created with libxlsxwriter against a file created by Excel.
+
+    """
+
+    def test_output_sink01(self):
+        self.run_exe_test('test_output_sink01', 'simple01.xlsx')
+
+    def test_output_sink02(self):
+        self.run_exe_test('test_output_sink02', 'image01.xlsx')
@@ -0,0 +1,27 @@
+###############################################################################
+#
+# Tests for libxlsxwriter.
+#
+# SPDX-License-Identifier: BSD-2-Clause
+# Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+#
+
+import base_test_class
+
+class TestCompareXLSXFiles(base_test_class.XLSXBaseTest):
+    """
+    Test writing strings with worksheet_write_string_len(). The rows don't
+    have the optional spans attribute in constant_memory mode with shared
+    strings so they are ignored.
+
+    """
+
+    def test_string_len01(self):
+        self.run_exe_test('test_string_len01', 'simple01.xlsx')
+
+    def test_string_len02(self):
+        self.run_exe_test('test_string_len02', 'optimize01.xlsx')
+
+    def test_string_len03(self):
+        self.ignore_elements = {'xl/worksheets/sheet1.xml': ['<row']}
+        self.run_exe_test('test_string_len03', 'simple01.xlsx')
@@ -0,0 +1,97 @@
+/*
+ * Performance test for format deduplication. Creates a format for each cell,
+ * as applications that generate per cell formats do, with a limited number
+ * of distinct formats. The formats are created either with
+ * workbook_add_format() for each cell or with workbook_intern_format() from
+ * a single template format.
+ *
+ * Usage: perf_formats [formats] [unique formats]
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ * Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "xlsxwriter.h"
+
+/* Set conditional looking properties: colors and a border from a value. */
+static void
+set_format_properties(lxw_format *format, uint32_t n)
+{
+    format_set_bg_color(format, 0xFF0000 + n);
+    format_set_font_color(format, 0x000000 + n % 64);
+    format_set_border(format, 1 + n % 13);
+    format_set_bold(format);
+
+    if (n % 2 == 0)
+        format->bold = LXW_FALSE;
+}
+
+/* Write a format for each cell and return the elapsed time in seconds. */
+static double
+write_workbook(uint32_t num_formats, uint32_t num_unique, uint8_t intern)
+{
+    lxw_workbook *workbook;
+    lxw_worksheet *worksheet;
+    lxw_format *template;
+    lxw_format *format;
+    lxw_error error;
+    clock_t start = clock();
+    uint32_t i;
+    uint32_t n;
+
+    workbook = workbook_new("perf_formats.xlsx");
+    worksheet = workbook_add_worksheet(workbook, NULL);
+    template = workbook_add_format(workbook);
+
+    for (i = 0; i < num_formats; i++) {
+        n = i % num_unique;
+
+        if (intern) {
+            set_format_properties(template, n);
+            format = workbook_intern_format(workbook, template);
+        }
+        else {
+            format = workbook_add_format(workbook);
+            set_format_properties(format, n);
+        }
+
+        worksheet_write_number(worksheet, i / 10, i % 10, n, format);
+    }
+
+    error = workbook_close(workbook);
+    if (error) {
+        fprintf(stderr, "workbook_close() failed: %s\n", lxw_strerror(error));
+        exit(1);
+    }
+
+    return (double) (clock() - start) / CLOCKS_PER_SEC;
+}
+
+int
+main(int argc, char **argv)
+{
+    uint32_t num_formats = argc > 1 ? (uint32_t) atol(argv[1]) : 200000;
+    uint32_t num_unique = argc > 2 ? (uint32_t) atol(argv[2]) : 10000;
+    uint8_t intern;
+
+    if (num_unique == 0)
+        num_unique = 1;
+
+    printf("Formats: %u, unique: %u\n\n", (unsigned) num_formats,
+           (unsigned) num_unique);
+    printf("%-24s %10s\n", "Method", "Seconds");
+
+    for (intern = 0; intern <= 1; intern++) {
+        printf("%-24s %10.2f\n",
+               intern ? "workbook_intern_format" : "workbook_add_format",
+               write_workbook(num_formats, num_unique, intern));
+    }
+
+    remove("perf_formats.xlsx");
+
+    return 0;
+}
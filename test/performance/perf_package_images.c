@@ -0,0 +1,184 @@
+/*
+ * Performance test for packaging images. Reports the workbook_close() time
+ * and file size for a workbook with many already-compressed PNG images, with
+ * the images stored in the xlsx file, which is the default, and with the
+ * images deflated like the XML parts.
+ *
+ * Usage: perf_package_images [images] [size]
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ * Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <zlib.h>
+#include "xlsxwriter.h"
+
+typedef struct png_image {
+    unsigned char *data;
+    size_t size;
+} png_image;
+
+/* Write a 32 bit big endian value. */
+static unsigned char *
+put_u32(unsigned char *p, uint32_t value)
+{
+    p[0] = (unsigned char) (value >> 24);
+    p[1] = (unsigned char) (value >> 16);
+    p[2] = (unsigned char) (value >> 8);
+    p[3] = (unsigned char) value;
+    return p + 4;
+}
+
+/* Write a PNG chunk with its length and crc. */
+static unsigned char *
+put_chunk(unsigned char *p, const char *type, const unsigned char *data,
+          uint32_t length)
+{
+    p = put_u32(p, length);
+    memcpy(p, type, 4);
+    memcpy(p + 4, data, length);
+    p = put_u32(p + 4 + length, (uint32_t) crc32(0L, p, length + 4));
+    return p;
+}
+
+/*
+ * Create a size x size RGB PNG filled with noise. Like a photo, the image
+ * data doesn't compress any further.
+ */
+static png_image
+make_png(uint32_t size, uint32_t seed)
+{
+    static const unsigned char signature[8] = {
+        0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A
+    };
+    png_image image = { NULL, 0 };
+    unsigned char header[13] = { 0 };
+    size_t row_size = (size_t) size * 3 + 1;
+    uLongf idat_size = compressBound((uLong) (row_size * size));
+    unsigned char *pixels = malloc(row_size * size);
+    unsigned char *idat = malloc(idat_size);
+    unsigned char *p;
+    size_t i;
+
+    if (!pixels || !idat)
+        exit(1);
+
+    for (i = 0; i < row_size * size; i++) {
+        seed = seed * 1103515245 + 12345;
+        pixels[i] = i % row_size ? (unsigned char) (seed >> 16) : 0;
+    }
+
+    compress2(idat, &idat_size, pixels, (uLong) (row_size * size), 1);
+
+    put_u32(header, size);
+    put_u32(header + 4, size);
+    header[8] = 8;
+    header[9] = 2;
+
+    image.data = malloc(8 + 25 + 12 + idat_size + 12);
+    if (!image.data)
+        exit(1);
+
+    p = image.data;
+    memcpy(p, signature, 8);
+    p = put_chunk(p + 8, "IHDR", header, 13);
+    p = put_chunk(p, "IDAT", idat, (uint32_t) idat_size);
+    p = put_chunk(p, "IEND", NULL, 0);
+    image.size = (size_t) (p - image.data);
+
+    free(pixels);
+    free(idat);
+
+    return image;
+}
+
+/* Write the images to a workbook and return the workbook_close() time. */
+static double
+write_workbook(png_image *images, uint32_t num_images, uint8_t deflate)
+{
+    lxw_part_compression compression = { 0 };
+    lxw_workbook *workbook;
+    lxw_worksheet *worksheet;
+    lxw_error error;
+    clock_t start;
+    uint32_t i;
+
+    workbook = workbook_new("perf_package_images.xlsx");
+    worksheet = workbook_add_worksheet(workbook, NULL);
+
+    /* Override the default so that the images are deflated. */
+    if (deflate)
+        workbook_set_part_compression(workbook, "xl/media/", &compression);
+
+    for (i = 0; i < num_images; i++)
+        worksheet_insert_image_buffer(worksheet, i * 10, 0,
+                                      images[i].data, images[i].size);
+
+    start = clock();
+
+    error = workbook_close(workbook);
+    if (error) {
+        fprintf(stderr, "workbook_close() failed: %s\n", lxw_strerror(error));
+        exit(1);
+    }
+
+    return (double) (clock() - start) / CLOCKS_PER_SEC;
+}
+
+/* Get the size of the output file. */
+static long
+file_size(void)
+{
+    FILE *file = fopen("perf_package_images.xlsx", "rb");
+    long size = -1;
+
+    if (file) {
+        fseek(file, 0, SEEK_END);
+        size = ftell(file);
+        fclose(file);
+    }
+
+    return size;
+}
+
+int
+main(int argc, char **argv)
+{
+    uint32_t num_images = argc > 1 ? (uint32_t) atol(argv[1]) : 200;
+    uint32_t size = argc > 2 ? (uint32_t) atol(argv[2]) : 400;
+    png_image *images = calloc(num_images, sizeof(png_image));
+    uint8_t deflate;
+    double elapsed;
+    uint32_t i;
+
+    if (!images)
+        return 1;
+
+    for (i = 0; i < num_images; i++)
+        images[i] = make_png(size, i + 1);
+
+    printf("Packaging %u PNG images of %u x %u pixels.\n\n",
+           (unsigned) num_images, (unsigned) size, (unsigned) size);
+    printf("%-10s %10s %14s\n", "Mode", "Seconds", "File size");
+
+    for (deflate = 0; deflate <= 1; deflate++) {
+        elapsed = write_workbook(images, num_images, deflate);
+
+        printf("%-10s %10.2f %14ld\n", deflate ? "deflated" : "stored",
+               elapsed, file_size());
+    }
+
+    remove("perf_package_images.xlsx");
+
+    for (i = 0; i < num_images; i++)
+        free(images[i].data);
+
+    free(images);
+
+    return 0;
+}
@@ -0,0 +1,116 @@
+/*
+ * Performance test for the shared string table. Writes a worksheet where
+ * most of the strings are repeated labels, like a typical data export, and
+ * reports the time spent in the worksheet_write_string() calls and in
+ * workbook_close(), the file size and the shared string statistics.
+ *
+ * The mode is 0 for the standard mode, 1 for constant_memory mode with
+ * inline strings and 2 for constant_memory mode with shared strings.
+ *
+ * Usage: perf_shared_strings [rows] [cols] [labels] [mode]
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ * Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "xlsxwriter.h"
+
+static const char *mode_names[] = {
+    "standard", "constant_memory", "constant_memory_sst"
+};
+
+/* Get the size of the output file. */
+static long
+file_size(void)
+{
+    FILE *file = fopen("perf_shared_strings.xlsx", "rb");
+    long size = -1;
+
+    if (file) {
+        fseek(file, 0, SEEK_END);
+        size = ftell(file);
+        fclose(file);
+    }
+
+    return size;
+}
+
+int
+main(int argc, char **argv)
+{
+    lxw_row_t rows = argc > 1 ? (lxw_row_t) atol(argv[1]) : 200000;
+    lxw_col_t cols = argc > 2 ? (lxw_col_t) atol(argv[2]) : 10;
+    long labels = argc > 3 ? atol(argv[3]) : 1000;
+    int mode = argc > 4 ? atoi(argv[4]) : 0;
+    lxw_workbook_options options = { 0 };
+    lxw_string_stats stats;
+    lxw_workbook *workbook;
+    lxw_worksheet *worksheet;
+    lxw_row_t row;
+    lxw_col_t col;
+    lxw_error error;
+    char string[32];
+    double write_time;
+    double close_time;
+    clock_t start;
+
+    if (labels < 1)
+        labels = 1;
+
+    if (mode < 0 || mode > 2)
+        mode = 0;
+
+    options.constant_memory = mode >= 1;
+    options.constant_memory_sst = mode == 2;
+
+    workbook = workbook_new_opt("perf_shared_strings.xlsx", &options);
+    worksheet = workbook_add_worksheet(workbook, NULL);
+
+    start = clock();
+
+    /* Nine in ten strings are repeated labels, the rest are unique. */
+    for (row = 0; row < rows; row++) {
+        for (col = 0; col < cols; col++) {
+            if (col == 0)
+                lxw_snprintf(string, sizeof(string), "Item %lu",
+                             (unsigned long) row);
+            else
+                lxw_snprintf(string, sizeof(string), "Category %ld",
+                             (long) ((row + col) % labels));
+
+            worksheet_write_string(worksheet, row, col, string, NULL);
+        }
+    }
+
+    write_time = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+    workbook_get_string_stats(workbook, &stats);
+
+    start = clock();
+
+    error = workbook_close(workbook);
+    if (error) {
+        fprintf(stderr, "workbook_close() failed: %s\n", lxw_strerror(error));
+        return 1;
+    }
+
+    close_time = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+    printf("Writing %u rows x %u cols of strings, %s mode.\n\n",
+           (unsigned) rows, (unsigned) cols, mode_names[mode]);
+    printf("%-16s %12.2f\n", "Write seconds", write_time);
+    printf("%-16s %12.2f\n", "Close seconds", close_time);
+    printf("%-16s %12ld\n", "File size", file_size());
+    printf("%-16s %12u\n", "Total strings", (unsigned) stats.total_strings);
+    printf("%-16s %12u\n", "Unique strings", (unsigned) stats.unique_strings);
+    printf("%-16s %12lu\n", "String bytes",
+           (unsigned long) stats.string_bytes);
+
+    remove("perf_shared_strings.xlsx");
+
+    return 0;
+}
@@ -0,0 +1,138 @@
+/*
+ * Performance test for writing worksheet cell data. Reports the number of
+ * cells written per second for numbers, shared strings and a mix of cell
+ * types, and for rows of numbers written with worksheet_write_row_numbers(),
+ * in the standard and constant_memory modes.
+ *
+ * Usage: perf_write_cells [rows] [cols]
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ * Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "xlsxwriter.h"
+
+enum data_types {
+    NUMBERS,
+    INTEGERS,
+    STRINGS,
+    MIXED,
+    NUMBER_ROWS
+};
+
+static const char *type_names[] = {
+    "numbers", "integers", "strings", "mixed", "row arrays"
+};
+
+static const char *labels[] = {
+    "North", "South", "East", "West", "Central", "Overseas", "Online", "Retail"
+};
+
+/* Write a rows x cols worksheet and return the elapsed time in seconds. */
+static double
+write_workbook(lxw_row_t rows, lxw_col_t cols, int type, uint8_t optimize)
+{
+    lxw_workbook_options options = { 0 };
+    lxw_workbook *workbook;
+    lxw_worksheet *worksheet;
+    lxw_format *bold;
+    lxw_row_t row;
+    lxw_col_t col;
+    lxw_error error;
+    double *values;
+    clock_t start = clock();
+
+    options.constant_memory = optimize;
+
+    workbook = workbook_new_opt("perf_write_cells.xlsx", &options);
+    worksheet = workbook_add_worksheet(workbook, NULL);
+    bold = workbook_add_format(workbook);
+    format_set_bold(bold);
+
+    values = malloc(cols * sizeof(double));
+    if (!values) {
+        fprintf(stderr, "malloc() failed\n");
+        exit(1);
+    }
+
+    for (row = 0; row < rows; row++) {
+        if (type == NUMBER_ROWS) {
+            for (col = 0; col < cols; col++)
+                values[col] = row * 1.5 + col / 8.0;
+
+            worksheet_write_row_numbers(worksheet, row, 0, values, cols,
+                                        NULL);
+            continue;
+        }
+
+        for (col = 0; col < cols; col++) {
+            switch (type) {
+                case NUMBERS:
+                    worksheet_write_number(worksheet, row, col,
+                                           row * 1.5 + col / 8.0, NULL);
+                    break;
+                case INTEGERS:
+                    worksheet_write_number(worksheet, row, col,
+                                           row * 100 + col, NULL);
+                    break;
+                case STRINGS:
+                    worksheet_write_string(worksheet, row, col,
+                                           labels[(row + col) % 8], NULL);
+                    break;
+                default:
+                    if (col % 4 == 0)
+                        worksheet_write_string(worksheet, row, col,
+                                               labels[row % 8], bold);
+                    else if (col % 4 == 1)
+                        worksheet_write_boolean(worksheet, row, col,
+                                                row % 2, NULL);
+                    else
+                        worksheet_write_number(worksheet, row, col,
+                                               row + col * 0.25, NULL);
+                    break;
+            }
+        }
+    }
+
+    free(values);
+
+    error = workbook_close(workbook);
+    if (error) {
+        fprintf(stderr, "workbook_close() failed: %s\n", lxw_strerror(error));
+        exit(1);
+    }
+
+    return (double) (clock() - start) / CLOCKS_PER_SEC;
+}
+
+int
+main(int argc, char **argv)
+{
+    lxw_row_t rows = argc > 1 ? (lxw_row_t) atol(argv[1]) : 200000;
+    lxw_col_t cols = argc > 2 ? (lxw_col_t) atol(argv[2]) : 25;
+    double cells = (double) rows * cols;
+    double elapsed;
+    uint8_t optimize;
+    int type;
+
+    printf("Writing %u rows x %u cols.\n\n", (unsigned) rows, (unsigned) cols);
+    printf("%-10s %-16s %10s %14s\n", "Data", "Mode", "Seconds", "Cells/sec");
+
+    for (optimize = 0; optimize <= 1; optimize++) {
+        for (type = NUMBERS; type <= NUMBER_ROWS; type++) {
+            elapsed = write_workbook(rows, cols, type, optimize);
+
+            printf("%-10s %-16s %10.2f %14.0f\n", type_names[type],
+                   optimize ? "constant_memory" : "standard", elapsed,
+                   elapsed > 0 ? cells / elapsed : 0.0);
+        }
+    }
+
+    remove("perf_write_cells.xlsx");
+
+    return 0;
+}
@@ -0,0 +1,110 @@
+/*
+ * Performance test for the write then close cycle of a large worksheet.
+ * Reports the time spent in the worksheet_write_number() calls, the time
+ * spent in workbook_close(), which includes freeing the cells and rows, and
+ * the peak resident memory of the process.
+ *
+ * The peak memory is a high water mark for the whole process so each run
+ * measures a single mode: 0 for the standard mode, 1 for constant_memory
+ * mode and 2 for compact_cells mode.
+ *
+ * Usage: perf_write_close [rows] [cols] [mode]
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ * Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "xlsxwriter.h"
+
+static const char *mode_names[] = {
+    "standard", "constant_memory", "compact_cells"
+};
+
+/* Get the peak resident memory in kB, where the platform reports it. */
+static long
+peak_rss_kb(void)
+{
+    FILE *file = fopen("/proc/self/status", "r");
+    char line[256];
+    long peak = -1;
+
+    if (!file)
+        return -1;
+
+    while (fgets(line, sizeof(line), file)) {
+        if (strncmp(line, "VmHWM:", 6) == 0) {
+            peak = atol(line + 6);
+            break;
+        }
+    }
+
+    fclose(file);
+
+    return peak;
+}
+
+int
+main(int argc, char **argv)
+{
+    lxw_row_t rows = argc > 1 ? (lxw_row_t) atol(argv[1]) : 400000;
+    lxw_col_t cols = argc > 2 ? (lxw_col_t) atol(argv[2]) : 25;
+    int mode = argc > 3 ? atoi(argv[3]) : 0;
+    lxw_workbook_options options = { 0 };
+    lxw_workbook *workbook;
+    lxw_worksheet *worksheet;
+    lxw_row_t row;
+    lxw_col_t col;
+    lxw_error error;
+    double write_time;
+    double close_time;
+    clock_t start;
+    long peak;
+
+    if (mode < 0 || mode > 2)
+        mode = 0;
+
+    options.constant_memory = mode == 1;
+    options.compact_cells = mode == 2;
+
+    workbook = workbook_new_opt("perf_write_close.xlsx", &options);
+    worksheet = workbook_add_worksheet(workbook, NULL);
+
+    start = clock();
+
+    for (row = 0; row < rows; row++)
+        for (col = 0; col < cols; col++)
+            worksheet_write_number(worksheet, row, col, row + col * 0.5,
+                                   NULL);
+
+    write_time = (double) (clock() - start) / CLOCKS_PER_SEC;
+    start = clock();
+
+    error = workbook_close(workbook);
+    if (error) {
+        fprintf(stderr, "workbook_close() failed: %s\n", lxw_strerror(error));
+        return 1;
+    }
+
+    close_time = (double) (clock() - start) / CLOCKS_PER_SEC;
+    peak = peak_rss_kb();
+
+    printf("Writing %u rows x %u cols, %s mode.\n\n", (unsigned) rows,
+           (unsigned) cols, mode_names[mode]);
+    printf("%-10s %10s\n", "Write", "Seconds");
+    printf("%-10s %10.2f\n", "write", write_time);
+    printf("%-10s %10.2f\n", "close", close_time);
+
+    if (peak >= 0)
+        printf("\nPeak RSS: %ld kB\n", peak);
+    else
+        printf("\nPeak RSS: not available on this platform\n");
+
+    remove("perf_write_close.xlsx");
+
+    return 0;
+}
@@ -0,0 +1,82 @@
+/*
+ * Tests for the libxlsxwriter library.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ * Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+ *
+ */
+
+#include <string.h>
+#include "../ctest.h"
+#include "../helper.h"
+
+#include "../../../include/xlsxwriter/chart.h"
+
+// Test the _chart_write_str_cache() function with mixed data.
+CTEST(chart, write_str_cache01) {
+
+    char* got;
+    char exp[] = "<c:strCache>"
+                   "<c:ptCount val=\"4\"/>"
+                   "<c:pt idx=\"0\"><c:v>1.5</c:v></c:pt>"
+                   "<c:pt idx=\"2\"><c:v>Foo</c:v></c:pt>"
+                   "<c:pt idx=\"3\"><c:v>0</c:v></c:pt>"
+                 "</c:strCache>";
+    FILE* testfile = lxw_tmpfile(NULL);
+    lxw_series_range range = {0};
+
+    lxw_chart *chart = lxw_chart_new(LXW_CHART_AREA);
+    chart->file = testfile;
+
+    lxw_chart_init_data_cache(&range, 4);
+    range.data_cache[0] = 1.5;
+    lxw_chart_set_cache_no_data(&range, 1);
+    lxw_chart_set_cache_string(&range, 2, "Foo");
+
+    ASSERT_TRUE(range.has_string_cache);
+
+    _chart_write_str_cache(chart, &range);
+
+    RUN_XLSX_STREQ(exp, got);
+
+    lxw_chart_free_data_cache(&range);
+    lxw_chart_free(chart);
+}
+
+// Test the _chart_write_num_cache() function with more than 65535 points.
+CTEST(chart, write_num_cache01) {
+
+    char* got;
+    long file_size;
+    uint32_t i;
+    uint32_t num_points = 70000;
+    FILE* testfile = lxw_tmpfile(NULL);
+    lxw_series_range range = {0};
+
+    lxw_chart *chart = lxw_chart_new(LXW_CHART_SCATTER);
+    chart->file = testfile;
+
+    lxw_chart_init_data_cache(&range, num_points);
+    for (i = 0; i < num_points; i++)
+        range.data_cache[i] = i;
+
+    lxw_chart_set_cache_no_data(&range, 65536);
+
+    _chart_write_num_cache(chart, &range);
+
+    fflush(testfile);
+    file_size = ftell(testfile);
+    got = (char*)calloc(file_size + 1, 1);
+    rewind(testfile);
+    (void)fread(got, file_size, 1, testfile);
+
+    ASSERT_NOT_NULL(strstr(got, "<c:ptCount val=\"70000\"/>"));
+    ASSERT_NOT_NULL(strstr(got, "<c:pt idx=\"65535\"><c:v>65535</c:v>"));
+    ASSERT_NULL(strstr(got, "<c:pt idx=\"65536\">"));
+    ASSERT_NOT_NULL(strstr(got, "<c:pt idx=\"69999\"><c:v>69999</c:v>"));
+
+    free(got);
+    fclose(testfile);
+    lxw_chart_free_data_cache(&range);
+    lxw_chart_free(chart);
+}
@@ -83,3 +83,142 @@ CTEST(sst, sst02) {
 
     lxw_sst_free(sst);
 }
+
+// Test finding strings when the hash table grows and the strings are in
+// several blocks.
+CTEST(sst, sst03) {
+
+    char string[32];
+    char long_string[20000];
+    struct sst_element *elements[2000];
+    struct sst_element *element;
+    int i;
+
+    lxw_sst *sst = lxw_sst_new();
+
+    memset(long_string, 'x', sizeof(long_string) - 1);
+    long_string[sizeof(long_string) - 1] = '\0';
+
+    for (i = 0; i < 2000; i++) {
+        lxw_snprintf(string, sizeof(string), "string %d", i);
+        elements[i] = lxw_get_sst_index(sst, string, LXW_FALSE);
+        ASSERT_EQUAL(i, elements[i]->index);
+    }
+
+    element = lxw_get_sst_index(sst, long_string, LXW_FALSE);
+    ASSERT_EQUAL(2000, element->index);
+    ASSERT_TRUE(element == lxw_get_sst_index(sst, long_string, LXW_FALSE));
+
+    // Strings that are prefixes of other strings are different strings.
+    element = lxw_get_sst_index(sst, "string 1", LXW_FALSE);
+    ASSERT_TRUE(element == elements[1]);
+    element = lxw_get_sst_index(sst, "string", LXW_FALSE);
+    ASSERT_EQUAL(2001, element->index);
+    element = lxw_get_sst_index(sst, "", LXW_FALSE);
+    ASSERT_EQUAL(2002, element->index);
+
+    for (i = 0; i < 2000; i++) {
+        lxw_snprintf(string, sizeof(string), "string %d", i);
+        element = lxw_get_sst_index(sst, string, LXW_FALSE);
+        ASSERT_TRUE(element == elements[i]);
+        ASSERT_STR(string, element->string);
+    }
+
+    ASSERT_EQUAL(4005, sst->string_count);
+    ASSERT_EQUAL(2003, sst->unique_count);
+
+    lxw_sst_free(sst);
+}
+
+// Test assembling a SharedStrings file from temp files.
+CTEST(sst, sst04) {
+
+    char* got;
+    char exp[] =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<sst xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\" count=\"6\" uniqueCount=\"3\">"
+          "<si>"
+            "<t>neptune</t>"
+          "</si>"
+          "<si>"
+            "<t xml:space=\"preserve\">   mars</t>"
+          "</si>"
+          "<si>"
+            "<t>&lt;venus&gt;</t>"
+          "</si>"
+        "</sst>";
+
+    uint32_t index;
+    FILE* testfile = lxw_tmpfile(NULL);
+
+    lxw_sst *sst = lxw_sst_new();
+    lxw_sst_use_tmpfiles(sst, NULL);
+    sst->file = testfile;
+
+    lxw_get_sst_id(sst, "neptune", LXW_FALSE, &index);
+    ASSERT_EQUAL(0, index);
+    lxw_get_sst_id(sst, "   mars", LXW_FALSE, &index);
+    ASSERT_EQUAL(1, index);
+    lxw_get_sst_id(sst, "neptune", LXW_FALSE, &index);
+    ASSERT_EQUAL(0, index);
+    lxw_get_sst_id(sst, "<venus>", LXW_FALSE, &index);
+    ASSERT_EQUAL(2, index);
+    lxw_get_sst_id(sst, "<venus>", LXW_FALSE, &index);
+    ASSERT_EQUAL(2, index);
+    lxw_get_sst_id(sst, "   mars", LXW_FALSE, &index);
+    ASSERT_EQUAL(1, index);
+
+    lxw_sst_assemble_xml_file(sst);
+
+    RUN_XLSX_STREQ_SHORT(exp, got);
+
+    lxw_sst_free(sst);
+}
+
+// Test finding strings in the temp files after they have been evicted from
+// the recently used string cache.
+CTEST(sst, sst05) {
+
+    char string[32];
+    char long_string[1000];
+    uint32_t index;
+    lxw_error err;
+    int i;
+
+    lxw_sst *sst = lxw_sst_new();
+    lxw_sst_use_tmpfiles(sst, NULL);
+
+    memset(long_string, 'x', sizeof(long_string) - 1);
+    long_string[sizeof(long_string) - 1] = '\0';
+
+    for (i = 0; i < 5000; i++) {
+        lxw_snprintf(string, sizeof(string), "string %d", i);
+        err = lxw_get_sst_id(sst, string, LXW_FALSE, &index);
+        ASSERT_EQUAL(LXW_NO_ERROR, err);
+        ASSERT_EQUAL(i, index);
+    }
+
+    // Long strings aren't cached.
+    lxw_get_sst_id(sst, long_string, LXW_FALSE, &index);
+    ASSERT_EQUAL(5000, index);
+    lxw_get_sst_id(sst, long_string, LXW_FALSE, &index);
+    ASSERT_EQUAL(5000, index);
+
+    for (i = 0; i < 5000; i++) {
+        lxw_snprintf(string, sizeof(string), "string %d", i);
+        err = lxw_get_sst_id(sst, string, LXW_FALSE, &index);
+        ASSERT_EQUAL(LXW_NO_ERROR, err);
+        ASSERT_EQUAL(i, index);
+    }
+
+    // New strings are appended after the key file has been read.
+    lxw_get_sst_id(sst, "string", LXW_FALSE, &index);
+    ASSERT_EQUAL(5001, index);
+    lxw_get_sst_id(sst, "string 0", LXW_FALSE, &index);
+    ASSERT_EQUAL(0, index);
+
+    ASSERT_EQUAL(10004, sst->string_count);
+    ASSERT_EQUAL(5002, sst->unique_count);
+
+    lxw_sst_free(sst);
+}
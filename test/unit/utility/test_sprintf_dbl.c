@@ -0,0 +1,47 @@
+/*
+ * Tests for the libxlsxwriter library.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ * Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+ *
+ */
+
+#include "../ctest.h"
+#include "../helper.h"
+
+#include "../../../include/xlsxwriter/utility.h"
+#include <string.h>
+
+#define TEST_SPRINTF_DBL(number, exp)               \
+    len = lxw_sprintf_dbl(got, number);             \
+    ASSERT_STR(exp, got);                           \
+    ASSERT_EQUAL((int) strlen(exp), len);
+
+
+// Test lxw_sprintf_dbl().
+CTEST(utility, lxw_sprintf_dbl) {
+
+    char got[LXW_ATTR_32];
+    int len;
+
+    TEST_SPRINTF_DBL(0.0,                     "0");
+    TEST_SPRINTF_DBL(-0.0,                    "-0");
+    TEST_SPRINTF_DBL(1.0,                     "1");
+    TEST_SPRINTF_DBL(-123.0,                  "-123");
+    TEST_SPRINTF_DBL(1000000.0,               "1000000");
+    TEST_SPRINTF_DBL(9007199254740993.0,      "9007199254740992");
+    TEST_SPRINTF_DBL(9999999999999998.0,      "9999999999999998");
+    TEST_SPRINTF_DBL(1e16,                    "1E+16");
+    TEST_SPRINTF_DBL(1.5,                     "1.5");
+    TEST_SPRINTF_DBL(-1234.5678,              "-1234.5678");
+    TEST_SPRINTF_DBL(0.1,                     "0.1");
+    TEST_SPRINTF_DBL(0.1 + 0.2,               "0.30000000000000004");
+    TEST_SPRINTF_DBL(1.0 / 3.0,               "0.3333333333333333");
+    TEST_SPRINTF_DBL(0.0001,                  "0.0001");
+    TEST_SPRINTF_DBL(0.00001234,              "1.234E-05");
+    TEST_SPRINTF_DBL(123456789012345.67,      "123456789012345.67");
+    TEST_SPRINTF_DBL(1.7976931348623157e308,  "1.7976931348623157E+308");
+    TEST_SPRINTF_DBL(2.2250738585072014e-308, "2.2250738585072014E-308");
+    TEST_SPRINTF_DBL(4.9406564584124654e-324, "5E-324");
+    TEST_SPRINTF_DBL(-4.56e123,               "-4.56E+123");
+}
@@ -0,0 +1,109 @@
+/*
+ * Tests for the lib_xlsx_writer library.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ * Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+ *
+ */
+
+#include "../ctest.h"
+#include "../helper.h"
+
+#include "../../../include/xlsxwriter/workbook.h"
+
+// Test writing chart series arrays to a hidden data worksheet.
+CTEST(workbook, chart_array_data01) {
+
+    int err;
+    lxw_cell compact_cell;
+    lxw_cell *cell;
+    lxw_worksheet *data_sheet;
+    double x[] = {1, 2, 3};
+    double y[] = {10, 20};
+
+    lxw_workbook *workbook = workbook_new(NULL);
+    lxw_worksheet *worksheet = workbook_add_worksheet(workbook, NULL);
+    lxw_chart *chart = workbook_add_chart(workbook, LXW_CHART_SCATTER);
+    lxw_chart *unused = workbook_add_chart(workbook, LXW_CHART_LINE);
+    lxw_chart_series *series = chart_add_series(chart, NULL, NULL);
+    lxw_chart_series *unused_series = chart_add_series(unused, NULL, NULL);
+
+    /* The default data sheet name is already in use. */
+    workbook_add_worksheet(workbook, "_ChartData");
+
+    chart_series_set_categories_array(series, x, 3);
+    chart_series_set_values_array(series, y, 2);
+    chart_series_set_values_array(unused_series, y, 2);
+
+    worksheet_insert_chart(worksheet, 0, 0, chart);
+
+    err = _prepare_chart_array_data(workbook);
+    ASSERT_EQUAL(LXW_NO_ERROR, err);
+
+    data_sheet = workbook_get_worksheet_by_name(workbook, "_ChartData2");
+    ASSERT_NOT_NULL(data_sheet);
+    ASSERT_TRUE(data_sheet->hidden);
+
+    ASSERT_STR("_ChartData2!$A$1:$A$3", series->categories->formula);
+    ASSERT_STR("_ChartData2!$B$1:$B$2", series->values->formula);
+    ASSERT_EQUAL(1, series->values->first_col);
+    ASSERT_EQUAL(1, series->values->last_row);
+
+    /* The cache is still the array data. */
+    ASSERT_EQUAL(2, series->values->num_data_points);
+    ASSERT_DBL_NEAR(20, series->values->data_cache[1]);
+
+    cell = lxw_worksheet_find_cell_in_row(data_sheet,
+                                          lxw_worksheet_find_row(data_sheet, 2),
+                                          0, &compact_cell);
+    ASSERT_NOT_NULL(cell);
+    ASSERT_DBL_NEAR(3, cell->u.number);
+
+    cell = lxw_worksheet_find_cell_in_row(data_sheet,
+                                          lxw_worksheet_find_row(data_sheet, 2),
+                                          1, &compact_cell);
+    ASSERT_NULL(cell);
+
+    /* Series in charts that aren't inserted aren't written. */
+    ASSERT_NULL(unused_series->values->formula);
+    ASSERT_NULL(workbook_get_worksheet_by_name(workbook, "_ChartData3"));
+
+    lxw_workbook_free(workbook);
+}
+
+// Test the return values of the chart series array functions.
+CTEST(workbook, chart_array_data02) {
+
+    int err;
+    double data[] = {1, 2, 3};
+
+    lxw_workbook *workbook = workbook_new(NULL);
+    lxw_chart *chart = workbook_add_chart(workbook, LXW_CHART_LINE);
+    lxw_chart_series *series = chart_add_series(chart, NULL,
+                                                "=Sheet1!$A$1:$A$3");
+
+    err = chart_series_set_values_array(series, NULL, 3);
+    ASSERT_EQUAL(LXW_ERROR_NULL_PARAMETER_IGNORED, err);
+
+    err = chart_series_set_values_array(series, data, 0);
+    ASSERT_EQUAL(LXW_ERROR_PARAMETER_VALIDATION, err);
+
+    err = chart_series_set_categories_array(series, data,
+                                            LXW_CHART_ARRAY_MAX + 1);
+    ASSERT_EQUAL(LXW_ERROR_PARAMETER_VALIDATION, err);
+
+    /* The existing range is kept on error. */
+    ASSERT_STR("Sheet1!$A$1:$A$3", series->values->formula);
+    ASSERT_FALSE(series->values->has_array_data);
+
+    err = chart_series_set_values_array(series, data, 3);
+    ASSERT_EQUAL(LXW_NO_ERROR, err);
+    ASSERT_NULL(series->values->formula);
+    ASSERT_TRUE(series->values->has_array_data);
+
+    /* Setting a worksheet range replaces the array. */
+    chart_series_set_values(series, "Sheet1", 0, 1, 2, 1);
+    ASSERT_FALSE(series->values->has_array_data);
+
+    lxw_workbook_free(workbook);
+}
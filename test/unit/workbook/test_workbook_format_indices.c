@@ -0,0 +1,63 @@
+/*
+ * Tests for the lib_xlsx_writer library.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ * Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+ *
+ */
+
+#include "../ctest.h"
+#include "../helper.h"
+
+#include "../../../include/xlsxwriter/workbook.h"
+
+// Test format deduplication across resizes of the used formats hash table.
+CTEST(workbook, format_indices01) {
+
+    int i;
+    int32_t first_index;
+    lxw_format *format;
+    lxw_format *duplicate;
+    lxw_hash_element *element;
+
+    lxw_workbook *workbook = workbook_new(NULL);
+
+    /* The default format is the first used format. */
+    first_index = workbook->used_xf_formats->unique_count;
+
+    for (i = 0; i < 1000; i++) {
+        format = workbook_add_format(workbook);
+        format_set_font_color(format, 0x100000 + i);
+        ASSERT_EQUAL(first_index + i, lxw_format_get_xf_index(format));
+    }
+
+    ASSERT_EQUAL(first_index + 1000, workbook->used_xf_formats->unique_count);
+
+    /* Equivalent formats get the index of the first one. */
+    for (i = 999; i >= 0; i--) {
+        duplicate = workbook_add_format(workbook);
+        format_set_font_color(duplicate, 0x100000 + i);
+        ASSERT_EQUAL(first_index + i, lxw_format_get_xf_index(duplicate));
+    }
+
+    ASSERT_EQUAL(first_index + 1000, workbook->used_xf_formats->unique_count);
+
+    /* The used formats are kept in index order. */
+    i = 0;
+    LXW_FOREACH_ORDERED(element, workbook->used_xf_formats) {
+        format = element->value;
+        ASSERT_EQUAL(i, format->xf_index);
+        i++;
+    }
+
+    /* The dxf indices are independent of the xf indices. */
+    format = workbook_add_format(workbook);
+    format_set_bold(format);
+    ASSERT_EQUAL(0, lxw_format_get_dxf_index(format));
+
+    duplicate = workbook_add_format(workbook);
+    format_set_bold(duplicate);
+    ASSERT_EQUAL(0, lxw_format_get_dxf_index(duplicate));
+
+    lxw_workbook_free(workbook);
+}
@@ -0,0 +1,33 @@
+/*
+ * Tests for the libxlsxwriter library.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ * Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+ *
+ */
+
+#include "../ctest.h"
+#include "../helper.h"
+
+#include "../../../include/xlsxwriter/workbook.h"
+#include "../../../include/xlsxwriter/shared_strings.h"
+
+/* Test the shared string statistics. */
+CTEST(workbook, get_string_stats01) {
+    lxw_string_stats stats;
+    lxw_workbook *workbook = workbook_new(NULL);
+    lxw_worksheet *worksheet = workbook_add_worksheet(workbook, NULL);
+
+    worksheet_write_string(worksheet, 0, 0, "North", NULL);
+    worksheet_write_string(worksheet, 1, 0, "South", NULL);
+    worksheet_write_string(worksheet, 2, 0, "North", NULL);
+    worksheet_write_string(worksheet, 3, 0, "North", NULL);
+
+    workbook_get_string_stats(workbook, &stats);
+
+    ASSERT_EQUAL(4, stats.total_strings);
+    ASSERT_EQUAL(2, stats.unique_strings);
+    ASSERT_EQUAL(12, stats.string_bytes);
+
+    lxw_workbook_free(workbook);
+}
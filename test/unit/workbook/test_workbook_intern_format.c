@@ -0,0 +1,69 @@
+/*
+ * Tests for the lib_xlsx_writer library.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ * Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+ *
+ */
+
+#include "../ctest.h"
+#include "../helper.h"
+
+#include "../../../include/xlsxwriter/workbook.h"
+
+// Test getting shared formats with workbook_intern_format().
+CTEST(workbook, intern_format01) {
+
+    int i;
+    uint32_t num_formats;
+    lxw_format *format;
+    lxw_format *red;
+    lxw_format *blue;
+    lxw_format *bold_red;
+
+    lxw_workbook *workbook = workbook_new(NULL);
+    lxw_format *template = workbook_add_format(workbook);
+
+    format_set_font_color(template, LXW_COLOR_RED);
+    red = workbook_intern_format(workbook, template);
+
+    format_set_font_color(template, LXW_COLOR_BLUE);
+    blue = workbook_intern_format(workbook, template);
+
+    format_set_bold(template);
+    format_set_font_color(template, LXW_COLOR_RED);
+    bold_red = workbook_intern_format(workbook, template);
+
+    /* The template isn't returned and each set of properties is unique. */
+    ASSERT_TRUE(red != template);
+    ASSERT_TRUE(red != blue);
+    ASSERT_TRUE(red != bold_red);
+    ASSERT_EQUAL(LXW_COLOR_RED, red->font_color);
+    ASSERT_EQUAL(LXW_COLOR_BLUE, blue->font_color);
+    ASSERT_EQUAL(0, red->bold);
+    ASSERT_EQUAL(1, bold_red->bold);
+
+    /* Repeated properties return the same format without adding formats. */
+    num_formats = workbook->num_format_ids;
+
+    for (i = 0; i < 100; i++) {
+        format_set_bold(template);
+        format_set_font_color(template, LXW_COLOR_RED);
+        ASSERT_TRUE(workbook_intern_format(workbook, template) == bold_red);
+    }
+
+    ASSERT_EQUAL(num_formats, workbook->num_format_ids);
+
+    /* A separately created format with the same properties also matches. */
+    format = workbook_add_format(workbook);
+    format_set_font_color(format, LXW_COLOR_BLUE);
+    ASSERT_TRUE(workbook_intern_format(workbook, format) == blue);
+
+    /* Formats still match after they have been used in a cell. */
+    lxw_format_get_xf_index(red);
+    format = workbook_add_format(workbook);
+    format_set_font_color(format, LXW_COLOR_RED);
+    ASSERT_TRUE(workbook_intern_format(workbook, format) == red);
+
+    lxw_workbook_free(workbook);
+}
@@ -0,0 +1,93 @@
+/*
+ * Tests for the lib_xlsx_writer library.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ * Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+ *
+ */
+
+#include "../ctest.h"
+#include "../helper.h"
+
+#include "../../../include/xlsxwriter/worksheet.h"
+#include "../../../include/xlsxwriter/utility.h"
+
+#define NO_DATA(range, index) \
+    ((range).no_data_cache[(index) >> 3] & (1 << ((index) & 7)))
+
+// Test capturing chart range data as rows are written in constant_memory mode.
+CTEST(worksheet, chart_row_taps01) {
+
+    lxw_chart_range_taps range_taps = {0};
+    lxw_series_range *ranges[3];
+    lxw_series_range column = {0};
+    lxw_series_range row = {0};
+    lxw_series_range late = {0};
+    lxw_worksheet_init_data init_data = {0};
+    lxw_worksheet *worksheet;
+
+    init_data.optimize = LXW_TRUE;
+    init_data.name = lxw_strdup("Sheet1");
+    init_data.chart_range_taps = &range_taps;
+
+    worksheet = lxw_worksheet_new(&init_data);
+
+    /* Sheet1!$B$1:$B$4 and Sheet1!$A$2:$D$2. */
+    column.sheetname = "Sheet1";
+    column.first_row = 0;
+    column.last_row = 3;
+    column.first_col = 1;
+    column.last_col = 1;
+
+    row.sheetname = "Sheet1";
+    row.first_row = 1;
+    row.last_row = 1;
+    row.first_col = 0;
+    row.last_col = 3;
+
+    ranges[0] = &column;
+    ranges[1] = &row;
+    range_taps.ranges = ranges;
+    range_taps.count = 2;
+    range_taps.size = 3;
+
+    worksheet_write_number(worksheet, 0, 1, 1, NULL);
+    worksheet_write_number(worksheet, 1, 1, 2, NULL);
+    worksheet_write_number(worksheet, 1, 3, 4, NULL);
+    worksheet_write_formula(worksheet, 1, 5, "=1+1", NULL);
+
+    /* Sheet1!$B$1:$B$4 again, added after the first rows were written. */
+    late.sheetname = "Sheet1";
+    late.first_row = 0;
+    late.last_row = 3;
+    late.first_col = 1;
+    late.last_col = 1;
+    ranges[2] = &late;
+    range_taps.count = 3;
+
+    worksheet_write_number(worksheet, 3, 1, 5, NULL);
+    lxw_worksheet_write_single_row(worksheet);
+
+    ASSERT_TRUE(column.has_row_tap);
+    ASSERT_EQUAL(4, column.num_data_points);
+    ASSERT_DBL_NEAR(1, column.data_cache[0]);
+    ASSERT_DBL_NEAR(2, column.data_cache[1]);
+    ASSERT_DBL_NEAR(5, column.data_cache[3]);
+    ASSERT_FALSE(NO_DATA(column, 0));
+    ASSERT_TRUE(NO_DATA(column, 2));
+    ASSERT_FALSE(NO_DATA(column, 3));
+
+    ASSERT_TRUE(row.has_row_tap);
+    ASSERT_EQUAL(4, row.num_data_points);
+    ASSERT_TRUE(NO_DATA(row, 0));
+    ASSERT_DBL_NEAR(2, row.data_cache[1]);
+    ASSERT_TRUE(NO_DATA(row, 2));
+    ASSERT_DBL_NEAR(4, row.data_cache[3]);
+
+    ASSERT_FALSE(late.has_row_tap);
+    ASSERT_NULL(late.data_cache);
+
+    lxw_chart_free_data_cache(&column);
+    lxw_chart_free_data_cache(&row);
+    lxw_worksheet_free(worksheet);
+}
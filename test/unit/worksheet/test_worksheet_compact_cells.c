@@ -0,0 +1,108 @@
+/*
+ * Tests for the lib_xlsx_writer library.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ * Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+ *
+ */
+
+#include "../ctest.h"
+#include "../helper.h"
+
+#include "../../../include/xlsxwriter/worksheet.h"
+
+// Test compact cells mixed with formula cells, out of order and overwritten.
+CTEST(worksheet, compact_cells01) {
+
+    char* got;
+    char exp[] =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<worksheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\" xmlns:r=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships\">"
+          "<dimension ref=\"A1:F3\"/>"
+          "<sheetViews>"
+            "<sheetView tabSelected=\"1\" workbookViewId=\"0\"/>"
+          "</sheetViews>"
+          "<sheetFormatPr defaultRowHeight=\"15\"/>"
+          "<sheetData>"
+            "<row r=\"1\" spans=\"1:6\">"
+              "<c r=\"A1\"><v>1</v></c>"
+              "<c r=\"B1\"><f>1+1</f><v>0</v></c>"
+              "<c r=\"C1\"><v>3</v></c>"
+              "<c r=\"D1\"><f>TRUE</f><v>0</v></c>"
+              "<c r=\"E1\"><v>5</v></c>"
+            "</row>"
+            "<row r=\"2\" spans=\"1:6\">"
+              "<c r=\"A2\"><f>2+2</f><v>0</v></c>"
+              "<c r=\"F2\"><v>6</v></c>"
+            "</row>"
+            "<row r=\"3\" spans=\"1:6\">"
+              "<c r=\"B3\"><v>7</v></c>"
+            "</row>"
+          "</sheetData>"
+          "<pageMargins left=\"0.7\" right=\"0.7\" top=\"0.75\" bottom=\"0.75\" header=\"0.3\" footer=\"0.3\"/>"
+        "</worksheet>";
+
+    FILE* testfile = lxw_tmpfile(NULL);
+    lxw_worksheet_init_data init_data = {0};
+
+    init_data.compact_cells = LXW_TRUE;
+
+    lxw_worksheet *worksheet = lxw_worksheet_new(&init_data);
+    worksheet->file = testfile;
+    worksheet_select(worksheet);
+
+    worksheet_write_number(worksheet, 0, 2, 3, NULL);
+    worksheet_write_number(worksheet, 0, 0, 1, NULL);
+    worksheet_write_formula(worksheet, 0, 1, "=1+1", NULL);
+    worksheet_write_number(worksheet, 0, 4, 5, NULL);
+    worksheet_write_boolean(worksheet, 0, 3, 1, NULL);
+    worksheet_write_formula(worksheet, 0, 3, "=TRUE", NULL);
+
+    worksheet_write_number(worksheet, 1, 0, 0, NULL);
+    worksheet_write_formula(worksheet, 1, 0, "=2+2", NULL);
+    worksheet_write_number(worksheet, 1, 5, 6, NULL);
+
+    worksheet_write_formula(worksheet, 2, 1, "=3+3", NULL);
+    worksheet_write_number(worksheet, 2, 1, 7, NULL);
+
+    lxw_worksheet_assemble_xml_file(worksheet);
+
+    RUN_XLSX_STREQ_SHORT(exp, got);
+
+    lxw_worksheet_free(worksheet);
+}
+
+// Test looking up compact cells and cells in the row tree.
+CTEST(worksheet, compact_cells02) {
+
+    lxw_worksheet_init_data init_data = {0};
+    lxw_cell compact_cell;
+    lxw_cell *cell;
+    lxw_row *row;
+
+    init_data.compact_cells = LXW_TRUE;
+
+    lxw_worksheet *worksheet = lxw_worksheet_new(&init_data);
+
+    worksheet_write_number(worksheet, 3, 2, 1.5, NULL);
+    worksheet_write_formula(worksheet, 3, 4, "=1+1", NULL);
+
+    row = lxw_worksheet_find_row(worksheet, 3);
+    ASSERT_TRUE(row != NULL);
+
+    cell = lxw_worksheet_find_cell_in_row(worksheet, row, 2, &compact_cell);
+    ASSERT_TRUE(cell == &compact_cell);
+    ASSERT_EQUAL(NUMBER_CELL, cell->type);
+    ASSERT_EQUAL(3, cell->row_num);
+    ASSERT_EQUAL(2, cell->col_num);
+    ASSERT_DBL_NEAR(1.5, cell->u.number);
+
+    cell = lxw_worksheet_find_cell_in_row(worksheet, row, 4, &compact_cell);
+    ASSERT_TRUE(cell != NULL && cell != &compact_cell);
+    ASSERT_EQUAL(FORMULA_CELL, cell->type);
+
+    cell = lxw_worksheet_find_cell_in_row(worksheet, row, 3, &compact_cell);
+    ASSERT_TRUE(cell == NULL);
+
+    lxw_worksheet_free(worksheet);
+}
@@ -0,0 +1,113 @@
+/*
+ * Tests for the lib_xlsx_writer library.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ * Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+ *
+ */
+
+#include "../ctest.h"
+#include "../helper.h"
+
+#include "../../../include/xlsxwriter/worksheet.h"
+
+
+// Function used for testing. Sum the column widths up to col_num.
+uint32_t
+sum_col_widths(lxw_worksheet *worksheet, lxw_col_t col_num)
+{
+    uint32_t offset = 0;
+    lxw_col_t col;
+
+    for (col = 0; col < col_num; col++)
+        offset += _worksheet_size_col(worksheet, col,
+                                      LXW_OBJECT_POSITION_DEFAULT);
+
+    return offset;
+}
+
+// Function used for testing. Sum the row heights up to row_num.
+uint32_t
+sum_row_heights(lxw_worksheet *worksheet, lxw_row_t row_num)
+{
+    uint32_t offset = 0;
+    lxw_row_t row;
+
+    for (row = 0; row < row_num; row++)
+        offset += _worksheet_size_row(worksheet, row,
+                                      LXW_OBJECT_POSITION_DEFAULT);
+
+    return offset;
+}
+
+
+// Test the column offsets with overlapping and hidden column ranges.
+CTEST(worksheet, col_offset01) {
+
+    lxw_col_t col;
+    lxw_row_col_options hidden = {1, 0, 0};
+    lxw_worksheet *worksheet = lxw_worksheet_new(NULL);
+
+    ASSERT_EQUAL(64 * 100, _worksheet_col_offset(worksheet, 100));
+
+    worksheet_set_column(worksheet, 2, 5, 20, NULL);
+    worksheet_set_column(worksheet, 4, 9, 0.5, NULL);
+    worksheet_set_column_opt(worksheet, 12, 12, 30, NULL, &hidden);
+    worksheet_set_column(worksheet, 14, 15, 3, NULL);
+
+    for (col = 0; col < 40; col++)
+        ASSERT_EQUAL(sum_col_widths(worksheet, col),
+                     _worksheet_col_offset(worksheet, col));
+
+    ASSERT_EQUAL(sum_col_widths(worksheet, LXW_COL_MAX - 1),
+                 _worksheet_col_offset(worksheet, LXW_COL_MAX - 1));
+
+    // Changing the columns should invalidate the cached offsets.
+    worksheet_set_column(worksheet, 0, 0, 50, NULL);
+    worksheet_set_column(worksheet, 30, 31, 10, NULL);
+
+    for (col = 0; col < 40; col++)
+        ASSERT_EQUAL(sum_col_widths(worksheet, col),
+                     _worksheet_col_offset(worksheet, col));
+
+    lxw_worksheet_free(worksheet);
+}
+
+// Test the row offsets with a changed default height and hidden rows.
+CTEST(worksheet, row_offset01) {
+
+    lxw_row_t row;
+    lxw_row_col_options hidden = {1, 0, 0};
+    lxw_worksheet *worksheet = lxw_worksheet_new(NULL);
+
+    worksheet_set_row(worksheet, 3, 30, NULL);
+    ASSERT_EQUAL(20 * 100, _worksheet_row_offset(worksheet, 100));
+
+    worksheet_set_default_row(worksheet, 24, LXW_FALSE);
+    worksheet_set_row_opt(worksheet, 5, 30, NULL, &hidden);
+    worksheet_set_row(worksheet, 7, 24, NULL);
+    worksheet_set_row(worksheet, 1000, 50, NULL);
+    worksheet_write_number(worksheet, 8, 0, 1, NULL);
+
+    for (row = 0; row < 20; row++)
+        ASSERT_EQUAL(sum_row_heights(worksheet, row),
+                     _worksheet_row_offset(worksheet, row));
+
+    ASSERT_EQUAL(sum_row_heights(worksheet, 2000),
+                 _worksheet_row_offset(worksheet, 2000));
+
+    // New rows and row changes should invalidate the cached offsets.
+    worksheet_write_number(worksheet, 10, 0, 1, NULL);
+    worksheet_set_row(worksheet, 3, 10, NULL);
+
+    for (row = 0; row < 20; row++)
+        ASSERT_EQUAL(sum_row_heights(worksheet, row),
+                     _worksheet_row_offset(worksheet, row));
+
+    worksheet_set_default_row(worksheet, 15, LXW_FALSE);
+
+    ASSERT_EQUAL(sum_row_heights(worksheet, 2000),
+                 _worksheet_row_offset(worksheet, 2000));
+
+    lxw_worksheet_free(worksheet);
+}
@@ -0,0 +1,95 @@
+/*
+ * Tests for the lib_xlsx_writer library.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ * Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+ *
+ */
+
+#include "../ctest.h"
+#include "../helper.h"
+
+#include "../../../include/xlsxwriter/worksheet.h"
+
+// Test iterating over a column range with sparse rows.
+CTEST(worksheet, range_iterator01) {
+
+    lxw_range_iterator iterator;
+    lxw_cell *cell;
+
+    lxw_worksheet *worksheet = lxw_worksheet_new(NULL);
+
+    worksheet_write_number(worksheet, 0, 1, 1, NULL);
+    worksheet_write_number(worksheet, 2, 0, 2, NULL);
+    worksheet_write_number(worksheet, 2, 1, 3, NULL);
+    worksheet_write_number(worksheet, 2, 2, 4, NULL);
+    worksheet_write_number(worksheet, 5, 1, 5, NULL);
+    worksheet_write_number(worksheet, 9, 1, 6, NULL);
+
+    lxw_worksheet_range_iterator_init(&iterator, worksheet, 1, 1, 5, 1);
+
+    cell = lxw_worksheet_range_iterator_next(&iterator);
+    ASSERT_NOT_NULL(cell);
+    ASSERT_EQUAL(2, cell->row_num);
+    ASSERT_EQUAL(1, cell->col_num);
+    ASSERT_DBL_NEAR(3, cell->u.number);
+
+    cell = lxw_worksheet_range_iterator_next(&iterator);
+    ASSERT_NOT_NULL(cell);
+    ASSERT_EQUAL(5, cell->row_num);
+    ASSERT_DBL_NEAR(5, cell->u.number);
+
+    cell = lxw_worksheet_range_iterator_next(&iterator);
+    ASSERT_NULL(cell);
+
+    /* A range with no rows. */
+    lxw_worksheet_range_iterator_init(&iterator, worksheet, 10, 0, 20, 0);
+    ASSERT_NULL(lxw_worksheet_range_iterator_next(&iterator));
+
+    lxw_worksheet_free(worksheet);
+}
+
+// Test iterating over a row range with compact cells and tree cells.
+CTEST(worksheet, range_iterator02) {
+
+    lxw_worksheet_init_data init_data = {0};
+    lxw_range_iterator iterator;
+    lxw_cell *cell;
+    lxw_col_t cols[4];
+    uint8_t types[4];
+    int count = 0;
+
+    init_data.compact_cells = LXW_TRUE;
+
+    lxw_worksheet *worksheet = lxw_worksheet_new(&init_data);
+
+    worksheet_write_number(worksheet, 3, 0, 1, NULL);
+    worksheet_write_formula(worksheet, 3, 1, "=1+1", NULL);
+    worksheet_write_number(worksheet, 3, 2, 3, NULL);
+    worksheet_write_number(worksheet, 3, 4, 5, NULL);
+    worksheet_write_formula(worksheet, 3, 5, "=2+2", NULL);
+    worksheet_write_number(worksheet, 3, 7, 8, NULL);
+    worksheet_write_number(worksheet, 4, 2, 9, NULL);
+
+    lxw_worksheet_range_iterator_init(&iterator, worksheet, 3, 1, 3, 6);
+
+    while ((cell = lxw_worksheet_range_iterator_next(&iterator))) {
+        ASSERT_TRUE(count < 4);
+        ASSERT_EQUAL(3, cell->row_num);
+        cols[count] = cell->col_num;
+        types[count] = cell->type;
+        count++;
+    }
+
+    ASSERT_EQUAL(4, count);
+    ASSERT_EQUAL(1, cols[0]);
+    ASSERT_EQUAL(FORMULA_CELL, types[0]);
+    ASSERT_EQUAL(2, cols[1]);
+    ASSERT_EQUAL(NUMBER_CELL, types[1]);
+    ASSERT_EQUAL(4, cols[2]);
+    ASSERT_EQUAL(NUMBER_CELL, types[2]);
+    ASSERT_EQUAL(5, cols[3]);
+    ASSERT_EQUAL(FORMULA_CELL, types[3]);
+
+    lxw_worksheet_free(worksheet);
+}
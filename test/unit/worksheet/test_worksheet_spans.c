@@ -316,3 +316,58 @@ CTEST(worksheet, spans06) {
 
     lxw_worksheet_free(worksheet);
 }
+
+// Test that the stored block spans match the spans calculated from the rows.
+CTEST(worksheet, spans07) {
+
+    int i;
+    char* got;
+    char exp[] =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<worksheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\" xmlns:r=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships\">"
+          "<dimension ref=\"B2:E21\"/>"
+          "<sheetViews>"
+            "<sheetView tabSelected=\"1\" workbookViewId=\"0\"/>"
+          "</sheetViews>"
+          "<sheetFormatPr defaultRowHeight=\"15\"/>"
+          "<sheetData>"
+            "<row r=\"2\" spans=\"2:5\">"
+              "<c r=\"B2\"><v>1</v></c>"
+            "</row>"
+            "<row r=\"4\" spans=\"2:5\">"
+              "<c r=\"E4\"><v>2</v></c>"
+            "</row>"
+            "<row r=\"21\" spans=\"3:3\">"
+              "<c r=\"C21\"><v>3</v></c>"
+            "</row>"
+          "</sheetData>"
+          "<pageMargins left=\"0.7\" right=\"0.7\" top=\"0.75\" bottom=\"0.75\" header=\"0.3\" footer=\"0.3\"/>"
+        "</worksheet>";
+
+    for (i = 0; i < 2; i++) {
+        FILE* testfile = lxw_tmpfile(NULL);
+
+        lxw_worksheet *worksheet = lxw_worksheet_new(NULL);
+        worksheet->file = testfile;
+        worksheet_select(worksheet);
+
+        worksheet_write_number(worksheet, 3, 4, 2, NULL);
+        worksheet_write_number(worksheet, 1, 1, 1, NULL);
+        worksheet_write_number(worksheet, 20, 2, 3, NULL);
+
+        ASSERT_EQUAL(1, worksheet->block_spans[0].col_min);
+        ASSERT_EQUAL(4, worksheet->block_spans[0].col_max);
+        ASSERT_EQUAL(2, worksheet->block_spans[1].col_min);
+        ASSERT_EQUAL(2, worksheet->block_spans[1].col_max);
+
+        /* Calculate the spans from the rows the second time. */
+        if (i == 1)
+            worksheet->block_spans_max = 0;
+
+        lxw_worksheet_assemble_xml_file(worksheet);
+
+        RUN_XLSX_STREQ_SHORT(exp, got);
+
+        lxw_worksheet_free(worksheet);
+    }
+}
@@ -0,0 +1,162 @@
+/*
+ * Tests for the lib_xlsx_writer library.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ * Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+ *
+ */
+
+#include "../ctest.h"
+#include "../helper.h"
+
+#include "../../../include/xlsxwriter/worksheet.h"
+#include "../../../include/xlsxwriter/shared_strings.h"
+
+// Test writing arrays of numbers to rows, columns and ranges.
+CTEST(worksheet, write_array01) {
+
+    char* got;
+    char exp[] =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<worksheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\" xmlns:r=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships\">"
+          "<dimension ref=\"A1:D4\"/>"
+          "<sheetViews>"
+            "<sheetView tabSelected=\"1\" workbookViewId=\"0\"/>"
+          "</sheetViews>"
+          "<sheetFormatPr defaultRowHeight=\"15\"/>"
+          "<sheetData>"
+            "<row r=\"1\" spans=\"1:4\">"
+              "<c r=\"A1\"><v>1</v></c>"
+              "<c r=\"B1\"><v>2</v></c>"
+              "<c r=\"C1\"><v>3</v></c>"
+            "</row>"
+            "<row r=\"2\" spans=\"1:4\">"
+              "<c r=\"A2\"><v>0</v></c>"
+              "<c r=\"B2\"><v>4</v></c>"
+              "<c r=\"C2\"><v>5</v></c>"
+              "<c r=\"D2\"><v>6</v></c>"
+            "</row>"
+            "<row r=\"3\" spans=\"1:4\">"
+              "<c r=\"A3\"><v>7</v></c>"
+              "<c r=\"B3\"><v>8</v></c>"
+              "<c r=\"C3\"><v>9</v></c>"
+              "<c r=\"D3\"><v>10</v></c>"
+            "</row>"
+            "<row r=\"4\" spans=\"1:4\">"
+              "<c r=\"A4\"><v>11</v></c>"
+            "</row>"
+          "</sheetData>"
+          "<pageMargins left=\"0.7\" right=\"0.7\" top=\"0.75\" bottom=\"0.75\" header=\"0.3\" footer=\"0.3\"/>"
+        "</worksheet>";
+
+    double row_data[] = {1, 2, 3};
+    double col_data[] = {0, 7, 11};
+    double array_data[2][3] = {{4, 5, 6}, {8, 9, 10}};
+
+    FILE* testfile = lxw_tmpfile(NULL);
+
+    lxw_worksheet *worksheet = lxw_worksheet_new(NULL);
+    worksheet->file = testfile;
+    worksheet_select(worksheet);
+
+    worksheet_write_row_numbers(worksheet, 0, 0, row_data, 3, NULL);
+    worksheet_write_array(worksheet, 1, 1, 2, 3, LXW_ARRAY_NUMBER,
+                          array_data, NULL);
+    worksheet_write_column_numbers(worksheet, 1, 0, col_data, 3, NULL);
+
+    lxw_worksheet_assemble_xml_file(worksheet);
+
+    RUN_XLSX_STREQ_SHORT(exp, got);
+
+    lxw_worksheet_free(worksheet);
+}
+
+// Test writing an array of strings with NULL and empty strings.
+CTEST(worksheet, write_array02) {
+
+    char* got;
+    char exp[] =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<worksheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\" xmlns:r=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships\">"
+          "<dimension ref=\"B2:C3\"/>"
+          "<sheetViews>"
+            "<sheetView tabSelected=\"1\" workbookViewId=\"0\"/>"
+          "</sheetViews>"
+          "<sheetFormatPr defaultRowHeight=\"15\"/>"
+          "<sheetData>"
+            "<row r=\"2\" spans=\"2:3\">"
+              "<c r=\"B2\" t=\"s\"><v>0</v></c>"
+            "</row>"
+            "<row r=\"3\" spans=\"2:3\">"
+              "<c r=\"B3\" t=\"s\"><v>1</v></c>"
+              "<c r=\"C3\" t=\"s\"><v>0</v></c>"
+            "</row>"
+          "</sheetData>"
+          "<pageMargins left=\"0.7\" right=\"0.7\" top=\"0.75\" bottom=\"0.75\" header=\"0.3\" footer=\"0.3\"/>"
+        "</worksheet>";
+
+    const char *data[3][3] = {
+        {"Foo", NULL,  ""},
+        {"Bar", "Foo", NULL},
+        {NULL,  "",    NULL}
+    };
+
+    FILE* testfile = lxw_tmpfile(NULL);
+
+    lxw_worksheet *worksheet = lxw_worksheet_new(NULL);
+    worksheet->file = testfile;
+    worksheet->sst = lxw_sst_new();
+    worksheet_select(worksheet);
+
+    worksheet_write_array(worksheet, 1, 1, 3, 3, LXW_ARRAY_STRING, data,
+                          NULL);
+
+    lxw_worksheet_assemble_xml_file(worksheet);
+
+    RUN_XLSX_STREQ_SHORT(exp, got);
+
+    /* Rows without any strings aren't created. */
+    ASSERT_TRUE(lxw_worksheet_find_row(worksheet, 3) == NULL);
+
+    lxw_sst_free(worksheet->sst);
+    lxw_worksheet_free(worksheet);
+}
+
+// Test the return values of the array functions.
+CTEST(worksheet, write_array03) {
+
+    int err;
+    double data[4] = {1, 2, 3, 4};
+
+    lxw_worksheet *worksheet = lxw_worksheet_new(NULL);
+
+    err = worksheet_write_row_numbers(worksheet, 0, 16381, data, 4, NULL);
+    ASSERT_EQUAL(LXW_ERROR_WORKSHEET_INDEX_OUT_OF_RANGE, err);
+
+    err = worksheet_write_column_numbers(worksheet, 1048573, 0, data, 4,
+                                         NULL);
+    ASSERT_EQUAL(LXW_ERROR_WORKSHEET_INDEX_OUT_OF_RANGE, err);
+
+    /* Nothing is written if the range is out of bounds. */
+    ASSERT_TRUE(RB_EMPTY(worksheet->table));
+
+    err = worksheet_write_row_numbers(worksheet, 0, 16380, data, 4, NULL);
+    ASSERT_EQUAL(LXW_NO_ERROR, err);
+
+    err = worksheet_write_column_numbers(worksheet, 1048572, 0, data, 4,
+                                         NULL);
+    ASSERT_EQUAL(LXW_NO_ERROR, err);
+
+    err = worksheet_write_array(worksheet, 0, 0, 2, 2, LXW_ARRAY_NUMBER,
+                                NULL, NULL);
+    ASSERT_EQUAL(LXW_ERROR_NULL_PARAMETER_IGNORED, err);
+
+    err = worksheet_write_array(worksheet, 0, 0, 2, 2, 99, data, NULL);
+    ASSERT_EQUAL(LXW_ERROR_PARAMETER_VALIDATION, err);
+
+    err = worksheet_write_array(worksheet, 0, 0, 0, 2, LXW_ARRAY_NUMBER,
+                                data, NULL);
+    ASSERT_EQUAL(LXW_NO_ERROR, err);
+
+    lxw_worksheet_free(worksheet);
+}
@@ -21,7 +21,7 @@ CTEST(worksheet, write_row) {
     lxw_worksheet *worksheet = lxw_worksheet_new(NULL);
     worksheet->file = testfile;
 
-    lxw_row *row = _get_row_list(worksheet->table, 0);
+    lxw_row *row = _get_row_list(worksheet, worksheet->table, 0);
 
     _write_row(worksheet, row, NULL);
 
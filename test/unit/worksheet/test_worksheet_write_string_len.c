@@ -0,0 +1,117 @@
+/*
+ * Tests for the lib_xlsx_writer library.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ * Copyright 2014-2025, John McNamara, jmcnamara@cpan.org.
+ *
+ */
+
+#include "../ctest.h"
+#include "../helper.h"
+
+#include "../../../include/xlsxwriter/worksheet.h"
+#include "../../../include/xlsxwriter/shared_strings.h"
+
+// Test writing strings of known length, with and without flags.
+CTEST(worksheet, write_string_len01) {
+
+    char* got;
+    char exp[] =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<worksheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\" xmlns:r=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships\">"
+          "<dimension ref=\"A1:B2\"/>"
+          "<sheetViews>"
+            "<sheetView tabSelected=\"1\" workbookViewId=\"0\"/>"
+          "</sheetViews>"
+          "<sheetFormatPr defaultRowHeight=\"15\"/>"
+          "<sheetData>"
+            "<row r=\"1\" spans=\"1:2\">"
+              "<c r=\"A1\" t=\"s\"><v>0</v></c>"
+              "<c r=\"B1\" t=\"s\"><v>0</v></c>"
+            "</row>"
+            "<row r=\"2\" spans=\"1:2\">"
+              "<c r=\"A2\" t=\"s\"><v>1</v></c>"
+            "</row>"
+          "</sheetData>"
+          "<pageMargins left=\"0.7\" right=\"0.7\" top=\"0.75\" bottom=\"0.75\" header=\"0.3\" footer=\"0.3\"/>"
+        "</worksheet>";
+
+    const char *record = "FooBar";
+    lxw_row *row;
+    lxw_cell *cell;
+
+    FILE* testfile = lxw_tmpfile(NULL);
+
+    lxw_worksheet *worksheet = lxw_worksheet_new(NULL);
+    worksheet->file = testfile;
+    worksheet->sst = lxw_sst_new();
+    worksheet_select(worksheet);
+
+    worksheet_write_string_len(worksheet, 0, 0, record, 3, NULL,
+                               LXW_STRING_DEFAULT);
+    worksheet_write_string(worksheet, 0, 1, "Foo", NULL);
+    worksheet_write_string_len(worksheet, 1, 0, record + 3, 3, NULL,
+                               LXW_STRING_STATIC | LXW_STRING_VALIDATED);
+
+    /* The first string is copied and the static string isn't. */
+    row = lxw_worksheet_find_row(worksheet, 0);
+    cell = lxw_worksheet_find_cell_in_row(worksheet, row, 0, NULL);
+    ASSERT_STR("Foo", cell->sst_element->string);
+    ASSERT_TRUE(cell->sst_element->string != record);
+
+    row = lxw_worksheet_find_row(worksheet, 1);
+    cell = lxw_worksheet_find_cell_in_row(worksheet, row, 0, NULL);
+    ASSERT_TRUE(cell->sst_element->string == record + 3);
+    ASSERT_TRUE(cell->sst_element->is_validated);
+
+    lxw_worksheet_assemble_xml_file(worksheet);
+
+    RUN_XLSX_STREQ_SHORT(exp, got);
+
+    lxw_sst_free(worksheet->sst);
+    lxw_worksheet_free(worksheet);
+}
+
+// Test the return values of worksheet_write_string_len().
+CTEST(worksheet, write_string_len02) {
+
+    int err;
+    size_t i;
+    char *string = malloc(65536);
+
+    lxw_worksheet *worksheet = lxw_worksheet_new(NULL);
+    worksheet->sst = lxw_sst_new();
+
+    /* The length limit is in UTF-8 characters, not bytes. */
+    for (i = 0; i < 65536; i += 2) {
+        string[i] = (char) 0xC3;
+        string[i + 1] = (char) 0xA9;
+    }
+
+    err = worksheet_write_string_len(worksheet, 0, 0, string, 32767 * 2,
+                                     NULL, LXW_STRING_DEFAULT);
+    ASSERT_EQUAL(LXW_NO_ERROR, err);
+
+    err = worksheet_write_string_len(worksheet, 0, 0, string, 32768 * 2,
+                                     NULL, LXW_STRING_DEFAULT);
+    ASSERT_EQUAL(LXW_ERROR_MAX_STRING_LENGTH_EXCEEDED, err);
+
+    err = worksheet_write_string_len(worksheet, 1, 0, string, 0, NULL,
+                                     LXW_STRING_DEFAULT);
+    ASSERT_EQUAL(LXW_NO_ERROR, err);
+
+    err = worksheet_write_string_len(worksheet, 1, 0, NULL, 10, NULL,
+                                     LXW_STRING_DEFAULT);
+    ASSERT_EQUAL(LXW_NO_ERROR, err);
+
+    /* Empty and NULL strings without a format aren't written. */
+    ASSERT_TRUE(lxw_worksheet_find_row(worksheet, 1) == NULL);
+
+    err = worksheet_write_string_len(worksheet, 1048576, 0, "Foo", 3, NULL,
+                                     LXW_STRING_DEFAULT);
+    ASSERT_EQUAL(LXW_ERROR_WORKSHEET_INDEX_OUT_OF_RANGE, err);
+
+    free(string);
+    lxw_sst_free(worksheet->sst);
+    lxw_worksheet_free(worksheet);
+}
@@ -6,6 +6,7 @@
  *
  */
 
+#include <string.h>
 #include "../ctest.h"
 #include "../helper.h"
 
@@ -225,3 +226,58 @@ CTEST(xmlwriter, xml_data_element_with_escapes) {
     LXW_FREE_ATTRIBUTES();
 }
 
+
+// Test _xml_empty_tag() with number attributes and escaped newlines.
+CTEST(xmlwriter, xml_empty_tag_with_attribute_types) {
+
+    char* got;
+    char exp[] = "<foo a=\"-12\" b=\"0.25\" c=\"1&#xA;2\"/>";
+    FILE* testfile = lxw_tmpfile(NULL);
+    struct xml_attribute_list attributes;
+    struct xml_attribute *attribute;
+
+    LXW_INIT_ATTRIBUTES();
+    LXW_PUSH_ATTRIBUTES_INT("a", -12);
+    LXW_PUSH_ATTRIBUTES_DBL("b", 0.25);
+    LXW_PUSH_ATTRIBUTES_STR("c", "1\n2");
+
+    lxw_xml_empty_tag(testfile, "foo", &attributes);
+
+    RUN_XLSX_STREQ(exp, got);
+
+    LXW_FREE_ATTRIBUTES();
+}
+
+// Test _xml_empty_tag() with attributes that exceed the list storage.
+CTEST(xmlwriter, xml_empty_tag_with_many_attributes) {
+
+    int i;
+    char* got;
+    char exp[6000] = "<foo";
+    char value[3000];
+    char *p = exp + 4;
+    FILE* testfile = lxw_tmpfile(NULL);
+    struct xml_attribute_list attributes;
+    struct xml_attribute *attribute;
+
+    /* Long values are truncated to the maximum attribute length. */
+    memset(value, 'x', sizeof(value) - 1);
+    value[sizeof(value) - 1] = '\0';
+
+    LXW_INIT_ATTRIBUTES();
+
+    for (i = 0; i < 100; i++) {
+        LXW_PUSH_ATTRIBUTES_INT("span", i);
+        p += sprintf(p, " span=\"%d\"", i);
+    }
+
+    LXW_PUSH_ATTRIBUTES_STR("long", value);
+    value[LXW_MAX_ATTRIBUTE_LENGTH - 1] = '\0';
+    p += sprintf(p, " long=\"%s\"/>", value);
+
+    lxw_xml_empty_tag(testfile, "foo", &attributes);
+
+    RUN_XLSX_STREQ(exp, got);
+
+    LXW_FREE_ATTRIBUTES();
+}